@@ -0,0 +1,91 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <iostream>
+#include <vector>
+
+// Include headers for the Chisei library
+#include <chisei/idx_loader.hpp> // For loading the MNIST dataset
+#include <chisei/sequential_network.hpp> // For building layered networks
+
+int main() {
+    // Load the first 6000 MNIST samples, with pixels scaled to [0, 1]
+    std::vector<std::vector<double>> inputs, targets;
+    chisei::IDXLoader::loadMNIST(
+        "data/train-images-idx3-ubyte",
+        "data/train-labels-idx1-ubyte",
+        inputs, targets, 6000
+    );
+
+    // Keep the last 1000 samples aside to measure accuracy on unseen digits
+    std::vector<std::vector<double>> test_inputs(inputs.end() - 1000, inputs.end());
+    std::vector<std::vector<double>> test_targets(targets.end() - 1000, targets.end());
+    inputs.resize(inputs.size() - 1000);
+    targets.resize(targets.size() - 1000);
+
+    // Build a small convolutional network over 1x28x28 images:
+    // conv(8, 3x3) -> ReLU -> max pool -> conv(16, 3x3) -> ReLU -> max pool -> dense(10)
+    chisei::SequentialNetwork cnn({1, 28, 28});
+    cnn.add<chisei::Conv2DLayer>(8, 3, 1, 1);
+    cnn.add<chisei::ActivationLayer>(chisei::ActivationType::ReLU);
+    cnn.add<chisei::Pool2DLayer>(chisei::PoolingMode::Max, 2);
+    cnn.add<chisei::Conv2DLayer>(16, 3, 1, 1);
+    cnn.add<chisei::ActivationLayer>(chisei::ActivationType::ReLU);
+    cnn.add<chisei::Pool2DLayer>(chisei::PoolingMode::Max, 2);
+    cnn.add<chisei::DenseLayer>(10);
+    cnn.add<chisei::ActivationLayer>(chisei::ActivationType::Sigmoid);
+
+    std::cout << "Parameters: " << cnn.parameter_count() << std::endl;
+
+    // Train with mini-batches of 16 samples
+    for(int epoch = 1; epoch <= 3; ++epoch) {
+        cnn.train(inputs, targets, 0.5, 1, 16);
+
+        std::cout << "Epoch " << epoch
+            << ", Test Accuracy: " << cnn.compute_accuracy(test_inputs, test_targets) * 100
+            << "%" << std::endl;
+    }
+
+    // Save the trained network and load it back
+    cnn.save_model("data/mnist_cnn.chisei");
+    chisei::SequentialNetwork loaded = chisei::SequentialNetwork::loadFromModel(
+        "data/mnist_cnn.chisei"
+    );
+
+    std::cout << "Loaded Model Accuracy: "
+        << loaded.compute_accuracy(test_inputs, test_targets) * 100
+        << "%" << std::endl;
+
+    return 0;
+}
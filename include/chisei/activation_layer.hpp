@@ -0,0 +1,178 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file ActivationLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the element-wise activation layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_ACTIVATION_LAYER_HPP
+#define CHISEI_ACTIVATION_LAYER_HPP
+
+#include <istream>
+#include <memory>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class ActivationLayer
+     * @brief Applies an activation function element-wise, preserving the shape.
+     */
+    class ActivationLayer final : public Layer {
+    private:
+        /**
+         * @brief The activation function applied by the layer.
+         */
+        ActivationType activation;
+
+        /**
+         * @brief Approximation evaluated in `forward` instead, or `nullptr`.
+         */
+        std::shared_ptr<const ApproximateActivation> approximation;
+
+    public:
+        /**
+         * @brief Constructs an activation layer.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param _activation The activation function to apply.
+         */
+        ActivationLayer(const TensorShape& _input_shape, ActivationType _activation);
+
+        /**
+         * @brief Applies an activation function to an array.
+         * 
+         * `input` and `output` may alias.
+         * 
+         * @param activation The activation function.
+         * @param input The input values.
+         * @param output Receives the activated values.
+         * @param count The number of values.
+         */
+        static void apply(
+            ActivationType activation,
+            const double* input,
+            double* output,
+            size_t count
+        );
+
+        /**
+         * @brief Multiplies a gradient by the activation derivative.
+         * 
+         * The derivative is evaluated on the activated outputs, matching the
+         * conventions of `ActivationFunctions`. `output_gradient` and
+         * `input_gradient` may alias.
+         * 
+         * @param activation The activation function.
+         * @param output The activated values.
+         * @param output_gradient Gradient with respect to the activated values.
+         * @param input_gradient Receives the gradient with respect to the inputs.
+         * @param count The number of values.
+         */
+        static void apply_derivative(
+            ActivationType activation,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t count
+        );
+
+        /**
+         * @brief Builds an approximation of an activation function.
+         * 
+         * Sigmoid is approximated over `[-8, 8]` and tanh over `[-4, 4]`;
+         * `ApproximationKind::Hard` gives hard-sigmoid and hard-tanh. ReLU is
+         * already exact and cheap, so it is never approximated.
+         * 
+         * @param activation The activation function.
+         * @param kind The kind of approximation.
+         * @param resolution Segments for `PiecewiseLinear` (default 16) or entries
+         *                   for `LookupTable` (default 1024); 0 picks the default.
+         * @return The approximation, or `nullptr` for the exact function.
+         */
+        static std::shared_ptr<const ApproximateActivation> approximate(
+            ActivationType activation,
+            ApproximationKind kind,
+            size_t resolution = 0
+        );
+
+        /**
+         * @brief Makes `forward` evaluate an approximation instead of the exact function.
+         * 
+         * `backward` still uses the exact derivative.
+         * 
+         * @param _approximation The approximation, or `nullptr` for the exact function.
+         */
+        void set_approximation(std::shared_ptr<const ApproximateActivation> _approximation) noexcept;
+
+        /**
+         * @brief Reads an activation layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<ActivationLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the activation function applied by the layer.
+         * 
+         * @return The activation type.
+         */
+        ActivationType get_activation() const noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,270 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file ApproximateActivation.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for fast piecewise-linear approximations of activation functions.
+ */
+#ifndef CHISEI_APPROXIMATE_ACTIVATION_HPP
+#define CHISEI_APPROXIMATE_ACTIVATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace chisei {
+
+    /**
+     * @enum ApproximationKind
+     * @brief How an activation function is approximated for inference.
+     */
+    enum class ApproximationKind : uint32_t {
+        /**
+         * @brief The exact function, evaluated with `std::exp` and friends.
+         */
+        Exact = 0,
+
+        /**
+         * @brief A single clamped line, i.e. hard-sigmoid or hard-tanh.
+         */
+        Hard = 1,
+
+        /**
+         * @brief A few least-squares line segments.
+         */
+        PiecewiseLinear = 2,
+
+        /**
+         * @brief A dense table of samples with linear interpolation between them.
+         */
+        LookupTable = 3
+    };
+
+    /**
+     * @class ApproximateActivation
+     * @brief Evaluates an activation function as piecewise-linear segments.
+     * 
+     * The input is clamped to `[lower, upper]`, which is split into equally
+     * wide segments, each holding a slope and an intercept. Every kind of
+     * approximation shares this representation, so they all run through the
+     * same branch-free kernel, which uses AVX2 or AVX-512 gathers when
+     * available. Outside the range the value at the nearer bound is returned,
+     * which suits saturating functions such as the sigmoid and tanh.
+     * 
+     * Approximations only affect inference; training always uses the exact
+     * function and its derivative.
+     */
+    class ApproximateActivation final {
+    private:
+        /**
+         * @brief The kind of approximation.
+         */
+        ApproximationKind kind;
+
+        /**
+         * @brief The lower bound of the approximated range.
+         */
+        double lower;
+
+        /**
+         * @brief The upper bound of the approximated range.
+         */
+        double upper;
+
+        /**
+         * @brief The number of segments per unit of input.
+         */
+        double inverse_step;
+
+        /**
+         * @brief The slope of each segment.
+         */
+        std::vector<double> slopes;
+
+        /**
+         * @brief The intercept of each segment.
+         */
+        std::vector<double> intercepts;
+
+        /**
+         * @brief Single-precision copy of `slopes` for the packed inference path.
+         */
+        std::vector<float> slopes_f;
+
+        /**
+         * @brief Single-precision copy of `intercepts` for the packed inference path.
+         */
+        std::vector<float> intercepts_f;
+
+        /**
+         * @brief Constructs an approximation with uninitialized segments.
+         * 
+         * @param _kind The kind of approximation.
+         * @param _lower The lower bound of the range.
+         * @param _upper The upper bound of the range.
+         * @param segments The number of segments.
+         */
+        ApproximateActivation(
+            ApproximationKind _kind,
+            double _lower,
+            double _upper,
+            size_t segments
+        );
+
+        /**
+         * @brief Copies the segments to their single-precision arrays.
+         */
+        void finalize();
+
+    public:
+        /**
+         * @brief Creates the hard-sigmoid `clamp(x / 4 + 1 / 2, 0, 1)`.
+         * 
+         * @return The approximation.
+         */
+        static ApproximateActivation hard_sigmoid();
+
+        /**
+         * @brief Creates the hard-tanh `clamp(x, -1, 1)`.
+         * 
+         * @return The approximation.
+         */
+        static ApproximateActivation hard_tanh();
+
+        /**
+         * @brief Fits each segment to the function by least squares.
+         * 
+         * Best suited to a small number of segments, where fitting instead of
+         * interpolating roughly halves the maximum error.
+         * 
+         * @param function The function to approximate.
+         * @param segments The number of segments.
+         * @param _lower The lower bound of the range.
+         * @param _upper The upper bound of the range.
+         * @return The approximation.
+         * 
+         * @throws std::invalid_argument if `segments` is 0 or the range is empty.
+         */
+        static ApproximateActivation piecewise_linear(
+            const std::function<double(double)>& function,
+            size_t segments,
+            double _lower,
+            double _upper
+        );
+
+        /**
+         * @brief Samples the function at `entries` evenly spaced points and
+         *        interpolates linearly between them.
+         * 
+         * @param function The function to approximate.
+         * @param entries The number of samples, at least 2.
+         * @param _lower The lower bound of the range.
+         * @param _upper The upper bound of the range.
+         * @return The approximation.
+         * 
+         * @throws std::invalid_argument if `entries` is below 2 or the range is empty.
+         */
+        static ApproximateActivation lookup_table(
+            const std::function<double(double)>& function,
+            size_t entries,
+            double _lower,
+            double _upper
+        );
+
+        /**
+         * @brief Returns the kind of approximation.
+         * 
+         * @return The approximation kind.
+         */
+        ApproximationKind get_kind() const noexcept;
+
+        /**
+         * @brief Returns the number of line segments.
+         * 
+         * @return The segment count.
+         */
+        size_t segment_count() const noexcept;
+
+        /**
+         * @brief Evaluates the approximation at one point.
+         * 
+         * @param x The input value.
+         * @return The approximated function value.
+         */
+        double operator()(double x) const noexcept;
+
+        /**
+         * @brief Evaluates the approximation over an array.
+         * 
+         * `input` and `output` may alias.
+         * 
+         * @param input The input values.
+         * @param output Receives the approximated values.
+         * @param count The number of values.
+         */
+        void apply(const double* input, double* output, size_t count) const noexcept;
+
+        /**
+         * @brief Evaluates the approximation over a single-precision array.
+         * 
+         * `input` and `output` may alias.
+         * 
+         * @param input The input values.
+         * @param output Receives the approximated values.
+         * @param count The number of values.
+         */
+        void apply(const float* input, float* output, size_t count) const noexcept;
+
+        /**
+         * @brief Measures the largest deviation from a function over a range.
+         * 
+         * @param function The reference function.
+         * @param _lower The lower bound of the range.
+         * @param _upper The upper bound of the range.
+         * @param samples The number of evenly spaced points to check (default = 100000).
+         * @return The maximum absolute error.
+         */
+        double max_error(
+            const std::function<double(double)>& function,
+            double _lower,
+            double _upper,
+            size_t samples = 100000
+        ) const;
+    };
+}
+
+#endif
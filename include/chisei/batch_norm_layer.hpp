@@ -0,0 +1,235 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file BatchNormLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the batch normalization layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_BATCH_NORM_LAYER_HPP
+#define CHISEI_BATCH_NORM_LAYER_HPP
+
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class BatchNormLayer
+     * @brief Normalizes each channel over the mini-batch, then scales and shifts it.
+     * 
+     * Statistics are taken per channel over every sample and spatial position,
+     * so a dense layer's outputs are normalized per neuron and a convolution's
+     * per filter. During training the batch statistics are used and folded into
+     * running averages; at inference the running averages turn the layer into a
+     * per-channel affine map, which `SequentialNetwork::fold_batch_norm` merges
+     * into a preceding dense or convolution layer. Training needs batches of
+     * more than one sample for the statistics to be meaningful.
+     */
+    class BatchNormLayer final : public Layer {
+    private:
+        /**
+         * @brief Weight of the newest batch in the running statistics.
+         */
+        double momentum;
+
+        /**
+         * @brief Added to the variance for numerical stability.
+         */
+        double epsilon;
+
+        /**
+         * @brief True while training, selecting batch statistics.
+         */
+        bool training;
+
+        /**
+         * @brief Per-channel scale.
+         */
+        std::vector<double> gamma;
+
+        /**
+         * @brief Per-channel shift.
+         */
+        std::vector<double> beta;
+
+        /**
+         * @brief Running average of the per-channel mean.
+         */
+        std::vector<double> running_mean;
+
+        /**
+         * @brief Running average of the per-channel variance.
+         */
+        std::vector<double> running_variance;
+
+        /**
+         * @brief Accumulated gradient of `gamma`.
+         */
+        std::vector<double> gamma_gradients;
+
+        /**
+         * @brief Accumulated gradient of `beta`.
+         */
+        std::vector<double> beta_gradients;
+
+        /**
+         * @brief Per-channel mean used by the last `forward`.
+         */
+        std::vector<double> batch_mean;
+
+        /**
+         * @brief Per-channel inverse standard deviation used by the last `forward`.
+         */
+        std::vector<double> batch_inverse_std;
+
+        /**
+         * @brief Per-channel scale applied by the last `forward`.
+         */
+        std::vector<double> scale;
+
+        /**
+         * @brief Per-channel shift applied by the last `forward`.
+         */
+        std::vector<double> shift;
+
+        /**
+         * @brief Per-channel variance used by the last `forward`.
+         */
+        std::vector<double> variance;
+
+        /**
+         * @brief Per-channel sum of the output gradients in `backward`.
+         */
+        std::vector<double> gradient_sum;
+
+        /**
+         * @brief Per-channel sum of the output gradients weighted by the normalized inputs.
+         */
+        std::vector<double> weighted_gradient_sum;
+
+        /**
+         * @brief Scratch buffer for the pre-activation gradient of a fused activation.
+         */
+        std::vector<double> activation_gradients;
+
+        /**
+         * @brief Computes the per-channel mean and variance of a batch.
+         * 
+         * @param input The batch.
+         * @param batch The number of samples.
+         * @param mean Receives the per-channel mean.
+         * @param biased_variance Receives the per-channel biased variance.
+         */
+        void compute_statistics(
+            const double* input,
+            size_t batch,
+            std::vector<double>& mean,
+            std::vector<double>& biased_variance
+        ) const;
+
+    public:
+        /**
+         * @brief Constructs a batch normalization layer with `gamma = 1` and `beta = 0`.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param _momentum Weight of each new batch in the running statistics (default = 0.1).
+         * @param _epsilon Added to the variance for numerical stability (default = 1e-5).
+         */
+        explicit BatchNormLayer(
+            const TensorShape& _input_shape,
+            double _momentum = 0.1,
+            double _epsilon = 1e-5
+        );
+
+        /**
+         * @brief Reads a batch normalization layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<BatchNormLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void set_training(bool _training) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the per-channel scale of the inference-time affine map.
+         * 
+         * At inference the layer computes `scale[c] * x + shift[c]` per channel.
+         * 
+         * @return The scale, `gamma / sqrt(running_variance + epsilon)`.
+         */
+        std::vector<double> folded_scale() const;
+
+        /**
+         * @brief Returns the per-channel shift of the inference-time affine map.
+         * 
+         * @return The shift, `beta - running_mean * scale`.
+         */
+        std::vector<double> folded_shift() const;
+    };
+}
+
+#endif
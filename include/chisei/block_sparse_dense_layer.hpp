@@ -0,0 +1,203 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file BlockSparseDenseLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for a fully connected layer with block-sparse weights.
+ */
+#ifndef CHISEI_BLOCK_SPARSE_DENSE_LAYER_HPP
+#define CHISEI_BLOCK_SPARSE_DENSE_LAYER_HPP
+
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/block_sparse_matrix.hpp>
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class BlockSparseDenseLayer
+     * @brief Fully connected layer whose weights keep only a subset of dense blocks.
+     * 
+     * The `n_in x n_out` weight matrix is split into `block_rows x block_cols`
+     * blocks and only the stored blocks of a `BlockSparseMatrix` are computed,
+     * each with a dense vectorized micro-kernel. Unlike unstructured sparsity,
+     * this keeps the regular memory access of dense code, so moderate sparsity
+     * already turns into speed. The sparsity pattern is fixed; training updates
+     * the stored blocks only, which fine-tunes a pruned layer.
+     */
+    class BlockSparseDenseLayer final : public Layer {
+    private:
+        /**
+         * @brief The stored weight blocks.
+         */
+        BlockSparseMatrix weights;
+
+        /**
+         * @brief Bias vector of `n_out` values.
+         */
+        std::vector<double> biases;
+
+        /**
+         * @brief Accumulated gradient of the stored blocks, laid out like their values.
+         */
+        std::vector<double> weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of the biases.
+         */
+        std::vector<double> bias_gradients;
+
+        /**
+         * @brief Scratch buffer for the pre-activation gradient of a fused activation.
+         */
+        std::vector<double> activation_gradients;
+
+        /**
+         * @brief Constructs the layer from existing blocks and biases.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param _weights The weight blocks.
+         * @param _biases The bias vector.
+         */
+        BlockSparseDenseLayer(
+            const TensorShape& _input_shape,
+            BlockSparseMatrix&& _weights,
+            std::vector<double>&& _biases
+        );
+
+    public:
+        /**
+         * @brief Constructs the layer with a random block pattern and random weights.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param outputs The number of output neurons.
+         * @param density The fraction of blocks to store, in (0, 1].
+         * @param block_rows The number of inputs per block (default = 4).
+         * @param block_cols The number of outputs per block; 4, 8 or 16 (default = 16).
+         * 
+         * @throws std::invalid_argument if the density or block shape is invalid.
+         */
+        BlockSparseDenseLayer(
+            const TensorShape& _input_shape,
+            size_t outputs,
+            double density,
+            size_t block_rows = 4,
+            size_t block_cols = 16
+        );
+
+        /**
+         * @brief Prunes dense weights to their blocks of largest magnitude.
+         * 
+         * Blocks are ranked by the sum of their squared weights and the weakest
+         * fraction `sparsity` of them is dropped; the kept weights and the biases
+         * are copied unchanged.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param dense_weights Row-major `n_in x n_out` weight matrix.
+         * @param dense_biases Bias vector of `n_out` values.
+         * @param sparsity The fraction of blocks to drop, in [0, 1).
+         * @param block_rows The number of inputs per block (default = 4).
+         * @param block_cols The number of outputs per block; 4, 8 or 16 (default = 16).
+         * @return The pruned layer.
+         * 
+         * @throws std::invalid_argument if the sparsity, block shape or sizes are invalid.
+         */
+        static std::unique_ptr<BlockSparseDenseLayer> prune(
+            const TensorShape& _input_shape,
+            const std::vector<double>& dense_weights,
+            const std::vector<double>& dense_biases,
+            double sparsity,
+            size_t block_rows = 4,
+            size_t block_cols = 16
+        );
+
+        /**
+         * @brief Reads a layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<BlockSparseDenseLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the stored weight blocks.
+         * 
+         * @return The weights.
+         */
+        const BlockSparseMatrix& get_weights() const noexcept;
+
+        /**
+         * @brief Returns the bias vector.
+         * 
+         * @return The biases.
+         */
+        std::vector<double>& get_biases() noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file BlockSparseMatrix.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the block compressed sparse weight matrix used by block-sparse layers.
+ */
+#ifndef CHISEI_BLOCK_SPARSE_MATRIX_HPP
+#define CHISEI_BLOCK_SPARSE_MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chisei {
+
+    /**
+     * @struct BlockSparseMatrix
+     * @brief A `rows * cols` weight matrix stored as dense `block_rows * block_cols`
+     *        blocks with a block compressed sparse index.
+     * 
+     * Rows are input neurons and columns output neurons, as in the row-major
+     * dense weights, and each stored block is itself a row-major slice of that
+     * layout. The index is compressed by tile, a column of blocks covering
+     * `block_cols` outputs: it is block CSR over the transposed matrix, so the
+     * forward kernel keeps a whole output tile in vector registers while it
+     * streams the tile's blocks, and never scatters. Edge blocks are padded with
+     * zeros. Every kernel costs time proportional to the number of stored blocks.
+     */
+    struct BlockSparseMatrix {
+        /**
+         * @brief Number of rows (input neurons).
+         */
+        size_t rows = 0;
+
+        /**
+         * @brief Number of columns (output neurons).
+         */
+        size_t cols = 0;
+
+        /**
+         * @brief Number of rows (inputs) per block.
+         */
+        size_t block_rows = 0;
+
+        /**
+         * @brief Number of columns (outputs) per block; 4, 8 or 16.
+         */
+        size_t block_cols = 0;
+
+        /**
+         * @brief Offset of the first block of each tile, plus the total block count.
+         */
+        std::vector<uint32_t> tile_offsets{};
+
+        /**
+         * @brief Block row of each stored block, sorted within a tile.
+         */
+        std::vector<uint32_t> block_indices{};
+
+        /**
+         * @brief Values of each stored block, `block_rows * block_cols` apart.
+         */
+        std::vector<double> values{};
+
+        /**
+         * @brief Checks whether a block shape is supported by the kernels.
+         * 
+         * @param block_rows The number of rows per block.
+         * @param block_cols The number of columns per block.
+         * @return True if `block_rows` is between 1 and 256 and `block_cols` is 4, 8 or 16.
+         */
+        static bool valid_block_shape(size_t block_rows, size_t block_cols) noexcept;
+
+        /**
+         * @brief Builds a matrix from the blocks of largest magnitude of a dense matrix.
+         * 
+         * Blocks are ranked by the sum of their squared weights, so a block
+         * survives on its total contribution rather than on any single weight.
+         * 
+         * @param dense Row-major `rows * cols` values.
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param block_rows The number of rows per block.
+         * @param block_cols The number of columns per block.
+         * @param keep The number of blocks to keep.
+         * @return The matrix.
+         * 
+         * @throws std::invalid_argument if the block shape is unsupported.
+         */
+        static BlockSparseMatrix from_dense(
+            const double* dense,
+            size_t rows,
+            size_t cols,
+            size_t block_rows,
+            size_t block_cols,
+            size_t keep
+        );
+
+        /**
+         * @brief Returns the number of block rows.
+         * 
+         * @return `rows / block_rows`, rounded up.
+         */
+        size_t block_row_count() const noexcept {
+            return (this->rows + this->block_rows - 1) / this->block_rows;
+        }
+
+        /**
+         * @brief Returns the number of tiles (block columns).
+         * 
+         * @return `cols / block_cols`, rounded up.
+         */
+        size_t tile_count() const noexcept {
+            return (this->cols + this->block_cols - 1) / this->block_cols;
+        }
+
+        /**
+         * @brief Returns the number of stored blocks.
+         * 
+         * @return The block count.
+         */
+        size_t blocks() const noexcept {
+            return this->block_indices.size();
+        }
+
+        /**
+         * @brief Returns the fraction of blocks that are stored.
+         * 
+         * @return The block density, between 0 and 1.
+         */
+        double density() const noexcept;
+
+        /**
+         * @brief Writes the matrix into a dense row-major buffer.
+         * 
+         * @param dense Receives `rows * cols` values; missing blocks become zero.
+         */
+        void to_dense(double* dense) const;
+
+        /**
+         * @brief Accumulates `output[b][j] += sum_i input[b][i] * W[i][j]` for a batch.
+         * 
+         * @param input `batch * rows` input values.
+         * @param output `batch * cols` output values to accumulate into.
+         * @param batch The number of samples.
+         */
+        void multiply_add(const double* input, double* output, size_t batch) const;
+
+        /**
+         * @brief Computes `output[b][i] = sum_j W[i][j] * gradient[b][j]` for a batch.
+         * 
+         * @param gradient `batch * cols` values.
+         * @param output Receives `batch * rows` values.
+         * @param batch The number of samples.
+         */
+        void multiply_transposed(const double* gradient, double* output, size_t batch) const;
+
+        /**
+         * @brief Accumulates the weight gradient of the stored blocks over a batch.
+         * 
+         * Adds `sum_b input[b][i] * gradient[b][j]` to the entry of `(i, j)` in
+         * `block_gradients`, which has the layout of `values`.
+         * 
+         * @param input `batch * rows` input values.
+         * @param gradient `batch * cols` gradient values.
+         * @param block_gradients `values.size()` gradients to accumulate into.
+         * @param batch The number of samples.
+         */
+        void accumulate_gradient(
+            const double* input,
+            const double* gradient,
+            double* block_gradients,
+            size_t batch
+        ) const;
+    };
+}
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file Conv2DLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the 2D convolution layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_CONV2D_LAYER_HPP
+#define CHISEI_CONV2D_LAYER_HPP
+
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class Conv2DLayer
+     * @brief 2D convolution over CHW inputs with square kernels, stride and zero padding.
+     * 
+     * Each sample is unfolded with im2col into a `(channels * k * k) x (out_h * out_w)`
+     * column matrix and multiplied by the `filters x (channels * k * k)` weight matrix
+     * with the cache-blocked `DenseKernels::gemm`. The backward pass reuses the same
+     * unfolding for the weight gradient and folds the column gradient back with col2im.
+     * Pointwise (1x1, stride 1, no padding) convolutions skip the unfolding entirely.
+     */
+    class Conv2DLayer final : public Layer {
+    private:
+        /**
+         * @brief The side length of the square kernel.
+         */
+        size_t kernel_size;
+
+        /**
+         * @brief The step between neighbouring kernel positions.
+         */
+        size_t stride;
+
+        /**
+         * @brief The number of zero pixels added on every border.
+         */
+        size_t padding;
+
+        /**
+         * @brief Row-major `filters x (channels * k * k)` weight matrix.
+         */
+        std::vector<double> weights;
+
+        /**
+         * @brief Bias of each filter.
+         */
+        std::vector<double> biases;
+
+        /**
+         * @brief Accumulated gradient of the weights.
+         */
+        std::vector<double> weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of the biases.
+         */
+        std::vector<double> bias_gradients;
+
+        /**
+         * @brief Scratch buffer for the unfolded input of one sample.
+         */
+        std::vector<double> columns;
+
+        /**
+         * @brief Scratch buffer for the column gradient of one sample.
+         */
+        std::vector<double> column_gradients;
+
+        /**
+         * @brief Scratch buffer for the pre-activation gradient of one sample when an
+         *        activation is fused.
+         */
+        std::vector<double> activation_gradients;
+
+        /**
+         * @brief Checks whether the convolution is a plain per-pixel matrix product.
+         * 
+         * @return True for 1x1 kernels with stride 1 and no padding.
+         */
+        bool is_pointwise() const noexcept;
+
+        /**
+         * @brief Unfolds one input sample into `columns`.
+         * 
+         * @param input The input sample.
+         */
+        void im2col(const double* input);
+
+        /**
+         * @brief Folds `column_gradients` back into one input gradient sample.
+         * 
+         * @param input_gradient The input gradient sample, overwritten.
+         */
+        void col2im(double* input_gradient) const;
+
+    public:
+        /**
+         * @brief Constructs a convolution layer with randomly initialized parameters.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param filters The number of output channels.
+         * @param _kernel_size The side length of the square kernel.
+         * @param _stride The step between kernel positions (default = 1).
+         * @param _padding The zero padding on every border (default = 0).
+         * 
+         * @throws std::invalid_argument if the kernel does not fit the padded input.
+         */
+        Conv2DLayer(
+            const TensorShape& _input_shape,
+            size_t filters,
+            size_t _kernel_size,
+            size_t _stride = 1,
+            size_t _padding = 0
+        );
+
+        /**
+         * @brief Reads a convolution layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<Conv2DLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the filter weights, one row of `channels * kernel * kernel`
+         *        values per filter.
+         * 
+         * @return The weights.
+         */
+        std::vector<double>& get_weights() noexcept;
+
+        /**
+         * @brief Returns the bias vector, one value per filter.
+         * 
+         * @return The biases.
+         */
+        std::vector<double>& get_biases() noexcept;
+    };
+}
+
+#endif
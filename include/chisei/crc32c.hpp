@@ -0,0 +1,88 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file CRC32C.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the CRC32C (Castagnoli) checksum used by model files.
+ */
+#ifndef CHISEI_CRC32C_HPP
+#define CHISEI_CRC32C_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chisei {
+
+    /**
+     * @class CRC32C
+     * @brief Computes CRC32C checksums with the CPU's CRC instructions.
+     * 
+     * Uses the SSE4.2 `crc32` instruction on x86-64 and the ARMv8 `crc32c`
+     * instructions where the compiler targets them, and a slice-by-8 table
+     * elsewhere. All implementations produce the same standard CRC32C values.
+     */
+    class CRC32C final {
+    public:
+        /**
+         * @brief Extends a checksum with more data.
+         * 
+         * `update(update(0, a), b)` equals the checksum of `a` followed by `b`.
+         * 
+         * @param crc The checksum of the preceding data; 0 for none.
+         * @param data The data to append.
+         * @param length The number of bytes to append.
+         * @return The checksum of the preceding data followed by `data`.
+         */
+        static uint32_t update(uint32_t crc, const void* data, size_t length) noexcept;
+
+        /**
+         * @brief Computes the checksum of a buffer.
+         * 
+         * @param data The data.
+         * @param length The number of bytes.
+         * @return The checksum.
+         */
+        static uint32_t compute(const void* data, size_t length) noexcept;
+
+        /**
+         * @brief Names the implementation compiled in.
+         * 
+         * @return "sse4.2", "armv8" or "software".
+         */
+        static const char* implementation() noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,249 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file Dataset.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the Dataset class, a non-owning view of training samples.
+ */
+#ifndef CHISEI_DATASET_HPP
+#define CHISEI_DATASET_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include <chisei/matrix_view.hpp>
+
+namespace chisei {
+
+    /**
+     * @class Dataset
+     * @brief Input and target rows read in place from caller-owned memory.
+     * 
+     * A dataset never copies its samples. Rows of `double` views and of
+     * `std::vector` rows are used directly. Rows of `float` views are converted
+     * one at a time into a caller-provided scratch buffer when they are read.
+     * The referenced memory must outlive the dataset.
+     * 
+     * @code
+     * // Samples in a NumPy-style float32 buffer with padded rows.
+     * chisei::Dataset dataset(
+     *     chisei::MatrixView<float>(images, count, 784, 800),
+     *     chisei::MatrixView<float>(labels, count, 10)
+     * );
+     * network.train(dataset, 0.1, 10);
+     * @endcode
+     */
+    class Dataset final {
+    private:
+        /**
+         * @struct Source
+         * @brief One side of the dataset, inputs or targets.
+         */
+        struct Source {
+            /**
+             * @brief Rows of a `double` view, or `nullptr`.
+             */
+            MatrixView<double> doubles{};
+
+            /**
+             * @brief Rows of a `float` view, or `nullptr`.
+             */
+            MatrixView<float> floats{};
+
+            /**
+             * @brief Rows held in vectors, or `nullptr`.
+             */
+            const std::vector<std::vector<double>>* vectors = nullptr;
+
+            /**
+             * @brief Returns the number of rows.
+             * 
+             * @return The row count.
+             */
+            size_t rows() const noexcept;
+
+            /**
+             * @brief Returns the number of values per row.
+             * 
+             * @return The column count; 0 if there are no rows.
+             */
+            size_t cols() const noexcept;
+
+            /**
+             * @brief Checks that every row has `cols()` values.
+             * 
+             * Views are rectangular by construction; vector rows are each
+             * compared with the first one.
+             * 
+             * @return `true` if all rows have the same length.
+             */
+            bool uniform() const noexcept;
+
+            /**
+             * @brief Returns one row as `double` values.
+             * 
+             * @param row The row index.
+             * @param scratch At least `cols()` values, used for `float` rows.
+             * @return Pointer to the row.
+             */
+            const double* row(size_t row, double* scratch) const;
+        };
+
+        /**
+         * @brief The input rows.
+         */
+        Source inputs;
+
+        /**
+         * @brief The target rows; empty for an inputs-only dataset.
+         */
+        Source targets;
+
+        /**
+         * @brief Checks that inputs and targets have the same number of rows,
+         *        and that all rows on each side have the same length.
+         * 
+         * @throws std::invalid_argument if they differ.
+         */
+        void check() const;
+
+    public:
+        /**
+         * @brief Constructs a dataset over vectors of rows, without copying them.
+         * 
+         * @param _inputs The input rows.
+         * @param _targets The target rows.
+         * @throws std::invalid_argument if the row counts differ, or if
+         *         the rows on either side differ in length.
+         */
+        Dataset(
+            const std::vector<std::vector<double>>& _inputs,
+            const std::vector<std::vector<double>>& _targets
+        );
+
+        /**
+         * @brief Constructs a dataset over `double` matrices.
+         * 
+         * @param _inputs The input rows.
+         * @param _targets The target rows.
+         * @throws std::invalid_argument if the row counts differ.
+         */
+        Dataset(const MatrixView<double>& _inputs, const MatrixView<double>& _targets);
+
+        /**
+         * @brief Constructs a dataset over `float` matrices.
+         * 
+         * @param _inputs The input rows.
+         * @param _targets The target rows.
+         * @throws std::invalid_argument if the row counts differ.
+         */
+        Dataset(const MatrixView<float>& _inputs, const MatrixView<float>& _targets);
+
+        /**
+         * @brief Constructs an inputs-only dataset over a `double` matrix.
+         * 
+         * @param _inputs The input rows.
+         */
+        Dataset(const MatrixView<double>& _inputs);
+
+        /**
+         * @brief Constructs an inputs-only dataset over a `float` matrix.
+         * 
+         * @param _inputs The input rows.
+         */
+        Dataset(const MatrixView<float>& _inputs);
+
+        /**
+         * @brief Returns the number of samples.
+         * 
+         * @return The sample count.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Checks whether the dataset has no samples.
+         * 
+         * @return True if there are no samples.
+         */
+        bool empty() const noexcept;
+
+        /**
+         * @brief Returns the number of values per input.
+         * 
+         * @return The input size.
+         */
+        size_t input_size() const noexcept;
+
+        /**
+         * @brief Returns the number of values per target.
+         * 
+         * @return The target size; 0 for an inputs-only dataset.
+         */
+        size_t target_size() const noexcept;
+
+        /**
+         * @brief Returns one input as `double` values.
+         * 
+         * @param sample The sample index.
+         * @param scratch At least `input_size()` values, used for `float` data.
+         * @return Pointer to the input, valid until `scratch` is reused.
+         */
+        const double* input(size_t sample, double* scratch) const;
+
+        /**
+         * @brief Returns one target as `double` values.
+         * 
+         * @param sample The sample index.
+         * @param scratch At least `target_size()` values, used for `float` data.
+         * @return Pointer to the target, valid until `scratch` is reused.
+         */
+        const double* target(size_t sample, double* scratch) const;
+
+        /**
+         * @brief Returns consecutive inputs as one contiguous row-major block.
+         * 
+         * Contiguous `double` views are returned in place; anything else is
+         * copied into `scratch`.
+         * 
+         * @param first The first sample.
+         * @param count The number of samples.
+         * @param scratch At least `count * input_size()` values.
+         * @return Pointer to `count * input_size()` values.
+         */
+        const double* input_block(size_t first, size_t count, double* scratch) const;
+    };
+}
+
+#endif
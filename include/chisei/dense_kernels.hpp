@@ -0,0 +1,237 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file DenseKernels.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the tiled dense layer kernels and their tunable configuration.
+ */
+#ifndef CHISEI_DENSE_KERNELS_HPP
+#define CHISEI_DENSE_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chisei {
+
+    /**
+     * @enum KernelPrecision
+     * @brief Floating-point precision a dense kernel operates in.
+     */
+    enum class KernelPrecision {
+        Double,
+        Float
+    };
+
+    /**
+     * @struct KernelConfig
+     * @brief Tunable parameters of the dense layer kernels.
+     * 
+     * The best values depend on the layer shape, the batch size and the host CPU,
+     * which is why they are chosen by the `KernelAutotuner` rather than hard-coded.
+     */
+    struct KernelConfig {
+        /**
+         * @brief Number of output neurons accumulated together in one tile.
+         */
+        size_t tile_size = 64;
+
+        /**
+         * @brief Number of input rows folded into each accumulation step (1, 2, 4 or 8).
+         */
+        size_t unroll = 4;
+
+        /**
+         * @brief Number of threads used when the kernel runs in parallel.
+         */
+        int threads = 1;
+
+        /**
+         * @brief Minimum amount of work (`n_in * n_out * batch`) before the kernel
+         *        is parallelized across threads.
+         */
+        size_t parallel_threshold = 65536;
+
+        /**
+         * @brief Input density below which a sample only visits the weight rows
+         *        of its non-zero inputs.
+         * 
+         * Inputs produced by a ReLU are often mostly zero; such samples skip the
+         * rows that would only add zeros. The choice is made per sample, so a
+         * value of 0 disables the sparse path.
+         */
+        double sparse_density = 0.75;
+    };
+
+    /**
+     * @struct KernelEpilogue
+     * @brief In-place transform applied to each finished output tile of a dense kernel.
+     * 
+     * Used to fuse an activation into the kernel while the tile is still in cache.
+     */
+    struct KernelEpilogue {
+        /**
+         * @brief The transform, or `nullptr` for none.
+         */
+        void (*function)(const void* context, double* values, size_t count) = nullptr;
+
+        /**
+         * @brief Opaque state passed to `function`.
+         */
+        const void* context = nullptr;
+    };
+
+    /**
+     * @class DenseKernels
+     * @brief Computes fully connected layer outputs over contiguous row-major weights.
+     * 
+     * Weights are laid out as `n_in` rows of `n_out` values, so element `(i, j)`
+     * connects input `i` to output `j`. Outputs are split into tiles of
+     * `KernelConfig::tile_size` neurons; each tile streams the matching slice of
+     * every weight row while its accumulators stay in cache.
+     */
+    class DenseKernels final {
+    public:
+
+        /**
+         * @brief Writes the indices of the non-zero values, in ascending order.
+         * 
+         * @param values The values to scan.
+         * @param count The number of values.
+         * @param indices Receives up to `count` indices.
+         * @return The number of non-zero values.
+         */
+        static size_t compress_nonzero(const double* values, size_t count, uint32_t* indices);
+
+        /**
+         * @brief Single-precision overload of `compress_nonzero`.
+         * 
+         * @param values The values to scan.
+         * @param count The number of values.
+         * @param indices Receives up to `count` indices.
+         * @return The number of non-zero values.
+         */
+        static size_t compress_nonzero(const float* values, size_t count, uint32_t* indices);
+
+        /**
+         * @brief Computes `output = input * weights + biases` for a batch of samples.
+         * 
+         * Samples whose input density is below `KernelConfig::sparse_density`
+         * accumulate only the weight rows of their non-zero inputs.
+         * 
+         * @param config The kernel configuration to use.
+         * @param weights Row-major weight matrix of `n_in * n_out` values.
+         * @param biases Bias vector of `n_out` values, or `nullptr` for none.
+         * @param input Row-major batch of `batch * n_in` input values.
+         * @param output Row-major batch of `batch * n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples in the batch (default = 1).
+         * @param epilogue Transform applied to each finished tile (default = none).
+         */
+        static void forward(
+            const KernelConfig& config,
+            const double* weights,
+            const double* biases,
+            const double* input,
+            double* output,
+            size_t n_in,
+            size_t n_out,
+            size_t batch = 1,
+            KernelEpilogue epilogue = KernelEpilogue()
+        );
+
+        /**
+         * @brief Single-precision overload of `forward`.
+         * 
+         * @param config The kernel configuration to use.
+         * @param weights Row-major weight matrix of `n_in * n_out` values.
+         * @param biases Bias vector of `n_out` values, or `nullptr` for none.
+         * @param input Row-major batch of `batch * n_in` input values.
+         * @param output Row-major batch of `batch * n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples in the batch (default = 1).
+         */
+        static void forward(
+            const KernelConfig& config,
+            const float* weights,
+            const float* biases,
+            const float* input,
+            float* output,
+            size_t n_in,
+            size_t n_out,
+            size_t batch = 1
+        );
+
+        /**
+         * @brief Cache-blocked general matrix multiply, `C = alpha * op(A) * op(B) + beta * C`.
+         * 
+         * `op(A)` is `m x k` and `op(B)` is `k x n`; either operand may be stored
+         * transposed. Blocks of both operands are packed into contiguous buffers so
+         * the inner loop streams unit-stride rows regardless of transposition.
+         * 
+         * @param transpose_a True if `A` is stored as `k x m`.
+         * @param transpose_b True if `B` is stored as `n x k`.
+         * @param m The number of rows of `C`.
+         * @param n The number of columns of `C`.
+         * @param k The inner dimension.
+         * @param alpha Scale applied to the product.
+         * @param a Row-major matrix `A`.
+         * @param lda Row stride of `A`.
+         * @param b Row-major matrix `B`.
+         * @param ldb Row stride of `B`.
+         * @param beta Scale applied to the existing contents of `C` (0 overwrites).
+         * @param c Row-major matrix `C`.
+         * @param ldc Row stride of `C`.
+         */
+        static void gemm(
+            bool transpose_a,
+            bool transpose_b,
+            size_t m,
+            size_t n,
+            size_t k,
+            double alpha,
+            const double* a,
+            size_t lda,
+            const double* b,
+            size_t ldb,
+            double beta,
+            double* c,
+            size_t ldc
+        );
+    };
+}
+
+#endif
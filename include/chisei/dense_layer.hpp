@@ -0,0 +1,169 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file DenseLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the fully connected layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_DENSE_LAYER_HPP
+#define CHISEI_DENSE_LAYER_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class DenseLayer
+     * @brief Fully connected layer computing `y = x * W + b` without an activation.
+     * 
+     * Any non-spatial input shape is flattened. Weights use the same row-major
+     * `n_in x n_out` layout as `NeuralNetwork`, so both run through `DenseKernels`.
+     */
+    class DenseLayer final : public Layer {
+    private:
+        /**
+         * @brief Row-major `n_in x n_out` weight matrix.
+         */
+        std::vector<double> weights;
+
+        /**
+         * @brief Bias vector of `n_out` values.
+         */
+        std::vector<double> biases;
+
+        /**
+         * @brief Accumulated gradient of the weights.
+         */
+        std::vector<double> weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of the biases.
+         */
+        std::vector<double> bias_gradients;
+
+        /**
+         * @brief Scratch buffer for the pre-activation gradient of a fused activation.
+         */
+        std::vector<double> activation_gradients;
+
+        /**
+         * @brief Per-sample indices of the non-zero inputs, `n_in` apart.
+         */
+        std::vector<uint32_t> nonzero_inputs;
+
+        /**
+         * @brief Per-sample number of entries used in `nonzero_inputs`.
+         */
+        std::vector<size_t> nonzero_counts;
+
+        /**
+         * @brief Flags the weight rows with accumulated gradients since the last `update`.
+         */
+        std::vector<uint8_t> touched_rows;
+
+        /**
+         * @brief True if a dense batch may have touched every weight row since the last `update`.
+         */
+        bool all_rows_touched;
+
+    public:
+        /**
+         * @brief Constructs a dense layer with randomly initialized parameters.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param outputs The number of output neurons.
+         */
+        DenseLayer(const TensorShape& _input_shape, size_t outputs);
+
+        /**
+         * @brief Reads a dense layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<DenseLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the row-major weight matrix.
+         * 
+         * @return The weights.
+         */
+        std::vector<double>& get_weights() noexcept;
+
+        /**
+         * @brief Returns the bias vector.
+         * 
+         * @return The biases.
+         */
+        std::vector<double>& get_biases() noexcept;
+    };
+}
+
+#endif
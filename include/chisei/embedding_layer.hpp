@@ -0,0 +1,163 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file EmbeddingLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the token embedding layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_EMBEDDING_LAYER_HPP
+#define CHISEI_EMBEDDING_LAYER_HPP
+
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class EmbeddingLayer
+     * @brief Maps integer token ids to learned dense vectors.
+     * 
+     * Every input value is read as a token id in `[0, vocabulary)`, and the
+     * output holds one row of `dimension` values per token, concatenated in
+     * input order. Only the rows seen in a batch receive gradients, so `update`
+     * costs time proportional to the batch rather than to the vocabulary.
+     */
+    class EmbeddingLayer final : public Layer {
+    private:
+        /**
+         * @brief The number of distinct token ids.
+         */
+        size_t vocabulary;
+
+        /**
+         * @brief The length of each embedding vector.
+         */
+        size_t dimension;
+
+        /**
+         * @brief Row-major `vocabulary x dimension` embedding table.
+         */
+        std::vector<double> table;
+
+        /**
+         * @brief Accumulated gradient of the table, non-zero only in touched rows.
+         */
+        std::vector<double> table_gradients;
+
+        /**
+         * @brief Rows with a pending gradient, in the order they were first touched.
+         */
+        std::vector<size_t> touched_rows;
+
+        /**
+         * @brief Per-row flag marking membership in `touched_rows`.
+         */
+        std::vector<unsigned char> touched;
+
+        /**
+         * @brief Converts an input value to a row index.
+         * 
+         * @param value The input value.
+         * @return The token id.
+         * 
+         * @throws std::out_of_range if the value is not a valid token id.
+         */
+        size_t token(double value) const;
+
+    public:
+        /**
+         * @brief Constructs an embedding layer with randomly initialized vectors.
+         * 
+         * @param _input_shape The shape of one input sample; each value is a token id.
+         * @param _vocabulary The number of distinct token ids.
+         * @param _dimension The length of each embedding vector.
+         * 
+         * @throws std::invalid_argument if the vocabulary or dimension is zero.
+         */
+        EmbeddingLayer(
+            const TensorShape& _input_shape,
+            size_t _vocabulary,
+            size_t _dimension
+        );
+
+        /**
+         * @brief Reads an embedding layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<EmbeddingLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the row-major embedding table.
+         * 
+         * @return The table.
+         */
+        std::vector<double>& get_table() noexcept;
+    };
+}
+
+#endif
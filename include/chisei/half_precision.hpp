@@ -0,0 +1,104 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file HalfPrecision.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for IEEE 754 half-precision conversions.
+ */
+#ifndef CHISEI_HALF_PRECISION_HPP
+#define CHISEI_HALF_PRECISION_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chisei {
+
+    /**
+     * @class HalfPrecision
+     * @brief Converts between float and IEEE 754 binary16 values stored as `uint16_t`.
+     * 
+     * Uses the F16C conversion instructions where the compiler targets them and an
+     * exact software conversion elsewhere. Narrowing rounds to nearest even, keeps
+     * NaNs and infinities, and produces subnormals for tiny values; both
+     * implementations return identical bits.
+     */
+    class HalfPrecision final {
+    public:
+        /**
+         * @brief Narrows one float to half precision.
+         * 
+         * @param value The float value.
+         * @return The nearest half-precision value's bits.
+         */
+        static uint16_t from_float(float value) noexcept;
+
+        /**
+         * @brief Widens one half-precision value to float.
+         * 
+         * The conversion is exact.
+         * 
+         * @param value The half-precision value's bits.
+         * @return The float value.
+         */
+        static float to_float(uint16_t value) noexcept;
+
+        /**
+         * @brief Narrows an array of floats to half precision.
+         * 
+         * @param input The `count` float values.
+         * @param output Destination of `count` half-precision values.
+         * @param count The number of values.
+         */
+        static void from_float(const float* input, uint16_t* output, size_t count) noexcept;
+
+        /**
+         * @brief Widens an array of half-precision values to float.
+         * 
+         * @param input The `count` half-precision values.
+         * @param output Destination of `count` float values.
+         * @param count The number of values.
+         */
+        static void to_float(const uint16_t* input, float* output, size_t count) noexcept;
+
+        /**
+         * @brief Names the implementation compiled in.
+         * 
+         * @return "f16c" or "software".
+         */
+        static const char* implementation() noexcept;
+    };
+}
+
+#endif
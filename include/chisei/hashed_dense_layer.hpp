@@ -0,0 +1,195 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file HashedDenseLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for a dense layer whose weights are shared through a hash (HashedNets).
+ */
+#ifndef CHISEI_HASHED_DENSE_LAYER_HPP
+#define CHISEI_HASHED_DENSE_LAYER_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @class HashedDenseLayer
+     * @brief Fully connected layer whose virtual `n_in x n_out` weight matrix is
+     *        backed by a much smaller array of shared parameters.
+     * 
+     * Virtual weight `(i, j)` is `sign(i, j) * parameters[bucket(i, j)]`, with
+     * both the bucket and the sign taken from one integer hash of `(i, j)`, so
+     * the matrix is never stored: kernels expand it a chunk of a row at a time
+     * with a vectorized hash and gather, amortized over the whole batch, and
+     * gradients are scatter-added back into the shared parameters. Memory
+     * shrinks by `n_in * n_out / buckets` at the cost of hashing per weight.
+     */
+    class HashedDenseLayer final : public Layer {
+    private:
+        /**
+         * @brief Seed mixed into every hash.
+         */
+        uint32_t seed;
+
+        /**
+         * @brief The shared parameters.
+         */
+        std::vector<double> parameters;
+
+        /**
+         * @brief Bias vector of `n_out` values; biases are not shared.
+         */
+        std::vector<double> biases;
+
+        /**
+         * @brief Accumulated gradient of the shared parameters.
+         */
+        std::vector<double> parameter_gradients;
+
+        /**
+         * @brief Accumulated gradient of the biases.
+         */
+        std::vector<double> bias_gradients;
+
+        /**
+         * @brief Bucket (low 31 bits) and sign (top bit) of each weight of the current chunk.
+         */
+        std::vector<uint32_t> chunk_keys;
+
+        /**
+         * @brief Expanded virtual weights of the current chunk.
+         */
+        std::vector<double> chunk_weights;
+
+        /**
+         * @brief Weight gradients of the current chunk, before scattering.
+         */
+        std::vector<double> chunk_gradients;
+
+        /**
+         * @brief Scratch buffer for the pre-activation gradient of a fused activation.
+         */
+        std::vector<double> activation_gradients;
+
+        /**
+         * @brief Hashes one chunk of a virtual weight row into `chunk_keys`.
+         * 
+         * @param row The input index `i`.
+         * @param first The first output index `j` of the chunk.
+         * @param count The chunk length.
+         */
+        void hash_chunk(size_t row, size_t first, size_t count);
+
+        /**
+         * @brief Gathers the signed parameters of `chunk_keys` into `chunk_weights`.
+         * 
+         * @param count The chunk length.
+         */
+        void gather_chunk(size_t count);
+
+    public:
+        /**
+         * @brief Constructs the layer with randomly initialized shared parameters.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param outputs The number of output neurons.
+         * @param buckets The number of shared parameters.
+         * 
+         * @throws std::invalid_argument if `buckets` is zero or exceeds 2^31.
+         */
+        HashedDenseLayer(const TensorShape& _input_shape, size_t outputs, size_t buckets);
+
+        /**
+         * @brief Reads a layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<HashedDenseLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the virtual weight `(i, j)`.
+         * 
+         * @param row The input index `i`.
+         * @param column The output index `j`.
+         * @return The weight.
+         */
+        double weight(size_t row, size_t column) const noexcept;
+
+        /**
+         * @brief Returns how many virtual weights share each parameter on average.
+         * 
+         * @return `n_in * n_out / buckets`.
+         */
+        double compression_ratio() const noexcept;
+    };
+}
+
+#endif
@@ -53,6 +53,22 @@ namespace chisei {
             int epoch
         );
 
+        static void loadMNIST(
+            const std::string& images_file,
+            const std::string& labels_file,
+            std::vector<std::vector<double>>& inputs,
+            std::vector<std::vector<double>>& targets,
+            size_t max_samples = 0
+        );
+
+        static void loadMNISTRaw(
+            const std::string& images_file,
+            const std::string& labels_file,
+            std::vector<std::vector<uint8_t>>& inputs,
+            std::vector<std::vector<double>>& targets,
+            size_t max_samples = 0
+        );
+
     private:
         static uint32_t readUint32(std::ifstream& file);
     };
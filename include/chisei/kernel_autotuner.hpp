@@ -0,0 +1,203 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file KernelAutotuner.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the dense kernel autotuner and its persisted per-machine cache.
+ */
+#ifndef CHISEI_KERNEL_AUTOTUNER_HPP
+#define CHISEI_KERNEL_AUTOTUNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include <chisei/dense_kernels.hpp>
+
+namespace chisei {
+
+    /**
+     * @struct TuningCacheStatistics
+     * @brief Counts how often `KernelAutotuner::lookup` found a tuned configuration.
+     */
+    struct TuningCacheStatistics {
+        /**
+         * @brief Lookups answered from the tuned configurations.
+         */
+        uint64_t hits = 0;
+
+        /**
+         * @brief Lookups that fell back to tuning or to the heuristic default.
+         */
+        uint64_t misses = 0;
+    };
+
+    /**
+     * @class KernelAutotuner
+     * @brief Benchmarks candidate kernel configurations and remembers the fastest one.
+     * 
+     * Results are keyed by layer shape, batch size rounded up to a power of two and
+     * precision, and are persisted to a small text cache file grouped by CPU model.
+     * The cache is read lazily on first lookup, so later runs on the same kind of
+     * host pick the tuned values up automatically. Hosts sharing a home directory
+     * keep separate sections in the same file.
+     * 
+     * The cache file defaults to `$CHISEI_TUNING_CACHE`, then
+     * `$XDG_CACHE_HOME/chisei/kernels.tune`, then `$HOME/.cache/chisei/kernels.tune`.
+     */
+    class KernelAutotuner final {
+    public:
+
+        /**
+         * @brief Returns the kernel configuration to use for the given problem.
+         * 
+         * If no tuned configuration is cached, the problem is benchmarked right away
+         * when tuning on first use is enabled; otherwise a heuristic default is returned.
+         * Answers are memoized per thread until the cache or a setting changes, so
+         * repeated lookups do not take the global lock.
+         * 
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples per call.
+         * @param precision The floating-point precision of the kernel.
+         * @return The kernel configuration.
+         */
+        static KernelConfig lookup(
+            size_t n_in,
+            size_t n_out,
+            size_t batch,
+            KernelPrecision precision
+        );
+
+        /**
+         * @brief Benchmarks all candidate configurations for the given problem.
+         * 
+         * The fastest configuration is stored in the in-memory cache and written
+         * back to the cache file.
+         * 
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples per call.
+         * @param precision The floating-point precision of the kernel.
+         * @return The fastest kernel configuration.
+         */
+        static KernelConfig tune(
+            size_t n_in,
+            size_t n_out,
+            size_t batch,
+            KernelPrecision precision
+        );
+
+        /**
+         * @brief Returns the heuristic configuration used for untuned problems.
+         * 
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples per call.
+         * @return The default kernel configuration.
+         */
+        static KernelConfig default_config(size_t n_in, size_t n_out, size_t batch);
+
+        /**
+         * @brief Enables or disables benchmarking of untuned problems on first lookup.
+         * 
+         * @param enabled True to tune on first use (disabled by default).
+         */
+        static void set_tune_on_first_use(bool enabled);
+
+        /**
+         * @brief Sets the input density below which `lookup` configurations take
+         *        the sparse path for a sample.
+         * 
+         * @param density The threshold in [0, 1]; 0 disables the sparse path
+         *                (default = `KernelConfig::sparse_density`).
+         * 
+         * @throws std::invalid_argument if the density is outside [0, 1].
+         */
+        static void set_sparse_density(double density);
+
+        /**
+         * @brief Overrides the location of the tuning cache file.
+         * 
+         * Any configurations already loaded from the previous file are discarded.
+         * An empty path disables persistence.
+         * 
+         * @param path The path of the cache file.
+         */
+        static void set_cache_file(const std::string& path);
+
+        /**
+         * @brief Returns the path of the tuning cache file currently in use.
+         * 
+         * @return The cache file path, or an empty string if persistence is disabled.
+         */
+        static std::string cache_file();
+
+        /**
+         * @brief Returns the model name of the host CPU, used to key the cache.
+         * 
+         * @return The CPU model string.
+         */
+        static std::string cpu_model();
+
+        /**
+         * @brief Returns the lookup hit and miss counts since the process started.
+         * 
+         * @return The cache statistics.
+         */
+        static TuningCacheStatistics cache_statistics();
+
+    private:
+        /**
+         * @brief Measures the best-of-N running time of one configuration.
+         * 
+         * @param config The configuration to benchmark.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param batch The number of samples per call.
+         * @param precision The floating-point precision of the kernel.
+         * @return The fastest observed time in seconds.
+         */
+        static double benchmark(
+            const KernelConfig& config,
+            size_t n_in,
+            size_t n_out,
+            size_t batch,
+            KernelPrecision precision
+        );
+    };
+}
+
+#endif
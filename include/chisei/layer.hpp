@@ -0,0 +1,349 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file Layer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the abstract layer interface used by `SequentialNetwork`.
+ */
+#ifndef CHISEI_LAYER_HPP
+#define CHISEI_LAYER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <utility>
+#include <vector>
+
+#include <chisei/approximate_activation.hpp>
+
+namespace chisei {
+
+    /**
+     * @struct TensorShape
+     * @brief Shape of the activations flowing between layers, in CHW order.
+     * 
+     * Flat vectors are represented as `{n, 1, 1}`.
+     */
+    struct TensorShape {
+        /**
+         * @brief The number of channels (or features for flat vectors).
+         */
+        size_t channels = 1;
+
+        /**
+         * @brief The height of each channel.
+         */
+        size_t height = 1;
+
+        /**
+         * @brief The width of each channel.
+         */
+        size_t width = 1;
+
+        /**
+         * @brief Returns the total number of values per sample.
+         * 
+         * @return `channels * height * width`.
+         */
+        size_t size() const noexcept {
+            return channels * height * width;
+        }
+
+        /**
+         * @brief Compares two shapes for equality.
+         * 
+         * @param other The shape to compare with.
+         * @return True if all dimensions match.
+         */
+        bool operator==(const TensorShape& other) const noexcept {
+            return channels == other.channels &&
+                height == other.height &&
+                width == other.width;
+        }
+
+        /**
+         * @brief Compares two shapes for inequality.
+         * 
+         * @param other The shape to compare with.
+         * @return True if any dimension differs.
+         */
+        bool operator!=(const TensorShape& other) const noexcept {
+            return !(*this == other);
+        }
+    };
+
+    /**
+     * @enum LayerType
+     * @brief Identifies a layer implementation in saved model files.
+     */
+    enum class LayerType : uint32_t {
+        Dense = 1,
+        Activation = 2,
+        Conv2D = 3,
+        Pool2D = 4,
+        Embedding = 5,
+        BatchNorm = 6,
+        LshDense = 7,
+        MixtureOfExperts = 8,
+        HashedDense = 9,
+        BlockSparseDense = 10
+    };
+
+    /**
+     * @enum ActivationType
+     * @brief Activation functions an `ActivationLayer` can apply.
+     * 
+     * These map to the functions in `ActivationFunctions`; unlike the free-form
+     * `std::function` activations of `NeuralNetwork`, they can be stored in a
+     * model file and restored on load, and fused into the preceding layer.
+     */
+    enum class ActivationType : uint32_t {
+        Sigmoid = 1,
+        ReLU = 2,
+        Tanh = 3
+    };
+
+    /**
+     * @class Layer
+     * @brief Abstract base class of all layers of a `SequentialNetwork`.
+     * 
+     * Layers operate on row-major batches: sample `b` of a batch starts at offset
+     * `b * shape.size()`. A layer's shapes are fixed at construction, so networks
+     * can validate the whole stack as it is built.
+     */
+    class Layer {
+    protected:
+        /**
+         * @brief The shape of one input sample.
+         */
+        TensorShape input_shape;
+
+        /**
+         * @brief The shape of one output sample.
+         */
+        TensorShape output_shape;
+
+        /**
+         * @brief True if the layer applies `fused_activation` to its own outputs.
+         */
+        bool has_fused_activation;
+
+        /**
+         * @brief Activation absorbed from the following layer by `SequentialNetwork::compile`.
+         */
+        ActivationType fused_activation;
+
+        /**
+         * @brief Approximation used in place of `fused_activation`, or `nullptr`.
+         */
+        std::shared_ptr<const ApproximateActivation> fused_approximation;
+
+        /**
+         * @brief Initializes the input and output shapes.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param _output_shape The shape of one output sample.
+         */
+        Layer(const TensorShape& _input_shape, const TensorShape& _output_shape) :
+            input_shape(_input_shape),
+            output_shape(_output_shape),
+            has_fused_activation(false),
+            fused_activation(ActivationType::Sigmoid),
+            fused_approximation() { }
+
+    public:
+        /**
+         * @brief Virtual destructor.
+         */
+        virtual ~Layer() = default;
+
+        /**
+         * @brief Returns the shape of one input sample.
+         * 
+         * @return The input shape.
+         */
+        const TensorShape& get_input_shape() const noexcept {
+            return input_shape;
+        }
+
+        /**
+         * @brief Returns the shape of one output sample.
+         * 
+         * @return The output shape.
+         */
+        const TensorShape& get_output_shape() const noexcept {
+            return output_shape;
+        }
+
+        /**
+         * @brief Checks whether the layer can apply an activation in its own epilogue.
+         * 
+         * @return True if `set_fused_activation` is supported.
+         */
+        virtual bool supports_fused_activation() const noexcept {
+            return false;
+        }
+
+        /**
+         * @brief Makes the layer apply an activation to its outputs.
+         * 
+         * `forward` then produces activated outputs and `backward` expects the
+         * gradient with respect to them. Only valid if `supports_fused_activation`.
+         * 
+         * @param activation The activation to fuse.
+         * @param approximation Approximation evaluated in `forward` instead of the
+         *                      exact activation, or `nullptr` (default = `nullptr`).
+         */
+        void set_fused_activation(
+            ActivationType activation,
+            std::shared_ptr<const ApproximateActivation> approximation = nullptr
+        ) noexcept {
+            has_fused_activation = true;
+            fused_activation = activation;
+            fused_approximation = std::move(approximation);
+        }
+
+        /**
+         * @brief Removes a fused activation.
+         */
+        void clear_fused_activation() noexcept {
+            has_fused_activation = false;
+            fused_approximation.reset();
+        }
+
+        /**
+         * @brief Preallocates all scratch memory needed for batches up to `max_batch`.
+         * 
+         * Called by `SequentialNetwork::compile` so that later `forward` and
+         * `backward` calls do not allocate.
+         * 
+         * @param max_batch The largest batch the layer will be called with.
+         */
+        virtual void prepare(size_t max_batch) {
+            (void) max_batch;
+        }
+
+        /**
+         * @brief Switches between training and inference behaviour.
+         * 
+         * Only layers whose forward pass differs between the two, such as batch
+         * normalization, need to override this. Set by `SequentialNetwork::compile`.
+         * 
+         * @param training True while training.
+         */
+        virtual void set_training(bool training) {
+            (void) training;
+        }
+
+        /**
+         * @brief Returns the type identifier written to model files.
+         * 
+         * @return The layer type.
+         */
+        virtual LayerType type() const noexcept = 0;
+
+        /**
+         * @brief Computes the outputs for a batch of inputs.
+         * 
+         * @param input `batch * input_shape.size()` input values.
+         * @param output `batch * output_shape.size()` output values.
+         * @param batch The number of samples.
+         */
+        virtual void forward(const double* input, double* output, size_t batch) = 0;
+
+        /**
+         * @brief Back-propagates a batch of output gradients.
+         * 
+         * Parameter gradients are accumulated inside the layer until `update` is
+         * called. `input_gradient` may be `nullptr` for the first layer.
+         * 
+         * @param input The inputs passed to `forward`.
+         * @param output The outputs produced by `forward`.
+         * @param output_gradient Gradient of the loss with respect to `output`.
+         * @param input_gradient Receives the gradient with respect to `input`.
+         * @param batch The number of samples.
+         */
+        virtual void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) = 0;
+
+        /**
+         * @brief Applies and clears the accumulated parameter gradients.
+         * 
+         * @param learning_rate The learning rate for gradient descent.
+         */
+        virtual void update(double learning_rate) {
+            (void) learning_rate;
+        }
+
+        /**
+         * @brief Returns the number of trainable parameters.
+         * 
+         * @return The parameter count.
+         */
+        virtual size_t parameter_count() const noexcept {
+            return 0;
+        }
+
+        /**
+         * @brief Returns a copy of the layer's weights, without biases.
+         * 
+         * Meant for inspection, such as weight magnitude statistics; the order
+         * of the values is layer-specific. Pruned connections are included as
+         * zeros.
+         * 
+         * @return The weights; empty for layers without weights.
+         */
+        virtual std::vector<double> weight_values() const {
+            return std::vector<double>();
+        }
+
+        /**
+         * @brief Writes the layer's configuration and parameters.
+         * 
+         * The input shape is not written since it is implied by the previous layer.
+         * 
+         * @param stream The output stream.
+         */
+        virtual void save(std::ostream& stream) const = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,423 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file LshDenseLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for a very wide dense layer that only evaluates neurons
+ *        retrieved by locality-sensitive hashing.
+ */
+#ifndef CHISEI_LSH_DENSE_LAYER_HPP
+#define CHISEI_LSH_DENSE_LAYER_HPP
+
+#include <cstdint>
+#include <future>
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @enum LshFamily
+     * @brief Hash family used to bucket neuron weight vectors.
+     */
+    enum class LshFamily : uint32_t {
+        /**
+         * @brief Signs of sparse random ±1 projections; approximates angular similarity.
+         */
+        SimHash = 1,
+
+        /**
+         * @brief Densified winner-take-all: the index of the largest of a few
+         *        random coordinates; cheap, and suited to non-negative inputs.
+         */
+        DWTA = 2
+    };
+
+    /**
+     * @struct LshOptions
+     * @brief Hashing parameters of an `LshDenseLayer`.
+     */
+    struct LshOptions {
+        /**
+         * @brief The hash family.
+         */
+        LshFamily family = LshFamily::DWTA;
+
+        /**
+         * @brief Number of independent hash tables; more tables retrieve more neurons.
+         */
+        size_t tables = 16;
+
+        /**
+         * @brief Hashes concatenated into one bucket key per table; more hashes
+         *        make buckets smaller and more selective.
+         * 
+         * Each SimHash contributes one bit and each DWTA hash three bits; keys
+         * are limited to 32 bits.
+         */
+        size_t hashes = 4;
+
+        /**
+         * @brief Number of `update` calls between asynchronous table rebuilds;
+         *        0 keeps the tables built at construction.
+         */
+        size_t rebuild_interval = 64;
+
+        /**
+         * @brief Upper bound on the neurons evaluated per sample; 0 for no bound.
+         */
+        size_t max_active = 0;
+
+        /**
+         * @brief Evaluates every neuron when not training, so inference is exact.
+         */
+        bool exact_inference = true;
+    };
+
+    /**
+     * @class LshDenseLayer
+     * @brief Fully connected layer that, per sample, only computes the neurons
+     *        whose weight vectors hash into the same buckets as the input.
+     * 
+     * Intended for layers too wide for dense math, such as output layers over
+     * 100k+ classes. Neurons that are not retrieved output zero and receive no
+     * gradient, except for the target neurons named through `set_targets`,
+     * which are trained as if they had been retrieved. `SequentialNetwork`
+     * names the non-zero target entries when this is its output layer; in
+     * any other position only retrieved neurons are trained. Weights are stored neuron-major, `n_out x n_in`, so every
+     * retrieved neuron is one contiguous dot product.
+     * 
+     * The hash tables are rebuilt on a background thread from a snapshot of
+     * the weights every `LshOptions::rebuild_interval` updates, and swapped in
+     * once ready, so training never waits for a rebuild.
+     */
+    class LshDenseLayer final : public Layer {
+    private:
+        /**
+         * @struct Index
+         * @brief Bucket contents of every table in compressed-row form.
+         */
+        struct Index {
+            /**
+             * @brief Per table, `buckets + 1` offsets into `neurons`.
+             */
+            std::vector<uint32_t> offsets{};
+
+            /**
+             * @brief Neuron ids grouped by table, then bucket.
+             */
+            std::vector<uint32_t> neurons{};
+        };
+
+        /**
+         * @brief The hashing parameters.
+         */
+        LshOptions options;
+
+        /**
+         * @brief Seed of the hash functions, stored so a loaded layer hashes alike.
+         */
+        uint64_t seed;
+
+        /**
+         * @brief Number of bits of each bucket key.
+         */
+        size_t bucket_bits;
+
+        /**
+         * @brief Input coordinates read by each hash, `coordinates_per_hash` per hash.
+         */
+        std::vector<uint32_t> hash_coordinates;
+
+        /**
+         * @brief SimHash projection sign of each entry of `hash_coordinates`.
+         */
+        std::vector<int8_t> hash_signs;
+
+        /**
+         * @brief Number of coordinates each hash reads.
+         */
+        size_t coordinates_per_hash;
+
+        /**
+         * @brief Neuron-major `n_out x n_in` weight matrix.
+         */
+        std::vector<double> weights;
+
+        /**
+         * @brief Bias vector of `n_out` values.
+         */
+        std::vector<double> biases;
+
+        /**
+         * @brief Accumulated gradient of the weights, non-zero only in touched rows.
+         */
+        std::vector<double> weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of the biases.
+         */
+        std::vector<double> bias_gradients;
+
+        /**
+         * @brief Neurons with a pending gradient, in the order they were first touched.
+         */
+        std::vector<uint32_t> touched_neurons;
+
+        /**
+         * @brief Per-neuron flag marking membership in `touched_neurons`.
+         */
+        std::vector<unsigned char> touched;
+
+        /**
+         * @brief The tables queried by `forward`.
+         */
+        Index index;
+
+        /**
+         * @brief Neurons evaluated by the last `forward`, sample after sample.
+         */
+        std::vector<uint32_t> active;
+
+        /**
+         * @brief Per sample, the offset of its neurons in `active`; `batch + 1` entries.
+         */
+        std::vector<size_t> active_offsets;
+
+        /**
+         * @brief Per-neuron stamp used to deduplicate retrieved neurons.
+         */
+        std::vector<uint32_t> stamps;
+
+        /**
+         * @brief The current stamp value.
+         */
+        uint32_t stamp;
+
+        /**
+         * @brief Bucket key of each table for the current sample.
+         */
+        std::vector<uint32_t> keys;
+
+        /**
+         * @brief Pre-activation values of the active neurons of one sample.
+         */
+        std::vector<double> active_values;
+
+        /**
+         * @brief Target neurons of the next `backward`, sample after sample.
+         */
+        std::vector<uint32_t> target_neurons;
+
+        /**
+         * @brief Per sample, the offset of its neurons in `target_neurons`;
+         *        empty when no targets are set.
+         */
+        std::vector<size_t> target_offsets;
+
+        /**
+         * @brief True while training; otherwise `exact_inference` may apply.
+         */
+        bool training;
+
+        /**
+         * @brief Number of `update` calls since the last rebuild was started.
+         */
+        size_t updates_since_rebuild;
+
+        /**
+         * @brief Copy of the weights read by the background rebuild.
+         */
+        std::vector<double> snapshot;
+
+        /**
+         * @brief The running background rebuild, if any.
+         * 
+         * Declared last so that it is destroyed, and thereby joined, before
+         * the state the rebuild reads.
+         */
+        std::future<Index> rebuilding;
+
+        /**
+         * @brief Draws the hash functions from `seed`.
+         */
+        void initialize_hashes();
+
+        /**
+         * @brief Computes the bucket key of every table for one vector.
+         * 
+         * @param vector `n_in` values.
+         * @param out Receives one key per table.
+         */
+        void hash(const double* vector, uint32_t* out) const;
+
+        /**
+         * @brief Returns the current tables, building them on first use.
+         * 
+         * @return The tables.
+         */
+        const Index& current_index();
+
+        /**
+         * @brief Hashes every neuron's weight vector into fresh tables.
+         * 
+         * @param source Neuron-major weights to hash.
+         * @return The tables.
+         */
+        Index build_index(const double* source) const;
+
+        /**
+         * @brief Swaps in a finished background rebuild, if there is one.
+         */
+        void collect_rebuild();
+
+        /**
+         * @brief Computes the pre-activation value of one neuron.
+         * 
+         * @param neuron The neuron id.
+         * @param input `n_in` input values.
+         * @return `w_neuron · input + b_neuron`.
+         */
+        double evaluate(size_t neuron, const double* input) const;
+
+        /**
+         * @brief Records gradients of one neuron for one sample.
+         * 
+         * @param neuron The neuron id.
+         * @param gradient Gradient with respect to the neuron's pre-activation.
+         * @param input `n_in` input values.
+         * @param input_gradient `n_in` values receiving the input gradient, or `nullptr`.
+         */
+        void accumulate(size_t neuron, double gradient, const double* input, double* input_gradient);
+
+    public:
+        /**
+         * @brief Constructs the layer with randomly initialized weights.
+         * 
+         * The hash tables are built on first use.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param outputs The number of output neurons.
+         * @param _options The hashing parameters (default = `LshOptions()`).
+         * 
+         * @throws std::invalid_argument if the options are out of range.
+         */
+        LshDenseLayer(
+            const TensorShape& _input_shape,
+            size_t outputs,
+            const LshOptions& _options = LshOptions()
+        );
+
+        /**
+         * @brief Reads a layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<LshDenseLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        bool supports_fused_activation() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void set_training(bool _training) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        /**
+         * @brief Names the neurons the next `backward` trains even if the
+         *        tables did not retrieve them, usually the label classes.
+         * 
+         * The targets apply to one `backward` call only. Without them the
+         * gradient is limited to the retrieved neurons.
+         * 
+         * @param neurons Target neuron ids, sample after sample.
+         * @param offsets Per sample, the offset of its ids in `neurons`;
+         *        `batch + 1` entries starting at 0.
+         * @param batch The number of samples.
+         * 
+         * @throws std::invalid_argument if a neuron id is out of range.
+         */
+        void set_targets(const uint32_t* neurons, const size_t* offsets, size_t batch);
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Rebuilds the hash tables from the current weights, synchronously.
+         */
+        void rebuild();
+
+        /**
+         * @brief Returns the number of neurons the last `forward` evaluated.
+         * 
+         * @return The active neuron count summed over the batch.
+         */
+        size_t active_count() const noexcept;
+
+        /**
+         * @brief Returns the hashing parameters.
+         * 
+         * @return The options.
+         */
+        const LshOptions& get_options() const noexcept;
+    };
+}
+
+#endif
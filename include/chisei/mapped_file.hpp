@@ -0,0 +1,116 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file MappedFile.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for read-only file mappings used when loading models.
+ */
+#ifndef CHISEI_MAPPED_FILE_HPP
+#define CHISEI_MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace chisei {
+
+    /**
+     * @class MappedFile
+     * @brief Read-only view of a whole file, memory-mapped where the platform allows it.
+     * 
+     * On POSIX systems the file is mapped with `mmap`, so only the pages that are
+     * actually touched get read from disk. Elsewhere, or when mapping is not
+     * requested, the file is read into an owned buffer instead.
+     */
+    class MappedFile final {
+    private:
+        /**
+         * @brief Start of the mapping, or `nullptr` if the file was read into `buffer`.
+         */
+        void* mapping;
+
+        /**
+         * @brief Size of the file in bytes.
+         */
+        size_t length;
+
+        /**
+         * @brief Owned file contents when the file is not memory-mapped.
+         */
+        std::vector<char> buffer;
+
+    public:
+        /**
+         * @brief Opens and maps (or reads) the given file.
+         * 
+         * @param filename The file to open.
+         * @param use_mmap True to memory-map the file if supported.
+         * 
+         * @throws ModelLoaderException if the file cannot be opened or read.
+         */
+        MappedFile(const std::string& filename, bool use_mmap = true);
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Unmaps the file.
+         */
+        ~MappedFile();
+
+        /**
+         * @brief Returns a pointer to the first byte of the file.
+         * 
+         * @return The file contents.
+         */
+        const char* data() const noexcept;
+
+        /**
+         * @brief Returns the size of the file in bytes.
+         * 
+         * @return The file size.
+         */
+        size_t size() const noexcept;
+
+        /**
+         * @brief Checks whether the contents are backed by a memory mapping.
+         * 
+         * @return True if the file is memory-mapped.
+         */
+        bool is_mapped() const noexcept;
+    };
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file MatrixView.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for a non-owning strided view of a row-major matrix.
+ */
+#ifndef CHISEI_MATRIX_VIEW_HPP
+#define CHISEI_MATRIX_VIEW_HPP
+
+#include <cstddef>
+
+namespace chisei {
+
+    /**
+     * @struct MatrixView
+     * @brief A read-only view of `rows * cols` values laid out row by row in
+     *        caller-owned memory.
+     * 
+     * Consecutive rows start `stride` elements apart, so views can describe
+     * padded rows or a subset of columns of a wider matrix, such as a NumPy
+     * or Eigen row-major buffer, without copying it. The memory must outlive
+     * every use of the view.
+     * 
+     * @tparam T The element type, `float` or `double`.
+     */
+    template<typename T>
+    struct MatrixView {
+        /**
+         * @brief Pointer to the first element of the first row.
+         */
+        const T* data = nullptr;
+
+        /**
+         * @brief Number of rows (samples).
+         */
+        size_t rows = 0;
+
+        /**
+         * @brief Number of columns (values per sample).
+         */
+        size_t cols = 0;
+
+        /**
+         * @brief Distance in elements between the starts of consecutive rows.
+         */
+        size_t stride = 0;
+
+        /**
+         * @brief Constructs an empty view.
+         */
+        constexpr MatrixView() noexcept = default;
+
+        /**
+         * @brief Constructs a view of strided rows.
+         * 
+         * @param _data Pointer to the first element of the first row.
+         * @param _rows The number of rows.
+         * @param _cols The number of columns.
+         * @param _stride The distance between row starts; 0 means `_cols`
+         *                (default = 0).
+         */
+        constexpr MatrixView(const T* _data, size_t _rows, size_t _cols, size_t _stride = 0) noexcept :
+            data(_data),
+            rows(_rows),
+            cols(_cols),
+            stride(_stride == 0 ? _cols : _stride) { }
+
+        /**
+         * @brief Returns a pointer to the first element of a row.
+         * 
+         * @param row The row index.
+         * @return Pointer to `cols` consecutive values.
+         */
+        constexpr const T* row(size_t row) const noexcept {
+            return this->data + row * this->stride;
+        }
+
+        /**
+         * @brief Returns one element.
+         * 
+         * @param row The row index.
+         * @param col The column index.
+         * @return The element.
+         */
+        constexpr T operator()(size_t row, size_t col) const noexcept {
+            return this->data[row * this->stride + col];
+        }
+
+        /**
+         * @brief Checks whether rows follow each other without padding.
+         * 
+         * @return True if `stride == cols`.
+         */
+        constexpr bool is_contiguous() const noexcept {
+            return this->stride == this->cols;
+        }
+    };
+}
+
+#endif
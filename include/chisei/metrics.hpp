@@ -0,0 +1,277 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file Metrics.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the counters collected while training and serving models.
+ */
+#ifndef CHISEI_METRICS_HPP
+#define CHISEI_METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+
+namespace chisei {
+
+    /**
+     * @struct HistogramSnapshot
+     * @brief Point-in-time copy of a histogram with fixed bucket bounds.
+     * 
+     * @tparam Buckets The number of finite bucket bounds.
+     */
+    template<size_t Buckets>
+    struct HistogramSnapshot {
+        /**
+         * @brief Upper bound of every finite bucket, in ascending order.
+         */
+        std::array<double, Buckets> bounds{};
+
+        /**
+         * @brief Observations per finite bucket (not cumulative).
+         */
+        std::array<uint64_t, Buckets> counts{};
+
+        /**
+         * @brief Number of observations, including those above the last bound.
+         */
+        uint64_t count = 0;
+
+        /**
+         * @brief Sum of all observations.
+         */
+        double sum = 0.0;
+    };
+
+    /**
+     * @struct MetricsSnapshot
+     * @brief Point-in-time copy of every counter in a `Metrics` collector.
+     */
+    struct MetricsSnapshot {
+        /**
+         * @brief Prediction latency per call in seconds, whatever the batch size.
+         */
+        HistogramSnapshot<14> predict_latency{};
+
+        /**
+         * @brief Number of samples per prediction call.
+         */
+        HistogramSnapshot<11> predict_batch_size{};
+
+        /**
+         * @brief Number of samples predicted.
+         */
+        uint64_t predicted_samples = 0;
+
+        /**
+         * @brief Number of completed training epochs (or L-BFGS iterations).
+         */
+        uint64_t epochs = 0;
+
+        /**
+         * @brief Number of samples trained on.
+         */
+        uint64_t trained_samples = 0;
+
+        /**
+         * @brief Training throughput of the last epoch, in samples per second.
+         */
+        double train_samples_per_second = 0.0;
+
+        /**
+         * @brief Mean squared error over the samples of the last epoch.
+         */
+        double epoch_loss = 0.0;
+
+        /**
+         * @brief Bytes of weights and biases of the networks reporting here.
+         */
+        uint64_t parameter_bytes = 0;
+
+        /**
+         * @brief Bytes currently allocated through a `MetricsMemoryResource`.
+         */
+        uint64_t allocated_bytes = 0;
+
+        /**
+         * @brief Most bytes ever allocated at once through a `MetricsMemoryResource`.
+         */
+        uint64_t peak_allocated_bytes = 0;
+    };
+
+    /**
+     * @class Metrics
+     * @brief Thread-safe counters that networks report predictions and training into.
+     * 
+     * Attach one collector to any number of networks with
+     * `NeuralNetwork::set_metrics`; every update is a few relaxed atomic
+     * operations, so collection can stay on in production. `MetricsExporter`
+     * publishes the counters in OpenMetrics text format.
+     */
+    class Metrics final {
+    private:
+        template<size_t Buckets>
+        struct Histogram {
+            std::array<std::atomic<uint64_t>, Buckets> counts{};
+            std::atomic<uint64_t> count{0};
+            std::atomic<uint64_t> sum{0};
+        };
+
+        /**
+         * @brief Latency buckets; the sum is kept in nanoseconds.
+         */
+        Histogram<14> latency;
+
+        /**
+         * @brief Batch size buckets; the sum is kept in samples.
+         */
+        Histogram<11> batch_size;
+
+        std::atomic<uint64_t> epochs;
+        std::atomic<uint64_t> trained_samples;
+        std::atomic<double> samples_per_second;
+        std::atomic<double> epoch_loss;
+        std::atomic<uint64_t> parameter_bytes;
+        std::atomic<uint64_t> allocated_bytes;
+        std::atomic<uint64_t> peak_allocated_bytes;
+
+    public:
+        /**
+         * @brief Upper bounds of the prediction latency buckets, in seconds.
+         */
+        static constexpr std::array<double, 14> latency_bounds = {{
+            1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5, 1e-4,
+            2.5e-4, 5e-4, 1e-3, 2.5e-3, 5e-3, 1e-2, 1e-1
+        }};
+
+        /**
+         * @brief Upper bounds of the batch size buckets, in samples.
+         */
+        static constexpr std::array<double, 11> batch_size_bounds = {{
+            1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024
+        }};
+
+        Metrics();
+
+        Metrics(const Metrics&) = delete;
+        Metrics& operator=(const Metrics&) = delete;
+
+        /**
+         * @brief Records one prediction call.
+         * 
+         * @param samples The number of samples predicted by the call.
+         * @param seconds The wall-clock duration of the call.
+         */
+        void record_prediction(size_t samples, double seconds) noexcept;
+
+        /**
+         * @brief Records one completed training epoch.
+         * 
+         * @param samples The number of samples trained on during the epoch.
+         * @param seconds The wall-clock duration of the epoch.
+         * @param loss The mean squared error over those samples.
+         */
+        void record_epoch(size_t samples, double seconds, double loss) noexcept;
+
+        /**
+         * @brief Sets the parameter footprint reported for the attached networks.
+         * 
+         * @param bytes The number of bytes of weights and biases.
+         */
+        void set_parameter_bytes(size_t bytes) noexcept;
+
+        /**
+         * @brief Records memory allocated or released through a tracking resource.
+         * 
+         * @param bytes The number of bytes.
+         * @param allocated True for an allocation, false for a release.
+         */
+        void record_allocation(size_t bytes, bool allocated) noexcept;
+
+        /**
+         * @brief Clears every counter.
+         */
+        void reset() noexcept;
+
+        /**
+         * @brief Copies the current value of every counter.
+         * 
+         * Counters are read one by one, so a snapshot taken during updates can mix
+         * values from before and after a single record call.
+         * 
+         * @return The snapshot.
+         */
+        MetricsSnapshot snapshot() const noexcept;
+    };
+
+    /**
+     * @class MetricsMemoryResource
+     * @brief Memory resource that forwards to another and reports its usage to `Metrics`.
+     * 
+     * Pass it to `NeuralNetwork` (or `ModelLoadOptions`) to export the bytes the
+     * network holds for parameters and workspaces. The resource must outlive
+     * every network allocating from it.
+     */
+    class MetricsMemoryResource final : public std::pmr::memory_resource {
+    private:
+        std::shared_ptr<Metrics> metrics;
+        std::pmr::memory_resource* upstream;
+
+    public:
+        /**
+         * @brief Creates a tracking resource.
+         * 
+         * @param _metrics The collector to report allocations to.
+         * @param _upstream The resource that performs the allocations.
+         */
+        MetricsMemoryResource(
+            std::shared_ptr<Metrics> _metrics,
+            std::pmr::memory_resource* _upstream = std::pmr::get_default_resource()
+        );
+
+        MetricsMemoryResource(const MetricsMemoryResource&) = delete;
+        MetricsMemoryResource& operator=(const MetricsMemoryResource&) = delete;
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+}
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file MetricsExporter.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for publishing `Metrics` in OpenMetrics text format.
+ */
+#ifndef CHISEI_METRICS_EXPORTER_HPP
+#define CHISEI_METRICS_EXPORTER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <chisei/metrics.hpp>
+
+namespace chisei {
+
+    /**
+     * @class MetricsExporter
+     * @brief Publishes a `Metrics` collector in OpenMetrics (Prometheus) text format.
+     * 
+     * The exposition can be rendered on demand, written to a file periodically
+     * for a node exporter's textfile collector, or served to scrapers from a
+     * local HTTP endpoint. Both background modes run on one worker thread that
+     * the destructor stops. Kernel autotuner cache hits and misses are exported
+     * alongside the collector's own counters.
+     */
+    class MetricsExporter final {
+    private:
+        std::shared_ptr<const Metrics> metrics;
+        std::thread worker;
+        std::mutex mutex;
+        std::condition_variable wake;
+        bool stopping;
+        int listener;
+        std::atomic<uint16_t> bound_port;
+
+        void serve();
+
+    public:
+        /**
+         * @brief Creates an exporter for the given collector.
+         * 
+         * @param _metrics The collector to publish.
+         * @throws std::invalid_argument if `_metrics` is null.
+         */
+        explicit MetricsExporter(std::shared_ptr<const Metrics> _metrics);
+
+        MetricsExporter(const MetricsExporter&) = delete;
+        MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+        /**
+         * @brief Stops any background export.
+         */
+        ~MetricsExporter();
+
+        /**
+         * @brief Renders the current counters, terminated by `# EOF`.
+         * 
+         * @return The OpenMetrics text exposition.
+         */
+        std::string render() const;
+
+        /**
+         * @brief Writes the exposition to a file, replacing it atomically.
+         * 
+         * The text is written to `path` + ".tmp" and renamed over `path`, so
+         * readers never see a partial file.
+         * 
+         * @param path The file to write.
+         * @throws std::runtime_error if the file cannot be written.
+         */
+        void write_file(const std::string& path) const;
+
+        /**
+         * @brief Rewrites the file every `interval` on a background thread.
+         * 
+         * A failed write is retried at the next interval.
+         * 
+         * @param path The file to write.
+         * @param interval The time between writes.
+         * @throws std::logic_error if a background export is already running.
+         */
+        void start_file(const std::string& path, std::chrono::milliseconds interval);
+
+        /**
+         * @brief Serves the exposition over HTTP on a background thread.
+         * 
+         * Answers `GET /metrics` (and `GET /`) with the current counters. Only
+         * POSIX systems are supported.
+         * 
+         * @param port The TCP port to listen on; 0 picks a free one.
+         * @param address The IPv4 address to bind (default = loopback only).
+         * 
+         * @throws std::logic_error if a background export is already running.
+         * @throws std::runtime_error if the socket cannot be bound, or HTTP is
+         *         not supported on this platform.
+         */
+        void start_http(uint16_t port, const std::string& address = "127.0.0.1");
+
+        /**
+         * @brief Returns the port the HTTP endpoint listens on.
+         * 
+         * @return The bound port, or 0 if no endpoint is running.
+         */
+        uint16_t port() const noexcept;
+
+        /**
+         * @brief Stops the background export and waits for the worker thread.
+         */
+        void stop();
+    };
+}
+
+#endif
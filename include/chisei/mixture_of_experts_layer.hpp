@@ -0,0 +1,322 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file MixtureOfExpertsLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for a mixture-of-experts dense layer with top-k routing.
+ */
+#ifndef CHISEI_MIXTURE_OF_EXPERTS_LAYER_HPP
+#define CHISEI_MIXTURE_OF_EXPERTS_LAYER_HPP
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <vector>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @struct ExpertStatistics
+     * @brief Routing statistics of a `MixtureOfExpertsLayer`, accumulated over
+     *        every `forward` since the last reset.
+     */
+    struct ExpertStatistics {
+        /**
+         * @brief Number of samples routed to each expert.
+         */
+        std::vector<uint64_t> assignments{};
+
+        /**
+         * @brief Sum of each expert's gate probability over all samples.
+         */
+        std::vector<double> gate_mass{};
+
+        /**
+         * @brief Number of samples seen.
+         */
+        uint64_t samples = 0;
+
+        /**
+         * @brief Ratio of the busiest expert's assignments to the mean; 1 is perfectly balanced.
+         * 
+         * @return The imbalance, or 0 before any sample was routed.
+         */
+        double imbalance() const noexcept {
+            uint64_t total = 0, busiest = 0;
+            for(uint64_t count : assignments) {
+                total += count;
+                busiest = count > busiest ? count : busiest;
+            }
+
+            return total == 0 ? 0.0 : static_cast<double>(busiest) *
+                static_cast<double>(assignments.size()) / static_cast<double>(total);
+        }
+    };
+
+    /**
+     * @class MixtureOfExpertsLayer
+     * @brief Dense layer split into `E` experts, of which a gate picks `k` per sample.
+     * 
+     * A linear gate scores the experts with a softmax; each sample is sent to
+     * its `k` best experts, and its output is their outputs weighted by the
+     * gate probabilities renormalized over the chosen `k`. Samples are grouped
+     * by expert so each expert runs one batched kernel over just its samples,
+     * which keeps the cost per sample near that of `k` dense layers while the
+     * parameter count grows with `E`.
+     * 
+     * To keep the experts evenly used, training adds the auxiliary balancing
+     * loss `balance_weight * E * sum_e f_e * P_e` (`f_e` the fraction of routes
+     * to expert `e`, `P_e` its mean gate probability) to the gate gradient.
+     */
+    class MixtureOfExpertsLayer final : public Layer {
+    private:
+        /**
+         * @brief The number of experts.
+         */
+        size_t experts;
+
+        /**
+         * @brief The number of experts each sample is routed to.
+         */
+        size_t top_k;
+
+        /**
+         * @brief Weight of the auxiliary load-balancing loss.
+         */
+        double balance_weight;
+
+        /**
+         * @brief Row-major `n_in x experts` gate weights.
+         */
+        std::vector<double> gate_weights;
+
+        /**
+         * @brief Gate biases, one per expert.
+         */
+        std::vector<double> gate_biases;
+
+        /**
+         * @brief Expert weights, one row-major `n_in x n_out` matrix per expert.
+         */
+        std::vector<double> expert_weights;
+
+        /**
+         * @brief Expert biases, `n_out` per expert.
+         */
+        std::vector<double> expert_biases;
+
+        /**
+         * @brief Accumulated gradient of `gate_weights`.
+         */
+        std::vector<double> gate_weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of `gate_biases`.
+         */
+        std::vector<double> gate_bias_gradients;
+
+        /**
+         * @brief Accumulated gradient of `expert_weights`.
+         */
+        std::vector<double> expert_weight_gradients;
+
+        /**
+         * @brief Accumulated gradient of `expert_biases`.
+         */
+        std::vector<double> expert_bias_gradients;
+
+        /**
+         * @brief Per-expert flag marking pending gradients.
+         */
+        std::vector<unsigned char> expert_touched;
+
+        /**
+         * @brief Gate probabilities of the last batch, `batch x experts`.
+         */
+        std::vector<double> probabilities;
+
+        /**
+         * @brief Per sample and slot, the position of the route in expert order.
+         */
+        std::vector<size_t> route_positions;
+
+        /**
+         * @brief Per expert, the offset of its routes; `experts + 1` entries.
+         */
+        std::vector<size_t> expert_offsets;
+
+        /**
+         * @brief Per expert, the next free route position while grouping.
+         */
+        std::vector<size_t> expert_cursors;
+
+        /**
+         * @brief Expert chosen for each sample and slot, in sample order.
+         */
+        std::vector<size_t> slot_experts;
+
+        /**
+         * @brief Renormalized gate weight of each sample and slot, in sample order.
+         */
+        std::vector<double> slot_gates;
+
+        /**
+         * @brief Sample of each route, in expert order.
+         */
+        std::vector<size_t> routed_samples;
+
+        /**
+         * @brief Expert of each route, in expert order.
+         */
+        std::vector<size_t> routed_experts;
+
+        /**
+         * @brief Renormalized gate weight of each route, in expert order.
+         */
+        std::vector<double> routed_gates;
+
+        /**
+         * @brief Inputs gathered per route, in expert order.
+         */
+        std::vector<double> routed_inputs;
+
+        /**
+         * @brief Expert outputs per route, before gate weighting.
+         */
+        std::vector<double> routed_outputs;
+
+        /**
+         * @brief Scratch for gradients per route.
+         */
+        std::vector<double> routed_gradients;
+
+        /**
+         * @brief Scratch for input gradients per route.
+         */
+        std::vector<double> routed_input_gradients;
+
+        /**
+         * @brief Scratch for gate logit gradients, `batch x experts`.
+         */
+        std::vector<double> gate_gradients;
+
+        /**
+         * @brief Gradient with respect to each route's gate weight, in expert order.
+         */
+        std::vector<double> gate_output_gradients;
+
+        /**
+         * @brief Per-expert gradient of the balancing loss with respect to the gate probabilities.
+         */
+        std::vector<double> balance_gradients;
+
+        /**
+         * @brief Routing statistics since the last reset.
+         */
+        ExpertStatistics statistics;
+
+    public:
+        /**
+         * @brief Constructs the layer with randomly initialized experts and gate.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param outputs The number of output neurons.
+         * @param _experts The number of experts.
+         * @param _top_k The number of experts per sample (default = 2).
+         * @param _balance_weight Weight of the load-balancing loss (default = 0.01).
+         * 
+         * @throws std::invalid_argument if `_top_k` is zero or exceeds `_experts`.
+         */
+        MixtureOfExpertsLayer(
+            const TensorShape& _input_shape,
+            size_t outputs,
+            size_t _experts,
+            size_t _top_k = 2,
+            double _balance_weight = 0.01
+        );
+
+        /**
+         * @brief Reads a layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<MixtureOfExpertsLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        void prepare(size_t max_batch) override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void update(double learning_rate) override;
+
+        size_t parameter_count() const noexcept override;
+
+        std::vector<double> weight_values() const override;
+
+        void save(std::ostream& stream) const override;
+
+        /**
+         * @brief Returns the routing statistics accumulated since the last reset.
+         * 
+         * @return The statistics.
+         */
+        const ExpertStatistics& get_statistics() const noexcept;
+
+        /**
+         * @brief Clears the routing statistics.
+         */
+        void reset_statistics();
+    };
+}
+
+#endif
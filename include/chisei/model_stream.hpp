@@ -0,0 +1,233 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file ModelStream.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Helpers for reading and writing binary model data with truncation checks.
+ */
+#ifndef CHISEI_MODEL_STREAM_HPP
+#define CHISEI_MODEL_STREAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <chisei/crc32c.hpp>
+#include <chisei/model_loader_exception.hpp>
+
+namespace chisei {
+
+    /**
+     * @class ModelStream
+     * @brief Static helpers for the binary layout of layered model files.
+     * 
+     * Sizes are always written as 64-bit values so files are portable between
+     * 32-bit and 64-bit hosts. Every read is checked and a truncated stream
+     * raises a `ModelLoaderException`. Whole files end in the same tagged
+     * CRC32C section that `NeuralNetwork` model files use.
+     */
+    class ModelStream final {
+    public:
+
+        /**
+         * @brief The largest number of values a loaded layer may hold in one array.
+         * 
+         * 2^34, or less where `size_t` cannot address that many `double` values,
+         * so that sizes checked against it never wrap on 32-bit hosts.
+         */
+        static constexpr uint64_t max_elements =
+            std::numeric_limits<size_t>::max() / sizeof(double) < (uint64_t(1) << 34) ?
+                std::numeric_limits<size_t>::max() / sizeof(double) : uint64_t(1) << 34;
+
+        /**
+         * @brief Writes one trivially copyable value.
+         * 
+         * @param stream The output stream.
+         * @param value The value to write.
+         */
+        template<typename T>
+        static void write(std::ostream& stream, const T& value) {
+            stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        /**
+         * @brief Reads one trivially copyable value.
+         * 
+         * @param stream The input stream.
+         * @return The value read.
+         * 
+         * @throws ModelLoaderException if the stream ends early.
+         */
+        template<typename T>
+        static T read(std::istream& stream) {
+            T value;
+            stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+
+            if(!stream)
+                throw ModelLoaderException("Truncated *.chisei file.");
+            return value;
+        }
+
+        /**
+         * @brief Writes a size as a 64-bit value.
+         * 
+         * @param stream The output stream.
+         * @param size The size to write.
+         */
+        static void write_size(std::ostream& stream, size_t size) {
+            write(stream, static_cast<uint64_t>(size));
+        }
+
+        /**
+         * @brief Reads a size written by `write_size`.
+         * 
+         * @param stream The input stream.
+         * @return The size read.
+         * 
+         * @throws ModelLoaderException if the stream ends early, or if the
+         *         size does not fit in `size_t`.
+         */
+        static size_t read_size(std::istream& stream) {
+            const uint64_t size = read<uint64_t>(stream);
+            if(size > static_cast<uint64_t>(std::numeric_limits<size_t>::max()))
+                throw ModelLoaderException("Invalid *.chisei file format, size out of range.");
+
+            return static_cast<size_t>(size);
+        }
+
+        /**
+         * @brief Writes the contents of a vector, without its length.
+         * 
+         * @param stream The output stream.
+         * @param values The values to write.
+         */
+        template<typename T>
+        static void write_array(std::ostream& stream, const std::vector<T>& values) {
+            stream.write(
+                reinterpret_cast<const char*>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(T))
+            );
+        }
+
+        /**
+         * @brief Fills a pre-sized vector from the stream.
+         * 
+         * @param stream The input stream.
+         * @param values The vector to fill; its size determines how much is read.
+         * 
+         * @throws ModelLoaderException if the stream ends early.
+         */
+        template<typename T>
+        static void read_array(std::istream& stream, std::vector<T>& values) {
+            stream.read(
+                reinterpret_cast<char*>(values.data()),
+                static_cast<std::streamsize>(values.size() * sizeof(T))
+            );
+
+            if(!stream)
+                throw ModelLoaderException("Truncated *.chisei file.");
+        }
+
+        /**
+         * @brief Tag of a section holding the CRC32C of the bytes it covers.
+         */
+        static constexpr char checksum_tag[4] = {'C', 'R', 'C', 'C'};
+
+        /**
+         * @brief Writes a checksum section: the tag, a 64-bit payload size and the checksum.
+         * 
+         * @param stream The output stream.
+         * @param checksum The CRC32C of the covered bytes.
+         */
+        static void write_checksum(std::ostream& stream, uint32_t checksum) {
+            stream.write(checksum_tag, sizeof(checksum_tag));
+            write(stream, static_cast<uint64_t>(sizeof(checksum)));
+            write(stream, checksum);
+        }
+
+        /**
+         * @brief Writes a file body followed by a checksum section covering it.
+         * 
+         * @param stream The output stream.
+         * @param body The serialized model.
+         */
+        static void write_checksummed(std::ostream& stream, const std::string& body) {
+            stream.write(body.data(), static_cast<std::streamsize>(body.size()));
+            write_checksum(stream, CRC32C::compute(body.data(), body.size()));
+        }
+
+        /**
+         * @brief Reads the rest of a stream and verifies its trailing checksum section.
+         * 
+         * Files written before checksums were added have no such section and
+         * are returned as they are.
+         * 
+         * @param stream The input stream.
+         * @return The bytes covered by the checksum.
+         * 
+         * @throws ModelLoaderException if the checksum does not match.
+         */
+        static std::string read_checksummed(std::istream& stream) {
+            std::string data{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+
+            const size_t section = sizeof(checksum_tag) + sizeof(uint64_t) + sizeof(uint32_t);
+            if(data.size() < section ||
+                std::memcmp(data.data() + data.size() - section, checksum_tag, sizeof(checksum_tag)) != 0)
+                return data;
+
+            uint64_t payload_size = 0;
+            uint32_t checksum = 0;
+            std::memcpy(&payload_size, data.data() + data.size() - section + sizeof(checksum_tag), sizeof(payload_size));
+            std::memcpy(&checksum, data.data() + data.size() - sizeof(checksum), sizeof(checksum));
+
+            if(payload_size != sizeof(checksum))
+                throw ModelLoaderException("Invalid *.chisei file format, bad checksum.");
+
+            data.resize(data.size() - section);
+            if(CRC32C::compute(data.data(), data.size()) != checksum)
+                throw ModelLoaderException("Corrupted *.chisei file, checksum mismatch.");
+
+            return data;
+        }
+    };
+}
+
+#endif
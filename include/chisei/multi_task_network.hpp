@@ -0,0 +1,230 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file MultiTaskNetwork.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the MultiTaskNetwork class, several task heads sharing one trunk.
+ */
+#ifndef CHISEI_MULTI_TASK_NETWORK_HPP
+#define CHISEI_MULTI_TASK_NETWORK_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <chisei/sequential_network.hpp>
+
+namespace chisei {
+
+    /**
+     * @class MultiTaskNetwork
+     * @brief Several related tasks learned on top of one shared trunk.
+     * 
+     * The trunk runs once per sample or batch and feeds every task head, so K
+     * tasks cost one trunk and K heads instead of K full networks. Training
+     * sums the gradients of all heads into the trunk output and runs a single
+     * backward pass through the trunk. The trunk and the heads are ordinary
+     * `SequentialNetwork`s, so any layer type can be used in either.
+     * 
+     * @code
+     * chisei::MultiTaskNetwork network({1, 1, 64});
+     * network.get_trunk().add<chisei::DenseLayer>(32);
+     * network.get_trunk().add<chisei::ActivationLayer>(chisei::ActivationType::ReLU);
+     * 
+     * chisei::SequentialNetwork& digit = network.add_task();
+     * digit.add<chisei::DenseLayer>(10);
+     * digit.add<chisei::ActivationLayer>(chisei::ActivationType::Sigmoid);
+     * @endcode
+     */
+    class MultiTaskNetwork final {
+    private:
+        /**
+         * @brief The shared layers every task head is fed by.
+         */
+        SequentialNetwork trunk;
+
+        /**
+         * @brief One head per task, in task order.
+         */
+        std::vector<std::unique_ptr<SequentialNetwork>> heads;
+
+        /**
+         * @brief Scratch batch of inputs fed to the trunk.
+         */
+        std::vector<double> batch_input;
+
+        /**
+         * @brief Scratch gradient of one head with respect to the trunk output.
+         */
+        std::vector<double> head_gradient;
+
+        /**
+         * @brief Compiles the trunk and every head for the given batch and mode.
+         * 
+         * @param batch The number of samples per call.
+         * @param mode The mode the plans are needed for.
+         * @throws std::invalid_argument if the trunk or a head has no layers, or
+         *         a head's input shape differs from the trunk's output shape.
+         */
+        void prepare(size_t batch, CompileMode mode);
+
+    public:
+        /**
+         * @brief Constructs a network with an empty trunk and no tasks.
+         * 
+         * @param _input_shape The shape of one input sample.
+         */
+        explicit MultiTaskNetwork(const TensorShape& _input_shape);
+
+        /**
+         * @brief Returns the shared trunk, to add layers to it.
+         * 
+         * @return A reference to the trunk.
+         */
+        SequentialNetwork& get_trunk() noexcept;
+
+        /**
+         * @brief Appends an empty task head fed by the current trunk output.
+         * 
+         * The trunk should be complete before heads are added, since every head
+         * must take the trunk's final output shape.
+         * 
+         * @return A reference to the new head, to add layers to it.
+         */
+        SequentialNetwork& add_task();
+
+        /**
+         * @brief Returns the head of a task.
+         * 
+         * @param task The task index.
+         * @return A reference to the head.
+         * @throws std::out_of_range if the task index is out of range.
+         */
+        SequentialNetwork& get_task(size_t task);
+
+        /**
+         * @brief Returns the number of tasks.
+         * 
+         * @return The task count.
+         */
+        size_t task_count() const noexcept;
+
+        /**
+         * @brief Returns the total number of trainable parameters.
+         * 
+         * @return The parameter count of the trunk and every head.
+         */
+        size_t parameter_count() const noexcept;
+
+        /**
+         * @brief Predicts the output of every task for one input.
+         * 
+         * @param input The flattened CHW input vector.
+         * @return One output vector per task.
+         */
+        std::vector<std::vector<double>> predict(const std::vector<double>& input);
+
+        /**
+         * @brief Predicts the output of every task for a set of inputs.
+         * 
+         * @param inputs The input data.
+         * @param batch_size The number of samples run through the trunk at once
+         *                   (default = 32).
+         * @return The outputs indexed by task, then by sample.
+         */
+        std::vector<std::vector<std::vector<double>>> predict_batch(
+            const std::vector<std::vector<double>>& inputs,
+            size_t batch_size = 32
+        );
+
+        /**
+         * @brief Trains every task with mini-batch gradient descent on the summed MSE loss.
+         * 
+         * @param inputs The training input data.
+         * @param targets The expected outputs indexed by task, then by sample.
+         * @param learning_rate The learning rate for gradient descent (default = 0.1).
+         * @param epochs The number of training iterations (default = 10).
+         * @param batch_size The number of samples per update (default = 1).
+         * @throws std::invalid_argument if there is not one target per task and sample.
+         */
+        void train(
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<std::vector<double>>>& targets,
+            double learning_rate = 0.1,
+            int epochs = 10,
+            size_t batch_size = 1
+        );
+
+        /**
+         * @brief Computes the accuracy of one task on a dataset.
+         * 
+         * @param task The task index.
+         * @param inputs The input data.
+         * @param targets The expected outputs of the task.
+         * @return The accuracy as a fraction (0.0 to 1.0).
+         * @throws std::out_of_range if the task index is out of range.
+         */
+        double compute_accuracy(
+            size_t task,
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<double>>& targets
+        );
+
+        /**
+         * @brief Saves the trunk and every head to a file.
+         * 
+         * The file holds the `MT` magic bytes, the trunk and the heads, each in
+         * the `CL` layout of `SequentialNetwork`.
+         * 
+         * @param filename The name of the file to save the model to.
+         * @param fold_batch_norm If true, foldable batch normalization layers are
+         *                        saved merged into their dense or convolution
+         *                        layers (default = true).
+         * @throws ModelLoaderException if the file cannot be written.
+         */
+        void save_model(const std::string& filename, bool fold_batch_norm = true) const;
+
+        /**
+         * @brief Loads a network saved by `save_model`.
+         * 
+         * @param filename The name of the file to load the model from.
+         * @return The loaded network.
+         * @throws ModelLoaderException if the file cannot be read or is malformed.
+         */
+        static MultiTaskNetwork loadFromModel(const std::string& filename);
+    };
+}
+
+#endif
@@ -42,17 +42,382 @@
 #define CHISEI_NEURAL_NETWORK_HPP
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <exception>
 #include <fstream>
 #include <functional>
+#include <future>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <random>
+#include <string>
 #include <vector>
 
 #include <chisei/activation_functions.hpp>
+#include <chisei/approximate_activation.hpp>
 #include <chisei/cpu_feature_optimizer.hpp>
+#include <chisei/dataset.hpp>
+#include <chisei/dense_kernels.hpp>
+#include <chisei/metrics.hpp>
+#include <chisei/packed_layout.hpp>
+#include <chisei/sparse_matrix.hpp>
 
 namespace chisei {
 
+    /**
+     * @struct TrainingProgress
+     * @brief Result of one validation pass, reported while training continues.
+     * 
+     * Validation runs asynchronously against a snapshot of the weights, so `epoch`
+     * refers to the epoch at which the snapshot was taken, not the epoch training
+     * has reached when the result is delivered.
+     */
+    struct TrainingProgress {
+        /**
+         * @brief Number of completed epochs when the weights were snapshotted.
+         */
+        int epoch = 0;
+
+        /**
+         * @brief Mean squared error over the validation set.
+         */
+        double validation_loss = 0.0;
+
+        /**
+         * @brief Fraction of correctly classified validation samples (0.0 to 1.0).
+         */
+        double validation_accuracy = 0.0;
+
+        /**
+         * @brief True if this snapshot has the lowest validation loss seen so far.
+         */
+        bool improved = false;
+    };
+
+    /**
+     * @struct ValidationOptions
+     * @brief Controls snapshotting, early stopping and progress reporting during training.
+     */
+    struct ValidationOptions {
+        /**
+         * @brief Number of epochs between weight snapshots.
+         * 
+         * A snapshot is skipped if the evaluation of the previous one has not
+         * finished yet, so training never waits on validation.
+         */
+        int interval = 1;
+
+        /**
+         * @brief Number of consecutive non-improving validations before training stops.
+         * 
+         * A value of 0 disables early stopping.
+         */
+        int patience = 0;
+
+        /**
+         * @brief Restores the best validated weights once training stops.
+         */
+        bool restore_best = true;
+
+        /**
+         * @brief Callback invoked on the training thread for every finished validation.
+         */
+        std::function<void(const TrainingProgress&)> on_progress = nullptr;
+    };
+
+    /**
+     * @struct LbfgsOptions
+     * @brief Controls `NeuralNetwork::train_lbfgs`.
+     */
+    struct LbfgsOptions {
+        /**
+         * @brief Number of recent steps kept to approximate the inverse Hessian.
+         */
+        size_t history = 10;
+
+        /**
+         * @brief Maximum number of iterations.
+         */
+        int max_iterations = 100;
+
+        /**
+         * @brief Stops once no gradient component exceeds this magnitude.
+         */
+        double gradient_tolerance = 1e-6;
+
+        /**
+         * @brief Maximum number of step halvings per backtracking line search.
+         */
+        int max_line_search = 20;
+
+        /**
+         * @brief Number of samples evaluated per batched kernel call.
+         * 
+         * Only bounds the scratch memory; loss and gradient always cover the
+         * whole training set.
+         */
+        size_t batch_size = 256;
+
+        /**
+         * @brief Callback invoked after every iteration with its index and the loss.
+         */
+        std::function<void(int, double)> on_iteration = nullptr;
+    };
+
+    /**
+     * @struct LbfgsResult
+     * @brief Outcome of `NeuralNetwork::train_lbfgs`.
+     */
+    struct LbfgsResult {
+        /**
+         * @brief Number of iterations performed.
+         */
+        int iterations = 0;
+
+        /**
+         * @brief Half the mean squared error over the training set when training stopped.
+         */
+        double loss = 0.0;
+
+        /**
+         * @brief True if the gradient tolerance was reached.
+         */
+        bool converged = false;
+    };
+
+    /**
+     * @struct ModelSaveOptions
+     * @brief Optional content written by `NeuralNetwork::save_model`.
+     */
+    struct ModelSaveOptions {
+        /**
+         * @brief Embeds pre-packed inference panels alongside the canonical weights.
+         */
+        bool embed_packed = false;
+
+        /**
+         * @brief Kernel ISA to pack the panels for; empty selects the host ISA.
+         * 
+         * See `PackedLayout::host_isa` for the supported names.
+         */
+        std::string packed_isa = "";
+
+        /**
+         * @brief Storage format of the embedded panels.
+         * 
+         * Half-precision panels are half the size of float ones on disk and in the
+         * page cache, and are widened to float when loaded into registers.
+         */
+        PackedPrecision packed_precision = PackedPrecision::Float;
+    };
+
+    /**
+     * @struct ModelLoadOptions
+     * @brief Controls how `NeuralNetwork::loadFromModel` reads a model file.
+     */
+    struct ModelLoadOptions {
+        /**
+         * @brief Memory-maps the file instead of reading it, where supported.
+         * 
+         * Embedded packed panels are then used in place without being copied.
+         */
+        bool use_mmap = true;
+
+        /**
+         * @brief Freezes the loaded network if the file embeds packed panels.
+         * 
+         * Panels packed for the running ISA are used directly; panels packed for
+         * another ISA are ignored and the weights are repacked instead, keeping the
+         * precision of the embedded panels.
+         */
+        bool use_packed = true;
+
+        /**
+         * @brief Verifies the CRC32C checksum of every section while reading it.
+         * 
+         * Checksumming touches every page of a mapped file; trusted files can skip
+         * it so embedded packed panels stay lazily paged in. Files saved without
+         * checksums load unverified either way.
+         */
+        bool verify_checksums = true;
+
+        /**
+         * @brief Memory resource for the loaded network; `nullptr` selects the default.
+         */
+        std::pmr::memory_resource* memory_resource = nullptr;
+    };
+
+    /**
+     * @enum SparseRegrowth
+     * @brief How sparse training picks the connections it grows back.
+     */
+    enum class SparseRegrowth {
+        /**
+         * @brief Grows random missing connections with random weights (SET).
+         */
+        Random = 1,
+
+        /**
+         * @brief Grows the missing connections with the largest gradient
+         *        magnitude, starting from zero (RigL).
+         */
+        Gradient = 2
+    };
+
+    /**
+     * @struct SparseTrainingOptions
+     * @brief Controls `NeuralNetwork::enable_sparse_training`.
+     */
+    struct SparseTrainingOptions {
+        /**
+         * @brief Fraction of each layer's connections that exist, in (0, 1].
+         */
+        double density = 0.1;
+
+        /**
+         * @brief Fraction of each layer's connections replaced per update.
+         * 
+         * It decays to zero over a training run along a cosine schedule, so
+         * the topology settles before training ends.
+         */
+        double drop_fraction = 0.3;
+
+        /**
+         * @brief Number of training samples between topology updates.
+         */
+        size_t interval = 1000;
+
+        /**
+         * @brief How dropped connections are replaced.
+         */
+        SparseRegrowth regrowth = SparseRegrowth::Gradient;
+
+        /**
+         * @brief Number of samples whose summed gradient ranks missing connections
+         *        for `SparseRegrowth::Gradient`.
+         */
+        size_t gradient_samples = 32;
+    };
+
+    /**
+     * @struct ExitHead
+     * @brief Auxiliary output head attached after a hidden layer of a `NeuralNetwork`.
+     * 
+     * The head maps the hidden layer straight to the output layer, so `predict`
+     * can return its output and skip the remaining layers once the head is
+     * confident enough.
+     */
+    struct ExitHead {
+        /**
+         * @brief Allocator type, so containers of heads hand their memory resource down.
+         */
+        using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+        /**
+         * @brief Index into the layer sizes of the hidden layer feeding the head.
+         */
+        size_t layer = 0;
+
+        /**
+         * @brief Row-major `layer_sizes[layer] * layer_sizes.back()` weight matrix.
+         */
+        std::pmr::vector<double> weights{};
+
+        /**
+         * @brief Bias vector of the head, one per output neuron.
+         */
+        std::pmr::vector<double> biases{};
+
+        /**
+         * @brief Minimum confidence at which `predict` returns from this head.
+         * 
+         * Confidence is the margin between the two largest outputs. Uncalibrated
+         * heads keep the largest finite value and never exit.
+         */
+        double threshold = std::numeric_limits<double>::max();
+
+        /**
+         * @brief Constructs an empty head using the default memory resource.
+         */
+        ExitHead() = default;
+
+        /**
+         * @brief Constructs an empty head allocating from the given allocator.
+         * 
+         * @param allocator The allocator of the weights and biases.
+         */
+        explicit ExitHead(const allocator_type& allocator) :
+            layer(0),
+            weights(allocator),
+            biases(allocator),
+            threshold(std::numeric_limits<double>::max()) { }
+
+        /**
+         * @brief Copies a head into memory from the given allocator.
+         * 
+         * @param other The head to copy.
+         * @param allocator The allocator of the weights and biases.
+         */
+        ExitHead(const ExitHead& other, const allocator_type& allocator) :
+            layer(other.layer),
+            weights(other.weights, allocator),
+            biases(other.biases, allocator),
+            threshold(other.threshold) { }
+
+        /**
+         * @brief Moves a head into memory from the given allocator.
+         * 
+         * @param other The head to move from.
+         * @param allocator The allocator of the weights and biases.
+         */
+        ExitHead(ExitHead&& other, const allocator_type& allocator) :
+            layer(other.layer),
+            weights(std::move(other.weights), allocator),
+            biases(std::move(other.biases), allocator),
+            threshold(other.threshold) { }
+
+        ExitHead(const ExitHead&) = default;
+        ExitHead(ExitHead&&) = default;
+        ExitHead& operator=(const ExitHead&) = default;
+        ExitHead& operator=(ExitHead&&) = default;
+    };
+
+    /**
+     * @struct ExitStatistics
+     * @brief Counts where `NeuralNetwork::predict` returned from.
+     * 
+     * Only networks with exit heads record predictions.
+     */
+    struct ExitStatistics {
+        /**
+         * @brief Number of predictions recorded.
+         */
+        uint64_t predictions = 0;
+
+        /**
+         * @brief Total number of weight layers executed, counting an exit head as one.
+         */
+        uint64_t layers_executed = 0;
+
+        /**
+         * @brief Predictions returned per exit head, with full-depth predictions last.
+         */
+        std::vector<uint64_t> exits{};
+
+        /**
+         * @brief Returns the average number of weight layers executed per prediction.
+         * @return The average depth, or 0 if nothing was recorded.
+         */
+        double average_layers() const {
+            return this->predictions == 0 ? 0.0 :
+                static_cast<double>(this->layers_executed) /
+                    static_cast<double>(this->predictions);
+        }
+    };
+
     /**
      * @class NeuralNetwork
      * @brief Represents a fully connected feedforward neural network.
@@ -61,66 +426,421 @@ namespace chisei {
      * - Customizable activation functions.
      * - Training via backpropagation with mean squared error (MSE) loss.
      * - Saving and loading models to/from files.
+     * 
+     * Parameters and training or inference workspaces are allocated from the
+     * `std::pmr::memory_resource` given at construction, so a network can live
+     * in an arena, a huge-page pool or shared memory. The resource must outlive
+     * the network; copies share it and move assignment keeps the target's.
+     * Validated training and exit calibration allocate from several threads, so
+     * they need a thread-safe resource such as `std::pmr::synchronized_pool_resource`.
      */
     class NeuralNetwork {
     private:
 
         /**
-         * @brief The size of each layer in the neural network.
+         * @brief The memory resource parameters and workspaces are allocated from.
+         */
+        std::pmr::memory_resource* resource;
+
+        /**
+         * @brief The size of each layer in the neural network.
+         * 
+         * For example, a network with layer sizes {3, 5, 2} has:
+         * - An input layer with 3 neurons.
+         * - A hidden layer with 5 neurons.
+         * - An output layer with 2 neurons.
+         */
+        std::vector<size_t> layer_sizes;
+
+        /**
+         * @brief Weight matrices for each layer of the network.
+         * 
+         * Each weight matrix connects one layer to the next and is stored row-major as
+         * one contiguous array of `layer_sizes[l] * layer_sizes[l + 1]` values, where
+         * element `i * layer_sizes[l + 1] + j` connects input neuron `i` to output
+         * neuron `j`.
+         */
+        std::pmr::vector<std::pmr::vector<double>> weights;
+
+        /**
+         * @brief Bias vectors for each layer of the network.
+         * 
+         * Each bias vector corresponds to the neurons in a given layer, excluding the input layer.
+         */
+        std::pmr::vector<std::pmr::vector<double>> biases;
+
+        /**
+         * @brief The activation function used by the network.
+         * 
+         * The activation function is applied element-wise to the output of each layer.
+         */
+        std::function<double(double)> activation;
+
+        /**
+         * @brief The derivative of the activation function.
+         * 
+         * This is used during backpropagation to compute gradients.
+         */
+        std::function<double(double)> activation_derivative;
+
+        /**
+         * @brief Random number generator for initializing weights and biases.
+         */
+        std::random_device rd;
+
+        /**
+         * @brief Mersenne Twister random number generator.
+         */
+        std::mt19937 gen{rd()};
+
+        /**
+         * @brief Normal distribution for initializing weights.
+         * 
+         * Mean = 0, Standard Deviation = 0.1.
+         */
+        std::normal_distribution<> weight_dist{0, 0.1};
+
+        /**
+         * @brief Packed float panels used for inference while the network is frozen.
+         * 
+         * Shared between copies since it is never modified after packing; dropped
+         * as soon as training changes the canonical weights.
+         */
+        std::shared_ptr<const PackedModel> packed;
+
+        /**
+         * @brief Approximation of `activation` used by `predict`, or `nullptr`.
+         */
+        std::shared_ptr<const ApproximateActivation> approximation;
+
+        /**
+         * @brief Per-input scale of the recorded input transform; empty if none.
+         */
+        std::pmr::vector<double> input_scale;
+
+        /**
+         * @brief Per-input offset of the recorded input transform; empty if none.
+         */
+        std::pmr::vector<double> input_offset;
+
+        /**
+         * @brief Sparse weight matrices replacing `weights` during sparse training.
+         * 
+         * Empty unless sparse training is enabled, in which case every entry of
+         * `weights` is released.
+         */
+        std::pmr::vector<SparseMatrix> sparse_weights;
+
+        /**
+         * @brief Options of the current sparse training.
+         */
+        SparseTrainingOptions sparse_options;
+
+        /**
+         * @brief Exit heads sorted by the hidden layer they are attached to.
+         */
+        std::pmr::vector<ExitHead> exits;
+
+        /**
+         * @brief Where recent predictions returned from; see `get_exit_statistics`.
+         * 
+         * Holds the prediction count, the executed layer count, then one count
+         * per exit head and one for full depth. Atomic so that concurrent
+         * predictions can record their exits.
+         */
+        std::vector<std::atomic<uint64_t>> exit_counters;
+
+        /**
+         * @brief Collector predictions and training are reported to, or `nullptr`.
+         */
+        std::shared_ptr<Metrics> metrics;
+
+        /**
+         * @brief Constructs a network whose parameters are either random or zero.
+         * 
+         * Loaders pass `randomize = false` since every parameter is overwritten
+         * from the file anyway.
+         * 
+         * @param _layers A vector specifying the number of neurons in each layer.
+         * @param _activation The activation function to use in the network.
+         * @param _activation_derivative The derivative of the activation function.
+         * @param randomize True to draw the initial parameters from `weight_dist`.
+         * @param _resource The memory resource to allocate from.
+         */
+        NeuralNetwork(
+            const std::vector<size_t>& _layers,
+            std::function<double(double)> _activation,
+            std::function<double(double)> _activation_derivative,
+            bool randomize,
+            std::pmr::memory_resource* _resource
+        );
+
+        /**
+         * @brief Runs a forward pass over the packed panels.
+         * 
+         * @param input The input vector.
+         * @return The output vector.
+         */
+        std::vector<double> predict_packed(const std::vector<double>& input);
+
+        /**
+         * @brief Runs every packed layer, returning early from a confident exit head.
+         * 
+         * @param layer_output The float inputs of the first layer; used as scratch space.
+         * @param raw_input Raw bytes fed to the first layer instead, or `nullptr`.
+         * @return The output vector.
+         */
+        std::vector<double> run_packed(
+            std::pmr::vector<float>& layer_output,
+            const uint8_t* raw_input
+        );
+
+        /**
+         * @brief Runs the canonical weights, returning early from a confident exit head.
+         * 
+         * @param input The input vector.
+         * @param exit Receives the index of the head returned from, or the number
+         *             of heads for full depth.
+         * @param head_outputs If not `nullptr`, receives the output of every head
+         *                     and the network always runs at full depth.
+         * @return The output vector.
+         */
+        std::vector<double> run_exits(
+            const std::vector<double>& input,
+            size_t& exit,
+            std::pmr::vector<std::pmr::vector<double>>* head_outputs
+        ) const;
+
+        /**
+         * @brief Evaluates an exit head on the output of its hidden layer.
+         * 
+         * @param head The exit head.
+         * @param hidden The activations of `head.layer`.
+         * @param output Receives the head's output.
+         * @return The confidence of the head's output.
+         */
+        double evaluate_exit(
+            const ExitHead& head,
+            const double* hidden,
+            std::pmr::vector<double>& output
+        ) const;
+
+        /**
+         * @brief Records that a prediction returned from the given exit.
+         * 
+         * Does nothing for a network without exit heads.
+         * 
+         * @param exit The index of the exit head, or the number of heads for full depth.
+         */
+        void record_exit(size_t exit);
+
+        /**
+         * @brief Body of `predict` for one sample, without reporting to `metrics`.
+         * 
+         * @param input The input vector.
+         * @return The output vector.
+         */
+        std::vector<double> predict_sample(const std::vector<double>& input);
+
+        /**
+         * @brief Body of `predict` for a dataset, without reporting to `metrics`.
+         * 
+         * @param inputs The input rows, already checked against the input layer.
+         * @param outputs Receives `inputs.size()` rows of output values.
+         */
+        void predict_rows(const Dataset& inputs, double* outputs);
+
+        /**
+         * @brief Reports a finished epoch and the parameter footprint to `metrics`.
+         * 
+         * @param samples The number of samples trained on.
+         * @param start When the epoch started.
+         * @param total_loss The sum of the samples' mean squared errors.
+         */
+        void record_epoch(
+            size_t samples,
+            std::chrono::steady_clock::time_point start,
+            double total_loss
+        );
+
+        /**
+         * @brief Returns the bytes held by weights, biases and exit heads.
+         * 
+         * @return The parameter footprint.
+         */
+        size_t parameter_bytes() const noexcept;
+
+        /**
+         * @brief Performs a single stochastic gradient descent step on one sample.
+         * 
+         * @param input The input values, one per input neuron.
+         * @param target The expected output values, one per output neuron.
+         * @param learning_rate The learning rate for gradient descent.
+         * @return The squared error of the sample before the step, averaged over outputs.
+         */
+        double train_sample(
+            const double* input,
+            const double* target,
+            double learning_rate
+        );
+
+        /**
+         * @brief Runs the forward and backward pass of one sample over the sparse weights.
          * 
-         * For example, a network with layer sizes {3, 5, 2} has:
-         * - An input layer with 3 neurons.
-         * - A hidden layer with 5 neurons.
-         * - An output layer with 2 neurons.
+         * @param input The input values, one per input neuron.
+         * @param target The expected output values, one per output neuron.
+         * @param layer_outputs Receives the activations of every layer, input included.
+         * @param gradients Receives the gradient of every layer's pre-activations.
          */
-        std::vector<size_t> layer_sizes;
+        void sparse_backpropagate(
+            const double* input,
+            const double* target,
+            std::pmr::vector<std::pmr::vector<double>>& layer_outputs,
+            std::pmr::vector<std::pmr::vector<double>>& gradients
+        ) const;
 
         /**
-         * @brief Weight matrices for each layer of the network.
+         * @brief Performs a single stochastic gradient descent step on the sparse weights.
          * 
-         * Each weight matrix connects one layer to the next. The size of the matrix is
-         * determined by the number of neurons in the current layer and the number of 
-         * neurons in the next layer.
+         * @param input The input values, one per input neuron.
+         * @param target The expected output values, one per output neuron.
+         * @param learning_rate The learning rate for gradient descent.
+         * @return The squared error of the sample before the step, averaged over outputs.
          */
-        std::vector<std::vector<std::vector<double>>> weights;
+        double train_sample_sparse(
+            const double* input,
+            const double* target,
+            double learning_rate
+        );
 
         /**
-         * @brief Bias vectors for each layer of the network.
+         * @brief Updates the sparse topology when the given training step is due.
          * 
-         * Each bias vector corresponds to the neurons in a given layer, excluding the input layer.
+         * @param dataset The training data.
+         * @param step The number of samples trained so far in this run, minus one.
+         * @param total_steps The number of samples the run trains at most.
          */
-        std::vector<std::vector<double>> biases;
+        void sparse_step(
+            const Dataset& dataset,
+            size_t step,
+            size_t total_steps
+        );
 
         /**
-         * @brief The activation function used by the network.
+         * @brief Drops the smallest connections of every layer and grows as many new ones.
          * 
-         * The activation function is applied element-wise to the output of each layer.
+         * @param dataset The training data.
+         * @param first The first sample used to rank missing connections by gradient.
+         * @param fraction The fraction of each layer's connections to replace.
          */
-        std::function<double(double)> activation;
+        void rewire(
+            const Dataset& dataset,
+            size_t first,
+            double fraction
+        );
 
         /**
-         * @brief The derivative of the activation function.
+         * @brief Expands the sparse weights into dense row-major matrices.
          * 
-         * This is used during backpropagation to compute gradients.
+         * @return One dense weight matrix per layer.
          */
-        std::function<double(double)> activation_derivative;
+        std::pmr::vector<std::pmr::vector<double>> densify_weights() const;
 
         /**
-         * @brief Random number generator for initializing weights and biases.
+         * @brief Runs a forward pass over the sparse weights.
+         * 
+         * @param input The input vector.
+         * @return The output vector.
          */
-        std::random_device rd;
+        std::vector<double> predict_sparse(const std::vector<double>& input) const;
 
         /**
-         * @brief Mersenne Twister random number generator.
+         * @brief Evaluates the full-batch loss and, optionally, its gradient.
+         * 
+         * The loss is half the squared error summed over outputs and averaged
+         * over samples, whose gradient per sample is the one `train_sample` descends.
+         * 
+         * @param dataset The training data.
+         * @param batch_size The number of samples per batched kernel call.
+         * @param activations Scratch space for one batch of every layer's activations.
+         * @param deltas Scratch space for one batch of every layer's gradients.
+         * @param gradient Receives the gradient in `flatten_parameters` order, or `nullptr`.
+         * @return The loss.
          */
-        std::mt19937 gen{rd()};
+        double full_batch_loss(
+            const Dataset& dataset,
+            size_t batch_size,
+            std::pmr::vector<std::pmr::vector<double>>& activations,
+            std::pmr::vector<std::pmr::vector<double>>& deltas,
+            double* gradient
+        ) const;
 
         /**
-         * @brief Normal distribution for initializing weights.
+         * @brief Copies every weight, then every bias, into one contiguous vector.
          * 
-         * Mean = 0, Standard Deviation = 0.1.
+         * @param parameters Receives the parameters.
          */
-        std::normal_distribution<> weight_dist{0, 0.1};
+        void flatten_parameters(std::pmr::vector<double>& parameters) const;
+
+        /**
+         * @brief Restores weights and biases from a vector made by `flatten_parameters`.
+         * 
+         * @param parameters The parameters.
+         */
+        void unflatten_parameters(const std::pmr::vector<double>& parameters);
+
+        /**
+         * @brief Runs a forward pass using the given weights and biases.
+         * 
+         * Used both by `predict` and by the validation worker, which evaluates
+         * a snapshot of the weights instead of the live ones.
+         * 
+         * @param layer_sizes The size of each layer.
+         * @param weights The weight matrices to use.
+         * @param biases The bias vectors to use.
+         * @param activation The activation function to apply.
+         * @param input The input values, one per input neuron.
+         * @param approximation Evaluated instead of `activation` unless `nullptr`
+         *                      (default = `nullptr`).
+         * @return The output vector.
+         */
+        static std::vector<double> forward(
+            const std::vector<size_t>& layer_sizes,
+            const std::pmr::vector<std::pmr::vector<double>>& weights,
+            const std::pmr::vector<std::pmr::vector<double>>& biases,
+            const std::function<double(double)>& activation,
+            const double* input,
+            const ApproximateActivation* approximation = nullptr
+        );
+
+        /**
+         * @brief Evaluates loss and accuracy of a weight snapshot on a validation set.
+         * 
+         * @param layer_sizes The size of each layer.
+         * @param weights The snapshotted weight matrices.
+         * @param biases The snapshotted bias vectors.
+         * @param activation The activation function to apply.
+         * @param validation The validation data.
+         * @param epoch The epoch at which the snapshot was taken.
+         * @return The validation loss and accuracy.
+         */
+        static TrainingProgress evaluate_snapshot(
+            const std::vector<size_t>& layer_sizes,
+            const std::pmr::vector<std::pmr::vector<double>>& weights,
+            const std::pmr::vector<std::pmr::vector<double>>& biases,
+            const std::function<double(double)>& activation,
+            const Dataset& validation,
+            int epoch
+        );
+
+        /**
+         * @brief Checks that a dataset's rows fit the input and output layers.
+         * 
+         * @param dataset The dataset to check.
+         * @param with_targets Whether the targets are checked as well.
+         * @throws std::invalid_argument if a row size does not match its layer.
+         */
+        void check_dataset(const Dataset& dataset, bool with_targets) const;
 
     public:
         /**
@@ -129,11 +849,14 @@ namespace chisei {
          * @param _layers A vector specifying the number of neurons in each layer.
          * @param _activation The activation function to use in the network.
          * @param _activation_derivative The derivative of the activation function.
+         * @param _resource The memory resource for parameters and workspaces; it
+         *                  must outlive the network (default = the default resource).
          */
         NeuralNetwork(
             const std::vector<size_t>& _layers,
             std::function<double(double)> _activation,
-            std::function<double(double)> _activation_derivative
+            std::function<double(double)> _activation_derivative,
+            std::pmr::memory_resource* _resource = std::pmr::get_default_resource()
         );
 
         /**
@@ -160,6 +883,66 @@ namespace chisei {
          */
         NeuralNetwork& operator=(NeuralNetwork&& other) noexcept;
 
+        /**
+         * @brief Copy assignment is not supported; copy-construct instead.
+         */
+        NeuralNetwork& operator=(const NeuralNetwork&) = delete;
+
+        /**
+         * @brief Returns the memory resource parameters and workspaces are allocated from.
+         * 
+         * @return The memory resource.
+         */
+        std::pmr::memory_resource* get_memory_resource() const noexcept;
+
+        /**
+         * @brief Reports predictions and training to a metrics collector.
+         * 
+         * `predict`, `predict_raw` and every training method record their calls,
+         * latency, batch sizes, throughput and loss. Copies of the network report
+         * to the same collector. Pass `nullptr` to stop reporting.
+         * 
+         * @param _metrics The collector, possibly shared with other networks.
+         */
+        void set_metrics(std::shared_ptr<Metrics> _metrics);
+
+        /**
+         * @brief Returns the collector set by `set_metrics`.
+         * 
+         * @return The collector, or `nullptr` if none is set.
+         */
+        std::shared_ptr<Metrics> get_metrics() const noexcept;
+
+        /**
+         * @brief Returns the number of neurons in each layer, input layer first.
+         * 
+         * @return The layer sizes.
+         */
+        const std::vector<size_t>& get_layer_sizes() const noexcept;
+
+        /**
+         * @brief Returns a copy of one layer's weights.
+         * 
+         * The matrix is row-major with `n_in * n_out` values; while training
+         * sparsely, missing connections are returned as zero.
+         * 
+         * @param layer The weight layer, from 0 to the number of layers minus 2.
+         * @return The dense weight matrix.
+         * 
+         * @throws std::out_of_range if the layer does not exist.
+         */
+        std::vector<double> get_weights(size_t layer) const;
+
+        /**
+         * @brief Returns one layer's biases.
+         * 
+         * @param layer The weight layer, from 0 to the number of layers minus 2.
+         * @return The `n_out` biases.
+         * 
+         * @throws std::out_of_range if the layer does not exist.
+         */
+        const std::pmr::vector<double>& get_biases(size_t layer) const;
+
         /**
          * @brief Predicts the output for a given input vector.
          * 
@@ -170,6 +953,94 @@ namespace chisei {
          */
         std::vector<double> predict(const std::vector<double>& input);
 
+        /**
+         * @brief Predicts the outputs for every row of a dataset.
+         * 
+         * Rows are read in place and pushed through each layer in blocks, so a
+         * `MatrixView` over external float or double memory converts implicitly:
+         * `network.predict(chisei::MatrixView<float>(data, rows, cols))`.
+         * 
+         * @param inputs The input rows; targets, if any, are ignored.
+         * @return The outputs, one row of output values per input row.
+         * @throws std::invalid_argument if the rows do not fit the input layer.
+         */
+        std::vector<double> predict(const Dataset& inputs);
+
+        /**
+         * @brief Predicts the outputs for every row of a dataset into caller memory.
+         * 
+         * @param inputs The input rows; targets, if any, are ignored.
+         * @param outputs Receives `inputs.size()` rows of output values.
+         * @throws std::invalid_argument if the rows do not fit the input layer.
+         */
+        void predict(const Dataset& inputs, double* outputs);
+
+        /**
+         * @brief Predicts the output for raw byte inputs.
+         * 
+         * The recorded input transform maps each byte to the value `predict`
+         * expects, e.g. `pixel / 255.0`. While frozen, the transform is folded
+         * into the first layer's panels and the bytes feed a mixed `uint8_t` x
+         * `float` kernel directly, without a converted copy of the input.
+         * 
+         * @param input The raw input bytes, one per input neuron.
+         * @return The output vector.
+         * 
+         * @throws std::invalid_argument if the input size does not match the network.
+         */
+        std::vector<double> predict_raw(const std::vector<uint8_t>& input);
+
+        /**
+         * @brief Records an affine transform from raw inputs to network inputs.
+         * 
+         * Input `i` is computed as `scale[i] * raw[i] + offset[i]`. Training and
+         * `predict` keep taking transformed inputs; only `predict_raw` and the
+         * packed first layer use the transform. It is saved with the model.
+         * 
+         * @param scale The per-input scale.
+         * @param offset The per-input offset.
+         * 
+         * @throws std::invalid_argument if either size differs from the input layer.
+         */
+        void set_input_transform(
+            const std::vector<double>& scale,
+            const std::vector<double>& offset
+        );
+
+        /**
+         * @brief Records the same affine transform for every input.
+         * 
+         * @param scale The scale applied to every raw input.
+         * @param offset The offset added to every scaled input (default = 0).
+         */
+        void set_input_transform(double scale, double offset = 0.0);
+
+        /**
+         * @brief Removes the input transform, so raw inputs are used unchanged.
+         */
+        void clear_input_transform();
+
+        /**
+         * @brief Checks whether an input transform is recorded.
+         * 
+         * @return True if `set_input_transform` was called.
+         */
+        bool has_input_transform() const noexcept;
+
+        /**
+         * @brief Returns the per-input scale of the recorded transform.
+         * 
+         * @return The scales, or an empty vector if no transform is recorded.
+         */
+        const std::pmr::vector<double>& get_input_scale() const noexcept;
+
+        /**
+         * @brief Returns the per-input offset of the recorded transform.
+         * 
+         * @return The offsets, or an empty vector if no transform is recorded.
+         */
+        const std::pmr::vector<double>& get_input_offset() const noexcept;
+
         /**
          * @brief Trains the neural network using the provided training data.
          * 
@@ -187,6 +1058,101 @@ namespace chisei {
             int epochs = 10000
         );
 
+        /**
+         * @brief Trains the neural network on samples read in place.
+         * 
+         * @param dataset The training data.
+         * @param learning_rate The learning rate for gradient descent (default = 0.1).
+         * @param epochs The number of training iterations (default = 10,000).
+         * @throws std::invalid_argument if the rows do not fit the input and output layers.
+         */
+        void train(const Dataset& dataset, double learning_rate = 0.1, int epochs = 10000);
+
+        /**
+         * @brief Trains the neural network while validating weight snapshots concurrently.
+         * 
+         * Every `options.interval` epochs the weights are copied into a spare buffer
+         * and evaluated on the validation set by a background task, while training
+         * continues on the live weights. Finished results drive early stopping and
+         * are reported through `options.on_progress`.
+         * 
+         * @param inputs The training input data.
+         * @param targets The expected output data corresponding to the inputs.
+         * @param validation_inputs The validation input data.
+         * @param validation_targets The expected outputs for the validation data.
+         * @param options Snapshotting, early stopping and reporting options.
+         * @param learning_rate The learning rate for gradient descent (default = 0.1).
+         * @param epochs The maximum number of training iterations (default = 10,000).
+         * @return The number of epochs actually trained.
+         */
+        int train(
+            const std::vector<std::vector<double>>& inputs, 
+            const std::vector<std::vector<double>>& targets, 
+            const std::vector<std::vector<double>>& validation_inputs, 
+            const std::vector<std::vector<double>>& validation_targets, 
+            const ValidationOptions& options,
+            double learning_rate = 0.1, 
+            int epochs = 10000
+        );
+
+        /**
+         * @brief Trains on samples read in place while validating weight snapshots concurrently.
+         * 
+         * @param dataset The training data.
+         * @param validation The validation data; it must outlive the call.
+         * @param options Snapshotting, early stopping and reporting options.
+         * @param learning_rate The learning rate for gradient descent (default = 0.1).
+         * @param epochs The maximum number of training iterations (default = 10,000).
+         * @return The number of epochs actually trained.
+         * @throws std::invalid_argument if the rows do not fit the input and output layers.
+         */
+        int train(
+            const Dataset& dataset,
+            const Dataset& validation,
+            const ValidationOptions& options,
+            double learning_rate = 0.1,
+            int epochs = 10000
+        );
+
+        /**
+         * @brief Trains the network with the full-batch L-BFGS quasi-Newton method.
+         * 
+         * Suited to small datasets, where it typically converges in tens of
+         * iterations instead of thousands of SGD epochs. Each iteration evaluates
+         * the loss and gradient over the whole training set with batched GEMM,
+         * picks a direction from the last `options.history` steps, held in two
+         * contiguous ring buffers, and takes it with a backtracking line search.
+         * Networks with exit heads are rejected, since the heads would not be trained.
+         * 
+         * @param inputs The training input data.
+         * @param targets The expected output data corresponding to the inputs.
+         * @param options The history size, stopping criteria and batch size.
+         * @return The number of iterations, the final loss and whether it converged.
+         * @throws std::invalid_argument if the inputs and targets differ in size,
+         *         the network trains sparsely or it has exit heads.
+         */
+        LbfgsResult train_lbfgs(
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<double>>& targets,
+            const LbfgsOptions& options = LbfgsOptions()
+        );
+
+        /**
+         * @brief Trains the network with full-batch L-BFGS on samples read in place.
+         * 
+         * Contiguous `double` inputs feed the batched kernels without being copied.
+         * 
+         * @param dataset The training data.
+         * @param options The history size, stopping criteria and batch size.
+         * @return The number of iterations, the final loss and whether it converged.
+         * @throws std::invalid_argument if the rows do not fit the input and output
+         *         layers, the network trains sparsely or it has exit heads.
+         */
+        LbfgsResult train_lbfgs(
+            const Dataset& dataset,
+            const LbfgsOptions& options = LbfgsOptions()
+        );
+
         /**
          * @brief Computes the mean squared error (MSE) loss.
          * 
@@ -223,6 +1189,15 @@ namespace chisei {
             const std::vector<std::vector<double>>& targets
         );
 
+        /**
+         * @brief Computes the accuracy of the network on samples read in place.
+         * 
+         * @param dataset The input rows and expected outputs.
+         * @return The fraction of samples whose largest output matches the target's.
+         * @throws std::invalid_argument if the rows do not fit the input and output layers.
+         */
+        double compute_accuracy(const Dataset& dataset);
+
         /**
          * @brief Determines whether a prediction is correct based on a target.
          * 
@@ -244,6 +1219,24 @@ namespace chisei {
          */
         void save_model(const std::string& filename);
 
+        /**
+         * @brief Saves the neural network to a file with optional embedded sections.
+         * 
+         * Embedded packed panels are appended after the canonical weights and biases,
+         * aligned for memory mapping. Readers that do not know about them stop at the
+         * canonical data, so the file stays loadable by older versions. A recorded
+         * input transform is always written as its own section, and embedded
+         * panels then have it folded into their first layer. Exit heads and their
+         * thresholds are written as another section.
+         * 
+         * @param filename The name of the file to save the model to.
+         * @param options The optional content to embed.
+         * 
+         * @throws ModelLoaderException if the file cannot be written.
+         * @throws std::invalid_argument if the packed ISA name is unknown.
+         */
+        void save_model(const std::string& filename, const ModelSaveOptions& options);
+
         /**
          * @brief Loads a neural network from a saved model file.
          * 
@@ -253,6 +1246,212 @@ namespace chisei {
          * @throws std::ios_base::failure if the file cannot be read or is malformed.
          */
         static NeuralNetwork loadFromModel(const std::string& filename);
+
+        /**
+         * @brief Loads a neural network from a saved model file with the given options.
+         * 
+         * @param filename The name of the file to load the model from.
+         * @param options How to read the file and whether to use embedded panels.
+         * @return A NeuralNetwork object initialized from the file data.
+         * 
+         * @throws ModelLoaderException if the file cannot be read or is malformed.
+         */
+        static NeuralNetwork loadFromModel(
+            const std::string& filename,
+            const ModelLoadOptions& options
+        );
+
+        /**
+         * @brief Widens a hidden layer without changing what the network computes.
+         * Each new neuron copies the incoming weights and bias of a randomly
+         * chosen existing neuron (Net2WiderNet). The outgoing weights of every
+         * neuron and its copies, including those into an exit head, are split
+         * between them in random proportions that sum to one. The copies therefore
+         * add up to the original contribution, and they still diverge in training.
+         * @param layer The index into the layer sizes of the hidden layer.
+         * @param width The new number of neurons; at least the current one.
+         * @throws std::invalid_argument if the layer is not a hidden layer, the
+         *         width is smaller than the current one, or the network trains
+         *         sparsely.
+         */
+        void widen_layer(size_t layer, size_t width);
+
+        /**
+         * @brief Inserts an identity-initialized hidden layer without changing
+         *        what the network computes.
+         * The new layer has as many neurons as the layer it follows, identity
+         * weights and zero biases (Net2DeeperNet). This is exact only if the
+         * activation function leaves its own outputs unchanged, as ReLU does.
+         * @param after The index into the layer sizes of the hidden layer the
+         *              new layer follows.
+         * @throws std::invalid_argument if `after` is not a hidden layer, the
+         *         activation function is not idempotent, or the network trains
+         *         sparsely.
+         */
+        void insert_layer(size_t after);
+
+        /**
+         * @brief Switches training to a fixed fraction of connections in sparse storage.
+         * Every layer keeps its largest-magnitude weights, so enabling this right
+         * after construction starts from a random sparse topology, and enabling
+         * it on a trained network prunes it by magnitude. From then on, weights
+         * live in compressed sparse rows and the forward, backward and update
+         * passes cost time and memory in proportion to the kept connections.
+         * Every `options.interval` training samples, each layer drops its
+         * smallest connections and grows as many new ones. Saving, freezing
+         * and validation snapshots see the equivalent dense weights.
+         * @param options The density and topology update schedule.
+         * @throws std::invalid_argument if the density is not in (0, 1] or the
+         *         network has exit heads.
+         */
+        void enable_sparse_training(
+            const SparseTrainingOptions& options = SparseTrainingOptions()
+        );
+
+        /**
+         * @brief Returns to dense weights; missing connections become zero.
+         */
+        void disable_sparse_training();
+
+        /**
+         * @brief Checks whether the network trains sparsely.
+         * @return True if `enable_sparse_training` is in effect.
+         */
+        bool is_sparse() const noexcept;
+
+        /**
+         * @brief Returns the number of existing connections.
+         * @return The number of stored weights over all layers.
+         */
+        size_t connection_count() const noexcept;
+
+        /**
+         * @brief Attaches an exit head after a hidden layer.
+         * The head is a single dense layer from the hidden layer to the output
+         * layer, trained jointly with the network on the same targets. It never
+         * exits until `calibrate_exits` or `set_exit_threshold` sets its threshold.
+         * @param layer The index into the layer sizes of the hidden layer, from 1
+         *              to the number of layers minus 2.
+         * @return The index of the new head among all heads, ordered by layer.
+         * @throws std::invalid_argument if the layer is not a hidden layer, already
+         *         has a head, or the network trains sparsely.
+         */
+        size_t add_exit(size_t layer);
+
+        /**
+         * @brief Removes every exit head, so `predict` always runs at full depth.
+         */
+        void clear_exits();
+
+        /**
+         * @brief Returns the number of exit heads.
+         * @return The number of exit heads.
+         */
+        size_t exit_count() const noexcept;
+
+        /**
+         * @brief Returns an exit head.
+         * @param index The index of the head, ordered by layer.
+         * @return The exit head.
+         * @throws std::out_of_range if the index is out of range.
+         */
+        const ExitHead& get_exit(size_t index) const;
+
+        /**
+         * @brief Sets the confidence at which `predict` returns from an exit head.
+         * @param index The index of the head, ordered by layer.
+         * @param threshold The minimum margin between the two largest outputs.
+         * @throws std::out_of_range if the index is out of range.
+         */
+        void set_exit_threshold(size_t index, double threshold);
+
+        /**
+         * @brief Calibrates every exit threshold on held-out data.
+         * Heads are calibrated in order on the samples that earlier heads did not
+         * take. Each threshold is set as low as possible while the samples the head
+         * takes are still classified at least as accurately as the full network
+         * classifies the whole set, minus `tolerance`.
+         * @param inputs The calibration input data.
+         * @param targets The expected outputs for the calibration data.
+         * @param tolerance The accuracy each head may lose against the full network
+         *                  (default = 0.01).
+         * @return The average number of weight layers executed on the calibration data.
+         * @throws std::invalid_argument if the inputs and targets differ in size.
+         */
+        double calibrate_exits(
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<double>>& targets,
+            double tolerance = 0.01
+        );
+
+        /**
+         * @brief Returns where predictions returned from since the last reset.
+         * @return The exit statistics.
+         */
+        ExitStatistics get_exit_statistics() const;
+
+        /**
+         * @brief Clears the exit statistics.
+         */
+        void reset_exit_statistics();
+
+        /**
+         * @brief Packs the weights into panels for the host ISA.
+         * 
+         * While frozen, `predict` runs over the packed panels instead of the canonical
+         * double weights. Training unfreezes the network automatically.
+         * 
+         * Half-precision panels halve the weight traffic of float panels again and
+         * need no calibration; weights are rounded to 11 significant bits, and
+         * magnitudes beyond 65504 saturate to infinity.
+         * 
+         * @param precision Storage format of the panels (default = `PackedPrecision::Float`).
+         */
+        void freeze(PackedPrecision precision = PackedPrecision::Float);
+
+        /**
+         * @brief Drops the packed panels and returns to the canonical weights.
+         */
+        void unfreeze();
+
+        /**
+         * @brief Checks whether the network currently predicts from packed panels.
+         * 
+         * @return True if the network is frozen.
+         */
+        bool is_frozen() const;
+
+        /**
+         * @brief Benchmarks kernel configurations for every layer of the network.
+         * 
+         * Tuned configurations are cached per CPU model by the `KernelAutotuner`
+         * and picked up automatically by later predictions and training runs.
+         * 
+         * @param batch_sizes The batch sizes to tune for (default = {1}).
+         */
+        void autotune(const std::vector<size_t>& batch_sizes = {1});
+
+        /**
+         * @brief Makes `predict` evaluate an approximation of the activation function.
+         * 
+         * The approximation should be built from the same function the network
+         * was created with, e.g.
+         * `ApproximateActivation::lookup_table(ActivationFunctions::sigmoid_activation, 1024, -8, 8)`.
+         * It applies to both the double and the frozen packed paths; training and
+         * validation always use the exact function.
+         * 
+         * @param _approximation The approximation, or `nullptr` for the exact function.
+         */
+        void set_activation_approximation(
+            std::shared_ptr<const ApproximateActivation> _approximation
+        );
+
+        /**
+         * @brief Returns the approximation used by `predict`.
+         * 
+         * @return The approximation, or `nullptr` if the exact function is used.
+         */
+        std::shared_ptr<const ApproximateActivation> get_activation_approximation() const;
     };
 }
 
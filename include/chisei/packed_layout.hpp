@@ -0,0 +1,447 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file PackedLayout.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the frozen, panel-packed weight layout used for inference.
+ */
+#ifndef CHISEI_PACKED_LAYOUT_HPP
+#define CHISEI_PACKED_LAYOUT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include <chisei/dense_kernels.hpp>
+#include <chisei/mapped_file.hpp>
+
+namespace chisei {
+
+    /**
+     * @enum PackedPrecision
+     * @brief Storage format of the weights in packed panels.
+     * 
+     * The values are stored in the packed section of model files.
+     */
+    enum class PackedPrecision : uint32_t {
+        /**
+         * @brief IEEE 754 single precision.
+         */
+        Float = 0,
+
+        /**
+         * @brief IEEE 754 half precision, widened to float inside the kernels.
+         */
+        Half = 1
+    };
+
+    /**
+     * @struct PackedLayer
+     * @brief Location of one layer's packed panels and biases inside a `PackedModel`.
+     * 
+     * Offsets are counted in bytes from `PackedModel::base()`.
+     */
+    struct PackedLayer {
+        /**
+         * @brief The number of inputs of the layer.
+         */
+        size_t n_in = 0;
+
+        /**
+         * @brief The number of outputs of the layer.
+         */
+        size_t n_out = 0;
+
+        /**
+         * @brief Offset of the first panel.
+         */
+        size_t panels_offset = 0;
+
+        /**
+         * @brief Offset of the padded bias vector.
+         */
+        size_t biases_offset = 0;
+    };
+
+    /**
+     * @struct PackedModel
+     * @brief Immutable set of packed layers for one kernel ISA.
+     * 
+     * The packed data either lives in `storage` or directly inside a memory-mapped
+     * model file, in which case `mapping` keeps the mapping alive.
+     */
+    struct PackedModel {
+        /**
+         * @brief Allocator of the owned packed data.
+         */
+        using allocator_type = std::pmr::polymorphic_allocator<float>;
+
+        /**
+         * @brief Name of the kernel ISA the panels were packed for.
+         */
+        std::string isa = "";
+
+        /**
+         * @brief Number of output neurons interleaved in each panel.
+         */
+        size_t panel_width = 0;
+
+        /**
+         * @brief Storage format of the panels; biases are always float.
+         */
+        PackedPrecision precision = PackedPrecision::Float;
+
+        /**
+         * @brief Packed layers, in network order.
+         */
+        std::vector<PackedLayer> layers = {};
+
+        /**
+         * @brief Owned packed data, used when the model is not memory-mapped.
+         * 
+         * Held as floats so that every memory resource returns float-aligned panels.
+         */
+        std::pmr::vector<float> storage = {};
+
+        /**
+         * @brief Memory-mapped model file holding the packed data, if any.
+         */
+        std::shared_ptr<const MappedFile> mapping = nullptr;
+
+        /**
+         * @brief Byte offset of the packed data inside `mapping`.
+         */
+        size_t mapping_offset = 0;
+
+        /**
+         * @brief Constructs an empty model using the default memory resource.
+         */
+        PackedModel() = default;
+
+        /**
+         * @brief Constructs an empty model allocating its packed data from the given allocator.
+         * 
+         * @param allocator The allocator of `storage`.
+         */
+        explicit PackedModel(const allocator_type& allocator) :
+            isa(""),
+            panel_width(0),
+            precision(PackedPrecision::Float),
+            layers(),
+            storage(allocator),
+            mapping(nullptr),
+            mapping_offset(0) { }
+
+        /**
+         * @brief Returns a pointer to the first byte of the packed data.
+         * 
+         * @return The base pointer all layer offsets are relative to.
+         */
+        const unsigned char* base() const noexcept;
+
+        /**
+         * @brief Returns a layer's float panels.
+         * 
+         * @param layer A layer of this model, which must have float precision.
+         * @return The first float of the layer's panels.
+         */
+        const float* float_panels(const PackedLayer& layer) const noexcept;
+
+        /**
+         * @brief Returns a layer's half-precision panels.
+         * 
+         * @param layer A layer of this model, which must have half precision.
+         * @return The first half-precision value of the layer's panels.
+         */
+        const uint16_t* half_panels(const PackedLayer& layer) const noexcept;
+
+        /**
+         * @brief Returns a layer's padded bias vector.
+         * 
+         * @param layer A layer of this model.
+         * @return The first float of the layer's biases.
+         */
+        const float* biases(const PackedLayer& layer) const noexcept;
+    };
+
+    /**
+     * @class PackedLayout
+     * @brief Packs dense weights into output panels and runs inference over them.
+     * 
+     * A panel interleaves `panel_width` consecutive output neurons, so panel `p`
+     * stores weight `(i, p * panel_width + r)` at index `i * panel_width + r`. The
+     * kernel then streams one contiguous panel per group of outputs, keeping all
+     * of its accumulators in vector registers. Weights are narrowed to float,
+     * halving the bandwidth of the canonical double weights, or to half precision,
+     * quartering it; half panels are widened back to float in registers with F16C
+     * where available.
+     */
+    class PackedLayout final {
+    public:
+
+        /**
+         * @brief Returns the kernel ISA this build of the library runs packed layers with.
+         * 
+         * @return One of `avx512`, `avx2`, `avx`, `sse2`, `neon` or `generic`.
+         */
+        static std::string host_isa();
+
+        /**
+         * @brief Returns the panel width used by the kernel for the given ISA.
+         * 
+         * @param isa The kernel ISA name.
+         * @return The number of output neurons per panel.
+         * 
+         * @throws std::invalid_argument if the ISA name is unknown.
+         */
+        static size_t panel_width(const std::string& isa);
+
+        /**
+         * @brief Returns the number of weights in a layer's padded panels.
+         * 
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         * @return The number of weights in the panels.
+         */
+        static size_t panels_size(size_t n_in, size_t n_out, size_t panel_width);
+
+        /**
+         * @brief Returns the size of one packed weight.
+         * 
+         * @param precision The storage format of the panels.
+         * @return The number of bytes per weight.
+         */
+        static size_t element_size(PackedPrecision precision);
+
+        /**
+         * @brief Lays out a model's packed layers back to back.
+         * 
+         * Fills `model.layers` from the layer sizes, `model.panel_width` and
+         * `model.precision`.
+         * 
+         * @param model The model to lay out.
+         * @param layer_sizes The size of each layer.
+         * @return The number of bytes of packed data.
+         */
+        static size_t layout(PackedModel& model, const std::vector<size_t>& layer_sizes);
+
+        /**
+         * @brief Returns the number of floats in a layer's padded bias vector.
+         * 
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         * @return The number of floats in the bias vector.
+         */
+        static size_t biases_size(size_t n_out, size_t panel_width);
+
+        /**
+         * @brief Packs a row-major weight matrix and its biases into panels.
+         * 
+         * @param weights Row-major weight matrix of `n_in * n_out` values.
+         * @param biases Bias vector of `n_out` values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         * @param panels Destination of `panels_size(...)` floats.
+         * @param packed_biases Destination of `biases_size(...)` floats.
+         * @param input_scale Per-input scale folded into the weights, or `nullptr`.
+         * @param input_offset Per-input offset folded into the biases, or `nullptr`.
+         */
+        static void pack(
+            const double* weights,
+            const double* biases,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width,
+            float* panels,
+            float* packed_biases,
+            const double* input_scale = nullptr,
+            const double* input_offset = nullptr
+        );
+
+        /**
+         * @brief Packs a row-major weight matrix into half-precision panels.
+         * 
+         * Identical to the float overload except that every weight is rounded to
+         * the nearest half-precision value after the input scale is folded in.
+         * 
+         * @param weights Row-major weight matrix of `n_in * n_out` values.
+         * @param biases Bias vector of `n_out` values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         * @param panels Destination of `panels_size(...)` half-precision values.
+         * @param packed_biases Destination of `biases_size(...)` floats.
+         * @param input_scale Per-input scale folded into the weights, or `nullptr`.
+         * @param input_offset Per-input offset folded into the biases, or `nullptr`.
+         */
+        static void pack(
+            const double* weights,
+            const double* biases,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width,
+            uint16_t* panels,
+            float* packed_biases,
+            const double* input_scale = nullptr,
+            const double* input_offset = nullptr
+        );
+
+        /**
+         * @brief Packs every layer of a network into a new `PackedModel`.
+         * 
+         * @param layer_sizes The size of each layer.
+         * @param weights The row-major weight matrices.
+         * @param biases The bias vectors.
+         * @param isa The kernel ISA to pack for.
+         * @param input_scale Per-input scale folded into the first layer (default = none).
+         * @param input_offset Per-input offset folded into the first layer (default = none).
+         * @param precision Storage format of the panels (default = `PackedPrecision::Float`).
+         * @param resource The memory resource of the model and its panels (default = the default resource).
+         * @return The packed model.
+         */
+        static std::shared_ptr<const PackedModel> pack_model(
+            const std::vector<size_t>& layer_sizes,
+            const std::pmr::vector<std::pmr::vector<double>>& weights,
+            const std::pmr::vector<std::pmr::vector<double>>& biases,
+            const std::string& isa,
+            const std::pmr::vector<double>& input_scale = {},
+            const std::pmr::vector<double>& input_offset = {},
+            PackedPrecision precision = PackedPrecision::Float,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        );
+
+        /**
+         * @brief Computes one packed layer's outputs for a single sample.
+         * 
+         * @param config The kernel configuration (threads and parallel threshold are used).
+         * @param panels The packed panels of the layer.
+         * @param biases The padded bias vector of the layer.
+         * @param input The `n_in` input values.
+         * @param output The `n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         */
+        static void forward(
+            const KernelConfig& config,
+            const float* panels,
+            const float* biases,
+            const float* input,
+            float* output,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width
+        );
+
+        /**
+         * @brief Computes one packed layer's outputs for a single sample of raw bytes.
+         * 
+         * Each byte is widened to float inside the kernel, so a layer whose panels
+         * have an input transform folded in can consume raw `uint8_t` data directly.
+         * 
+         * @param config The kernel configuration (threads and parallel threshold are used).
+         * @param panels The packed panels of the layer.
+         * @param biases The padded bias vector of the layer.
+         * @param input The `n_in` input bytes.
+         * @param output The `n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         */
+        static void forward(
+            const KernelConfig& config,
+            const float* panels,
+            const float* biases,
+            const uint8_t* input,
+            float* output,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width
+        );
+
+        /**
+         * @brief Computes one half-precision packed layer's outputs for a single sample.
+         * 
+         * @param config The kernel configuration (threads and parallel threshold are used).
+         * @param panels The half-precision panels of the layer.
+         * @param biases The padded bias vector of the layer.
+         * @param input The `n_in` input values.
+         * @param output The `n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         */
+        static void forward(
+            const KernelConfig& config,
+            const uint16_t* panels,
+            const float* biases,
+            const float* input,
+            float* output,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width
+        );
+
+        /**
+         * @brief Computes one half-precision packed layer's outputs for a single sample of raw bytes.
+         * 
+         * @param config The kernel configuration (threads and parallel threshold are used).
+         * @param panels The half-precision panels of the layer.
+         * @param biases The padded bias vector of the layer.
+         * @param input The `n_in` input bytes.
+         * @param output The `n_out` output values.
+         * @param n_in The number of inputs of the layer.
+         * @param n_out The number of outputs of the layer.
+         * @param panel_width The number of output neurons per panel.
+         */
+        static void forward(
+            const KernelConfig& config,
+            const uint16_t* panels,
+            const float* biases,
+            const uint8_t* input,
+            float* output,
+            size_t n_in,
+            size_t n_out,
+            size_t panel_width
+        );
+    };
+}
+
+#endif
@@ -0,0 +1,132 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file Pool2DLayer.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the 2D max and average pooling layer of a `SequentialNetwork`.
+ */
+#ifndef CHISEI_POOL2D_LAYER_HPP
+#define CHISEI_POOL2D_LAYER_HPP
+
+#include <istream>
+#include <memory>
+
+#include <chisei/layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @enum PoolingMode
+     * @brief Reduction applied over each pooling window.
+     */
+    enum class PoolingMode : uint32_t {
+        Max = 1,
+        Average = 2
+    };
+
+    /**
+     * @class Pool2DLayer
+     * @brief Downsamples each channel of a CHW input over square windows.
+     * 
+     * Windows that would extend past the input border are dropped. The max
+     * pooling backward pass routes each gradient to the first maximum of its
+     * window, recomputed from the input instead of stored during `forward`.
+     */
+    class Pool2DLayer final : public Layer {
+    private:
+        /**
+         * @brief The reduction applied over each window.
+         */
+        PoolingMode mode;
+
+        /**
+         * @brief The side length of the square window.
+         */
+        size_t pool_size;
+
+        /**
+         * @brief The step between neighbouring windows.
+         */
+        size_t stride;
+
+    public:
+        /**
+         * @brief Constructs a pooling layer.
+         * 
+         * @param _input_shape The shape of one input sample.
+         * @param _mode The reduction applied over each window.
+         * @param _pool_size The side length of the square window.
+         * @param _stride The step between windows; 0 uses `_pool_size` (default = 0).
+         * 
+         * @throws std::invalid_argument if the window does not fit the input.
+         */
+        Pool2DLayer(
+            const TensorShape& _input_shape,
+            PoolingMode _mode,
+            size_t _pool_size,
+            size_t _stride = 0
+        );
+
+        /**
+         * @brief Reads a pooling layer written by `save`.
+         * 
+         * @param stream The input stream.
+         * @param _input_shape The shape of one input sample.
+         * @return The loaded layer.
+         * 
+         * @throws ModelLoaderException if the stream is truncated or malformed.
+         */
+        static std::unique_ptr<Pool2DLayer> load(
+            std::istream& stream,
+            const TensorShape& _input_shape
+        );
+
+        LayerType type() const noexcept override;
+
+        void forward(const double* input, double* output, size_t batch) override;
+
+        void backward(
+            const double* input,
+            const double* output,
+            const double* output_gradient,
+            double* input_gradient,
+            size_t batch
+        ) override;
+
+        void save(std::ostream& stream) const override;
+    };
+}
+
+#endif
@@ -0,0 +1,479 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file SequentialNetwork.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the SequentialNetwork class, a stack of heterogeneous layers.
+ */
+#ifndef CHISEI_SEQUENTIAL_NETWORK_HPP
+#define CHISEI_SEQUENTIAL_NETWORK_HPP
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/batch_norm_layer.hpp>
+#include <chisei/block_sparse_dense_layer.hpp>
+#include <chisei/conv2d_layer.hpp>
+#include <chisei/dense_layer.hpp>
+#include <chisei/embedding_layer.hpp>
+#include <chisei/hashed_dense_layer.hpp>
+#include <chisei/layer.hpp>
+#include <chisei/lsh_dense_layer.hpp>
+#include <chisei/mixture_of_experts_layer.hpp>
+#include <chisei/pool2d_layer.hpp>
+
+namespace chisei {
+
+    /**
+     * @enum CompileMode
+     * @brief Selects which buffers `SequentialNetwork::compile` keeps alive.
+     */
+    enum class CompileMode {
+        /**
+         * @brief Forward pass only; layer outputs are recycled once consumed,
+         *        which reduces a plain chain of layers to two ping-pong buffers.
+         */
+        Inference,
+
+        /**
+         * @brief Forward and backward passes; every layer output is retained
+         *        until its backward step, while gradients are recycled.
+         */
+        Training
+    };
+
+    /**
+     * @struct ExecutionStep
+     * @brief One layer invocation of a compiled `SequentialNetwork`.
+     */
+    struct ExecutionStep {
+        /**
+         * @brief Index of the layer that runs in this step.
+         */
+        size_t layer = 0;
+
+        /**
+         * @brief Index of the layer whose activation was fused into this step,
+         *        or `layer` if none was.
+         */
+        size_t last_layer = 0;
+
+        /**
+         * @brief Arena offset of the step's input; the first step reads the
+         *        network input instead.
+         */
+        size_t input_offset = 0;
+
+        /**
+         * @brief Arena offset of the step's output.
+         */
+        size_t output_offset = 0;
+
+        /**
+         * @brief Arena offset of the gradient with respect to the step's output.
+         */
+        size_t output_gradient_offset = 0;
+    };
+
+    /**
+     * @class SequentialNetwork
+     * @brief A feedforward network built from a sequence of `Layer` objects.
+     * 
+     * Unlike `NeuralNetwork`, which is a fixed stack of dense layers sharing one
+     * activation function, a sequential network can mix convolution, pooling,
+     * dense and activation layers. It trains with mini-batch gradient descent on
+     * the mean squared error loss and has its own `*.chisei` layout, identified
+     * by the `CL` magic bytes.
+     * 
+     * @code
+     * chisei::SequentialNetwork cnn({1, 28, 28});
+     * cnn.add<chisei::Conv2DLayer>(8, 3, 1, 1);
+     * cnn.add<chisei::ActivationLayer>(chisei::ActivationType::ReLU);
+     * cnn.add<chisei::Pool2DLayer>(chisei::PoolingMode::Max, 2);
+     * cnn.add<chisei::DenseLayer>(10);
+     * cnn.add<chisei::ActivationLayer>(chisei::ActivationType::Sigmoid);
+     * @endcode
+     */
+    class SequentialNetwork final {
+    private:
+        friend class MultiTaskNetwork;
+
+        /**
+         * @brief The shape of one input sample.
+         */
+        TensorShape input_shape;
+
+        /**
+         * @brief The layers, in evaluation order.
+         */
+        std::vector<std::unique_ptr<Layer>> layers;
+
+        /**
+         * @brief The compiled layer invocations, in evaluation order.
+         */
+        std::vector<ExecutionStep> plan;
+
+        /**
+         * @brief Single buffer holding every planned activation and gradient.
+         */
+        std::vector<double> arena;
+
+        /**
+         * @brief Arena offset of the training input batch.
+         */
+        size_t input_offset;
+
+        /**
+         * @brief The largest batch the current plan was sized for; 0 if not compiled.
+         */
+        size_t compiled_batch;
+
+        /**
+         * @brief The mode of the current plan.
+         */
+        CompileMode compiled_mode;
+
+        /**
+         * @brief Approximation applied to activations in inference plans.
+         */
+        ApproximationKind activation_approximation;
+
+        /**
+         * @brief Resolution passed to `ActivationLayer::approximate`.
+         */
+        size_t approximation_resolution;
+
+        /**
+         * @brief Runs a batch through the compiled plan.
+         * 
+         * @param input `batch * input_shape.size()` input values.
+         * @param batch The number of samples, at most `compiled_batch`.
+         * @return Pointer to the outputs of the last step inside the arena.
+         */
+        const double* forward(const double* input, size_t batch);
+
+        /**
+         * @brief Runs the backward pass of the compiled plan over the last batch.
+         * 
+         * The gradient with respect to the output must already be written to
+         * `output_gradient()`.
+         * 
+         * @param input The input batch the last `forward` call ran on.
+         * @param input_gradient Receives the gradient with respect to the input,
+         *                       or `nullptr` if it is not needed.
+         * @param batch The number of samples.
+         */
+        void backward(const double* input, double* input_gradient, size_t batch);
+
+        /**
+         * @brief Applies the accumulated gradients of every layer.
+         * 
+         * @param learning_rate The learning rate for gradient descent.
+         */
+        void update(double learning_rate);
+
+        /**
+         * @brief Returns the arena buffer of the gradient with respect to the output.
+         * 
+         * @return `compiled_batch * get_output_shape().size()` values; only valid
+         *         for training plans.
+         */
+        double* output_gradient();
+
+        /**
+         * @brief Compiles a plan for the given batch and mode unless the current
+         *        one already serves it.
+         * 
+         * @param batch The number of samples per call.
+         * @param mode The mode the plan is needed for.
+         */
+        void prepare(size_t batch, CompileMode mode);
+
+        /**
+         * @brief Switches every layer between training and inference behaviour.
+         * 
+         * @param training True while training.
+         */
+        void set_training(bool training);
+
+        /**
+         * @brief Writes the network in the `CL` model format.
+         * 
+         * @param stream The output stream.
+         * @param fold_batch_norm If true, foldable batch normalization layers are
+         *                        written merged as by `fold_batch_norm` (default = false).
+         */
+        void write(std::ostream& stream, bool fold_batch_norm = false) const;
+
+        /**
+         * @brief Reads a network in the `CL` model format.
+         * 
+         * @param stream The input stream.
+         * @return The network.
+         * 
+         * @throws ModelLoaderException if the stream is malformed.
+         */
+        static SequentialNetwork read(std::istream& stream);
+
+    public:
+        /**
+         * @brief Constructs an empty network for inputs of the given shape.
+         * 
+         * @param _input_shape The shape of one input sample.
+         */
+        explicit SequentialNetwork(const TensorShape& _input_shape);
+
+        SequentialNetwork(SequentialNetwork&& other) noexcept = default;
+        SequentialNetwork& operator=(SequentialNetwork&& other) noexcept = default;
+
+        SequentialNetwork(const SequentialNetwork&) = delete;
+        SequentialNetwork& operator=(const SequentialNetwork&) = delete;
+
+        /**
+         * @brief Appends an already constructed layer.
+         * 
+         * @param layer The layer to append.
+         * @return A reference to the appended layer.
+         * 
+         * @throws std::invalid_argument if the layer's input shape does not match
+         *         the current output shape of the network.
+         */
+        Layer& add(std::unique_ptr<Layer> layer);
+
+        /**
+         * @brief Constructs and appends a layer fed by the current output shape.
+         * 
+         * @param args The layer constructor arguments following the input shape.
+         * @return A reference to the appended layer.
+         */
+        template<typename LayerT, typename... Args>
+        LayerT& add(Args&&... args) {
+            LayerT* layer = new LayerT(this->get_output_shape(), std::forward<Args>(args)...);
+            this->add(std::unique_ptr<Layer>(layer));
+
+            return *layer;
+        }
+
+        /**
+         * @brief Returns the shape of one input sample.
+         * 
+         * @return The input shape.
+         */
+        const TensorShape& get_input_shape() const noexcept;
+
+        /**
+         * @brief Returns the shape of one output sample.
+         * 
+         * @return The output shape of the last layer, or the input shape if empty.
+         */
+        const TensorShape& get_output_shape() const noexcept;
+
+        /**
+         * @brief Returns the number of layers.
+         * 
+         * @return The layer count.
+         */
+        size_t layer_count() const noexcept;
+
+        /**
+         * @brief Returns the layer at the given position.
+         * 
+         * @param index The layer index.
+         * @return A reference to the layer.
+         */
+        Layer& get_layer(size_t index);
+
+        /**
+         * @brief Returns the total number of trainable parameters.
+         * 
+         * @return The parameter count.
+         */
+        size_t parameter_count() const noexcept;
+
+        /**
+         * @brief Plans execution for batches of up to `max_batch` samples.
+         * 
+         * Infers every tensor shape, fuses each dense or convolution layer with
+         * a directly following activation layer, and places all layer outputs
+         * and gradients in a single arena. Each buffer lives from the step that
+         * writes it to the last step that reads it, and buffers whose lifetimes
+         * do not overlap share memory. Layers preallocate their own scratch
+         * space, so running the plan does not allocate.
+         * 
+         * `predict` and `train` compile on demand; calling this up front only
+         * moves the cost out of the first call. Adding a layer discards the plan.
+         * 
+         * @param max_batch The largest batch the plan must hold (default = 1).
+         * @param mode Whether buffers for the backward pass are planned
+         *             (default = `CompileMode::Inference`).
+         */
+        void compile(size_t max_batch = 1, CompileMode mode = CompileMode::Inference);
+
+        /**
+         * @brief Checks whether an execution plan is available.
+         * 
+         * @return True if `compile` ran since the last `add`.
+         */
+        bool is_compiled() const noexcept;
+
+        /**
+         * @brief Returns the size of the activation arena of the current plan.
+         * 
+         * @return The number of `double` values in the arena.
+         */
+        size_t arena_size() const noexcept;
+
+        /**
+         * @brief Returns the compiled layer invocations.
+         * 
+         * @return The execution plan; empty if not compiled.
+         */
+        const std::vector<ExecutionStep>& get_plan() const noexcept;
+
+        /**
+         * @brief Selects an approximation for the sigmoid and tanh activations.
+         * 
+         * Only inference plans use it; `train` always evaluates the exact
+         * functions. The current plan is discarded.
+         * 
+         * @param kind The kind of approximation; `Exact` turns it off.
+         * @param resolution Passed to `ActivationLayer::approximate` (default = 0).
+         */
+        void set_activation_approximation(ApproximationKind kind, size_t resolution = 0);
+
+        /**
+         * @brief Returns the activation approximation used for inference.
+         * 
+         * @return The approximation kind.
+         */
+        ApproximationKind get_activation_approximation() const noexcept;
+
+        /**
+         * @brief Predicts the output for a given input vector.
+         * 
+         * @param input The flattened CHW input vector.
+         * @return The output vector.
+         */
+        std::vector<double> predict(const std::vector<double>& input);
+
+        /**
+         * @brief Trains the network with mini-batch gradient descent on the MSE loss.
+         * 
+         * @param inputs The training input data.
+         * @param targets The expected output data corresponding to the inputs.
+         * @param learning_rate The learning rate for gradient descent (default = 0.1).
+         * @param epochs The number of training iterations (default = 10).
+         * @param batch_size The number of samples per update (default = 1).
+         */
+        void train(
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<double>>& targets,
+            double learning_rate = 0.1,
+            int epochs = 10,
+            size_t batch_size = 1
+        );
+
+        /**
+         * @brief Computes the accuracy of the network on a dataset.
+         * 
+         * @param inputs The input data.
+         * @param targets The expected outputs.
+         * @return The accuracy as a fraction (0.0 to 1.0).
+         */
+        double compute_accuracy(
+            const std::vector<std::vector<double>>& inputs,
+            const std::vector<std::vector<double>>& targets
+        );
+
+        /**
+         * @brief Folds every batch normalization layer that directly follows a
+         *        dense or convolution layer into that layer's weights and biases.
+         * 
+         * The running statistics turn batch normalization into a per-channel
+         * affine map at inference, so the folded network computes the same
+         * predictions without the extra pass. The folded layers are removed,
+         * which makes this a one-way conversion for deployment.
+         * 
+         * @return The number of batch normalization layers folded.
+         */
+        size_t fold_batch_norm();
+
+        /**
+         * @brief Replaces every dense layer with a block-sparse layer pruned by block magnitude.
+         * 
+         * Each dense layer keeps the `1 - sparsity` fraction of its
+         * `block_rows x block_cols` blocks with the largest sum of squared
+         * weights. Pruning is a one-way conversion; training afterwards
+         * fine-tunes the kept blocks, which usually recovers the accuracy lost.
+         * 
+         * @param sparsity The fraction of blocks to drop, in [0, 1).
+         * @param block_rows The number of inputs per block (default = 4).
+         * @param block_cols The number of outputs per block; 4, 8 or 16 (default = 16).
+         * @return The number of layers pruned.
+         * 
+         * @throws std::invalid_argument if the sparsity or block shape is invalid.
+         */
+        size_t prune_blocks(double sparsity, size_t block_rows = 4, size_t block_cols = 16);
+
+        /**
+         * @brief Saves the network layout and parameters to a file.
+         * 
+         * @param filename The name of the file to save the model to.
+         * @param fold_batch_norm If true, the saved model has its foldable batch
+         *                        normalization layers merged as by `fold_batch_norm`,
+         *                        leaving this network untouched (default = true).
+         * 
+         * @throws ModelLoaderException if the file cannot be written.
+         */
+        void save_model(const std::string& filename, bool fold_batch_norm = true) const;
+
+        /**
+         * @brief Loads a network saved by `save_model`.
+         * 
+         * @param filename The name of the file to load the model from.
+         * @return The loaded network.
+         * 
+         * @throws ModelLoaderException if the file cannot be read or is malformed.
+         */
+        static SequentialNetwork loadFromModel(const std::string& filename);
+    };
+}
+
+#endif
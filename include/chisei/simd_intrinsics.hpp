@@ -0,0 +1,197 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file SimdIntrinsics.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the warning-free wrappers of x86 vector intrinsics used by the kernels.
+ */
+#ifndef CHISEI_SIMD_INTRINSICS_HPP
+#define CHISEI_SIMD_INTRINSICS_HPP
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+    /**
+     * @class SimdIntrinsics
+     * @brief Full-width forms of the intrinsics that GCC 12 cannot compile cleanly.
+     * 
+     * GCC 12 implements the plain AVX2 gathers and many plain AVX-512 intrinsics
+     * on top of their masked builtins, passing an undefined vector as the
+     * pass-through operand, and `-Wmaybe-uninitialized` then fails `-Werror`
+     * builds. Each wrapper calls the masked or zero-masked form with a full mask
+     * and a zero pass-through instead, which compiles to the same instruction.
+     * Kernels use these wrappers rather than the plain intrinsics below.
+     */
+    class SimdIntrinsics final {
+    public:
+    #if defined(__AVX2__)
+        /**
+         * @brief Gathers four doubles at 32-bit indices (`_mm256_i32gather_pd`).
+         */
+        static inline __m256d gather(const double* base, __m128i index) noexcept {
+            return _mm256_mask_i32gather_pd(
+                _mm256_setzero_pd(), base, index,
+                _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8
+            );
+        }
+
+        /**
+         * @brief Gathers eight floats at 32-bit indices (`_mm256_i32gather_ps`).
+         */
+        static inline __m256 gather(const float* base, __m256i index) noexcept {
+            return _mm256_mask_i32gather_ps(
+                _mm256_setzero_ps(), base, index,
+                _mm256_castsi256_ps(_mm256_set1_epi32(-1)), 4
+            );
+        }
+    #endif
+
+    #if defined(__AVX512F__)
+        /**
+         * @brief Gathers eight doubles at 32-bit indices (`_mm512_i32gather_pd`).
+         */
+        static inline __m512d gather(const double* base, __m256i index) noexcept {
+            return _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, index, base, 8);
+        }
+
+        /**
+         * @brief Gathers sixteen floats at 32-bit indices (`_mm512_i32gather_ps`).
+         */
+        static inline __m512 gather(const float* base, __m512i index) noexcept {
+            return _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, index, base, 4);
+        }
+
+        /**
+         * @brief Lane-wise minimum (`_mm512_min_pd`).
+         */
+        static inline __m512d min(__m512d a, __m512d b) noexcept {
+            return _mm512_maskz_min_pd(0xFF, a, b);
+        }
+
+        /**
+         * @brief Lane-wise maximum (`_mm512_max_pd`).
+         */
+        static inline __m512d max(__m512d a, __m512d b) noexcept {
+            return _mm512_maskz_max_pd(0xFF, a, b);
+        }
+
+        /**
+         * @brief Lane-wise minimum (`_mm512_min_ps`).
+         */
+        static inline __m512 min(__m512 a, __m512 b) noexcept {
+            return _mm512_maskz_min_ps(0xFFFF, a, b);
+        }
+
+        /**
+         * @brief Lane-wise maximum (`_mm512_max_ps`).
+         */
+        static inline __m512 max(__m512 a, __m512 b) noexcept {
+            return _mm512_maskz_max_ps(0xFFFF, a, b);
+        }
+
+        /**
+         * @brief Lane-wise signed 32-bit minimum (`_mm512_min_epi32`).
+         */
+        static inline __m512i min_epi32(__m512i a, __m512i b) noexcept {
+            return _mm512_maskz_min_epi32(0xFFFF, a, b);
+        }
+
+        /**
+         * @brief Truncates eight doubles to 32-bit integers (`_mm512_cvttpd_epi32`).
+         */
+        static inline __m256i truncate(__m512d value) noexcept {
+            return _mm512_maskz_cvttpd_epi32(0xFF, value);
+        }
+
+        /**
+         * @brief Truncates sixteen floats to 32-bit integers (`_mm512_cvttps_epi32`).
+         */
+        static inline __m512i truncate(__m512 value) noexcept {
+            return _mm512_maskz_cvttps_epi32(0xFFFF, value);
+        }
+
+        /**
+         * @brief Widens sixteen half-precision values to float (`_mm512_cvtph_ps`).
+         */
+        static inline __m512 widen_half(__m256i value) noexcept {
+            return _mm512_maskz_cvtph_ps(0xFFFF, value);
+        }
+
+        /**
+         * @brief Shifts 32-bit lanes right (`_mm512_srli_epi32`).
+         */
+        template<unsigned int shift>
+        static inline __m512i srli_epi32(__m512i value) noexcept {
+            return _mm512_maskz_srli_epi32(0xFFFF, value, shift);
+        }
+
+        /**
+         * @brief Shifts 32-bit lanes left (`_mm512_slli_epi32`).
+         */
+        template<unsigned int shift>
+        static inline __m512i slli_epi32(__m512i value) noexcept {
+            return _mm512_maskz_slli_epi32(0xFFFF, value, shift);
+        }
+
+        /**
+         * @brief Shifts 64-bit lanes right (`_mm512_srli_epi64`).
+         */
+        template<unsigned int shift>
+        static inline __m512i srli_epi64(__m512i value) noexcept {
+            return _mm512_maskz_srli_epi64(0xFF, value, shift);
+        }
+
+        /**
+         * @brief Multiplies the low unsigned 32 bits of each 64-bit lane (`_mm512_mul_epu32`).
+         */
+        static inline __m512i mul_epu32(__m512i a, __m512i b) noexcept {
+            return _mm512_maskz_mul_epu32(0xFF, a, b);
+        }
+
+        /**
+         * @brief Extracts one 256-bit half (`_mm512_extracti64x4_epi64`).
+         */
+        template<int half>
+        static inline __m256i extract_half(__m512i value) noexcept {
+            return _mm512_maskz_extracti64x4_epi64(0xF, value, half);
+        }
+    #endif
+    };
+}
+
+#endif
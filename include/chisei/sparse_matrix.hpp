@@ -0,0 +1,220 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+/**
+ * @file SparseMatrix.hpp
+ * @author [Nathanne Isip](https://github.com/nthnn)
+ * @brief Header file for the compressed sparse row weight matrix used by sparse training.
+ */
+#ifndef CHISEI_SPARSE_MATRIX_HPP
+#define CHISEI_SPARSE_MATRIX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace chisei {
+
+    /**
+     * @struct SparseMatrix
+     * @brief A `rows * cols` weight matrix in compressed sparse row storage.
+     * 
+     * Rows are input neurons and columns output neurons, as in the row-major
+     * dense weights of `NeuralNetwork`, so each row lists the outgoing
+     * connections of one input. Columns are sorted within a row. Every kernel
+     * costs time proportional to the number of stored entries.
+     */
+    struct SparseMatrix {
+        /**
+         * @brief Allocator of the entry arrays, so containers of matrices propagate their resource.
+         */
+        using allocator_type = std::pmr::polymorphic_allocator<double>;
+
+        /**
+         * @brief Number of rows (input neurons).
+         */
+        size_t rows = 0;
+
+        /**
+         * @brief Number of columns (output neurons).
+         */
+        size_t cols = 0;
+
+        /**
+         * @brief Offset of the first entry of each row, plus the total entry count.
+         */
+        std::pmr::vector<uint32_t> row_offsets{};
+
+        /**
+         * @brief Column of each entry.
+         */
+        std::pmr::vector<uint32_t> columns{};
+
+        /**
+         * @brief Value of each entry.
+         */
+        std::pmr::vector<double> values{};
+
+        /**
+         * @brief Constructs an empty matrix using the default memory resource.
+         */
+        SparseMatrix() = default;
+
+        /**
+         * @brief Constructs an empty matrix allocating from the given allocator.
+         * 
+         * @param allocator The allocator of the entry arrays.
+         */
+        explicit SparseMatrix(const allocator_type& allocator) :
+            rows(0),
+            cols(0),
+            row_offsets(allocator),
+            columns(allocator),
+            values(allocator) { }
+
+        /**
+         * @brief Copies a matrix into memory from the given allocator.
+         * 
+         * @param other The matrix to copy.
+         * @param allocator The allocator of the entry arrays.
+         */
+        SparseMatrix(const SparseMatrix& other, const allocator_type& allocator) :
+            rows(other.rows),
+            cols(other.cols),
+            row_offsets(other.row_offsets, allocator),
+            columns(other.columns, allocator),
+            values(other.values, allocator) { }
+
+        /**
+         * @brief Moves a matrix into memory from the given allocator.
+         * 
+         * @param other The matrix to move from.
+         * @param allocator The allocator of the entry arrays.
+         */
+        SparseMatrix(SparseMatrix&& other, const allocator_type& allocator) :
+            rows(other.rows),
+            cols(other.cols),
+            row_offsets(std::move(other.row_offsets), allocator),
+            columns(std::move(other.columns), allocator),
+            values(std::move(other.values), allocator) { }
+
+        SparseMatrix(const SparseMatrix&) = default;
+        SparseMatrix(SparseMatrix&&) = default;
+        SparseMatrix& operator=(const SparseMatrix&) = default;
+        SparseMatrix& operator=(SparseMatrix&&) = default;
+
+        /**
+         * @brief Builds a matrix from `(row * cols + col, value)` entries.
+         * 
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param entries The entries, each index at most once; sorted in place.
+         * @param resource The memory resource of the entry arrays.
+         * @return The matrix.
+         */
+        static SparseMatrix from_entries(
+            size_t rows,
+            size_t cols,
+            std::pmr::vector<std::pair<uint64_t, double>>& entries,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        );
+
+        /**
+         * @brief Builds a matrix from the largest-magnitude entries of a dense matrix.
+         * 
+         * @param dense Row-major `rows * cols` values.
+         * @param rows The number of rows.
+         * @param cols The number of columns.
+         * @param keep The number of entries to keep.
+         * @param resource The memory resource of the matrix and its selection buffers.
+         * @return The matrix.
+         */
+        static SparseMatrix from_dense(
+            const double* dense,
+            size_t rows,
+            size_t cols,
+            size_t keep,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+        );
+
+        /**
+         * @brief Returns the number of stored entries.
+         * 
+         * @return The entry count.
+         */
+        size_t nonzeros() const noexcept {
+            return this->values.size();
+        }
+
+        /**
+         * @brief Writes the matrix into a dense row-major buffer.
+         * 
+         * @param dense Receives `rows * cols` values; missing entries become zero.
+         */
+        void to_dense(double* dense) const;
+
+        /**
+         * @brief Accumulates `output[j] += sum_i input[i] * W[i][j]`.
+         * 
+         * Rows of zero inputs are skipped.
+         * 
+         * @param input `rows` input values.
+         * @param output `cols` output values to accumulate into.
+         */
+        void multiply_add(const double* input, double* output) const;
+
+        /**
+         * @brief Computes `output[i] = sum_j W[i][j] * gradient[j]`.
+         * 
+         * @param gradient `cols` values.
+         * @param output Receives `rows` values.
+         */
+        void multiply_transposed(const double* gradient, double* output) const;
+
+        /**
+         * @brief Applies `W[i][j] -= scale * input[i] * gradient[j]` to the stored entries.
+         * 
+         * Rows of zero inputs are skipped.
+         * 
+         * @param scale The learning rate.
+         * @param input `rows` input values.
+         * @param gradient `cols` gradient values.
+         */
+        void rank_one_update(double scale, const double* input, const double* gradient);
+    };
+}
+
+#endif
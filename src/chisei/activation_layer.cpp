@@ -0,0 +1,213 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_functions.hpp>
+#include <chisei/activation_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <functional>
+#include <utility>
+
+namespace chisei {
+
+ActivationLayer::ActivationLayer(
+    const TensorShape& _input_shape,
+    ActivationType _activation
+) : Layer(_input_shape, _input_shape),
+    activation(_activation),
+    approximation()
+{ }
+
+std::shared_ptr<const ApproximateActivation> ActivationLayer::approximate(
+    ActivationType activation,
+    ApproximationKind kind,
+    size_t resolution
+) {
+    if(activation == ActivationType::ReLU)
+        return nullptr;
+
+    const bool sigmoid = activation == ActivationType::Sigmoid;
+    const double range = sigmoid ? 8.0 : 4.0;
+    const std::function<double(double)> function = sigmoid ?
+        ActivationFunctions::sigmoid_activation :
+        ActivationFunctions::tanh_activation;
+
+    switch(kind) {
+        case ApproximationKind::Hard:
+            return std::make_shared<const ApproximateActivation>(sigmoid ?
+                ApproximateActivation::hard_sigmoid() :
+                ApproximateActivation::hard_tanh());
+
+        case ApproximationKind::PiecewiseLinear:
+            return std::make_shared<const ApproximateActivation>(
+                ApproximateActivation::piecewise_linear(
+                    function,
+                    resolution == 0 ? 16 : resolution,
+                    -range,
+                    range
+                )
+            );
+
+        case ApproximationKind::LookupTable:
+            return std::make_shared<const ApproximateActivation>(
+                ApproximateActivation::lookup_table(
+                    function,
+                    resolution == 0 ? 1024 : resolution,
+                    -range,
+                    range
+                )
+            );
+
+        case ApproximationKind::Exact:
+        default:
+            return nullptr;
+    }
+}
+
+void ActivationLayer::set_approximation(
+    std::shared_ptr<const ApproximateActivation> _approximation
+) noexcept {
+    this->approximation = std::move(_approximation);
+}
+
+std::unique_ptr<ActivationLayer> ActivationLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const uint32_t activation = ModelStream::read<uint32_t>(stream);
+    if(activation < static_cast<uint32_t>(ActivationType::Sigmoid) ||
+        activation > static_cast<uint32_t>(ActivationType::Tanh))
+        throw ModelLoaderException("Invalid *.chisei file format, unknown activation.");
+
+    return std::unique_ptr<ActivationLayer>(
+        new ActivationLayer(_input_shape, static_cast<ActivationType>(activation))
+    );
+}
+
+LayerType ActivationLayer::type() const noexcept {
+    return LayerType::Activation;
+}
+
+void ActivationLayer::apply(
+    ActivationType activation,
+    const double* input,
+    double* output,
+    size_t count
+) {
+    switch(activation) {
+        case ActivationType::ReLU:
+            for(size_t i = 0; i < count; ++i)
+                output[i] = ActivationFunctions::relu_activation(input[i]);
+            break;
+
+        case ActivationType::Tanh:
+            for(size_t i = 0; i < count; ++i)
+                output[i] = ActivationFunctions::tanh_activation(input[i]);
+            break;
+
+        case ActivationType::Sigmoid:
+        default:
+            for(size_t i = 0; i < count; ++i)
+                output[i] = ActivationFunctions::sigmoid_activation(input[i]);
+            break;
+    }
+}
+
+void ActivationLayer::apply_derivative(
+    ActivationType activation,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t count
+) {
+    switch(activation) {
+        case ActivationType::ReLU:
+            for(size_t i = 0; i < count; ++i)
+                input_gradient[i] = output_gradient[i] *
+                    ActivationFunctions::relu_derivative(output[i]);
+            break;
+
+        case ActivationType::Tanh:
+            for(size_t i = 0; i < count; ++i)
+                input_gradient[i] = output_gradient[i] *
+                    ActivationFunctions::tanh_derivative(output[i]);
+            break;
+
+        case ActivationType::Sigmoid:
+        default:
+            for(size_t i = 0; i < count; ++i)
+                input_gradient[i] = output_gradient[i] *
+                    ActivationFunctions::sigmoid_derivative(output[i]);
+            break;
+    }
+}
+
+void ActivationLayer::forward(const double* input, double* output, size_t batch) {
+    if(this->approximation) {
+        this->approximation->apply(input, output, batch * this->input_shape.size());
+        return;
+    }
+
+    apply(this->activation, input, output, batch * this->input_shape.size());
+}
+
+void ActivationLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    (void) input;
+    if(input_gradient == nullptr)
+        return;
+
+    apply_derivative(
+        this->activation,
+        output,
+        output_gradient,
+        input_gradient,
+        batch * this->input_shape.size()
+    );
+}
+
+void ActivationLayer::save(std::ostream& stream) const {
+    ModelStream::write(stream, static_cast<uint32_t>(this->activation));
+}
+
+ActivationType ActivationLayer::get_activation() const noexcept {
+    return this->activation;
+}
+
+}
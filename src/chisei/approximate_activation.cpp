@@ -0,0 +1,369 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/approximate_activation.hpp>
+#include <chisei/simd_intrinsics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+constexpr size_t max_segments = size_t(1) << 24;
+
+template<typename T>
+inline T evaluate(
+    T x,
+    T lower,
+    T upper,
+    T inverse_step,
+    const T* slopes,
+    const T* intercepts,
+    size_t last
+) noexcept {
+    const T clamped = !(x >= lower) ? lower : (x > upper ? upper : x);
+    const size_t k = std::min(static_cast<size_t>((clamped - lower) * inverse_step), last);
+
+    return slopes[k] * clamped + intercepts[k];
+}
+
+template<typename T>
+void apply_scalar(
+    const T* input,
+    T* output,
+    size_t begin,
+    size_t count,
+    T lower,
+    T upper,
+    T inverse_step,
+    const T* slopes,
+    const T* intercepts,
+    size_t last
+) noexcept {
+    for(size_t i = begin; i < count; ++i)
+        output[i] = evaluate(input[i], lower, upper, inverse_step, slopes, intercepts, last);
+}
+
+}
+
+ApproximateActivation::ApproximateActivation(
+    ApproximationKind _kind,
+    double _lower,
+    double _upper,
+    size_t segments
+) : kind(_kind),
+    lower(_lower),
+    upper(_upper),
+    inverse_step(0.0),
+    slopes(segments, 0.0),
+    intercepts(segments, 0.0),
+    slopes_f(),
+    intercepts_f()
+{
+    if(segments == 0 || segments > max_segments)
+        throw std::invalid_argument("Approximation segment count is out of range.");
+
+    if(!(_upper > _lower))
+        throw std::invalid_argument("Approximation range is empty.");
+
+    this->inverse_step = static_cast<double>(segments) / (_upper - _lower);
+}
+
+void ApproximateActivation::finalize() {
+    this->slopes_f.assign(this->slopes.begin(), this->slopes.end());
+    this->intercepts_f.assign(this->intercepts.begin(), this->intercepts.end());
+}
+
+ApproximateActivation ApproximateActivation::hard_sigmoid() {
+    ApproximateActivation approximation(ApproximationKind::Hard, -2.0, 2.0, 1);
+    approximation.slopes[0] = 0.25;
+    approximation.intercepts[0] = 0.5;
+
+    approximation.finalize();
+    return approximation;
+}
+
+ApproximateActivation ApproximateActivation::hard_tanh() {
+    ApproximateActivation approximation(ApproximationKind::Hard, -1.0, 1.0, 1);
+    approximation.slopes[0] = 1.0;
+    approximation.intercepts[0] = 0.0;
+
+    approximation.finalize();
+    return approximation;
+}
+
+ApproximateActivation ApproximateActivation::piecewise_linear(
+    const std::function<double(double)>& function,
+    size_t segments,
+    double _lower,
+    double _upper
+) {
+    constexpr size_t samples = 64;
+
+    ApproximateActivation approximation(
+        ApproximationKind::PiecewiseLinear,
+        _lower,
+        _upper,
+        segments
+    );
+    const double step = (_upper - _lower) / static_cast<double>(segments);
+
+    for(size_t k = 0; k < segments; ++k) {
+        const double start = _lower + static_cast<double>(k) * step;
+        double sum_x = 0.0, sum_y = 0.0, sum_xx = 0.0, sum_xy = 0.0;
+
+        for(size_t s = 0; s < samples; ++s) {
+            const double x = start + step * static_cast<double>(s) /
+                static_cast<double>(samples - 1);
+            const double y = function(x);
+
+            sum_x += x;
+            sum_y += y;
+            sum_xx += x * x;
+            sum_xy += x * y;
+        }
+
+        const double n = static_cast<double>(samples);
+        const double slope = (n * sum_xy - sum_x * sum_y) / (n * sum_xx - sum_x * sum_x);
+
+        approximation.slopes[k] = slope;
+        approximation.intercepts[k] = (sum_y - slope * sum_x) / n;
+    }
+
+    approximation.finalize();
+    return approximation;
+}
+
+ApproximateActivation ApproximateActivation::lookup_table(
+    const std::function<double(double)>& function,
+    size_t entries,
+    double _lower,
+    double _upper
+) {
+    if(entries < 2)
+        throw std::invalid_argument("Lookup table needs at least two entries.");
+
+    ApproximateActivation approximation(
+        ApproximationKind::LookupTable,
+        _lower,
+        _upper,
+        entries - 1
+    );
+
+    const double step = (_upper - _lower) / static_cast<double>(entries - 1);
+    double x0 = _lower, y0 = function(x0);
+
+    for(size_t k = 0; k + 1 < entries; ++k) {
+        const double x1 = _lower + static_cast<double>(k + 1) * step;
+        const double y1 = function(x1);
+        const double slope = (y1 - y0) / (x1 - x0);
+
+        approximation.slopes[k] = slope;
+        approximation.intercepts[k] = y0 - slope * x0;
+
+        x0 = x1;
+        y0 = y1;
+    }
+
+    approximation.finalize();
+    return approximation;
+}
+
+ApproximationKind ApproximateActivation::get_kind() const noexcept {
+    return this->kind;
+}
+
+size_t ApproximateActivation::segment_count() const noexcept {
+    return this->slopes.size();
+}
+
+double ApproximateActivation::operator()(double x) const noexcept {
+    return evaluate(
+        x,
+        this->lower,
+        this->upper,
+        this->inverse_step,
+        this->slopes.data(),
+        this->intercepts.data(),
+        this->slopes.size() - 1
+    );
+}
+
+void ApproximateActivation::apply(
+    const double* input,
+    double* output,
+    size_t count
+) const noexcept {
+    const size_t last = this->slopes.size() - 1;
+    const double* slope = this->slopes.data();
+    const double* intercept = this->intercepts.data();
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512d lo = _mm512_set1_pd(this->lower), hi = _mm512_set1_pd(this->upper);
+    const __m512d scale = _mm512_set1_pd(this->inverse_step);
+    const __m256i last_index = _mm256_set1_epi32(static_cast<int>(last));
+
+    for(; i + 8 <= count; i += 8) {
+        const __m512d x = SimdIntrinsics::min(
+            SimdIntrinsics::max(_mm512_loadu_pd(input + i), lo),
+            hi
+        );
+        const __m256i k = _mm256_min_epi32(
+            SimdIntrinsics::truncate(_mm512_mul_pd(_mm512_sub_pd(x, lo), scale)),
+            last_index
+        );
+
+        _mm512_storeu_pd(output + i, _mm512_fmadd_pd(
+            SimdIntrinsics::gather(slope, k),
+            x,
+            SimdIntrinsics::gather(intercept, k)
+        ));
+    }
+#elif defined(__AVX2__)
+    const __m256d lo = _mm256_set1_pd(this->lower), hi = _mm256_set1_pd(this->upper);
+    const __m256d scale = _mm256_set1_pd(this->inverse_step);
+    const __m128i last_index = _mm_set1_epi32(static_cast<int>(last));
+
+    for(; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_min_pd(_mm256_max_pd(_mm256_loadu_pd(input + i), lo), hi);
+        const __m128i k = _mm_min_epi32(
+            _mm256_cvttpd_epi32(_mm256_mul_pd(_mm256_sub_pd(x, lo), scale)),
+            last_index
+        );
+
+        const __m256d a = SimdIntrinsics::gather(slope, k);
+        const __m256d b = SimdIntrinsics::gather(intercept, k);
+    #if defined(__FMA__)
+        _mm256_storeu_pd(output + i, _mm256_fmadd_pd(a, x, b));
+    #else
+        _mm256_storeu_pd(output + i, _mm256_add_pd(_mm256_mul_pd(a, x), b));
+    #endif
+    }
+#endif
+
+    apply_scalar(
+        input, output, i, count,
+        this->lower, this->upper, this->inverse_step,
+        slope, intercept, last
+    );
+}
+
+void ApproximateActivation::apply(
+    const float* input,
+    float* output,
+    size_t count
+) const noexcept {
+    const size_t last = this->slopes_f.size() - 1;
+    const float* slope = this->slopes_f.data();
+    const float* intercept = this->intercepts_f.data();
+    const float lo_f = static_cast<float>(this->lower), hi_f = static_cast<float>(this->upper);
+    const float scale_f = static_cast<float>(this->inverse_step);
+    size_t i = 0;
+
+#if defined(__AVX512F__)
+    const __m512 lo = _mm512_set1_ps(lo_f), hi = _mm512_set1_ps(hi_f);
+    const __m512 scale = _mm512_set1_ps(scale_f);
+    const __m512i last_index = _mm512_set1_epi32(static_cast<int>(last));
+
+    for(; i + 16 <= count; i += 16) {
+        const __m512 x = SimdIntrinsics::min(
+            SimdIntrinsics::max(_mm512_loadu_ps(input + i), lo),
+            hi
+        );
+        const __m512i k = SimdIntrinsics::min_epi32(
+            SimdIntrinsics::truncate(_mm512_mul_ps(_mm512_sub_ps(x, lo), scale)),
+            last_index
+        );
+
+        _mm512_storeu_ps(output + i, _mm512_fmadd_ps(
+            SimdIntrinsics::gather(slope, k),
+            x,
+            SimdIntrinsics::gather(intercept, k)
+        ));
+    }
+#elif defined(__AVX2__)
+    const __m256 lo = _mm256_set1_ps(lo_f), hi = _mm256_set1_ps(hi_f);
+    const __m256 scale = _mm256_set1_ps(scale_f);
+    const __m256i last_index = _mm256_set1_epi32(static_cast<int>(last));
+
+    for(; i + 8 <= count; i += 8) {
+        const __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(input + i), lo), hi);
+        const __m256i k = _mm256_min_epi32(
+            _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_sub_ps(x, lo), scale)),
+            last_index
+        );
+
+        const __m256 a = SimdIntrinsics::gather(slope, k);
+        const __m256 b = SimdIntrinsics::gather(intercept, k);
+    #if defined(__FMA__)
+        _mm256_storeu_ps(output + i, _mm256_fmadd_ps(a, x, b));
+    #else
+        _mm256_storeu_ps(output + i, _mm256_add_ps(_mm256_mul_ps(a, x), b));
+    #endif
+    }
+#endif
+
+    apply_scalar(
+        input, output, i, count,
+        lo_f, hi_f, scale_f,
+        slope, intercept, last
+    );
+}
+
+double ApproximateActivation::max_error(
+    const std::function<double(double)>& function,
+    double _lower,
+    double _upper,
+    size_t samples
+) const {
+    double error = 0.0;
+
+    for(size_t s = 0; s < samples; ++s) {
+        const double x = _lower + (_upper - _lower) * static_cast<double>(s) /
+            static_cast<double>(std::max<size_t>(samples - 1, 1));
+        error = std::max(error, std::fabs((*this)(x) - function(x)));
+    }
+
+    return error;
+}
+
+}
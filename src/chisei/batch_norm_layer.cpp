@@ -0,0 +1,356 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/batch_norm_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace chisei {
+
+BatchNormLayer::BatchNormLayer(
+    const TensorShape& _input_shape,
+    double _momentum,
+    double _epsilon
+) : Layer(_input_shape, _input_shape),
+    momentum(_momentum),
+    epsilon(_epsilon),
+    training(true),
+    gamma(_input_shape.channels, 1.0),
+    beta(_input_shape.channels, 0.0),
+    running_mean(_input_shape.channels, 0.0),
+    running_variance(_input_shape.channels, 1.0),
+    gamma_gradients(_input_shape.channels, 0.0),
+    beta_gradients(_input_shape.channels, 0.0),
+    batch_mean(_input_shape.channels, 0.0),
+    batch_inverse_std(_input_shape.channels, 1.0),
+    scale(_input_shape.channels, 1.0),
+    shift(_input_shape.channels, 0.0),
+    variance(_input_shape.channels, 0.0),
+    gradient_sum(_input_shape.channels, 0.0),
+    weighted_gradient_sum(_input_shape.channels, 0.0),
+    activation_gradients()
+{
+    if(_input_shape.size() == 0)
+        throw std::invalid_argument("Batch normalization input must not be empty.");
+
+    if(!(_momentum > 0.0) || _momentum > 1.0)
+        throw std::invalid_argument("Batch normalization momentum must be in (0, 1].");
+
+    if(!(_epsilon > 0.0))
+        throw std::invalid_argument("Batch normalization epsilon must be positive.");
+}
+
+std::unique_ptr<BatchNormLayer> BatchNormLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const double stored_momentum = ModelStream::read<double>(stream);
+    const double stored_epsilon = ModelStream::read<double>(stream);
+
+    if(!(stored_momentum > 0.0) || stored_momentum > 1.0 || !(stored_epsilon > 0.0))
+        throw ModelLoaderException("Invalid *.chisei file format, bad batch normalization layer.");
+
+    std::unique_ptr<BatchNormLayer> layer(
+        new BatchNormLayer(_input_shape, stored_momentum, stored_epsilon)
+    );
+
+    ModelStream::read_array(stream, layer->gamma);
+    ModelStream::read_array(stream, layer->beta);
+    ModelStream::read_array(stream, layer->running_mean);
+    ModelStream::read_array(stream, layer->running_variance);
+
+    for(double value : layer->running_variance)
+        if(!(value >= 0.0))
+            throw ModelLoaderException("Invalid *.chisei file format, bad batch normalization layer.");
+
+    return layer;
+}
+
+LayerType BatchNormLayer::type() const noexcept {
+    return LayerType::BatchNorm;
+}
+
+bool BatchNormLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void BatchNormLayer::prepare(size_t max_batch) {
+    if(this->has_fused_activation)
+        this->activation_gradients.resize(max_batch * this->output_shape.size());
+}
+
+void BatchNormLayer::set_training(bool _training) {
+    this->training = _training;
+}
+
+void BatchNormLayer::compute_statistics(
+    const double* input,
+    size_t batch,
+    std::vector<double>& mean,
+    std::vector<double>& biased_variance
+) const {
+    const size_t channels = this->input_shape.channels;
+    const size_t spatial = this->input_shape.height * this->input_shape.width;
+    const size_t sample_size = this->input_shape.size();
+    const double count = static_cast<double>(batch * spatial);
+
+    std::fill(mean.begin(), mean.end(), 0.0);
+    std::fill(biased_variance.begin(), biased_variance.end(), 0.0);
+
+    // Two passes over the batch: a running sum of squares loses precision for
+    // channels whose mean is large compared to their spread.
+    for(size_t b = 0; b < batch; ++b) {
+        const double* x = input + b * sample_size;
+
+        for(size_t c = 0; c < channels; ++c) {
+            const double* row = x + c * spatial;
+            double sum = 0.0;
+
+            for(size_t s = 0; s < spatial; ++s)
+                sum += row[s];
+
+            mean[c] += sum;
+        }
+    }
+
+    for(double& value : mean)
+        value /= count;
+
+    for(size_t b = 0; b < batch; ++b) {
+        const double* x = input + b * sample_size;
+
+        for(size_t c = 0; c < channels; ++c) {
+            const double* row = x + c * spatial;
+            const double center = mean[c];
+            double sum = 0.0;
+
+            for(size_t s = 0; s < spatial; ++s) {
+                const double deviation = row[s] - center;
+                sum += deviation * deviation;
+            }
+
+            biased_variance[c] += sum;
+        }
+    }
+
+    for(double& value : biased_variance)
+        value /= count;
+}
+
+void BatchNormLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t channels = this->input_shape.channels;
+    const size_t spatial = this->input_shape.height * this->input_shape.width;
+    const size_t sample_size = this->input_shape.size();
+
+    if(this->training) {
+        this->compute_statistics(input, batch, this->batch_mean, this->variance);
+
+        const double count = static_cast<double>(batch * spatial);
+        const double correction = count > 1.0 ? count / (count - 1.0) : 1.0;
+
+        for(size_t c = 0; c < channels; ++c) {
+            this->running_mean[c] += this->momentum *
+                (this->batch_mean[c] - this->running_mean[c]);
+            this->running_variance[c] += this->momentum *
+                (this->variance[c] * correction - this->running_variance[c]);
+        }
+    }
+    else {
+        std::copy(this->running_mean.begin(), this->running_mean.end(), this->batch_mean.begin());
+        std::copy(this->running_variance.begin(), this->running_variance.end(), this->variance.begin());
+    }
+
+    for(size_t c = 0; c < channels; ++c) {
+        this->batch_inverse_std[c] = 1.0 / std::sqrt(this->variance[c] + this->epsilon);
+        this->scale[c] = this->gamma[c] * this->batch_inverse_std[c];
+        this->shift[c] = this->beta[c] - this->batch_mean[c] * this->scale[c];
+    }
+
+    for(size_t b = 0; b < batch; ++b) {
+        const double* x = input + b * sample_size;
+        double* y = output + b * sample_size;
+
+        for(size_t c = 0; c < channels; ++c) {
+            const double a = this->scale[c];
+            const double k = this->shift[c];
+            const double* in = x + c * spatial;
+            double* out = y + c * spatial;
+
+            for(size_t s = 0; s < spatial; ++s)
+                out[s] = a * in[s] + k;
+        }
+    }
+
+    const size_t total = batch * sample_size;
+    if(this->fused_approximation)
+        this->fused_approximation->apply(output, output, total);
+    else if(this->has_fused_activation)
+        ActivationLayer::apply(this->fused_activation, output, output, total);
+}
+
+void BatchNormLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t channels = this->input_shape.channels;
+    const size_t spatial = this->input_shape.height * this->input_shape.width;
+    const size_t sample_size = this->input_shape.size();
+    const double count = static_cast<double>(batch * spatial);
+
+    const double* dy = output_gradient;
+    if(this->has_fused_activation) {
+        this->activation_gradients.resize(batch * sample_size);
+        ActivationLayer::apply_derivative(
+            this->fused_activation,
+            output,
+            output_gradient,
+            this->activation_gradients.data(),
+            batch * sample_size
+        );
+        dy = this->activation_gradients.data();
+    }
+
+    // Per channel: sum(dy) and sum(dy * x_hat), the two reductions the input
+    // gradient of the batch statistics depends on.
+    std::fill(this->gradient_sum.begin(), this->gradient_sum.end(), 0.0);
+    std::fill(this->weighted_gradient_sum.begin(), this->weighted_gradient_sum.end(), 0.0);
+
+    for(size_t b = 0; b < batch; ++b) {
+        const double* x = input + b * sample_size;
+        const double* g = dy + b * sample_size;
+
+        for(size_t c = 0; c < channels; ++c) {
+            const double* in = x + c * spatial;
+            const double* grad = g + c * spatial;
+            const double center = this->batch_mean[c];
+            const double inv = this->batch_inverse_std[c];
+            double total = 0.0, weighted = 0.0;
+
+            for(size_t s = 0; s < spatial; ++s) {
+                total += grad[s];
+                weighted += grad[s] * (in[s] - center) * inv;
+            }
+
+            this->gradient_sum[c] += total;
+            this->weighted_gradient_sum[c] += weighted;
+        }
+    }
+
+    for(size_t c = 0; c < channels; ++c) {
+        this->beta_gradients[c] += this->gradient_sum[c];
+        this->gamma_gradients[c] += this->weighted_gradient_sum[c];
+    }
+
+    if(input_gradient == nullptr)
+        return;
+
+    for(size_t b = 0; b < batch; ++b) {
+        const double* x = input + b * sample_size;
+        const double* g = dy + b * sample_size;
+        double* dx = input_gradient + b * sample_size;
+
+        for(size_t c = 0; c < channels; ++c) {
+            const double* in = x + c * spatial;
+            const double* grad = g + c * spatial;
+            double* out = dx + c * spatial;
+            const double center = this->batch_mean[c];
+            const double inv = this->batch_inverse_std[c];
+            const double a = this->gamma[c] * inv;
+
+            if(!this->training) {
+                for(size_t s = 0; s < spatial; ++s)
+                    out[s] = a * grad[s];
+
+                continue;
+            }
+
+            const double mean_dy = this->gradient_sum[c] / count;
+            const double mean_dy_xhat = this->weighted_gradient_sum[c] / count;
+
+            for(size_t s = 0; s < spatial; ++s)
+                out[s] = a * (grad[s] - mean_dy - (in[s] - center) * inv * mean_dy_xhat);
+        }
+    }
+}
+
+void BatchNormLayer::update(double learning_rate) {
+    for(size_t c = 0; c < this->gamma.size(); ++c) {
+        this->gamma[c] -= learning_rate * this->gamma_gradients[c];
+        this->beta[c] -= learning_rate * this->beta_gradients[c];
+    }
+
+    std::fill(this->gamma_gradients.begin(), this->gamma_gradients.end(), 0.0);
+    std::fill(this->beta_gradients.begin(), this->beta_gradients.end(), 0.0);
+}
+
+size_t BatchNormLayer::parameter_count() const noexcept {
+    return this->gamma.size() + this->beta.size();
+}
+
+void BatchNormLayer::save(std::ostream& stream) const {
+    ModelStream::write(stream, this->momentum);
+    ModelStream::write(stream, this->epsilon);
+    ModelStream::write_array(stream, this->gamma);
+    ModelStream::write_array(stream, this->beta);
+    ModelStream::write_array(stream, this->running_mean);
+    ModelStream::write_array(stream, this->running_variance);
+}
+
+std::vector<double> BatchNormLayer::folded_scale() const {
+    std::vector<double> folded(this->gamma.size());
+
+    for(size_t c = 0; c < folded.size(); ++c)
+        folded[c] = this->gamma[c] / std::sqrt(this->running_variance[c] + this->epsilon);
+
+    return folded;
+}
+
+std::vector<double> BatchNormLayer::folded_shift() const {
+    const std::vector<double> folded_scale = this->folded_scale();
+    std::vector<double> folded(folded_scale.size());
+
+    for(size_t c = 0; c < folded.size(); ++c)
+        folded[c] = this->beta[c] - this->running_mean[c] * folded_scale[c];
+
+    return folded;
+}
+
+}
@@ -0,0 +1,285 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/block_sparse_dense_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+size_t block_count(size_t n_in, size_t n_out, size_t block_rows, size_t block_cols) {
+    return ((n_in + block_rows - 1) / block_rows) * ((n_out + block_cols - 1) / block_cols);
+}
+
+}
+
+BlockSparseDenseLayer::BlockSparseDenseLayer(
+    const TensorShape& _input_shape,
+    BlockSparseMatrix&& _weights,
+    std::vector<double>&& _biases
+) : Layer(_input_shape, TensorShape{_weights.cols, 1, 1}),
+    weights(std::move(_weights)),
+    biases(std::move(_biases)),
+    weight_gradients(this->weights.values.size(), 0.0),
+    bias_gradients(this->biases.size(), 0.0),
+    activation_gradients() { }
+
+BlockSparseDenseLayer::BlockSparseDenseLayer(
+    const TensorShape& _input_shape,
+    size_t outputs,
+    double density,
+    size_t block_rows,
+    size_t block_cols
+) : Layer(_input_shape, TensorShape{outputs, 1, 1}),
+    weights(),
+    biases(outputs, 0.0),
+    weight_gradients(),
+    bias_gradients(outputs, 0.0),
+    activation_gradients()
+{
+    if(!(density > 0.0 && density <= 1.0))
+        throw std::invalid_argument("Block-sparse layer density must be in (0, 1].");
+
+    if(outputs == 0 || outputs > UINT32_MAX || !BlockSparseMatrix::valid_block_shape(block_rows, block_cols))
+        throw std::invalid_argument("Invalid block-sparse layer shape.");
+
+    // The fan-in is scaled by the density to keep the output variance of a
+    // dense layer; random weights make the kept blocks a random pattern.
+    const size_t n_in = _input_shape.size();
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(
+        0.0,
+        1.0 / std::sqrt(std::max(static_cast<double>(n_in) * density, 1.0))
+    );
+
+    std::vector<double> dense(n_in * outputs);
+    for(double& weight : dense)
+        weight = dist(gen);
+
+    const size_t total = block_count(n_in, outputs, block_rows, block_cols);
+    this->weights = BlockSparseMatrix::from_dense(
+        dense.data(),
+        n_in,
+        outputs,
+        block_rows,
+        block_cols,
+        std::max<size_t>(static_cast<size_t>(std::llround(density * static_cast<double>(total))), 1)
+    );
+    this->weight_gradients.assign(this->weights.values.size(), 0.0);
+}
+
+std::unique_ptr<BlockSparseDenseLayer> BlockSparseDenseLayer::prune(
+    const TensorShape& _input_shape,
+    const std::vector<double>& dense_weights,
+    const std::vector<double>& dense_biases,
+    double sparsity,
+    size_t block_rows,
+    size_t block_cols
+) {
+    if(!(sparsity >= 0.0 && sparsity < 1.0))
+        throw std::invalid_argument("Block-sparse pruning sparsity must be in [0, 1).");
+
+    const size_t n_in = _input_shape.size(), n_out = dense_biases.size();
+    if(n_out == 0 || n_out > UINT32_MAX || dense_weights.size() != n_in * n_out)
+        throw std::invalid_argument("Dense weights do not match the block-sparse layer shape.");
+
+    const size_t total = block_count(n_in, n_out, block_rows, block_cols);
+    const size_t keep = std::max<size_t>(
+        total - static_cast<size_t>(std::llround(sparsity * static_cast<double>(total))),
+        1
+    );
+
+    return std::unique_ptr<BlockSparseDenseLayer>(new BlockSparseDenseLayer(
+        _input_shape,
+        BlockSparseMatrix::from_dense(dense_weights.data(), n_in, n_out, block_rows, block_cols, keep),
+        std::vector<double>(dense_biases)
+    ));
+}
+
+std::unique_ptr<BlockSparseDenseLayer> BlockSparseDenseLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    BlockSparseMatrix matrix;
+    matrix.rows = _input_shape.size();
+    matrix.cols = ModelStream::read_size(stream);
+    matrix.block_rows = ModelStream::read_size(stream);
+    matrix.block_cols = ModelStream::read_size(stream);
+
+    const size_t blocks = ModelStream::read_size(stream);
+    if(matrix.cols == 0 || matrix.cols > UINT32_MAX ||
+        !BlockSparseMatrix::valid_block_shape(matrix.block_rows, matrix.block_cols) ||
+        static_cast<uint64_t>(matrix.tile_count()) * matrix.block_cols >
+            ModelStream::max_elements / (static_cast<uint64_t>(matrix.block_row_count()) * matrix.block_rows) ||
+        blocks > matrix.block_row_count() * matrix.tile_count())
+        throw ModelLoaderException("Invalid *.chisei file format, bad block-sparse layer.");
+
+    matrix.tile_offsets.resize(matrix.tile_count() + 1);
+    matrix.block_indices.resize(blocks);
+    matrix.values.resize(blocks * matrix.block_rows * matrix.block_cols);
+
+    ModelStream::read_array(stream, matrix.tile_offsets);
+    ModelStream::read_array(stream, matrix.block_indices);
+    ModelStream::read_array(stream, matrix.values);
+
+    if(matrix.tile_offsets.front() != 0 || matrix.tile_offsets.back() != blocks)
+        throw ModelLoaderException("Invalid *.chisei file format, bad block-sparse layer.");
+
+    for(size_t tile = 0; tile < matrix.tile_count(); ++tile) {
+        if(matrix.tile_offsets[tile] > matrix.tile_offsets[tile + 1])
+            throw ModelLoaderException("Invalid *.chisei file format, bad block-sparse layer.");
+
+        for(size_t k = matrix.tile_offsets[tile]; k < matrix.tile_offsets[tile + 1]; ++k)
+            if(matrix.block_indices[k] >= matrix.block_row_count() ||
+                (k > matrix.tile_offsets[tile] && matrix.block_indices[k] <= matrix.block_indices[k - 1]))
+                throw ModelLoaderException("Invalid *.chisei file format, bad block-sparse layer.");
+    }
+
+    std::vector<double> stored_biases(matrix.cols);
+    ModelStream::read_array(stream, stored_biases);
+
+    return std::unique_ptr<BlockSparseDenseLayer>(new BlockSparseDenseLayer(
+        _input_shape,
+        std::move(matrix),
+        std::move(stored_biases)
+    ));
+}
+
+LayerType BlockSparseDenseLayer::type() const noexcept {
+    return LayerType::BlockSparseDense;
+}
+
+bool BlockSparseDenseLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void BlockSparseDenseLayer::prepare(size_t max_batch) {
+    if(this->has_fused_activation && this->activation_gradients.size() < max_batch * this->output_shape.size())
+        this->activation_gradients.resize(max_batch * this->output_shape.size());
+}
+
+void BlockSparseDenseLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t n_out = this->output_shape.size();
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        std::copy(this->biases.begin(), this->biases.end(), output + sample * n_out);
+    this->weights.multiply_add(input, output, batch);
+
+    if(this->fused_approximation)
+        this->fused_approximation->apply(output, output, batch * n_out);
+    else if(this->has_fused_activation)
+        ActivationLayer::apply(this->fused_activation, output, output, batch * n_out);
+}
+
+void BlockSparseDenseLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t n_out = this->output_shape.size();
+
+    if(this->has_fused_activation) {
+        this->prepare(batch);
+        ActivationLayer::apply_derivative(
+            this->fused_activation,
+            output,
+            output_gradient,
+            this->activation_gradients.data(),
+            batch * n_out
+        );
+        output_gradient = this->activation_gradients.data();
+    }
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        for(size_t j = 0; j < n_out; ++j)
+            this->bias_gradients[j] += output_gradient[sample * n_out + j];
+
+    this->weights.accumulate_gradient(input, output_gradient, this->weight_gradients.data(), batch);
+    if(input_gradient != nullptr)
+        this->weights.multiply_transposed(output_gradient, input_gradient, batch);
+}
+
+void BlockSparseDenseLayer::update(double learning_rate) {
+    for(size_t k = 0; k < this->weights.values.size(); ++k)
+        this->weights.values[k] -= learning_rate * this->weight_gradients[k];
+
+    for(size_t j = 0; j < this->biases.size(); ++j)
+        this->biases[j] -= learning_rate * this->bias_gradients[j];
+
+    std::fill(this->weight_gradients.begin(), this->weight_gradients.end(), 0.0);
+    std::fill(this->bias_gradients.begin(), this->bias_gradients.end(), 0.0);
+}
+
+size_t BlockSparseDenseLayer::parameter_count() const noexcept {
+    return this->weights.values.size() + this->biases.size();
+}
+
+std::vector<double> BlockSparseDenseLayer::weight_values() const {
+    std::vector<double> dense(this->weights.rows * this->weights.cols);
+    this->weights.to_dense(dense.data());
+
+    return dense;
+}
+
+void BlockSparseDenseLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->output_shape.size());
+    ModelStream::write_size(stream, this->weights.block_rows);
+    ModelStream::write_size(stream, this->weights.block_cols);
+    ModelStream::write_size(stream, this->weights.blocks());
+    ModelStream::write_array(stream, this->weights.tile_offsets);
+    ModelStream::write_array(stream, this->weights.block_indices);
+    ModelStream::write_array(stream, this->weights.values);
+    ModelStream::write_array(stream, this->biases);
+}
+
+const BlockSparseMatrix& BlockSparseDenseLayer::get_weights() const noexcept {
+    return this->weights;
+}
+
+std::vector<double>& BlockSparseDenseLayer::get_biases() noexcept {
+    return this->biases;
+}
+
+}
@@ -0,0 +1,385 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/block_sparse_matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#if defined(__AVX__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+constexpr size_t max_block_rows = 256;
+
+// Each micro-kernel holds the `BC` running sums of one output tile in vector
+// registers and streams the tile's blocks through them, one broadcast input
+// and one block row of weights at a time.
+
+#if defined(__AVX512F__)
+template<size_t V>
+void block_sums_avx512(
+    const BlockSparseMatrix& matrix,
+    size_t begin,
+    size_t end,
+    const double* input,
+    double* sums
+) {
+    constexpr size_t BC = V * 8;
+    const size_t block_size = matrix.block_rows * BC;
+
+    __m512d sum[V];
+    for(size_t v = 0; v < V; ++v)
+        sum[v] = _mm512_loadu_pd(sums + v * 8);
+
+    for(size_t k = begin; k < end; ++k) {
+        const size_t row = static_cast<size_t>(matrix.block_indices[k]) * matrix.block_rows;
+        const size_t count = std::min(matrix.block_rows, matrix.rows - row);
+        const double* block = matrix.values.data() + k * block_size;
+
+        for(size_t r = 0; r < count; ++r) {
+            const __m512d value = _mm512_set1_pd(input[row + r]);
+
+            for(size_t v = 0; v < V; ++v)
+                sum[v] = _mm512_fmadd_pd(value, _mm512_loadu_pd(block + r * BC + v * 8), sum[v]);
+        }
+    }
+
+    for(size_t v = 0; v < V; ++v)
+        _mm512_storeu_pd(sums + v * 8, sum[v]);
+}
+#endif
+
+#if defined(__AVX__)
+template<size_t V>
+void block_sums_avx(
+    const BlockSparseMatrix& matrix,
+    size_t begin,
+    size_t end,
+    const double* input,
+    double* sums
+) {
+    constexpr size_t BC = V * 4;
+    const size_t block_size = matrix.block_rows * BC;
+
+    #if defined(__FMA__)
+    #   define CHISEI_BLOCK_FMA(a, b, c) _mm256_fmadd_pd(a, b, c)
+    #else
+    #   define CHISEI_BLOCK_FMA(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+    #endif
+
+    __m256d sum[V];
+    for(size_t v = 0; v < V; ++v)
+        sum[v] = _mm256_loadu_pd(sums + v * 4);
+
+    for(size_t k = begin; k < end; ++k) {
+        const size_t row = static_cast<size_t>(matrix.block_indices[k]) * matrix.block_rows;
+        const size_t count = std::min(matrix.block_rows, matrix.rows - row);
+        const double* block = matrix.values.data() + k * block_size;
+
+        for(size_t r = 0; r < count; ++r) {
+            const __m256d value = _mm256_set1_pd(input[row + r]);
+
+            for(size_t v = 0; v < V; ++v)
+                sum[v] = CHISEI_BLOCK_FMA(value, _mm256_loadu_pd(block + r * BC + v * 4), sum[v]);
+        }
+    }
+
+    #undef CHISEI_BLOCK_FMA
+
+    for(size_t v = 0; v < V; ++v)
+        _mm256_storeu_pd(sums + v * 4, sum[v]);
+}
+#endif
+
+template<size_t BC>
+void block_sums(
+    const BlockSparseMatrix& matrix,
+    size_t begin,
+    size_t end,
+    const double* input,
+    double* sums
+) {
+    #if defined(__AVX512F__)
+    if constexpr(BC >= 8) {
+        block_sums_avx512<BC / 8>(matrix, begin, end, input, sums);
+        return;
+    }
+    #endif
+
+    #if defined(__AVX__)
+    block_sums_avx<BC / 4>(matrix, begin, end, input, sums);
+    #else
+    const size_t block_size = matrix.block_rows * BC;
+
+    for(size_t k = begin; k < end; ++k) {
+        const size_t row = static_cast<size_t>(matrix.block_indices[k]) * matrix.block_rows;
+        const size_t count = std::min(matrix.block_rows, matrix.rows - row);
+        const double* block = matrix.values.data() + k * block_size;
+
+        for(size_t r = 0; r < count; ++r) {
+            const double value = input[row + r];
+
+            for(size_t c = 0; c < BC; ++c)
+                sums[c] += value * block[r * BC + c];
+        }
+    }
+    #endif
+}
+
+template<size_t BC>
+void tile_product(
+    const BlockSparseMatrix& matrix,
+    size_t tile,
+    const double* input,
+    double* output,
+    size_t batch
+) {
+    const size_t begin = matrix.tile_offsets[tile], end = matrix.tile_offsets[tile + 1];
+    if(begin == end)
+        return;
+
+    const size_t first = tile * BC;
+    const size_t valid = std::min(BC, matrix.cols - first);
+
+    // The tile's blocks stay in cache while every sample streams through them.
+    for(size_t sample = 0; sample < batch; ++sample) {
+        double* y = output + sample * matrix.cols + first;
+        double sums[BC] = {};
+
+        std::copy(y, y + valid, sums);
+        block_sums<BC>(matrix, begin, end, input + sample * matrix.rows, sums);
+        std::copy(sums, sums + valid, y);
+    }
+}
+
+}
+
+bool BlockSparseMatrix::valid_block_shape(size_t block_rows, size_t block_cols) noexcept {
+    return block_rows >= 1 && block_rows <= max_block_rows &&
+        (block_cols == 4 || block_cols == 8 || block_cols == 16);
+}
+
+BlockSparseMatrix BlockSparseMatrix::from_dense(
+    const double* dense,
+    size_t rows,
+    size_t cols,
+    size_t block_rows,
+    size_t block_cols,
+    size_t keep
+) {
+    if(!valid_block_shape(block_rows, block_cols))
+        throw std::invalid_argument("Unsupported block shape for a block-sparse matrix.");
+
+    BlockSparseMatrix matrix;
+    matrix.rows = rows;
+    matrix.cols = cols;
+    matrix.block_rows = block_rows;
+    matrix.block_cols = block_cols;
+
+    // Candidates are numbered tile by tile, so sorting the kept ones by number
+    // groups them by tile with their block rows in order.
+    const size_t row_blocks = matrix.block_row_count(), tiles = matrix.tile_count();
+    std::vector<double> energy(row_blocks * tiles, 0.0);
+
+    for(size_t i = 0; i < rows; ++i)
+        for(size_t j = 0; j < cols; ++j)
+            energy[(j / block_cols) * row_blocks + i / block_rows] +=
+                dense[i * cols + j] * dense[i * cols + j];
+
+    std::vector<size_t> order(energy.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+
+    keep = std::min(keep, order.size());
+    std::nth_element(
+        order.begin(),
+        order.begin() + static_cast<std::ptrdiff_t>(keep),
+        order.end(),
+        [&energy](size_t a, size_t b) {
+            return energy[a] > energy[b];
+        }
+    );
+    order.resize(keep);
+    std::sort(order.begin(), order.end());
+
+    matrix.tile_offsets.assign(tiles + 1, 0);
+    matrix.block_indices.resize(keep);
+    matrix.values.assign(keep * block_rows * block_cols, 0.0);
+
+    for(size_t k = 0; k < keep; ++k) {
+        const size_t tile = order[k] / row_blocks, block_row = order[k] % row_blocks;
+        double* block = matrix.values.data() + k * block_rows * block_cols;
+
+        ++matrix.tile_offsets[tile + 1];
+        matrix.block_indices[k] = static_cast<uint32_t>(block_row);
+
+        for(size_t r = 0; r < block_rows && block_row * block_rows + r < rows; ++r)
+            for(size_t c = 0; c < block_cols && tile * block_cols + c < cols; ++c)
+                block[r * block_cols + c] =
+                    dense[(block_row * block_rows + r) * cols + tile * block_cols + c];
+    }
+
+    for(size_t tile = 0; tile < tiles; ++tile)
+        matrix.tile_offsets[tile + 1] += matrix.tile_offsets[tile];
+
+    return matrix;
+}
+
+double BlockSparseMatrix::density() const noexcept {
+    const size_t total = this->block_row_count() * this->tile_count();
+    return total == 0 ? 0.0 : static_cast<double>(this->blocks()) / static_cast<double>(total);
+}
+
+void BlockSparseMatrix::to_dense(double* dense) const {
+    std::fill(dense, dense + this->rows * this->cols, 0.0);
+
+    for(size_t tile = 0; tile < this->tile_count(); ++tile)
+        for(size_t k = this->tile_offsets[tile]; k < this->tile_offsets[tile + 1]; ++k) {
+            const size_t row = static_cast<size_t>(this->block_indices[k]) * this->block_rows;
+            const double* block = this->values.data() + k * this->block_rows * this->block_cols;
+
+            for(size_t r = 0; r < this->block_rows && row + r < this->rows; ++r)
+                for(size_t c = 0; c < this->block_cols && tile * this->block_cols + c < this->cols; ++c)
+                    dense[(row + r) * this->cols + tile * this->block_cols + c] =
+                        block[r * this->block_cols + c];
+        }
+}
+
+void BlockSparseMatrix::multiply_add(const double* input, double* output, size_t batch) const {
+    const size_t tiles = this->tile_count();
+    const bool parallel = batch * this->values.size() >= 65536;
+    (void) parallel;
+
+    // Pruning leaves tiles with very different block counts.
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for(size_t tile = 0; tile < tiles; ++tile)
+        switch(this->block_cols) {
+            case 4:
+                tile_product<4>(*this, tile, input, output, batch);
+                break;
+
+            case 8:
+                tile_product<8>(*this, tile, input, output, batch);
+                break;
+
+            case 16:
+            default:
+                tile_product<16>(*this, tile, input, output, batch);
+                break;
+        }
+}
+
+void BlockSparseMatrix::multiply_transposed(
+    const double* gradient,
+    double* output,
+    size_t batch
+) const {
+    const size_t block_size = this->block_rows * this->block_cols;
+    const bool parallel = batch * this->values.size() >= 65536;
+    (void) parallel;
+
+    std::fill(output, output + batch * this->rows, 0.0);
+
+    #pragma omp parallel for schedule(static) if(parallel)
+    for(size_t sample = 0; sample < batch; ++sample) {
+        const double* dy = gradient + sample * this->cols;
+        double* dx = output + sample * this->rows;
+
+        for(size_t tile = 0; tile < this->tile_count(); ++tile) {
+            const size_t first = tile * this->block_cols;
+            const size_t valid = std::min(this->block_cols, this->cols - first);
+
+            for(size_t k = this->tile_offsets[tile]; k < this->tile_offsets[tile + 1]; ++k) {
+                const size_t row = static_cast<size_t>(this->block_indices[k]) * this->block_rows;
+                const size_t count = std::min(this->block_rows, this->rows - row);
+                const double* block = this->values.data() + k * block_size;
+
+                for(size_t r = 0; r < count; ++r) {
+                    double sum = 0.0;
+
+                    for(size_t c = 0; c < valid; ++c)
+                        sum += block[r * this->block_cols + c] * dy[first + c];
+                    dx[row + r] += sum;
+                }
+            }
+        }
+    }
+}
+
+void BlockSparseMatrix::accumulate_gradient(
+    const double* input,
+    const double* gradient,
+    double* block_gradients,
+    size_t batch
+) const {
+    const size_t tiles = this->tile_count();
+    const size_t block_size = this->block_rows * this->block_cols;
+    const bool parallel = batch * this->values.size() >= 65536;
+    (void) parallel;
+
+    // Every block belongs to one tile, so tiles update disjoint gradients.
+    // Padding never receives a gradient and stays zero.
+    #pragma omp parallel for schedule(dynamic) if(parallel)
+    for(size_t tile = 0; tile < tiles; ++tile) {
+        const size_t first = tile * this->block_cols;
+        const size_t valid = std::min(this->block_cols, this->cols - first);
+
+        for(size_t k = this->tile_offsets[tile]; k < this->tile_offsets[tile + 1]; ++k) {
+            const size_t row = static_cast<size_t>(this->block_indices[k]) * this->block_rows;
+            const size_t count = std::min(this->block_rows, this->rows - row);
+            double* block = block_gradients + k * block_size;
+
+            for(size_t sample = 0; sample < batch; ++sample) {
+                const double* x = input + sample * this->rows + row;
+                const double* dy = gradient + sample * this->cols + first;
+
+                for(size_t r = 0; r < count; ++r) {
+                    if(std::fpclassify(x[r]) == FP_ZERO)
+                        continue;
+
+                    for(size_t c = 0; c < valid; ++c)
+                        block[r * this->block_cols + c] += x[r] * dy[c];
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,390 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/conv2d_layer.hpp>
+#include <chisei/dense_kernels.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+TensorShape convolution_output(
+    const TensorShape& input,
+    size_t filters,
+    size_t kernel_size,
+    size_t stride,
+    size_t padding
+) {
+    if(kernel_size == 0 || stride == 0 || filters == 0 ||
+        input.height + 2 * padding < kernel_size ||
+        input.width + 2 * padding < kernel_size)
+        throw std::invalid_argument("Convolution kernel does not fit the padded input.");
+
+    return TensorShape{
+        filters,
+        (input.height + 2 * padding - kernel_size) / stride + 1,
+        (input.width + 2 * padding - kernel_size) / stride + 1
+    };
+}
+
+}
+
+Conv2DLayer::Conv2DLayer(
+    const TensorShape& _input_shape,
+    size_t filters,
+    size_t _kernel_size,
+    size_t _stride,
+    size_t _padding
+) : Layer(
+        _input_shape,
+        convolution_output(_input_shape, filters, _kernel_size, _stride, _padding)
+    ),
+    kernel_size(_kernel_size),
+    stride(_stride),
+    padding(_padding),
+    weights(filters * _input_shape.channels * _kernel_size * _kernel_size),
+    biases(filters, 0.0),
+    weight_gradients(weights.size(), 0.0),
+    bias_gradients(filters, 0.0),
+    columns(),
+    column_gradients(),
+    activation_gradients()
+{
+    const size_t fan_in = _input_shape.channels * _kernel_size * _kernel_size;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(0.0, 1.0 / std::sqrt(static_cast<double>(fan_in)));
+
+    for(double& weight : this->weights)
+        weight = dist(gen);
+}
+
+std::unique_ptr<Conv2DLayer> Conv2DLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const size_t filters = ModelStream::read_size(stream);
+    const size_t kernel = ModelStream::read_size(stream);
+    const size_t step = ModelStream::read_size(stream);
+    const size_t pad = ModelStream::read_size(stream);
+
+    if(filters > (size_t(1) << 20) || kernel > (size_t(1) << 10) || pad > (size_t(1) << 10))
+        throw ModelLoaderException("Invalid *.chisei file format, bad convolution layer.");
+
+    // The kernel weights and the padded output bound what forward indexes;
+    // both are checked by division so neither product can wrap.
+    const uint64_t limit = ModelStream::max_elements;
+    const uint64_t fan_in = static_cast<uint64_t>(_input_shape.channels) * kernel * kernel;
+    const uint64_t padded = (static_cast<uint64_t>(_input_shape.height) + 2 * pad) *
+        (static_cast<uint64_t>(_input_shape.width) + 2 * pad);
+
+    if(filters > limit / std::max<uint64_t>(fan_in, 1) ||
+        filters > limit / std::max<uint64_t>(padded, 1))
+        throw ModelLoaderException("Invalid *.chisei file format, bad convolution layer.");
+
+    std::unique_ptr<Conv2DLayer> layer;
+    try {
+        layer.reset(new Conv2DLayer(_input_shape, filters, kernel, step, pad));
+    }
+    catch(const std::invalid_argument&) {
+        throw ModelLoaderException("Invalid *.chisei file format, bad convolution layer.");
+    }
+
+    ModelStream::read_array(stream, layer->weights);
+    ModelStream::read_array(stream, layer->biases);
+
+    return layer;
+}
+
+LayerType Conv2DLayer::type() const noexcept {
+    return LayerType::Conv2D;
+}
+
+bool Conv2DLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void Conv2DLayer::prepare(size_t max_batch) {
+    (void) max_batch;
+
+    const size_t pixels = this->output_shape.height * this->output_shape.width;
+    const size_t depth = this->input_shape.channels * this->kernel_size * this->kernel_size;
+
+    if(!this->is_pointwise()) {
+        this->columns.resize(depth * pixels);
+        this->column_gradients.resize(depth * pixels);
+    }
+
+    if(this->has_fused_activation)
+        this->activation_gradients.resize(this->output_shape.size());
+}
+
+bool Conv2DLayer::is_pointwise() const noexcept {
+    return this->kernel_size == 1 && this->stride == 1 && this->padding == 0;
+}
+
+void Conv2DLayer::im2col(const double* input) {
+    const size_t in_h = this->input_shape.height, in_w = this->input_shape.width;
+    const size_t out_h = this->output_shape.height, out_w = this->output_shape.width;
+    const size_t k = this->kernel_size;
+
+    this->columns.resize(this->input_shape.channels * k * k * out_h * out_w);
+    double* column = this->columns.data();
+
+    for(size_t c = 0; c < this->input_shape.channels; ++c) {
+        const double* channel = input + c * in_h * in_w;
+
+        for(size_t ky = 0; ky < k; ++ky)
+            for(size_t kx = 0; kx < k; ++kx)
+                for(size_t oy = 0; oy < out_h; ++oy) {
+                    const size_t y = oy * this->stride + ky;
+
+                    if(y < this->padding || y - this->padding >= in_h) {
+                        std::fill(column, column + out_w, 0.0);
+                        column += out_w;
+                        continue;
+                    }
+
+                    const double* row = channel + (y - this->padding) * in_w;
+                    for(size_t ox = 0; ox < out_w; ++ox) {
+                        const size_t x = ox * this->stride + kx;
+
+                        *column++ = x < this->padding || x - this->padding >= in_w ?
+                            0.0 : row[x - this->padding];
+                    }
+                }
+    }
+}
+
+void Conv2DLayer::col2im(double* input_gradient) const {
+    const size_t in_h = this->input_shape.height, in_w = this->input_shape.width;
+    const size_t out_h = this->output_shape.height, out_w = this->output_shape.width;
+    const size_t k = this->kernel_size;
+
+    std::fill(input_gradient, input_gradient + this->input_shape.size(), 0.0);
+    const double* column = this->column_gradients.data();
+
+    for(size_t c = 0; c < this->input_shape.channels; ++c) {
+        double* channel = input_gradient + c * in_h * in_w;
+
+        for(size_t ky = 0; ky < k; ++ky)
+            for(size_t kx = 0; kx < k; ++kx)
+                for(size_t oy = 0; oy < out_h; ++oy) {
+                    const size_t y = oy * this->stride + ky;
+
+                    if(y < this->padding || y - this->padding >= in_h) {
+                        column += out_w;
+                        continue;
+                    }
+
+                    double* row = channel + (y - this->padding) * in_w;
+                    for(size_t ox = 0; ox < out_w; ++ox, ++column) {
+                        const size_t x = ox * this->stride + kx;
+
+                        if(x >= this->padding && x - this->padding < in_w)
+                            row[x - this->padding] += *column;
+                    }
+                }
+    }
+}
+
+void Conv2DLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t filters = this->output_shape.channels;
+    const size_t pixels = this->output_shape.height * this->output_shape.width;
+    const size_t depth = this->input_shape.channels * this->kernel_size * this->kernel_size;
+
+    for(size_t sample = 0; sample < batch; ++sample) {
+        const double* x = input + sample * this->input_shape.size();
+        double* y = output + sample * this->output_shape.size();
+
+        const double* unfolded = x;
+        if(!this->is_pointwise()) {
+            this->im2col(x);
+            unfolded = this->columns.data();
+        }
+
+        DenseKernels::gemm(
+            false, false,
+            filters, pixels, depth,
+            1.0,
+            this->weights.data(), depth,
+            unfolded, pixels,
+            0.0,
+            y, pixels
+        );
+
+        for(size_t f = 0; f < filters; ++f) {
+            double* channel = y + f * pixels;
+            const double bias = this->biases[f];
+
+            for(size_t p = 0; p < pixels; ++p)
+                channel[p] += bias;
+        }
+
+        if(this->fused_approximation)
+            this->fused_approximation->apply(y, y, this->output_shape.size());
+        else if(this->has_fused_activation)
+            ActivationLayer::apply(this->fused_activation, y, y, this->output_shape.size());
+    }
+}
+
+void Conv2DLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t filters = this->output_shape.channels;
+    const size_t pixels = this->output_shape.height * this->output_shape.width;
+    const size_t depth = this->input_shape.channels * this->kernel_size * this->kernel_size;
+
+    for(size_t sample = 0; sample < batch; ++sample) {
+        const double* x = input + sample * this->input_shape.size();
+        const double* dy = output_gradient + sample * this->output_shape.size();
+
+        if(this->has_fused_activation) {
+            this->activation_gradients.resize(this->output_shape.size());
+            ActivationLayer::apply_derivative(
+                this->fused_activation,
+                output + sample * this->output_shape.size(),
+                dy,
+                this->activation_gradients.data(),
+                this->output_shape.size()
+            );
+            dy = this->activation_gradients.data();
+        }
+
+        const double* unfolded = x;
+        if(!this->is_pointwise()) {
+            this->im2col(x);
+            unfolded = this->columns.data();
+        }
+
+        DenseKernels::gemm(
+            false, true,
+            filters, depth, pixels,
+            1.0,
+            dy, pixels,
+            unfolded, pixels,
+            1.0,
+            this->weight_gradients.data(), depth
+        );
+
+        for(size_t f = 0; f < filters; ++f) {
+            const double* channel = dy + f * pixels;
+            double sum = 0.0;
+
+            for(size_t p = 0; p < pixels; ++p)
+                sum += channel[p];
+            this->bias_gradients[f] += sum;
+        }
+
+        if(input_gradient == nullptr)
+            continue;
+
+        double* dx = input_gradient + sample * this->input_shape.size();
+        if(this->is_pointwise()) {
+            DenseKernels::gemm(
+                true, false,
+                depth, pixels, filters,
+                1.0,
+                this->weights.data(), depth,
+                dy, pixels,
+                0.0,
+                dx, pixels
+            );
+            continue;
+        }
+
+        this->column_gradients.resize(depth * pixels);
+        DenseKernels::gemm(
+            true, false,
+            depth, pixels, filters,
+            1.0,
+            this->weights.data(), depth,
+            dy, pixels,
+            0.0,
+            this->column_gradients.data(), pixels
+        );
+        this->col2im(dx);
+    }
+}
+
+void Conv2DLayer::update(double learning_rate) {
+    for(size_t i = 0; i < this->weights.size(); ++i)
+        this->weights[i] -= learning_rate * this->weight_gradients[i];
+
+    for(size_t f = 0; f < this->biases.size(); ++f)
+        this->biases[f] -= learning_rate * this->bias_gradients[f];
+
+    std::fill(this->weight_gradients.begin(), this->weight_gradients.end(), 0.0);
+    std::fill(this->bias_gradients.begin(), this->bias_gradients.end(), 0.0);
+}
+
+size_t Conv2DLayer::parameter_count() const noexcept {
+    return this->weights.size() + this->biases.size();
+}
+
+std::vector<double> Conv2DLayer::weight_values() const {
+    return this->weights;
+}
+
+void Conv2DLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->output_shape.channels);
+    ModelStream::write_size(stream, this->kernel_size);
+    ModelStream::write_size(stream, this->stride);
+    ModelStream::write_size(stream, this->padding);
+    ModelStream::write_array(stream, this->weights);
+    ModelStream::write_array(stream, this->biases);
+}
+
+std::vector<double>& Conv2DLayer::get_weights() noexcept {
+    return this->weights;
+}
+
+std::vector<double>& Conv2DLayer::get_biases() noexcept {
+    return this->biases;
+}
+
+}
@@ -0,0 +1,243 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/crc32c.hpp>
+
+#include <cstring>
+
+#if defined(__SSE4_2__) && defined(__x86_64__)
+#   define CHISEI_CRC32C_SSE42 1
+#   include <nmmintrin.h>
+#elif defined(__ARM_FEATURE_CRC32) && defined(__aarch64__)
+#   define CHISEI_CRC32C_ARMV8 1
+#   include <arm_acle.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+constexpr uint32_t polynomial = 0x82F63B78u;
+
+#if defined(CHISEI_CRC32C_SSE42) || defined(CHISEI_CRC32C_ARMV8)
+
+// The CRC instruction has a latency of several cycles but a throughput of one
+// per cycle, so three independent streams run over adjacent blocks and are
+// combined by shifting the earlier ones over the later blocks' length.
+constexpr size_t long_block = 8192;
+constexpr size_t short_block = 256;
+
+inline uint32_t crc_word(uint32_t state, const unsigned char* bytes) noexcept {
+    uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+
+    #if defined(CHISEI_CRC32C_SSE42)
+    return static_cast<uint32_t>(_mm_crc32_u64(state, word));
+    #else
+    return __crc32cd(state, word);
+    #endif
+}
+
+inline uint32_t crc_byte(uint32_t state, unsigned char byte) noexcept {
+    #if defined(CHISEI_CRC32C_SSE42)
+    return _mm_crc32_u8(state, byte);
+    #else
+    return __crc32cb(state, byte);
+    #endif
+}
+
+// Tables applying the operator that appends a fixed number of zero bytes.
+struct ShiftTable {
+    uint32_t entries[4][256] = {};
+};
+
+constexpr uint32_t gf2_times(const uint32_t* matrix, uint32_t vector) noexcept {
+    uint32_t sum = 0;
+
+    for(size_t row = 0; vector != 0; vector >>= 1, ++row)
+        if(vector & 1u)
+            sum ^= matrix[row];
+
+    return sum;
+}
+
+constexpr ShiftTable make_shift_table(size_t length) noexcept {
+    // Operator for one zero bit, then squared up to one zero byte.
+    uint32_t odd[32] = {}, even[32] = {};
+    odd[0] = polynomial;
+    for(size_t row = 1; row < 32; ++row)
+        odd[row] = uint32_t(1) << (row - 1);
+
+    for(size_t row = 0; row < 32; ++row)
+        even[row] = gf2_times(odd, odd[row]);
+    for(size_t row = 0; row < 32; ++row)
+        odd[row] = gf2_times(even, even[row]);
+    for(size_t row = 0; row < 32; ++row)
+        even[row] = gf2_times(odd, odd[row]);
+
+    // `length` is a power of two; keep squaring until it covers that many bytes.
+    for(; length > 1; length >>= 1) {
+        for(size_t row = 0; row < 32; ++row)
+            odd[row] = gf2_times(even, even[row]);
+        for(size_t row = 0; row < 32; ++row)
+            even[row] = odd[row];
+    }
+
+    ShiftTable table;
+    for(uint32_t byte = 0; byte < 256; ++byte)
+        for(size_t lane = 0; lane < 4; ++lane)
+            table.entries[lane][byte] = gf2_times(even, byte << (8 * lane));
+
+    return table;
+}
+
+constexpr ShiftTable long_shift = make_shift_table(long_block);
+constexpr ShiftTable short_shift = make_shift_table(short_block);
+
+inline uint32_t shift(const ShiftTable& table, uint32_t state) noexcept {
+    return table.entries[0][state & 0xFFu] ^ table.entries[1][(state >> 8) & 0xFFu] ^
+        table.entries[2][(state >> 16) & 0xFFu] ^ table.entries[3][state >> 24];
+}
+
+inline uint32_t interleave(
+    uint32_t state,
+    const unsigned char*& bytes,
+    size_t& length,
+    size_t block,
+    const ShiftTable& table
+) noexcept {
+    for(; length >= 3 * block; length -= 3 * block, bytes += 3 * block) {
+        uint32_t second = 0, third = 0;
+
+        for(size_t offset = 0; offset < block; offset += 8) {
+            state = crc_word(state, bytes + offset);
+            second = crc_word(second, bytes + block + offset);
+            third = crc_word(third, bytes + 2 * block + offset);
+        }
+
+        state = shift(table, state) ^ second;
+        state = shift(table, state) ^ third;
+    }
+
+    return state;
+}
+
+#else
+
+// Slice-by-8 tables for the reflected Castagnoli polynomial.
+struct SliceTables {
+    uint32_t entries[8][256] = {};
+};
+
+constexpr SliceTables make_tables() noexcept {
+    SliceTables tables;
+
+    for(uint32_t byte = 0; byte < 256; ++byte) {
+        uint32_t crc = byte;
+
+        for(int bit = 0; bit < 8; ++bit)
+            crc = (crc >> 1) ^ (polynomial & (0u - (crc & 1u)));
+        tables.entries[0][byte] = crc;
+    }
+
+    for(uint32_t byte = 0; byte < 256; ++byte)
+        for(size_t slice = 1; slice < 8; ++slice) {
+            const uint32_t previous = tables.entries[slice - 1][byte];
+            tables.entries[slice][byte] = (previous >> 8) ^ tables.entries[0][previous & 0xFFu];
+        }
+
+    return tables;
+}
+
+constexpr SliceTables slice_tables = make_tables();
+
+#endif
+
+}
+
+uint32_t CRC32C::update(uint32_t crc, const void* data, size_t length) noexcept {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint32_t state = ~crc;
+
+    #if defined(CHISEI_CRC32C_SSE42) || defined(CHISEI_CRC32C_ARMV8)
+    state = interleave(state, bytes, length, long_block, long_shift);
+    state = interleave(state, bytes, length, short_block, short_shift);
+
+    for(; length >= 8; length -= 8, bytes += 8)
+        state = crc_word(state, bytes);
+
+    for(; length > 0; --length)
+        state = crc_byte(state, *bytes++);
+
+    #else
+    const auto& table = slice_tables.entries;
+    for(; length >= 8; length -= 8, bytes += 8) {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+
+        #if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+        #endif
+
+        const uint32_t low = static_cast<uint32_t>(word) ^ state;
+        const uint32_t high = static_cast<uint32_t>(word >> 32);
+
+        state = table[7][low & 0xFFu] ^ table[6][(low >> 8) & 0xFFu] ^
+            table[5][(low >> 16) & 0xFFu] ^ table[4][low >> 24] ^
+            table[3][high & 0xFFu] ^ table[2][(high >> 8) & 0xFFu] ^
+            table[1][(high >> 16) & 0xFFu] ^ table[0][high >> 24];
+    }
+
+    for(; length > 0; --length)
+        state = (state >> 8) ^ table[0][(state ^ *bytes++) & 0xFFu];
+    #endif
+
+    return ~state;
+}
+
+uint32_t CRC32C::compute(const void* data, size_t length) noexcept {
+    return update(0, data, length);
+}
+
+const char* CRC32C::implementation() noexcept {
+    #if defined(CHISEI_CRC32C_SSE42)
+    return "sse4.2";
+    #elif defined(CHISEI_CRC32C_ARMV8)
+    return "armv8";
+    #else
+    return "software";
+    #endif
+}
+
+}
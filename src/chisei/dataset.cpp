@@ -0,0 +1,173 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/dataset.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace chisei {
+
+size_t Dataset::Source::rows() const noexcept {
+    if(this->vectors != nullptr)
+        return this->vectors->size();
+
+    return this->doubles.data != nullptr ? this->doubles.rows : this->floats.rows;
+}
+
+size_t Dataset::Source::cols() const noexcept {
+    if(this->vectors != nullptr)
+        return this->vectors->empty() ? 0 : this->vectors->front().size();
+
+    return this->doubles.data != nullptr ? this->doubles.cols : this->floats.cols;
+}
+
+bool Dataset::Source::uniform() const noexcept {
+    if(this->vectors == nullptr)
+        return true;
+
+    const size_t width = this->cols();
+    return std::all_of(
+        this->vectors->begin(),
+        this->vectors->end(),
+        [width](const std::vector<double>& values) {
+            return values.size() == width;
+        }
+    );
+}
+
+const double* Dataset::Source::row(size_t row, double* scratch) const {
+    if(this->vectors != nullptr)
+        return (*this->vectors)[row].data();
+
+    if(this->doubles.data != nullptr)
+        return this->doubles.row(row);
+
+    const float* values = this->floats.row(row);
+    std::copy(values, values + this->floats.cols, scratch);
+
+    return scratch;
+}
+
+Dataset::Dataset(
+    const std::vector<std::vector<double>>& _inputs,
+    const std::vector<std::vector<double>>& _targets
+) : inputs(),
+    targets()
+{
+    this->inputs.vectors = &_inputs;
+    this->targets.vectors = &_targets;
+    this->check();
+}
+
+Dataset::Dataset(const MatrixView<double>& _inputs, const MatrixView<double>& _targets) :
+    inputs(),
+    targets()
+{
+    this->inputs.doubles = _inputs;
+    this->targets.doubles = _targets;
+    this->check();
+}
+
+Dataset::Dataset(const MatrixView<float>& _inputs, const MatrixView<float>& _targets) :
+    inputs(),
+    targets()
+{
+    this->inputs.floats = _inputs;
+    this->targets.floats = _targets;
+    this->check();
+}
+
+Dataset::Dataset(const MatrixView<double>& _inputs) :
+    inputs(),
+    targets()
+{
+    this->inputs.doubles = _inputs;
+}
+
+Dataset::Dataset(const MatrixView<float>& _inputs) :
+    inputs(),
+    targets()
+{
+    this->inputs.floats = _inputs;
+}
+
+void Dataset::check() const {
+    if(this->inputs.rows() != this->targets.rows())
+        throw std::invalid_argument("Dataset inputs and targets differ in size.");
+
+    if(!this->inputs.uniform() || !this->targets.uniform())
+        throw std::invalid_argument("Dataset rows differ in length.");
+}
+
+size_t Dataset::size() const noexcept {
+    return this->inputs.rows();
+}
+
+bool Dataset::empty() const noexcept {
+    return this->inputs.rows() == 0;
+}
+
+size_t Dataset::input_size() const noexcept {
+    return this->inputs.cols();
+}
+
+size_t Dataset::target_size() const noexcept {
+    return this->targets.cols();
+}
+
+const double* Dataset::input(size_t sample, double* scratch) const {
+    return this->inputs.row(sample, scratch);
+}
+
+const double* Dataset::target(size_t sample, double* scratch) const {
+    return this->targets.row(sample, scratch);
+}
+
+const double* Dataset::input_block(size_t first, size_t count, double* scratch) const {
+    if(this->inputs.doubles.data != nullptr && this->inputs.doubles.is_contiguous())
+        return this->inputs.doubles.row(first);
+
+    const size_t cols = this->inputs.cols();
+    for(size_t sample = 0; sample < count; ++sample) {
+        const double* row = this->inputs.row(first + sample, scratch + sample * cols);
+
+        if(row != scratch + sample * cols)
+            std::copy(row, row + cols, scratch + sample * cols);
+    }
+
+    return scratch;
+}
+
+}
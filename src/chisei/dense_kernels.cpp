@@ -0,0 +1,408 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/dense_kernels.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifdef __AVX512F__
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+template<typename T, size_t U>
+void forward_tile(
+    const T* weights,
+    const T* biases,
+    const T* input,
+    T* output,
+    size_t n_in,
+    size_t n_out,
+    size_t j0,
+    size_t j1
+) {
+    for(size_t j = j0; j < j1; ++j)
+        output[j] = biases ? biases[j] : T(0);
+
+    size_t i = 0;
+    for(; i + U <= n_in; i += U) {
+        T x[U];
+        for(size_t u = 0; u < U; ++u)
+            x[u] = input[i + u];
+
+        const T* rows = weights + i * n_out;
+        for(size_t j = j0; j < j1; ++j) {
+            T sum = output[j];
+
+            for(size_t u = 0; u < U; ++u)
+                sum += x[u] * rows[u * n_out + j];
+            output[j] = sum;
+        }
+    }
+
+    for(; i < n_in; ++i) {
+        const T x = input[i];
+        const T* row = weights + i * n_out;
+
+        for(size_t j = j0; j < j1; ++j)
+            output[j] += x * row[j];
+    }
+}
+
+template<typename T, size_t U>
+void sparse_tile(
+    const T* weights,
+    const T* biases,
+    const T* input,
+    const uint32_t* indices,
+    size_t nonzero,
+    T* output,
+    size_t n_out,
+    size_t j0,
+    size_t j1
+) {
+    for(size_t j = j0; j < j1; ++j)
+        output[j] = biases ? biases[j] : T(0);
+
+    size_t k = 0;
+    for(; k + U <= nonzero; k += U) {
+        T x[U];
+        const T* rows[U];
+
+        for(size_t u = 0; u < U; ++u) {
+            x[u] = input[indices[k + u]];
+            rows[u] = weights + indices[k + u] * n_out;
+        }
+
+        for(size_t j = j0; j < j1; ++j) {
+            T sum = output[j];
+
+            for(size_t u = 0; u < U; ++u)
+                sum += x[u] * rows[u][j];
+            output[j] = sum;
+        }
+    }
+
+    for(; k < nonzero; ++k) {
+        const T x = input[indices[k]];
+        const T* row = weights + indices[k] * n_out;
+
+        for(size_t j = j0; j < j1; ++j)
+            output[j] += x * row[j];
+    }
+}
+
+template<typename T, size_t U>
+void run_tile(
+    const T* weights,
+    const T* biases,
+    const T* input,
+    const uint32_t* indices,
+    size_t nonzero,
+    T* output,
+    size_t n_in,
+    size_t n_out,
+    size_t j0,
+    size_t j1
+) {
+    if(indices != nullptr)
+        sparse_tile<T, U>(weights, biases, input, indices, nonzero, output, n_out, j0, j1);
+    else forward_tile<T, U>(weights, biases, input, output, n_in, n_out, j0, j1);
+}
+
+template<typename T>
+size_t compress_scalar(const T* values, size_t start, size_t count, uint32_t* indices, size_t found) {
+    // Branchless: the index is always written and only kept if the value is non-zero.
+    for(size_t i = start; i < count; ++i) {
+        indices[found] = static_cast<uint32_t>(i);
+        found += static_cast<size_t>((values[i] < T(0)) | (values[i] > T(0)));
+    }
+
+    return found;
+}
+
+inline void apply_epilogue(const KernelEpilogue* epilogue, double* values, size_t count) {
+    if(epilogue != nullptr && epilogue->function != nullptr)
+        epilogue->function(epilogue->context, values, count);
+}
+
+inline void apply_epilogue(const KernelEpilogue* epilogue, float* values, size_t count) {
+    (void) epilogue;
+    (void) values;
+    (void) count;
+}
+
+template<typename T>
+void forward_impl(
+    const KernelConfig& config,
+    const T* weights,
+    const T* biases,
+    const T* input,
+    T* output,
+    size_t n_in,
+    size_t n_out,
+    size_t batch,
+    const KernelEpilogue* epilogue
+) {
+    if(n_out == 0 || batch == 0)
+        return;
+
+    const size_t tile = std::min(std::max<size_t>(config.tile_size, 1), n_out);
+    const size_t tiles = (n_out + tile - 1) / tile;
+    const size_t unroll = config.unroll;
+
+    // Each sample's non-zero inputs are compacted up front; samples sparse
+    // enough then stream only the matching weight rows.
+    static thread_local std::vector<uint32_t> nonzero_indices;
+    static thread_local std::vector<size_t> nonzero_counts;
+
+    const bool sparse = std::isgreater(config.sparse_density, 0.0) && n_in != 0;
+    const double sparse_limit = config.sparse_density * static_cast<double>(n_in);
+
+    if(sparse) {
+        if(nonzero_indices.size() < batch * n_in)
+            nonzero_indices.resize(batch * n_in);
+        if(nonzero_counts.size() < batch)
+            nonzero_counts.resize(batch);
+
+        for(size_t sample = 0; sample < batch; ++sample)
+            nonzero_counts[sample] = DenseKernels::compress_nonzero(
+                input + sample * n_in,
+                n_in,
+                nonzero_indices.data() + sample * n_in
+            );
+    }
+
+    // Worker threads would see their own thread_local, so share the pointers.
+    const uint32_t* indices = nonzero_indices.data();
+    const size_t* counts = nonzero_counts.data();
+
+    const bool parallel = config.threads > 1 &&
+        n_in * n_out * batch >= config.parallel_threshold;
+    const int threads = std::max(config.threads, 1);
+    (void) threads;
+
+    #pragma omp parallel for collapse(2) schedule(static) if(parallel) num_threads(threads)
+    for(size_t sample = 0; sample < batch; ++sample)
+        for(size_t t = 0; t < tiles; ++t) {
+            const T* x = input + sample * n_in;
+            T* y = output + sample * n_out;
+
+            const size_t j0 = t * tile;
+            const size_t j1 = std::min(j0 + tile, n_out);
+
+            const size_t nonzero = sparse ? counts[sample] : n_in;
+            const uint32_t* rows = sparse &&
+                std::isless(static_cast<double>(nonzero), sparse_limit) ?
+                indices + sample * n_in : nullptr;
+
+            if(unroll >= 8)
+                run_tile<T, 8>(weights, biases, x, rows, nonzero, y, n_in, n_out, j0, j1);
+            else if(unroll >= 4)
+                run_tile<T, 4>(weights, biases, x, rows, nonzero, y, n_in, n_out, j0, j1);
+            else if(unroll >= 2)
+                run_tile<T, 2>(weights, biases, x, rows, nonzero, y, n_in, n_out, j0, j1);
+            else run_tile<T, 1>(weights, biases, x, rows, nonzero, y, n_in, n_out, j0, j1);
+
+            apply_epilogue(epilogue, y + j0, j1 - j0);
+        }
+
+    (void) parallel;
+}
+
+}
+
+size_t DenseKernels::compress_nonzero(const double* values, size_t count, uint32_t* indices) {
+    size_t i = 0, found = 0;
+
+#ifdef __AVX512F__
+    // Two compares fill one 16-lane mask, and the compress packs the matching
+    // lane indices; a full vector is stored since found + 16 <= i + 16 <= count.
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    for(; i + 16 <= count; i += 16) {
+        const unsigned low = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + i), zero, _CMP_NEQ_OQ);
+        const unsigned high = _mm512_cmp_pd_mask(_mm512_loadu_pd(values + i + 8), zero, _CMP_NEQ_OQ);
+        const __mmask16 mask = static_cast<__mmask16>(low | (high << 8));
+
+        const __m512i index = _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(i)));
+        _mm512_storeu_si512(indices + found, _mm512_maskz_compress_epi32(mask, index));
+        found += static_cast<size_t>(__builtin_popcount(mask));
+    }
+#endif
+
+    return compress_scalar(values, i, count, indices, found);
+}
+
+size_t DenseKernels::compress_nonzero(const float* values, size_t count, uint32_t* indices) {
+    size_t i = 0, found = 0;
+
+#ifdef __AVX512F__
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+
+    for(; i + 16 <= count; i += 16) {
+        const __mmask16 mask = _mm512_cmp_ps_mask(_mm512_loadu_ps(values + i), zero, _CMP_NEQ_OQ);
+
+        const __m512i index = _mm512_add_epi32(lanes, _mm512_set1_epi32(static_cast<int>(i)));
+        _mm512_storeu_si512(indices + found, _mm512_maskz_compress_epi32(mask, index));
+        found += static_cast<size_t>(__builtin_popcount(mask));
+    }
+#endif
+
+    return compress_scalar(values, i, count, indices, found);
+}
+
+void DenseKernels::forward(
+    const KernelConfig& config,
+    const double* weights,
+    const double* biases,
+    const double* input,
+    double* output,
+    size_t n_in,
+    size_t n_out,
+    size_t batch,
+    KernelEpilogue epilogue
+) {
+    forward_impl(config, weights, biases, input, output, n_in, n_out, batch, &epilogue);
+}
+
+void DenseKernels::forward(
+    const KernelConfig& config,
+    const float* weights,
+    const float* biases,
+    const float* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t batch
+) {
+    forward_impl<float>(config, weights, biases, input, output, n_in, n_out, batch, nullptr);
+}
+
+void DenseKernels::gemm(
+    bool transpose_a,
+    bool transpose_b,
+    size_t m,
+    size_t n,
+    size_t k,
+    double alpha,
+    const double* a,
+    size_t lda,
+    const double* b,
+    size_t ldb,
+    double beta,
+    double* c,
+    size_t ldc
+) {
+    constexpr size_t block_m = 64, block_n = 256, block_k = 128;
+
+    for(size_t i = 0; i < m; ++i) {
+        double* row = c + i * ldc;
+
+        if(std::fpclassify(beta) == FP_ZERO)
+            std::fill(row, row + n, 0.0);
+        else if(std::isless(beta, 1.0) || std::isgreater(beta, 1.0))
+            for(size_t j = 0; j < n; ++j)
+                row[j] *= beta;
+    }
+
+    if(m == 0 || n == 0 || k == 0)
+        return;
+
+    // Packing buffers are kept per thread so repeated calls do not allocate.
+    static thread_local std::vector<double> packed_b;
+    if(packed_b.size() < block_k * block_n)
+        packed_b.resize(block_k * block_n);
+
+    // Worker threads would see their own thread_local, so share the pointer.
+    double* packed_b_data = packed_b.data();
+
+    for(size_t jc = 0; jc < n; jc += block_n) {
+        const size_t nc = std::min(block_n, n - jc);
+
+        for(size_t pc = 0; pc < k; pc += block_k) {
+            const size_t kc = std::min(block_k, k - pc);
+
+            for(size_t p = 0; p < kc; ++p)
+                for(size_t j = 0; j < nc; ++j)
+                    packed_b_data[p * nc + j] = transpose_b ?
+                        b[(jc + j) * ldb + pc + p] :
+                        b[(pc + p) * ldb + jc + j];
+
+            const size_t row_blocks = (m + block_m - 1) / block_m;
+            const bool parallel = m * nc * kc >= 65536;
+            (void) parallel;
+
+            #pragma omp parallel if(parallel)
+            {
+                static thread_local std::vector<double> packed_a;
+                if(packed_a.size() < block_m * block_k)
+                    packed_a.resize(block_m * block_k);
+
+                #pragma omp for schedule(static)
+                for(size_t block = 0; block < row_blocks; ++block) {
+                    const size_t ic = block * block_m;
+                    const size_t mc = std::min(block_m, m - ic);
+
+                    for(size_t i = 0; i < mc; ++i)
+                        for(size_t p = 0; p < kc; ++p)
+                            packed_a[i * kc + p] = alpha * (transpose_a ?
+                                a[(pc + p) * lda + ic + i] :
+                                a[(ic + i) * lda + pc + p]);
+
+                    for(size_t i = 0; i < mc; ++i) {
+                        double* c_row = c + (ic + i) * ldc + jc;
+
+                        for(size_t p = 0; p < kc; ++p) {
+                            const double value = packed_a[i * kc + p];
+                            const double* b_row = packed_b_data + p * nc;
+
+                            for(size_t j = 0; j < nc; ++j)
+                                c_row[j] += value * b_row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,309 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/dense_kernels.hpp>
+#include <chisei/dense_layer.hpp>
+#include <chisei/kernel_autotuner.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace chisei {
+
+namespace {
+
+template<ActivationType activation>
+void activate_in_place(const void* context, double* values, size_t count) {
+    (void) context;
+    ActivationLayer::apply(activation, values, values, count);
+}
+
+void approximate_in_place(const void* context, double* values, size_t count) {
+    static_cast<const ApproximateActivation*>(context)->apply(values, values, count);
+}
+
+KernelEpilogue activation_epilogue(
+    ActivationType activation,
+    const ApproximateActivation* approximation
+) {
+    KernelEpilogue epilogue;
+    if(approximation != nullptr) {
+        epilogue.function = &approximate_in_place;
+        epilogue.context = approximation;
+
+        return epilogue;
+    }
+
+    switch(activation) {
+        case ActivationType::ReLU:
+            epilogue.function = &activate_in_place<ActivationType::ReLU>;
+            break;
+
+        case ActivationType::Tanh:
+            epilogue.function = &activate_in_place<ActivationType::Tanh>;
+            break;
+
+        case ActivationType::Sigmoid:
+        default:
+            epilogue.function = &activate_in_place<ActivationType::Sigmoid>;
+            break;
+    }
+
+    return epilogue;
+}
+
+}
+
+DenseLayer::DenseLayer(const TensorShape& _input_shape, size_t outputs) :
+    Layer(_input_shape, TensorShape{outputs, 1, 1}),
+    weights(_input_shape.size() * outputs),
+    biases(outputs, 0.0),
+    weight_gradients(_input_shape.size() * outputs, 0.0),
+    bias_gradients(outputs, 0.0),
+    activation_gradients(),
+    nonzero_inputs(),
+    nonzero_counts(),
+    touched_rows(_input_shape.size(), 0),
+    all_rows_touched(false)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(
+        0.0,
+        1.0 / std::sqrt(static_cast<double>(std::max<size_t>(_input_shape.size(), 1)))
+    );
+
+    for(double& weight : this->weights)
+        weight = dist(gen);
+}
+
+std::unique_ptr<DenseLayer> DenseLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const size_t outputs = ModelStream::read_size(stream);
+    if(outputs == 0 || outputs > std::numeric_limits<uint32_t>::max() ||
+        outputs > ModelStream::max_elements / std::max<size_t>(_input_shape.size(), 1))
+        throw ModelLoaderException("Invalid *.chisei file format, bad dense layer.");
+
+    std::unique_ptr<DenseLayer> layer(new DenseLayer(_input_shape, outputs));
+    ModelStream::read_array(stream, layer->weights);
+    ModelStream::read_array(stream, layer->biases);
+
+    return layer;
+}
+
+LayerType DenseLayer::type() const noexcept {
+    return LayerType::Dense;
+}
+
+bool DenseLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void DenseLayer::prepare(size_t max_batch) {
+    if(this->has_fused_activation && this->activation_gradients.size() < max_batch * this->output_shape.size())
+        this->activation_gradients.resize(max_batch * this->output_shape.size());
+
+    if(this->nonzero_counts.size() < max_batch) {
+        this->nonzero_inputs.resize(max_batch * this->input_shape.size());
+        this->nonzero_counts.resize(max_batch);
+    }
+}
+
+void DenseLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    DenseKernels::forward(
+        KernelAutotuner::lookup(n_in, n_out, batch, KernelPrecision::Double),
+        this->weights.data(),
+        this->biases.data(),
+        input,
+        output,
+        n_in,
+        n_out,
+        batch,
+        this->has_fused_activation ?
+            activation_epilogue(this->fused_activation, this->fused_approximation.get()) :
+            KernelEpilogue()
+    );
+}
+
+void DenseLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    if(this->has_fused_activation) {
+        this->prepare(batch);
+        ActivationLayer::apply_derivative(
+            this->fused_activation,
+            output,
+            output_gradient,
+            this->activation_gradients.data(),
+            batch * n_out
+        );
+        output_gradient = this->activation_gradients.data();
+    }
+
+    // Zero inputs contribute nothing to their weight rows, so a sparse batch
+    // accumulates only the rows of its non-zero inputs and `update` skips the rest.
+    const double density = KernelAutotuner::lookup(
+        n_in, n_out, batch, KernelPrecision::Double
+    ).sparse_density;
+
+    size_t nonzero = batch * n_in;
+    if(std::isgreater(density, 0.0)) {
+        this->prepare(batch);
+        nonzero = 0;
+
+        for(size_t sample = 0; sample < batch; ++sample) {
+            this->nonzero_counts[sample] = DenseKernels::compress_nonzero(
+                input + sample * n_in,
+                n_in,
+                this->nonzero_inputs.data() + sample * n_in
+            );
+            nonzero += this->nonzero_counts[sample];
+        }
+    }
+
+    if(std::isless(static_cast<double>(nonzero), density * static_cast<double>(batch * n_in)))
+        for(size_t sample = 0; sample < batch; ++sample) {
+            const uint32_t* rows = this->nonzero_inputs.data() + sample * n_in;
+            const double* x = input + sample * n_in;
+            const double* dy = output_gradient + sample * n_out;
+
+            for(size_t k = 0; k < this->nonzero_counts[sample]; ++k) {
+                const size_t i = rows[k];
+                const double value = x[i];
+                double* gradient = this->weight_gradients.data() + i * n_out;
+
+                for(size_t j = 0; j < n_out; ++j)
+                    gradient[j] += value * dy[j];
+
+                this->touched_rows[i] = 1;
+            }
+        }
+    else {
+        DenseKernels::gemm(
+            true, false,
+            n_in, n_out, batch,
+            1.0,
+            input, n_in,
+            output_gradient, n_out,
+            1.0,
+            this->weight_gradients.data(), n_out
+        );
+
+        this->all_rows_touched = true;
+    }
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        for(size_t j = 0; j < n_out; ++j)
+            this->bias_gradients[j] += output_gradient[sample * n_out + j];
+
+    if(input_gradient != nullptr)
+        DenseKernels::gemm(
+            false, true,
+            batch, n_in, n_out,
+            1.0,
+            output_gradient, n_out,
+            this->weights.data(), n_out,
+            0.0,
+            input_gradient, n_in
+        );
+}
+
+void DenseLayer::update(double learning_rate) {
+    const size_t n_out = this->output_shape.size();
+
+    if(this->all_rows_touched) {
+        for(size_t i = 0; i < this->weights.size(); ++i)
+            this->weights[i] -= learning_rate * this->weight_gradients[i];
+
+        std::fill(this->weight_gradients.begin(), this->weight_gradients.end(), 0.0);
+    }
+    else for(size_t i = 0; i < this->touched_rows.size(); ++i) {
+        if(!this->touched_rows[i])
+            continue;
+
+        double* row = this->weights.data() + i * n_out;
+        double* gradient = this->weight_gradients.data() + i * n_out;
+
+        for(size_t j = 0; j < n_out; ++j) {
+            row[j] -= learning_rate * gradient[j];
+            gradient[j] = 0.0;
+        }
+    }
+
+    for(size_t j = 0; j < this->biases.size(); ++j)
+        this->biases[j] -= learning_rate * this->bias_gradients[j];
+
+    std::fill(this->bias_gradients.begin(), this->bias_gradients.end(), 0.0);
+    std::fill(this->touched_rows.begin(), this->touched_rows.end(), 0);
+    this->all_rows_touched = false;
+}
+
+size_t DenseLayer::parameter_count() const noexcept {
+    return this->weights.size() + this->biases.size();
+}
+
+std::vector<double> DenseLayer::weight_values() const {
+    return this->weights;
+}
+
+void DenseLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->output_shape.size());
+    ModelStream::write_array(stream, this->weights);
+    ModelStream::write_array(stream, this->biases);
+}
+
+std::vector<double>& DenseLayer::get_weights() noexcept {
+    return this->weights;
+}
+
+std::vector<double>& DenseLayer::get_biases() noexcept {
+    return this->biases;
+}
+
+}
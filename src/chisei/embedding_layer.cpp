@@ -0,0 +1,182 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/embedding_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+TensorShape embedding_output(const TensorShape& input, size_t vocabulary, size_t dimension) {
+    if(vocabulary == 0 || dimension == 0)
+        throw std::invalid_argument("Embedding vocabulary and dimension must be non-zero.");
+
+    return TensorShape{input.size() * dimension, 1, 1};
+}
+
+}
+
+EmbeddingLayer::EmbeddingLayer(
+    const TensorShape& _input_shape,
+    size_t _vocabulary,
+    size_t _dimension
+) : Layer(_input_shape, embedding_output(_input_shape, _vocabulary, _dimension)),
+    vocabulary(_vocabulary),
+    dimension(_dimension),
+    table(_vocabulary * _dimension),
+    table_gradients(_vocabulary * _dimension, 0.0),
+    touched_rows(),
+    touched(_vocabulary, 0)
+{
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(0.0, 1.0);
+
+    for(double& value : this->table)
+        value = dist(gen);
+}
+
+std::unique_ptr<EmbeddingLayer> EmbeddingLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const size_t words = ModelStream::read_size(stream);
+    const size_t width = ModelStream::read_size(stream);
+
+    if(words == 0 || width == 0 || words > std::numeric_limits<uint32_t>::max() ||
+        width > (size_t(1) << 20) ||
+        static_cast<uint64_t>(words) * width > ModelStream::max_elements)
+        throw ModelLoaderException("Invalid *.chisei file format, bad embedding layer.");
+
+    std::unique_ptr<EmbeddingLayer> layer(new EmbeddingLayer(_input_shape, words, width));
+    ModelStream::read_array(stream, layer->table);
+
+    return layer;
+}
+
+LayerType EmbeddingLayer::type() const noexcept {
+    return LayerType::Embedding;
+}
+
+void EmbeddingLayer::prepare(size_t max_batch) {
+    this->touched_rows.reserve(std::min(this->vocabulary, max_batch * this->input_shape.size()));
+}
+
+size_t EmbeddingLayer::token(double value) const {
+    if(!(value >= 0.0) || value >= static_cast<double>(this->vocabulary))
+        throw std::out_of_range("Embedding input is not a valid token id.");
+
+    return static_cast<size_t>(value);
+}
+
+void EmbeddingLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t tokens = batch * this->input_shape.size();
+
+    for(size_t t = 0; t < tokens; ++t) {
+        const double* row = this->table.data() + this->token(input[t]) * this->dimension;
+        std::copy(row, row + this->dimension, output + t * this->dimension);
+    }
+}
+
+void EmbeddingLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    (void) output;
+    const size_t tokens = batch * this->input_shape.size();
+
+    for(size_t t = 0; t < tokens; ++t) {
+        const size_t id = this->token(input[t]);
+        double* row = this->table_gradients.data() + id * this->dimension;
+        const double* gradient = output_gradient + t * this->dimension;
+
+        for(size_t d = 0; d < this->dimension; ++d)
+            row[d] += gradient[d];
+
+        if(!this->touched[id]) {
+            this->touched[id] = 1;
+            this->touched_rows.push_back(id);
+        }
+    }
+
+    if(input_gradient != nullptr)
+        std::fill(input_gradient, input_gradient + tokens, 0.0);
+}
+
+void EmbeddingLayer::update(double learning_rate) {
+    for(size_t id : this->touched_rows) {
+        double* row = this->table.data() + id * this->dimension;
+        double* gradient = this->table_gradients.data() + id * this->dimension;
+
+        for(size_t d = 0; d < this->dimension; ++d) {
+            row[d] -= learning_rate * gradient[d];
+            gradient[d] = 0.0;
+        }
+
+        this->touched[id] = 0;
+    }
+
+    this->touched_rows.clear();
+}
+
+size_t EmbeddingLayer::parameter_count() const noexcept {
+    return this->table.size();
+}
+
+std::vector<double> EmbeddingLayer::weight_values() const {
+    return this->table;
+}
+
+void EmbeddingLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->vocabulary);
+    ModelStream::write_size(stream, this->dimension);
+    ModelStream::write_array(stream, this->table);
+}
+
+std::vector<double>& EmbeddingLayer::get_table() noexcept {
+    return this->table;
+}
+
+}
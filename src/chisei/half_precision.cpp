@@ -0,0 +1,178 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/half_precision.hpp>
+
+#include <cstring>
+
+#if defined(__F16C__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+#if !defined(__F16C__)
+
+uint16_t narrow(float value) noexcept {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t exponent = (bits >> 23) & 0xFFu;
+    uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if(exponent == 0xFFu)
+        return static_cast<uint16_t>(sign | 0x7C00u |
+            (mantissa != 0 ? 0x200u | (mantissa >> 13) : 0u));
+
+    const int rebiased = static_cast<int>(exponent) - 127 + 15;
+    if(rebiased >= 31)
+        return static_cast<uint16_t>(sign | 0x7C00u);
+
+    // Values below the smallest normal half become subnormals, rounded on the
+    // bits shifted out; anything under half the smallest subnormal is zero.
+    if(rebiased <= 0) {
+        if(rebiased < -10)
+            return sign;
+
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - rebiased);
+        const uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1u);
+
+        uint32_t result = mantissa >> shift;
+        if(remainder > halfway || (remainder == halfway && (result & 1u) != 0))
+            ++result;
+
+        return static_cast<uint16_t>(sign | result);
+    }
+
+    // A carry out of the mantissa bumps the exponent, up to infinity.
+    uint32_t result = (static_cast<uint32_t>(rebiased) << 10) | (mantissa >> 13);
+    const uint32_t remainder = mantissa & 0x1FFFu;
+    if(remainder > 0x1000u || (remainder == 0x1000u && (result & 1u) != 0))
+        ++result;
+
+    return static_cast<uint16_t>(sign | result);
+}
+
+float widen(uint16_t value) noexcept {
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    uint32_t mantissa = value & 0x3FFu;
+    uint32_t bits;
+
+    // NaNs come back quiet, as the conversion instructions return them.
+    if(exponent == 0x1Fu)
+        bits = sign | 0x7F800000u | (mantissa << 13) | (mantissa != 0 ? 0x400000u : 0u);
+    else if(exponent != 0)
+        bits = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+    else if(mantissa == 0)
+        bits = sign;
+    else {
+        uint32_t shift = 0;
+        while((mantissa & 0x400u) == 0) {
+            mantissa <<= 1;
+            ++shift;
+        }
+
+        bits = sign | ((113u - shift) << 23) | ((mantissa & 0x3FFu) << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+#endif
+
+}
+
+uint16_t HalfPrecision::from_float(float value) noexcept {
+    #if defined(__F16C__)
+    return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+    #else
+    return narrow(value);
+    #endif
+}
+
+float HalfPrecision::to_float(uint16_t value) noexcept {
+    #if defined(__F16C__)
+    return _cvtsh_ss(value);
+    #else
+    return widen(value);
+    #endif
+}
+
+void HalfPrecision::from_float(const float* input, uint16_t* output, size_t count) noexcept {
+    size_t i = 0;
+
+    #if defined(__F16C__)
+    for(; i + 8 <= count; i += 8)
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i*>(output + i),
+            _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT)
+        );
+    #endif
+
+    for(; i < count; ++i)
+        output[i] = from_float(input[i]);
+}
+
+void HalfPrecision::to_float(const uint16_t* input, float* output, size_t count) noexcept {
+    size_t i = 0;
+
+    #if defined(__F16C__)
+    for(; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(
+            output + i,
+            _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i)))
+        );
+    #endif
+
+    for(; i < count; ++i)
+        output[i] = to_float(input[i]);
+}
+
+const char* HalfPrecision::implementation() noexcept {
+    #if defined(__F16C__)
+    return "f16c";
+    #else
+    return "software";
+    #endif
+}
+
+}
@@ -0,0 +1,409 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/hashed_dense_layer.hpp>
+#include <chisei/model_stream.hpp>
+#include <chisei/simd_intrinsics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+// Virtual weights are expanded this many columns at a time, so a chunk of
+// keys, weights and gradients stays in L1 while every sample visits it.
+constexpr size_t chunk_size = 256;
+
+constexpr uint32_t sign_bit = 0x80000000u;
+
+inline uint32_t row_key(size_t row, uint32_t seed) {
+    return static_cast<uint32_t>(row) * 0x9E3779B1u ^ seed;
+}
+
+// lowbias32 finalizer; the SIMD kernels below compute exactly the same.
+inline uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+
+    return x;
+}
+
+// Bucket from the high bits by multiply-shift, sign from the low bit.
+inline uint32_t bucket_key(uint32_t hash, uint32_t buckets) {
+    return static_cast<uint32_t>((static_cast<uint64_t>(hash) * buckets) >> 32) |
+        (hash << 31);
+}
+
+inline double signed_parameter(const double* parameters, uint32_t key) {
+    const double value = parameters[key & ~sign_bit];
+    return (key & sign_bit) ? -value : value;
+}
+
+}
+
+HashedDenseLayer::HashedDenseLayer(
+    const TensorShape& _input_shape,
+    size_t outputs,
+    size_t buckets
+) : Layer(_input_shape, TensorShape{outputs, 1, 1}),
+    seed(std::random_device()()),
+    parameters(buckets),
+    biases(outputs, 0.0),
+    parameter_gradients(buckets, 0.0),
+    bias_gradients(outputs, 0.0),
+    chunk_keys(chunk_size),
+    chunk_weights(chunk_size),
+    chunk_gradients(chunk_size),
+    activation_gradients()
+{
+    if(buckets == 0 || buckets > sign_bit)
+        throw std::invalid_argument("Hashed dense layer needs between 1 and 2^31 buckets.");
+
+    if(outputs == 0 || outputs > UINT32_MAX)
+        throw std::invalid_argument("Hashed dense layer output count is out of range.");
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(
+        0.0,
+        1.0 / std::sqrt(static_cast<double>(std::max<size_t>(_input_shape.size(), 1)))
+    );
+
+    for(double& parameter : this->parameters)
+        parameter = dist(gen);
+}
+
+std::unique_ptr<HashedDenseLayer> HashedDenseLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const size_t outputs = ModelStream::read_size(stream);
+    const size_t buckets = ModelStream::read_size(stream);
+    const uint32_t stored_seed = ModelStream::read<uint32_t>(stream);
+
+    if(outputs == 0 || outputs > UINT32_MAX || buckets == 0 || buckets > (size_t(1) << 31))
+        throw ModelLoaderException("Invalid *.chisei file format, bad hashed dense layer.");
+
+    std::unique_ptr<HashedDenseLayer> layer(new HashedDenseLayer(_input_shape, outputs, buckets));
+    layer->seed = stored_seed;
+
+    ModelStream::read_array(stream, layer->parameters);
+    ModelStream::read_array(stream, layer->biases);
+
+    return layer;
+}
+
+LayerType HashedDenseLayer::type() const noexcept {
+    return LayerType::HashedDense;
+}
+
+bool HashedDenseLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void HashedDenseLayer::prepare(size_t max_batch) {
+    if(this->has_fused_activation && this->activation_gradients.size() < max_batch * this->output_shape.size())
+        this->activation_gradients.resize(max_batch * this->output_shape.size());
+}
+
+void HashedDenseLayer::hash_chunk(size_t row, size_t first, size_t count) {
+    const uint32_t base = row_key(row, this->seed);
+    const uint32_t buckets = static_cast<uint32_t>(this->parameters.size());
+    uint32_t* keys = this->chunk_keys.data();
+    size_t k = 0;
+
+#if defined(__AVX512F__)
+    const __m512i lanes = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i bucket_count = _mm512_set1_epi32(static_cast<int>(buckets));
+
+    for(; k + 16 <= count; k += 16) {
+        __m512i x = _mm512_xor_si512(
+            _mm512_set1_epi32(static_cast<int>(base)),
+            _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(first + k)), lanes)
+        );
+
+        x = _mm512_xor_si512(x, SimdIntrinsics::srli_epi32<16>(x));
+        x = _mm512_mullo_epi32(x, _mm512_set1_epi32(static_cast<int>(0x7FEB352Du)));
+        x = _mm512_xor_si512(x, SimdIntrinsics::srli_epi32<15>(x));
+        x = _mm512_mullo_epi32(x, _mm512_set1_epi32(static_cast<int>(0x846CA68Bu)));
+        x = _mm512_xor_si512(x, SimdIntrinsics::srli_epi32<16>(x));
+
+        // High halves of the 32x32-bit products: even lanes from one widening
+        // multiply, odd lanes from another on the shifted hashes.
+        const __m512i even = SimdIntrinsics::srli_epi64<32>(SimdIntrinsics::mul_epu32(x, bucket_count));
+        const __m512i odd = SimdIntrinsics::mul_epu32(SimdIntrinsics::srli_epi64<32>(x), bucket_count);
+        const __m512i bucket = _mm512_mask_blend_epi32(0xAAAA, even, odd);
+
+        _mm512_storeu_si512(keys + k, _mm512_or_si512(bucket, SimdIntrinsics::slli_epi32<31>(x)));
+    }
+#elif defined(__AVX2__)
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i bucket_count = _mm256_set1_epi32(static_cast<int>(buckets));
+
+    for(; k + 8 <= count; k += 8) {
+        __m256i x = _mm256_xor_si256(
+            _mm256_set1_epi32(static_cast<int>(base)),
+            _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(first + k)), lanes)
+        );
+
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x7FEB352Du)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 15));
+        x = _mm256_mullo_epi32(x, _mm256_set1_epi32(static_cast<int>(0x846CA68Bu)));
+        x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 16));
+
+        const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(x, bucket_count), 32);
+        const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), bucket_count);
+        const __m256i bucket = _mm256_blend_epi32(even, odd, 0xAA);
+
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(keys + k),
+            _mm256_or_si256(bucket, _mm256_slli_epi32(x, 31))
+        );
+    }
+#endif
+
+    for(; k < count; ++k)
+        keys[k] = bucket_key(mix(base ^ static_cast<uint32_t>(first + k)), buckets);
+}
+
+void HashedDenseLayer::gather_chunk(size_t count) {
+    const double* source = this->parameters.data();
+    const uint32_t* keys = this->chunk_keys.data();
+    double* weights = this->chunk_weights.data();
+    size_t k = 0;
+
+#if defined(__AVX512F__)
+    const __m512i index_mask = _mm512_set1_epi32(static_cast<int>(~sign_bit));
+    const __m512i sign_mask = _mm512_set1_epi32(static_cast<int>(sign_bit));
+    const __m512d zero = _mm512_setzero_pd();
+
+    for(; k + 16 <= count; k += 16) {
+        const __m512i key = _mm512_loadu_si512(keys + k);
+        const __m512i index = _mm512_and_si512(key, index_mask);
+        const __mmask16 negative = _mm512_test_epi32_mask(key, sign_mask);
+
+        __m512d low = SimdIntrinsics::gather(source, SimdIntrinsics::extract_half<0>(index));
+        __m512d high = SimdIntrinsics::gather(source, SimdIntrinsics::extract_half<1>(index));
+
+        low = _mm512_mask_sub_pd(low, static_cast<__mmask8>(negative), zero, low);
+        high = _mm512_mask_sub_pd(high, static_cast<__mmask8>(negative >> 8), zero, high);
+
+        _mm512_storeu_pd(weights + k, low);
+        _mm512_storeu_pd(weights + k + 8, high);
+    }
+#elif defined(__AVX2__)
+    const __m128i index_mask = _mm_set1_epi32(static_cast<int>(~sign_bit));
+
+    for(; k + 4 <= count; k += 4) {
+        const __m128i key = _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + k));
+        const __m256d value = SimdIntrinsics::gather(source, _mm_and_si128(key, index_mask));
+        const __m256i sign = _mm256_slli_epi64(_mm256_cvtepu32_epi64(_mm_srli_epi32(key, 31)), 63);
+
+        _mm256_storeu_pd(weights + k, _mm256_xor_pd(value, _mm256_castsi256_pd(sign)));
+    }
+#endif
+
+    for(; k < count; ++k)
+        weights[k] = signed_parameter(source, keys[k]);
+}
+
+void HashedDenseLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        std::copy(this->biases.begin(), this->biases.end(), output + sample * n_out);
+
+    for(size_t first = 0; first < n_out; first += chunk_size) {
+        const size_t count = std::min(chunk_size, n_out - first);
+
+        for(size_t i = 0; i < n_in; ++i) {
+            bool active = false;
+            for(size_t sample = 0; sample < batch && !active; ++sample)
+                active = std::fpclassify(input[sample * n_in + i]) != FP_ZERO;
+
+            // A row only matters to samples with a non-zero input there.
+            if(!active)
+                continue;
+
+            this->hash_chunk(i, first, count);
+            this->gather_chunk(count);
+            const double* w = this->chunk_weights.data();
+
+            for(size_t sample = 0; sample < batch; ++sample) {
+                const double x = input[sample * n_in + i];
+                double* y = output + sample * n_out + first;
+
+                for(size_t k = 0; k < count; ++k)
+                    y[k] += x * w[k];
+            }
+        }
+    }
+
+    if(this->fused_approximation)
+        this->fused_approximation->apply(output, output, batch * n_out);
+    else if(this->has_fused_activation)
+        ActivationLayer::apply(this->fused_activation, output, output, batch * n_out);
+}
+
+void HashedDenseLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    if(this->has_fused_activation) {
+        this->prepare(batch);
+        ActivationLayer::apply_derivative(
+            this->fused_activation,
+            output,
+            output_gradient,
+            this->activation_gradients.data(),
+            batch * n_out
+        );
+        output_gradient = this->activation_gradients.data();
+    }
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        for(size_t j = 0; j < n_out; ++j)
+            this->bias_gradients[j] += output_gradient[sample * n_out + j];
+
+    if(input_gradient != nullptr)
+        std::fill(input_gradient, input_gradient + batch * n_in, 0.0);
+
+    for(size_t first = 0; first < n_out; first += chunk_size) {
+        const size_t count = std::min(chunk_size, n_out - first);
+
+        for(size_t i = 0; i < n_in; ++i) {
+            this->hash_chunk(i, first, count);
+
+            if(input_gradient != nullptr) {
+                this->gather_chunk(count);
+                const double* w = this->chunk_weights.data();
+
+                for(size_t sample = 0; sample < batch; ++sample) {
+                    const double* dy = output_gradient + sample * n_out + first;
+                    double sum = 0.0;
+
+                    for(size_t k = 0; k < count; ++k)
+                        sum += w[k] * dy[k];
+                    input_gradient[sample * n_in + i] += sum;
+                }
+            }
+
+            // Gradients of the virtual weights, summed over the batch, then
+            // scatter-added into the parameters they share.
+            double* g = this->chunk_gradients.data();
+            std::fill(g, g + count, 0.0);
+            bool active = false;
+
+            for(size_t sample = 0; sample < batch; ++sample) {
+                const double x = input[sample * n_in + i];
+                if(std::fpclassify(x) == FP_ZERO)
+                    continue;
+
+                const double* dy = output_gradient + sample * n_out + first;
+                for(size_t k = 0; k < count; ++k)
+                    g[k] += x * dy[k];
+                active = true;
+            }
+
+            if(!active)
+                continue;
+
+            const uint32_t* keys = this->chunk_keys.data();
+            for(size_t k = 0; k < count; ++k)
+                this->parameter_gradients[keys[k] & ~sign_bit] +=
+                    (keys[k] & sign_bit) ? -g[k] : g[k];
+        }
+    }
+}
+
+void HashedDenseLayer::update(double learning_rate) {
+    for(size_t k = 0; k < this->parameters.size(); ++k)
+        this->parameters[k] -= learning_rate * this->parameter_gradients[k];
+
+    for(size_t j = 0; j < this->biases.size(); ++j)
+        this->biases[j] -= learning_rate * this->bias_gradients[j];
+
+    std::fill(this->parameter_gradients.begin(), this->parameter_gradients.end(), 0.0);
+    std::fill(this->bias_gradients.begin(), this->bias_gradients.end(), 0.0);
+}
+
+size_t HashedDenseLayer::parameter_count() const noexcept {
+    return this->parameters.size() + this->biases.size();
+}
+
+std::vector<double> HashedDenseLayer::weight_values() const {
+    return this->parameters;
+}
+
+void HashedDenseLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->output_shape.size());
+    ModelStream::write_size(stream, this->parameters.size());
+    ModelStream::write(stream, this->seed);
+    ModelStream::write_array(stream, this->parameters);
+    ModelStream::write_array(stream, this->biases);
+}
+
+double HashedDenseLayer::weight(size_t row, size_t column) const noexcept {
+    const uint32_t key = bucket_key(
+        mix(row_key(row, this->seed) ^ static_cast<uint32_t>(column)),
+        static_cast<uint32_t>(this->parameters.size())
+    );
+
+    return signed_parameter(this->parameters.data(), key);
+}
+
+double HashedDenseLayer::compression_ratio() const noexcept {
+    return static_cast<double>(this->input_shape.size() * this->output_shape.size()) /
+        static_cast<double>(this->parameters.size());
+}
+
+}
@@ -35,6 +35,8 @@
 #include <chisei/idx_loader.hpp>
 #include <chisei/model_loader_exception.hpp>
 
+#include <utility>
+
 namespace chisei {
 
 NeuralNetwork IDXLoader::fromMNIST(
@@ -42,6 +44,59 @@ NeuralNetwork IDXLoader::fromMNIST(
     const std::string& labels_file,
     double learning_rate,
     int epoch
+) {
+    std::vector<std::vector<double>> inputs;
+    std::vector<std::vector<double>> targets;
+
+    loadMNIST(images_file, labels_file, inputs, targets, 5000);
+
+    std::vector<size_t> layer_sizes = {
+        inputs.empty() ? 0 : inputs[0].size(),
+        256,
+        128,
+        10
+    };
+
+    NeuralNetwork network(
+        layer_sizes,
+        ActivationFunctions::sigmoid_activation,
+        ActivationFunctions::sigmoid_derivative
+    );
+
+    network.set_input_transform(1.0 / 255.0);
+    network.train(inputs, targets, learning_rate, epoch);
+
+    return network;
+}
+
+void IDXLoader::loadMNIST(
+    const std::string& images_file,
+    const std::string& labels_file,
+    std::vector<std::vector<double>>& inputs,
+    std::vector<std::vector<double>>& targets,
+    size_t max_samples
+) {
+    std::vector<std::vector<uint8_t>> pixels;
+    loadMNISTRaw(images_file, labels_file, pixels, targets, max_samples);
+
+    inputs.clear();
+    inputs.reserve(pixels.size());
+
+    for(const std::vector<uint8_t>& image : pixels) {
+        std::vector<double> input(image.size());
+        for(size_t j = 0; j < image.size(); ++j)
+            input[j] = static_cast<double>(image[j]) / 255.0;
+
+        inputs.push_back(input);
+    }
+}
+
+void IDXLoader::loadMNISTRaw(
+    const std::string& images_file,
+    const std::string& labels_file,
+    std::vector<std::vector<uint8_t>>& inputs,
+    std::vector<std::vector<double>>& targets,
+    size_t max_samples
 ) {
     std::ifstream images(images_file, std::ios::binary);
     std::ifstream labels(labels_file, std::ios::binary);
@@ -55,7 +110,7 @@ NeuralNetwork IDXLoader::fromMNIST(
     uint32_t cols = readUint32(images);
 
     uint32_t label_magic = readUint32(labels);
-    readUint32(labels);
+    uint32_t num_labels = readUint32(labels);
 
     if(image_magic != 0x00000803 || label_magic != 0x00000801)
         throw ModelLoaderException("Invalid MNIST file format");
@@ -63,45 +118,34 @@ NeuralNetwork IDXLoader::fromMNIST(
     size_t input_size = rows * cols;
     size_t output_size = 10;
 
-    std::vector<size_t> layer_sizes = {
-        input_size,
-        256,
-        128,
-        output_size
-    };
-
-    NeuralNetwork network(
-        layer_sizes,
-        ActivationFunctions::sigmoid_activation,
-        ActivationFunctions::sigmoid_derivative
-    );
-
-    std::vector<std::vector<double>> inputs;
-    std::vector<std::vector<double>> targets;
+    size_t sample_count = std::min(num_images, num_labels);
+    if(max_samples != 0)
+        sample_count = std::min(sample_count, max_samples);
 
-    uint32_t max_samples = std::min(num_images, 5000u);
-    for(uint32_t i = 0; i < max_samples; ++i) {
-        std::vector<double> input(input_size);
+    inputs.clear();
+    targets.clear();
+    inputs.reserve(sample_count);
+    targets.reserve(sample_count);
 
-        for(size_t j = 0; j < input_size; ++j) {
-            uint8_t pixel;
-
-            images.read(reinterpret_cast<char*>(&pixel), 1);
-            input[j] = static_cast<double>(pixel) / 255.0;
-        }
+    for(size_t i = 0; i < sample_count; ++i) {
+        std::vector<uint8_t> pixels(input_size);
+        images.read(
+            reinterpret_cast<char*>(pixels.data()),
+            static_cast<std::streamsize>(input_size)
+        );
 
         uint8_t label;
         labels.read(reinterpret_cast<char*>(&label), 1);
 
+        if(!images || !labels || label >= output_size)
+            throw ModelLoaderException("Truncated or invalid MNIST file");
+
         std::vector<double> target(output_size, 0.0);
         target[label] = 1.0;
 
-        inputs.push_back(input);
+        inputs.push_back(std::move(pixels));
         targets.push_back(target);
     }
-
-    network.train(inputs, targets, learning_rate, epoch);
-    return network;
 }
 
 uint32_t IDXLoader::readUint32(std::ifstream& file) {
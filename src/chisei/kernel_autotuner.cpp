@@ -0,0 +1,592 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/kernel_autotuner.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <cpuid.h>
+#endif
+
+#ifdef _OPENMP
+#   include <omp.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+using TuningKey = std::tuple<size_t, size_t, size_t, KernelPrecision>;
+
+struct TunerState {
+    std::mutex mutex{};
+    std::map<TuningKey, KernelConfig> configs{};
+    std::string cache_file{};
+    bool cache_file_set = false;
+    bool loaded = false;
+    bool tune_on_first_use = false;
+    double sparse_density = KernelConfig().sparse_density;
+
+    // Bumped under the mutex whenever a lookup could resolve differently,
+    // which invalidates every thread's memo.
+    std::atomic<uint64_t> generation{0};
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+};
+
+// Resolved lookups of one thread, valid while `generation` matches.
+struct LookupMemo {
+    struct Entry {
+        KernelConfig config{};
+        bool tuned = false;
+    };
+
+    uint64_t generation = 0;
+    std::map<TuningKey, Entry> entries{};
+};
+
+TunerState& tuner_state() {
+    static TunerState state;
+    return state;
+}
+
+// Batch sizes share a tuned configuration per power of two, so a new batch
+// size near a tuned one is not benchmarked again.
+size_t batch_bucket(size_t batch) {
+    size_t bucket = 1;
+    while(bucket < batch && bucket <= std::numeric_limits<size_t>::max() / 2)
+        bucket <<= 1;
+
+    return bucket;
+}
+
+TuningKey tuning_key(size_t n_in, size_t n_out, size_t batch, KernelPrecision precision) {
+    return TuningKey(n_in, n_out, batch_bucket(batch), precision);
+}
+
+const char* precision_name(KernelPrecision precision) {
+    switch(precision) {
+        case KernelPrecision::Float:
+            return "f32";
+
+        case KernelPrecision::Double:
+        default:
+            return "f64";
+    }
+}
+
+bool parse_precision(const std::string& name, KernelPrecision& precision) {
+    if(name == "f64")
+        precision = KernelPrecision::Double;
+    else if(name == "f32")
+        precision = KernelPrecision::Float;
+    else return false;
+
+    return true;
+}
+
+int max_threads() {
+    #ifdef _OPENMP
+    return std::max(omp_get_max_threads(), 1);
+    #else
+    return 1;
+    #endif
+}
+
+std::string default_cache_file() {
+    if(const char* path = std::getenv("CHISEI_TUNING_CACHE"))
+        return path;
+
+    if(const char* xdg = std::getenv("XDG_CACHE_HOME"))
+        if(*xdg != '\0')
+            return std::string(xdg) + "/chisei/kernels.tune";
+
+    if(const char* home = std::getenv("HOME"))
+        if(*home != '\0')
+            return std::string(home) + "/.cache/chisei/kernels.tune";
+
+    return "";
+}
+
+std::string resolved_cache_file(TunerState& state) {
+    if(!state.cache_file_set) {
+        state.cache_file = default_cache_file();
+        state.cache_file_set = true;
+    }
+
+    return state.cache_file;
+}
+
+void load_cache(TunerState& state) {
+    if(state.loaded)
+        return;
+    state.loaded = true;
+    ++state.generation;
+
+    std::ifstream file(resolved_cache_file(state));
+    if(!file)
+        return;
+
+    const std::string header = "cpu " + KernelAutotuner::cpu_model();
+    bool in_section = false;
+    std::string line;
+
+    while(std::getline(file, line)) {
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        if(line.rfind("cpu ", 0) == 0) {
+            in_section = line == header;
+            continue;
+        }
+
+        if(!in_section)
+            continue;
+
+        std::istringstream fields(line);
+        size_t n_in, n_out, batch;
+        std::string precision_field;
+        KernelConfig config;
+
+        if(!(fields >> n_in >> n_out >> batch >> precision_field >>
+            config.tile_size >> config.unroll >> config.threads >>
+            config.parallel_threshold))
+            continue;
+
+        KernelPrecision precision;
+        if(parse_precision(precision_field, precision))
+            state.configs[tuning_key(n_in, n_out, batch, precision)] = config;
+    }
+}
+
+void save_cache(TunerState& state) {
+    const std::string path = resolved_cache_file(state);
+    if(path.empty())
+        return;
+
+    const std::string header = "cpu " + KernelAutotuner::cpu_model();
+    std::vector<std::string> other_sections;
+
+    {
+        std::ifstream file(path);
+        bool in_section = false;
+        std::string line;
+
+        while(std::getline(file, line)) {
+            if(line.empty() || line[0] == '#')
+                continue;
+
+            if(line.rfind("cpu ", 0) == 0)
+                in_section = line == header;
+
+            if(!in_section)
+                other_sections.push_back(line);
+        }
+    }
+
+    std::error_code error;
+    const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if(!parent.empty())
+        std::filesystem::create_directories(parent, error);
+
+    const std::string temp_path = path + ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::trunc);
+        if(!file)
+            return;
+
+        file << "# chisei kernel tuning cache\n";
+        for(const std::string& line : other_sections)
+            file << line << '\n';
+
+        file << header << '\n';
+        for(const auto& entry : state.configs) {
+            const KernelConfig& config = entry.second;
+
+            file << std::get<0>(entry.first) << ' '
+                << std::get<1>(entry.first) << ' '
+                << std::get<2>(entry.first) << ' '
+                << precision_name(std::get<3>(entry.first)) << ' '
+                << config.tile_size << ' '
+                << config.unroll << ' '
+                << config.threads << ' '
+                << config.parallel_threshold << '\n';
+        }
+    }
+
+    std::filesystem::rename(temp_path, path, error);
+}
+
+template<typename T>
+double benchmark_impl(
+    const KernelConfig& config,
+    size_t n_in,
+    size_t n_out,
+    size_t batch
+) {
+    std::mt19937 gen(42);
+    std::uniform_real_distribution<T> dist(T(-1), T(1));
+
+    std::vector<T> weights(n_in * n_out), biases(n_out),
+        input(n_in * batch), output(n_out * batch);
+    for(T& value : weights)
+        value = dist(gen);
+    for(T& value : biases)
+        value = dist(gen);
+    for(T& value : input)
+        value = dist(gen);
+
+    DenseKernels::forward(
+        config,
+        weights.data(),
+        biases.data(),
+        input.data(),
+        output.data(),
+        n_in,
+        n_out,
+        batch
+    );
+
+    using clock = std::chrono::steady_clock;
+    const auto budget = std::chrono::milliseconds(2);
+    const auto start = clock::now();
+
+    double best = std::numeric_limits<double>::infinity();
+    for(int run = 0; run < 100; ++run) {
+        const auto before = clock::now();
+        DenseKernels::forward(
+            config,
+            weights.data(),
+            biases.data(),
+            input.data(),
+            output.data(),
+            n_in,
+            n_out,
+            batch
+        );
+        const auto after = clock::now();
+
+        best = std::min(
+            best,
+            std::chrono::duration<double>(after - before).count()
+        );
+
+        if(run >= 2 && after - start > budget)
+            break;
+    }
+
+    return best;
+}
+
+}
+
+KernelConfig KernelAutotuner::lookup(
+    size_t n_in,
+    size_t n_out,
+    size_t batch,
+    KernelPrecision precision
+) {
+    TunerState& state = tuner_state();
+    const TuningKey key = tuning_key(n_in, n_out, batch, precision);
+
+    // Layers look their configuration up on every call, so settled answers
+    // are served from a per-thread memo without taking the lock.
+    static thread_local LookupMemo memo;
+    if(memo.generation == state.generation.load(std::memory_order_acquire)) {
+        auto memoized = memo.entries.find(key);
+
+        if(memoized != memo.entries.end()) {
+            ++(memoized->second.tuned ? state.hits : state.misses);
+            return memoized->second.config;
+        }
+    }
+
+    KernelConfig config;
+    uint64_t generation = 0;
+    bool tuned = false, known = true;
+    {
+        std::lock_guard<std::mutex> lock(state.mutex);
+        load_cache(state);
+        generation = state.generation.load(std::memory_order_relaxed);
+
+        auto found = state.configs.find(key);
+        if(found != state.configs.end()) {
+            config = found->second;
+            tuned = true;
+        }
+        else if(!state.tune_on_first_use)
+            config = default_config(n_in, n_out, batch);
+        else known = false;
+
+        // The density threshold is a policy rather than a tuned value, so
+        // it is neither cached nor benchmarked.
+        config.sparse_density = state.sparse_density;
+    }
+
+    ++(tuned ? state.hits : state.misses);
+    if(!known) {
+        const double density = config.sparse_density;
+
+        config = tune(n_in, n_out, batch, precision);
+        config.sparse_density = density;
+        return config;
+    }
+
+    if(memo.generation != generation) {
+        memo.entries.clear();
+        memo.generation = generation;
+    }
+
+    memo.entries[key] = LookupMemo::Entry{config, tuned};
+    return config;
+}
+
+KernelConfig KernelAutotuner::tune(
+    size_t n_in,
+    size_t n_out,
+    size_t batch,
+    KernelPrecision precision
+) {
+    // Tuned at the size every batch of its bucket shares the result with.
+    batch = batch_bucket(batch);
+
+    const int threads = max_threads();
+    const size_t tiles[] = {16, 32, 64, 128, 256, n_out};
+    const size_t unrolls[] = {1, 2, 4, 8};
+
+    KernelConfig best = default_config(n_in, n_out, batch);
+    best.threads = threads;
+    best.parallel_threshold = 0;
+    double best_time = benchmark(best, n_in, n_out, batch, precision);
+
+    for(size_t tile : tiles) {
+        if(tile > n_out)
+            continue;
+
+        for(size_t unroll : unrolls) {
+            KernelConfig candidate = best;
+            candidate.tile_size = tile;
+            candidate.unroll = unroll;
+
+            double time = benchmark(candidate, n_in, n_out, batch, precision);
+            if(time < best_time) {
+                best_time = time;
+                best = candidate;
+            }
+        }
+    }
+
+    const int thread_counts[] = {1, threads / 2, threads};
+    for(int count : thread_counts) {
+        if(count < 1 || count == best.threads)
+            continue;
+
+        KernelConfig candidate = best;
+        candidate.threads = count;
+
+        double time = benchmark(candidate, n_in, n_out, batch, precision);
+        if(time < best_time) {
+            best_time = time;
+            best = candidate;
+        }
+    }
+
+    if(best.threads <= 1) {
+        best.threads = 1;
+        best.parallel_threshold = std::numeric_limits<size_t>::max();
+    }
+
+    TunerState& state = tuner_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    load_cache(state);
+    state.configs[tuning_key(n_in, n_out, batch, precision)] = best;
+    ++state.generation;
+    save_cache(state);
+
+    return best;
+}
+
+KernelConfig KernelAutotuner::default_config(size_t n_in, size_t n_out, size_t batch) {
+    (void) n_in;
+    (void) batch;
+
+    KernelConfig config;
+    config.tile_size = std::min<size_t>(64, std::max<size_t>(n_out, 1));
+    config.unroll = 4;
+    config.threads = max_threads();
+    config.parallel_threshold = 65536;
+
+    return config;
+}
+
+void KernelAutotuner::set_tune_on_first_use(bool enabled) {
+    TunerState& state = tuner_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.tune_on_first_use = enabled;
+    ++state.generation;
+}
+
+void KernelAutotuner::set_sparse_density(double density) {
+    if(!(density >= 0.0) || density > 1.0)
+        throw std::invalid_argument("Sparse density threshold must be in [0, 1].");
+
+    TunerState& state = tuner_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.sparse_density = density;
+    ++state.generation;
+}
+
+void KernelAutotuner::set_cache_file(const std::string& path) {
+    TunerState& state = tuner_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    state.cache_file = path;
+    state.cache_file_set = true;
+    state.configs.clear();
+    state.loaded = false;
+    ++state.generation;
+}
+
+std::string KernelAutotuner::cache_file() {
+    TunerState& state = tuner_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+
+    return resolved_cache_file(state);
+}
+
+TuningCacheStatistics KernelAutotuner::cache_statistics() {
+    TunerState& state = tuner_state();
+
+    TuningCacheStatistics statistics;
+    statistics.hits = state.hits.load(std::memory_order_relaxed);
+    statistics.misses = state.misses.load(std::memory_order_relaxed);
+
+    return statistics;
+}
+
+std::string KernelAutotuner::cpu_model() {
+    static const std::string model = []() {
+        #if defined(__x86_64__) || defined(__i386__)
+        unsigned int brand[12] = {0};
+        unsigned int max_leaf = __get_cpuid_max(0x80000000, nullptr);
+
+        if(max_leaf >= 0x80000004) {
+            for(unsigned int leaf = 0; leaf < 3; ++leaf)
+                __get_cpuid(
+                    0x80000002 + leaf,
+                    &brand[leaf * 4],
+                    &brand[leaf * 4 + 1],
+                    &brand[leaf * 4 + 2],
+                    &brand[leaf * 4 + 3]
+                );
+
+            char text[sizeof(brand) + 1] = {0};
+            std::copy(
+                reinterpret_cast<const char*>(brand),
+                reinterpret_cast<const char*>(brand) + sizeof(brand),
+                text
+            );
+
+            std::string name(text);
+            name.erase(0, name.find_first_not_of(' '));
+            name.erase(name.find_last_not_of(' ') + 1);
+
+            if(!name.empty())
+                return name;
+        }
+        #endif
+
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line, implementer, part;
+
+        while(std::getline(cpuinfo, line)) {
+            size_t colon = line.find(':');
+            if(colon == std::string::npos)
+                continue;
+
+            std::string key = line.substr(0, line.find_last_not_of(" \t", colon - 1) + 1);
+            std::string value = line.substr(std::min(colon + 2, line.size()));
+
+            if(key == "model name" || key == "Hardware" || key == "uarch")
+                return value;
+            else if(key == "CPU implementer")
+                implementer = value;
+            else if(key == "CPU part")
+                part = value;
+        }
+
+        if(!implementer.empty())
+            return "arm " + implementer + " " + part;
+        return std::string("unknown");
+    }();
+
+    return model;
+}
+
+double KernelAutotuner::benchmark(
+    const KernelConfig& config,
+    size_t n_in,
+    size_t n_out,
+    size_t batch,
+    KernelPrecision precision
+) {
+    switch(precision) {
+        case KernelPrecision::Float:
+            return benchmark_impl<float>(config, n_in, n_out, batch);
+
+        case KernelPrecision::Double:
+        default:
+            return benchmark_impl<double>(config, n_in, n_out, batch);
+    }
+}
+
+}
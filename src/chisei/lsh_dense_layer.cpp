@@ -0,0 +1,537 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/lsh_dense_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+// Keys wider than this are mixed down so a table never exceeds 2^20 buckets.
+constexpr size_t max_bucket_bits = 20;
+
+// Each DWTA hash is the argmax over this many coordinates, i.e. 3 bits.
+constexpr size_t dwta_coordinates = 8;
+
+size_t key_bits(const LshOptions& options) {
+    return options.hashes * (options.family == LshFamily::DWTA ? 3 : 1);
+}
+
+const LshOptions& validated(const LshOptions& options, size_t outputs) {
+    if(options.family != LshFamily::SimHash && options.family != LshFamily::DWTA)
+        throw std::invalid_argument("Unknown LSH family.");
+
+    if(options.tables == 0 || options.hashes == 0 || key_bits(options) > 32)
+        throw std::invalid_argument("LSH needs at least one table and one hash, and keys of at most 32 bits.");
+
+    if(outputs == 0 || outputs > UINT32_MAX)
+        throw std::invalid_argument("LSH dense layer output count is out of range.");
+
+    return options;
+}
+
+}
+
+LshDenseLayer::LshDenseLayer(
+    const TensorShape& _input_shape,
+    size_t outputs,
+    const LshOptions& _options
+) : Layer(_input_shape, TensorShape{outputs, 1, 1}),
+    options(validated(_options, outputs)),
+    seed(std::random_device()()),
+    bucket_bits(std::min(key_bits(_options), max_bucket_bits)),
+    hash_coordinates(),
+    hash_signs(),
+    coordinates_per_hash(0),
+    weights(outputs * _input_shape.size()),
+    biases(outputs, 0.0),
+    weight_gradients(outputs * _input_shape.size(), 0.0),
+    bias_gradients(outputs, 0.0),
+    touched_neurons(),
+    touched(outputs, 0),
+    index(),
+    active(),
+    active_offsets(),
+    stamps(outputs, 0),
+    stamp(0),
+    keys(_options.tables),
+    active_values(),
+    target_neurons(),
+    target_offsets(),
+    training(true),
+    updates_since_rebuild(0),
+    snapshot(),
+    rebuilding()
+{
+    if(_input_shape.size() == 0 || _input_shape.size() > UINT32_MAX)
+        throw std::invalid_argument("LSH dense layer input size is out of range.");
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(
+        0.0,
+        1.0 / std::sqrt(static_cast<double>(_input_shape.size()))
+    );
+
+    for(double& weight : this->weights)
+        weight = dist(gen);
+
+    this->initialize_hashes();
+}
+
+void LshDenseLayer::initialize_hashes() {
+    const size_t n_in = this->input_shape.size();
+    const size_t hashes = this->options.tables * this->options.hashes;
+
+    // SimHash projections are sparse: each reads a third of the inputs.
+    this->coordinates_per_hash = this->options.family == LshFamily::DWTA ?
+        dwta_coordinates : std::max<size_t>(n_in / 3, 1);
+
+    std::mt19937_64 gen(this->seed);
+    std::uniform_int_distribution<uint32_t> coordinate(0, static_cast<uint32_t>(n_in - 1));
+
+    this->hash_coordinates.resize(hashes * this->coordinates_per_hash);
+    for(uint32_t& value : this->hash_coordinates)
+        value = coordinate(gen);
+
+    this->hash_signs.assign(this->hash_coordinates.size(), 1);
+    if(this->options.family == LshFamily::SimHash)
+        for(int8_t& sign : this->hash_signs)
+            sign = (gen() & 1) ? int8_t(1) : int8_t(-1);
+}
+
+std::unique_ptr<LshDenseLayer> LshDenseLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    LshOptions stored;
+    stored.family = static_cast<LshFamily>(ModelStream::read<uint32_t>(stream));
+    stored.tables = ModelStream::read_size(stream);
+    stored.hashes = ModelStream::read_size(stream);
+    stored.rebuild_interval = ModelStream::read_size(stream);
+    stored.max_active = ModelStream::read_size(stream);
+    stored.exact_inference = ModelStream::read<uint8_t>(stream) != 0;
+
+    const uint64_t stored_seed = ModelStream::read<uint64_t>(stream);
+    const size_t outputs = ModelStream::read_size(stream);
+
+    if(stored.tables > 4096 || outputs > std::numeric_limits<uint32_t>::max() ||
+        outputs > ModelStream::max_elements / std::max<size_t>(_input_shape.size(), 1))
+        throw ModelLoaderException("Invalid *.chisei file format, bad LSH dense layer.");
+
+    std::unique_ptr<LshDenseLayer> layer;
+    try {
+        layer.reset(new LshDenseLayer(_input_shape, outputs, stored));
+    }
+    catch(const std::invalid_argument&) {
+        throw ModelLoaderException("Invalid *.chisei file format, bad LSH dense layer.");
+    }
+
+    layer->seed = stored_seed;
+    layer->initialize_hashes();
+
+    ModelStream::read_array(stream, layer->weights);
+    ModelStream::read_array(stream, layer->biases);
+
+    return layer;
+}
+
+LayerType LshDenseLayer::type() const noexcept {
+    return LayerType::LshDense;
+}
+
+bool LshDenseLayer::supports_fused_activation() const noexcept {
+    return true;
+}
+
+void LshDenseLayer::prepare(size_t max_batch) {
+    this->current_index();
+    this->active_offsets.reserve(max_batch + 1);
+}
+
+void LshDenseLayer::set_training(bool _training) {
+    this->training = _training;
+}
+
+void LshDenseLayer::hash(const double* vector, uint32_t* out) const {
+    const size_t bits = key_bits(this->options);
+    const size_t per_hash = this->coordinates_per_hash;
+
+    for(size_t table = 0; table < this->options.tables; ++table) {
+        uint32_t key = 0;
+
+        for(size_t h = 0; h < this->options.hashes; ++h) {
+            const size_t base = (table * this->options.hashes + h) * per_hash;
+            const uint32_t* coordinates = this->hash_coordinates.data() + base;
+
+            if(this->options.family == LshFamily::DWTA) {
+                uint32_t winner = 0;
+                double best = vector[coordinates[0]];
+
+                for(uint32_t c = 1; c < per_hash; ++c)
+                    if(vector[coordinates[c]] > best) {
+                        best = vector[coordinates[c]];
+                        winner = c;
+                    }
+
+                key = (key << 3) | winner;
+            }
+            else {
+                const int8_t* signs = this->hash_signs.data() + base;
+                double projection = 0.0;
+
+                for(size_t c = 0; c < per_hash; ++c)
+                    projection += signs[c] * vector[coordinates[c]];
+
+                key = (key << 1) | (projection > 0.0 ? 1u : 0u);
+            }
+        }
+
+        // Fibonacci hashing keeps the high, best-mixed bits of wide keys.
+        out[table] = bits <= this->bucket_bits ? key :
+            static_cast<uint32_t>((key * 2654435769u) >> (32 - this->bucket_bits));
+    }
+}
+
+LshDenseLayer::Index LshDenseLayer::build_index(const double* source) const {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+    const size_t tables = this->options.tables;
+    const size_t buckets = size_t(1) << this->bucket_bits;
+
+    std::vector<uint32_t> neuron_keys(n_out * tables);
+
+    #pragma omp parallel for schedule(static)
+    for(size_t neuron = 0; neuron < n_out; ++neuron)
+        this->hash(source + neuron * n_in, neuron_keys.data() + neuron * tables);
+
+    Index built;
+    built.offsets.assign(tables * (buckets + 1), 0);
+    built.neurons.resize(tables * n_out);
+
+    // Counting sort of the neurons by key, table by table.
+    for(size_t table = 0; table < tables; ++table) {
+        uint32_t* offsets = built.offsets.data() + table * (buckets + 1);
+        uint32_t* neurons = built.neurons.data() + table * n_out;
+
+        for(size_t neuron = 0; neuron < n_out; ++neuron)
+            ++offsets[neuron_keys[neuron * tables + table] + 1];
+
+        for(size_t bucket = 0; bucket < buckets; ++bucket)
+            offsets[bucket + 1] += offsets[bucket];
+
+        std::vector<uint32_t> cursor(offsets, offsets + buckets);
+        for(size_t neuron = 0; neuron < n_out; ++neuron)
+            neurons[cursor[neuron_keys[neuron * tables + table]]++] =
+                static_cast<uint32_t>(neuron);
+    }
+
+    return built;
+}
+
+void LshDenseLayer::collect_rebuild() {
+    if(this->rebuilding.valid() &&
+        this->rebuilding.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+        this->index = this->rebuilding.get();
+}
+
+const LshDenseLayer::Index& LshDenseLayer::current_index() {
+    this->collect_rebuild();
+
+    if(this->index.offsets.empty())
+        this->index = this->build_index(this->weights.data());
+
+    return this->index;
+}
+
+void LshDenseLayer::rebuild() {
+    if(this->rebuilding.valid())
+        this->rebuilding.get();
+
+    this->index = this->build_index(this->weights.data());
+    this->updates_since_rebuild = 0;
+}
+
+double LshDenseLayer::evaluate(size_t neuron, const double* input) const {
+    const size_t n_in = this->input_shape.size();
+    const double* row = this->weights.data() + neuron * n_in;
+    double sum = this->biases[neuron];
+
+    for(size_t i = 0; i < n_in; ++i)
+        sum += row[i] * input[i];
+
+    return sum;
+}
+
+void LshDenseLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+    const bool exact = !this->training && this->options.exact_inference;
+
+    const Index& tables = this->current_index();
+    const size_t buckets = size_t(1) << this->bucket_bits;
+
+    this->active.clear();
+    this->active_offsets.assign(1, 0);
+
+    for(size_t sample = 0; sample < batch; ++sample) {
+        const double* x = input + sample * n_in;
+        double* y = output + sample * n_out;
+        const size_t first = this->active.size();
+
+        if(exact)
+            for(size_t neuron = 0; neuron < n_out; ++neuron)
+                this->active.push_back(static_cast<uint32_t>(neuron));
+        else {
+            this->hash(x, this->keys.data());
+
+            if(++this->stamp == 0) {
+                std::fill(this->stamps.begin(), this->stamps.end(), 0);
+                this->stamp = 1;
+            }
+
+            const size_t limit = this->options.max_active == 0 ?
+                n_out : this->options.max_active;
+
+            for(size_t table = 0; table < this->options.tables && this->active.size() - first < limit; ++table) {
+                const uint32_t* offsets = tables.offsets.data() + table * (buckets + 1);
+                const uint32_t* neurons = tables.neurons.data() + table * n_out;
+
+                for(uint32_t k = offsets[this->keys[table]]; k < offsets[this->keys[table] + 1]; ++k) {
+                    const uint32_t neuron = neurons[k];
+                    if(this->stamps[neuron] == this->stamp)
+                        continue;
+
+                    this->stamps[neuron] = this->stamp;
+                    this->active.push_back(neuron);
+
+                    if(this->active.size() - first == limit)
+                        break;
+                }
+            }
+        }
+
+        const size_t count = this->active.size() - first;
+        const uint32_t* neurons = this->active.data() + first;
+        this->active_values.resize(count);
+        double* values = this->active_values.data();
+
+        #pragma omp parallel for schedule(static) if(count * n_in >= 65536)
+        for(size_t k = 0; k < count; ++k)
+            values[k] = this->evaluate(neurons[k], x);
+
+        if(this->fused_approximation)
+            this->fused_approximation->apply(values, values, count);
+        else if(this->has_fused_activation)
+            ActivationLayer::apply(this->fused_activation, values, values, count);
+
+        std::fill(y, y + n_out, 0.0);
+        for(size_t k = 0; k < count; ++k)
+            y[neurons[k]] = values[k];
+
+        this->active_offsets.push_back(this->active.size());
+    }
+}
+
+void LshDenseLayer::accumulate(
+    size_t neuron,
+    double gradient,
+    const double* input,
+    double* input_gradient
+) {
+    const size_t n_in = this->input_shape.size();
+    const double* row = this->weights.data() + neuron * n_in;
+    double* row_gradient = this->weight_gradients.data() + neuron * n_in;
+
+    for(size_t i = 0; i < n_in; ++i)
+        row_gradient[i] += gradient * input[i];
+
+    if(input_gradient != nullptr)
+        for(size_t i = 0; i < n_in; ++i)
+            input_gradient[i] += gradient * row[i];
+
+    this->bias_gradients[neuron] += gradient;
+    if(!this->touched[neuron]) {
+        this->touched[neuron] = 1;
+        this->touched_neurons.push_back(static_cast<uint32_t>(neuron));
+    }
+}
+
+void LshDenseLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    if(input_gradient != nullptr)
+        std::fill(input_gradient, input_gradient + batch * n_in, 0.0);
+
+    for(size_t sample = 0; sample < batch && sample + 1 < this->active_offsets.size(); ++sample) {
+        const double* x = input + sample * n_in;
+        const double* y = output + sample * n_out;
+        const double* dy = output_gradient + sample * n_out;
+        double* dx = input_gradient != nullptr ? input_gradient + sample * n_in : nullptr;
+
+        if(++this->stamp == 0) {
+            std::fill(this->stamps.begin(), this->stamps.end(), 0);
+            this->stamp = 1;
+        }
+
+        for(size_t k = this->active_offsets[sample]; k < this->active_offsets[sample + 1]; ++k) {
+            const uint32_t neuron = this->active[k];
+            double gradient = dy[neuron];
+
+            if(this->has_fused_activation)
+                ActivationLayer::apply_derivative(
+                    this->fused_activation, y + neuron, dy + neuron, &gradient, 1
+                );
+
+            this->stamps[neuron] = this->stamp;
+            this->accumulate(neuron, gradient, x, dx);
+        }
+
+        if(sample + 1 >= this->target_offsets.size())
+            continue;
+
+        // Targets the tables missed are trained from their actual value so
+        // that they can be found.
+        for(size_t k = this->target_offsets[sample]; k < this->target_offsets[sample + 1]; ++k) {
+            const uint32_t neuron = this->target_neurons[k];
+            if(this->stamps[neuron] == this->stamp)
+                continue;
+
+            this->stamps[neuron] = this->stamp;
+
+            double gradient = dy[neuron];
+            if(this->has_fused_activation) {
+                double value = this->evaluate(neuron, x);
+                ActivationLayer::apply(this->fused_activation, &value, &value, 1);
+                ActivationLayer::apply_derivative(
+                    this->fused_activation, &value, dy + neuron, &gradient, 1
+                );
+            }
+
+            this->accumulate(neuron, gradient, x, dx);
+        }
+    }
+
+    this->target_neurons.clear();
+    this->target_offsets.clear();
+}
+
+void LshDenseLayer::set_targets(const uint32_t* neurons, const size_t* offsets, size_t batch) {
+    const size_t n_out = this->output_shape.size();
+    const size_t count = offsets[batch];
+
+    for(size_t k = 0; k < count; ++k)
+        if(neurons[k] >= n_out)
+            throw std::invalid_argument("LSH dense layer target is out of range.");
+
+    this->target_neurons.assign(neurons, neurons + count);
+    this->target_offsets.assign(offsets, offsets + batch + 1);
+}
+
+void LshDenseLayer::update(double learning_rate) {
+    const size_t n_in = this->input_shape.size();
+
+    for(uint32_t neuron : this->touched_neurons) {
+        double* row = this->weights.data() + neuron * n_in;
+        double* row_gradient = this->weight_gradients.data() + neuron * n_in;
+
+        for(size_t i = 0; i < n_in; ++i) {
+            row[i] -= learning_rate * row_gradient[i];
+            row_gradient[i] = 0.0;
+        }
+
+        this->biases[neuron] -= learning_rate * this->bias_gradients[neuron];
+        this->bias_gradients[neuron] = 0.0;
+        this->touched[neuron] = 0;
+    }
+    this->touched_neurons.clear();
+
+    this->collect_rebuild();
+    if(this->options.rebuild_interval == 0 ||
+        ++this->updates_since_rebuild < this->options.rebuild_interval ||
+        this->rebuilding.valid())
+        return;
+
+    // The rebuild hashes a snapshot, so training keeps writing the live weights.
+    this->snapshot = this->weights;
+    this->updates_since_rebuild = 0;
+    this->rebuilding = std::async(std::launch::async, [this]() {
+        return this->build_index(this->snapshot.data());
+    });
+}
+
+size_t LshDenseLayer::parameter_count() const noexcept {
+    return this->weights.size() + this->biases.size();
+}
+
+std::vector<double> LshDenseLayer::weight_values() const {
+    return this->weights;
+}
+
+void LshDenseLayer::save(std::ostream& stream) const {
+    ModelStream::write(stream, static_cast<uint32_t>(this->options.family));
+    ModelStream::write_size(stream, this->options.tables);
+    ModelStream::write_size(stream, this->options.hashes);
+    ModelStream::write_size(stream, this->options.rebuild_interval);
+    ModelStream::write_size(stream, this->options.max_active);
+    ModelStream::write(stream, static_cast<uint8_t>(this->options.exact_inference ? 1 : 0));
+    ModelStream::write(stream, this->seed);
+    ModelStream::write_size(stream, this->output_shape.size());
+    ModelStream::write_array(stream, this->weights);
+    ModelStream::write_array(stream, this->biases);
+}
+
+size_t LshDenseLayer::active_count() const noexcept {
+    return this->active.size();
+}
+
+const LshOptions& LshDenseLayer::get_options() const noexcept {
+    return this->options;
+}
+
+}
@@ -0,0 +1,118 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/mapped_file.hpp>
+#include <chisei/model_loader_exception.hpp>
+
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define CHISEI_HAS_MMAP 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace chisei {
+
+MappedFile::MappedFile(const std::string& filename, bool use_mmap) :
+    mapping(nullptr),
+    length(0),
+    buffer()
+{
+    #ifdef CHISEI_HAS_MMAP
+    if(use_mmap) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if(fd < 0)
+            throw ModelLoaderException("Failed to open file for loading model.");
+
+        struct stat info;
+        if(::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw ModelLoaderException("Failed to read file size of model.");
+        }
+
+        this->length = static_cast<size_t>(info.st_size);
+        if(this->length > 0) {
+            void* address = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if(address != MAP_FAILED)
+                this->mapping = address;
+        }
+
+        ::close(fd);
+        if(this->mapping != nullptr || this->length == 0)
+            return;
+    }
+    #else
+    (void) use_mmap;
+    #endif
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if(!file.is_open())
+        throw ModelLoaderException("Failed to open file for loading model.");
+
+    this->length = static_cast<size_t>(file.tellg());
+    this->buffer.resize(this->length);
+
+    file.seekg(0);
+    file.read(this->buffer.data(), static_cast<std::streamsize>(this->length));
+
+    if(!file)
+        throw ModelLoaderException("Failed to read model file.");
+}
+
+MappedFile::~MappedFile() {
+    #ifdef CHISEI_HAS_MMAP
+    if(this->mapping != nullptr)
+        ::munmap(this->mapping, this->length);
+    #endif
+}
+
+const char* MappedFile::data() const noexcept {
+    if(this->mapping != nullptr)
+        return static_cast<const char*>(this->mapping);
+    return this->buffer.data();
+}
+
+size_t MappedFile::size() const noexcept {
+    return this->length;
+}
+
+bool MappedFile::is_mapped() const noexcept {
+    return this->mapping != nullptr;
+}
+
+}
@@ -0,0 +1,189 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/metrics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace chisei {
+
+namespace {
+
+template<typename Histogram, size_t Buckets>
+void observe(Histogram& histogram, const std::array<double, Buckets>& bounds, double value) {
+    const size_t bucket = static_cast<size_t>(
+        std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin()
+    );
+
+    if(bucket < Buckets)
+        histogram.counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    histogram.count.fetch_add(1, std::memory_order_relaxed);
+}
+
+template<typename Histogram, size_t Buckets>
+void copy_histogram(
+    const Histogram& histogram,
+    const std::array<double, Buckets>& bounds,
+    double unit,
+    HistogramSnapshot<Buckets>& snapshot
+) {
+    snapshot.bounds = bounds;
+    for(size_t bucket = 0; bucket < Buckets; ++bucket)
+        snapshot.counts[bucket] = histogram.counts[bucket].load(std::memory_order_relaxed);
+
+    snapshot.count = histogram.count.load(std::memory_order_relaxed);
+    snapshot.sum = static_cast<double>(histogram.sum.load(std::memory_order_relaxed)) * unit;
+}
+
+template<typename Histogram>
+void clear_histogram(Histogram& histogram) {
+    for(std::atomic<uint64_t>& count : histogram.counts)
+        count.store(0, std::memory_order_relaxed);
+
+    histogram.count.store(0, std::memory_order_relaxed);
+    histogram.sum.store(0, std::memory_order_relaxed);
+}
+
+}
+
+Metrics::Metrics() :
+    latency(),
+    batch_size(),
+    epochs(0),
+    trained_samples(0),
+    samples_per_second(0.0),
+    epoch_loss(0.0),
+    parameter_bytes(0),
+    allocated_bytes(0),
+    peak_allocated_bytes(0) { }
+
+void Metrics::record_prediction(size_t samples, double seconds) noexcept {
+    observe(this->latency, latency_bounds, seconds);
+    this->latency.sum.fetch_add(
+        static_cast<uint64_t>(std::llround(std::max(seconds, 0.0) * 1e9)),
+        std::memory_order_relaxed
+    );
+
+    observe(this->batch_size, batch_size_bounds, static_cast<double>(samples));
+    this->batch_size.sum.fetch_add(samples, std::memory_order_relaxed);
+}
+
+void Metrics::record_epoch(size_t samples, double seconds, double loss) noexcept {
+    this->epochs.fetch_add(1, std::memory_order_relaxed);
+    this->trained_samples.fetch_add(samples, std::memory_order_relaxed);
+    this->epoch_loss.store(loss, std::memory_order_relaxed);
+
+    if(seconds > 0.0)
+        this->samples_per_second.store(
+            static_cast<double>(samples) / seconds,
+            std::memory_order_relaxed
+        );
+}
+
+void Metrics::set_parameter_bytes(size_t bytes) noexcept {
+    this->parameter_bytes.store(bytes, std::memory_order_relaxed);
+}
+
+void Metrics::record_allocation(size_t bytes, bool allocated) noexcept {
+    if(!allocated) {
+        this->allocated_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        return;
+    }
+
+    const uint64_t current = this->allocated_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    uint64_t peak = this->peak_allocated_bytes.load(std::memory_order_relaxed);
+
+    while(current > peak &&
+        !this->peak_allocated_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        ;
+}
+
+void Metrics::reset() noexcept {
+    clear_histogram(this->latency);
+    clear_histogram(this->batch_size);
+
+    this->epochs.store(0, std::memory_order_relaxed);
+    this->trained_samples.store(0, std::memory_order_relaxed);
+    this->samples_per_second.store(0.0, std::memory_order_relaxed);
+    this->epoch_loss.store(0.0, std::memory_order_relaxed);
+    this->peak_allocated_bytes.store(
+        this->allocated_bytes.load(std::memory_order_relaxed),
+        std::memory_order_relaxed
+    );
+}
+
+MetricsSnapshot Metrics::snapshot() const noexcept {
+    MetricsSnapshot snapshot;
+
+    copy_histogram(this->latency, latency_bounds, 1e-9, snapshot.predict_latency);
+    copy_histogram(this->batch_size, batch_size_bounds, 1.0, snapshot.predict_batch_size);
+
+    snapshot.predicted_samples = this->batch_size.sum.load(std::memory_order_relaxed);
+    snapshot.epochs = this->epochs.load(std::memory_order_relaxed);
+    snapshot.trained_samples = this->trained_samples.load(std::memory_order_relaxed);
+    snapshot.train_samples_per_second = this->samples_per_second.load(std::memory_order_relaxed);
+    snapshot.epoch_loss = this->epoch_loss.load(std::memory_order_relaxed);
+    snapshot.parameter_bytes = this->parameter_bytes.load(std::memory_order_relaxed);
+    snapshot.allocated_bytes = this->allocated_bytes.load(std::memory_order_relaxed);
+    snapshot.peak_allocated_bytes = this->peak_allocated_bytes.load(std::memory_order_relaxed);
+
+    return snapshot;
+}
+
+MetricsMemoryResource::MetricsMemoryResource(
+    std::shared_ptr<Metrics> _metrics,
+    std::pmr::memory_resource* _upstream
+) :
+    metrics(std::move(_metrics)),
+    upstream(_upstream) { }
+
+void* MetricsMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void* pointer = this->upstream->allocate(bytes, alignment);
+    this->metrics->record_allocation(bytes, true);
+
+    return pointer;
+}
+
+void MetricsMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    this->upstream->deallocate(pointer, bytes, alignment);
+    this->metrics->record_allocation(bytes, false);
+}
+
+bool MetricsMemoryResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+}
@@ -0,0 +1,350 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/kernel_autotuner.hpp>
+#include <chisei/metrics_exporter.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#   define CHISEI_HAS_SOCKETS 1
+#   include <arpa/inet.h>
+#   include <netinet/in.h>
+#   include <poll.h>
+#   include <sys/socket.h>
+#   include <unistd.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+std::string format_number(double value) {
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%.15g", value);
+
+    return std::string(buffer, static_cast<size_t>(length));
+}
+
+void describe(
+    std::string& text,
+    const std::string& name,
+    const char* type,
+    const char* unit,
+    const char* help
+) {
+    text += "# TYPE " + name + " " + type + "\n";
+    if(unit != nullptr)
+        text += "# UNIT " + name + " " + unit + "\n";
+    text += "# HELP " + name + " " + help + "\n";
+}
+
+void add_counter(std::string& text, const std::string& name, const char* help, uint64_t value) {
+    describe(text, name, "counter", nullptr, help);
+    text += name + "_total " + std::to_string(value) + "\n";
+}
+
+void add_gauge(
+    std::string& text,
+    const std::string& name,
+    const char* unit,
+    const char* help,
+    double value
+) {
+    describe(text, name, "gauge", unit, help);
+    text += name + " " + format_number(value) + "\n";
+}
+
+template<size_t Buckets>
+void add_histogram(
+    std::string& text,
+    const std::string& name,
+    const char* unit,
+    const char* help,
+    const HistogramSnapshot<Buckets>& histogram
+) {
+    describe(text, name, "histogram", unit, help);
+
+    // OpenMetrics buckets are cumulative.
+    uint64_t cumulative = 0;
+    for(size_t bucket = 0; bucket < Buckets; ++bucket) {
+        cumulative += histogram.counts[bucket];
+        text += name + "_bucket{le=\"" + format_number(histogram.bounds[bucket]) + "\"} " +
+            std::to_string(cumulative) + "\n";
+    }
+
+    text += name + "_bucket{le=\"+Inf\"} " + std::to_string(histogram.count) + "\n" +
+        name + "_count " + std::to_string(histogram.count) + "\n" +
+        name + "_sum " + format_number(histogram.sum) + "\n";
+}
+
+#ifdef CHISEI_HAS_SOCKETS
+bool send_all(int client, const std::string& data) {
+    #ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+
+    size_t sent = 0;
+    while(sent < data.size()) {
+        const ssize_t written = ::send(client, data.data() + sent, data.size() - sent, flags);
+        if(written <= 0)
+            return false;
+
+        sent += static_cast<size_t>(written);
+    }
+
+    return true;
+}
+#endif
+
+}
+
+MetricsExporter::MetricsExporter(std::shared_ptr<const Metrics> _metrics) :
+    metrics(std::move(_metrics)),
+    worker(),
+    mutex(),
+    wake(),
+    stopping(false),
+    listener(-1),
+    bound_port(0)
+{
+    if(!this->metrics)
+        throw std::invalid_argument("MetricsExporter requires a Metrics collector.");
+}
+
+MetricsExporter::~MetricsExporter() {
+    this->stop();
+}
+
+std::string MetricsExporter::render() const {
+    const MetricsSnapshot snapshot = this->metrics->snapshot();
+    const TuningCacheStatistics cache = KernelAutotuner::cache_statistics();
+    std::string text;
+
+    add_histogram(text, "chisei_predict_latency_seconds", "seconds",
+        "Latency of predict calls.", snapshot.predict_latency);
+    add_histogram(text, "chisei_predict_batch_size", nullptr,
+        "Samples per predict call.", snapshot.predict_batch_size);
+    add_counter(text, "chisei_predict_samples",
+        "Samples predicted.", snapshot.predicted_samples);
+
+    add_counter(text, "chisei_train_epochs",
+        "Training epochs completed.", snapshot.epochs);
+    add_counter(text, "chisei_train_samples",
+        "Samples trained on.", snapshot.trained_samples);
+    add_gauge(text, "chisei_train_samples_per_second", nullptr,
+        "Training throughput of the last epoch.", snapshot.train_samples_per_second);
+    add_gauge(text, "chisei_train_loss", nullptr,
+        "Mean squared error over the last epoch.", snapshot.epoch_loss);
+
+    add_counter(text, "chisei_kernel_cache_hits",
+        "Kernel configuration lookups answered by the tuning cache.", cache.hits);
+    add_counter(text, "chisei_kernel_cache_misses",
+        "Kernel configuration lookups missing from the tuning cache.", cache.misses);
+    add_gauge(text, "chisei_kernel_cache_hit_ratio", nullptr,
+        "Fraction of kernel configuration lookups answered by the tuning cache.",
+        cache.hits + cache.misses == 0 ? 0.0 :
+            static_cast<double>(cache.hits) / static_cast<double>(cache.hits + cache.misses));
+
+    add_gauge(text, "chisei_parameter_bytes", "bytes",
+        "Bytes of weights and biases.", static_cast<double>(snapshot.parameter_bytes));
+    add_gauge(text, "chisei_memory_allocated_bytes", "bytes",
+        "Bytes allocated through a MetricsMemoryResource.",
+        static_cast<double>(snapshot.allocated_bytes));
+    add_gauge(text, "chisei_memory_peak_bytes", "bytes",
+        "Most bytes allocated at once through a MetricsMemoryResource.",
+        static_cast<double>(snapshot.peak_allocated_bytes));
+
+    text += "# EOF\n";
+    return text;
+}
+
+void MetricsExporter::write_file(const std::string& path) const {
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        const std::string text = this->render();
+
+        file.write(text.data(), static_cast<std::streamsize>(text.size()));
+        if(!file)
+            throw std::runtime_error("Failed to write metrics file.");
+    }
+
+    if(std::rename(temporary.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("Failed to replace metrics file.");
+}
+
+void MetricsExporter::start_file(const std::string& path, std::chrono::milliseconds interval) {
+    if(this->worker.joinable())
+        throw std::logic_error("Metrics export is already running.");
+
+    this->worker = std::thread([this, path, interval]() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+
+        while(!this->stopping) {
+            lock.unlock();
+            try {
+                this->write_file(path);
+            }
+            catch(const std::runtime_error&) {
+                // Retried at the next interval, e.g. once the directory exists.
+            }
+            lock.lock();
+
+            this->wake.wait_for(lock, interval, [this]() { return this->stopping; });
+        }
+    });
+}
+
+void MetricsExporter::start_http(uint16_t port, const std::string& address) {
+    if(this->worker.joinable())
+        throw std::logic_error("Metrics export is already running.");
+
+    #ifdef CHISEI_HAS_SOCKETS
+    sockaddr_in endpoint{};
+    endpoint.sin_family = AF_INET;
+    endpoint.sin_port = htons(port);
+
+    if(::inet_pton(AF_INET, address.c_str(), &endpoint.sin_addr) != 1)
+        throw std::runtime_error("Invalid metrics endpoint address.");
+
+    const int descriptor = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(descriptor < 0)
+        throw std::runtime_error("Failed to create metrics endpoint socket.");
+
+    const int reuse = 1;
+    ::setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    socklen_t length = sizeof(endpoint);
+    if(::bind(descriptor, reinterpret_cast<const sockaddr*>(&endpoint), sizeof(endpoint)) != 0 ||
+        ::listen(descriptor, 16) != 0 ||
+        ::getsockname(descriptor, reinterpret_cast<sockaddr*>(&endpoint), &length) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Failed to bind metrics endpoint.");
+    }
+
+    this->listener = descriptor;
+    this->bound_port = ntohs(endpoint.sin_port);
+    this->worker = std::thread(&MetricsExporter::serve, this);
+    #else
+    (void) port;
+    (void) address;
+
+    throw std::runtime_error("HTTP metrics export is not supported on this platform.");
+    #endif
+}
+
+void MetricsExporter::serve() {
+    #ifdef CHISEI_HAS_SOCKETS
+    for(;;) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if(this->stopping)
+                return;
+        }
+
+        // Wakes up regularly to notice `stop`.
+        pollfd waiting{this->listener, POLLIN, 0};
+        if(::poll(&waiting, 1, 100) <= 0)
+            continue;
+
+        const int client = ::accept(this->listener, nullptr, nullptr);
+        if(client < 0)
+            continue;
+
+        std::string request;
+        char buffer[1024];
+
+        while(request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+            pollfd readable{client, POLLIN, 0};
+            if(::poll(&readable, 1, 1000) <= 0)
+                break;
+
+            const ssize_t received = ::recv(client, buffer, sizeof(buffer), 0);
+            if(received <= 0)
+                break;
+
+            request.append(buffer, static_cast<size_t>(received));
+        }
+
+        const bool found = request.rfind("GET /metrics ", 0) == 0 ||
+            request.rfind("GET /metrics?", 0) == 0 || request.rfind("GET / ", 0) == 0;
+        const std::string body = found ? this->render() : "Not Found\n";
+
+        send_all(client,
+            std::string(found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n") +
+            "Content-Type: " + (found ?
+                "application/openmetrics-text; version=1.0.0; charset=utf-8" :
+                "text/plain; charset=utf-8") + "\r\n" +
+            "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+            "Connection: close\r\n\r\n" + body
+        );
+
+        ::close(client);
+    }
+    #endif
+}
+
+uint16_t MetricsExporter::port() const noexcept {
+    return this->bound_port;
+}
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+
+    this->wake.notify_all();
+    if(this->worker.joinable())
+        this->worker.join();
+
+    #ifdef CHISEI_HAS_SOCKETS
+    if(this->listener >= 0)
+        ::close(this->listener);
+    #endif
+
+    this->listener = -1;
+    this->bound_port = 0;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->stopping = false;
+}
+
+}
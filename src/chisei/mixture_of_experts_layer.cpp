@@ -0,0 +1,505 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/dense_kernels.hpp>
+#include <chisei/kernel_autotuner.hpp>
+#include <chisei/mixture_of_experts_layer.hpp>
+#include <chisei/model_stream.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace chisei {
+
+MixtureOfExpertsLayer::MixtureOfExpertsLayer(
+    const TensorShape& _input_shape,
+    size_t outputs,
+    size_t _experts,
+    size_t _top_k,
+    double _balance_weight
+) : Layer(_input_shape, TensorShape{outputs, 1, 1}),
+    experts(_experts),
+    top_k(_top_k),
+    balance_weight(_balance_weight),
+    gate_weights(_input_shape.size() * _experts),
+    gate_biases(_experts, 0.0),
+    expert_weights(_experts * _input_shape.size() * outputs),
+    expert_biases(_experts * outputs, 0.0),
+    gate_weight_gradients(_input_shape.size() * _experts, 0.0),
+    gate_bias_gradients(_experts, 0.0),
+    expert_weight_gradients(_experts * _input_shape.size() * outputs, 0.0),
+    expert_bias_gradients(_experts * outputs, 0.0),
+    expert_touched(_experts, 0),
+    probabilities(),
+    route_positions(),
+    expert_offsets(_experts + 1, 0),
+    expert_cursors(_experts, 0),
+    slot_experts(),
+    slot_gates(),
+    routed_samples(),
+    routed_experts(),
+    routed_gates(),
+    routed_inputs(),
+    routed_outputs(),
+    routed_gradients(),
+    routed_input_gradients(),
+    gate_gradients(),
+    gate_output_gradients(),
+    balance_gradients(_experts, 0.0),
+    statistics()
+{
+    if(_experts == 0 || _top_k == 0 || _top_k > _experts)
+        throw std::invalid_argument("Mixture of experts needs 1 <= top_k <= experts.");
+
+    if(outputs == 0 || !(_balance_weight >= 0.0))
+        throw std::invalid_argument("Mixture of experts needs outputs and a non-negative balance weight.");
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::normal_distribution<> dist(
+        0.0,
+        1.0 / std::sqrt(static_cast<double>(std::max<size_t>(_input_shape.size(), 1)))
+    );
+
+    for(double& weight : this->expert_weights)
+        weight = dist(gen);
+
+    // A small gate starts routing close to uniform.
+    for(double& weight : this->gate_weights)
+        weight = 0.1 * dist(gen);
+
+    this->reset_statistics();
+}
+
+std::unique_ptr<MixtureOfExpertsLayer> MixtureOfExpertsLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const size_t outputs = ModelStream::read_size(stream);
+    const size_t stored_experts = ModelStream::read_size(stream);
+    const size_t stored_top_k = ModelStream::read_size(stream);
+    const double stored_balance = ModelStream::read<double>(stream);
+
+    // Each factor is checked against the remaining budget before it is
+    // multiplied in, so the expert weight count cannot wrap around.
+    const uint64_t limit = ModelStream::max_elements;
+    const uint64_t inputs = std::max<uint64_t>(_input_shape.size(), 1);
+
+    if(outputs == 0 || outputs > std::numeric_limits<uint32_t>::max() || stored_experts == 0 ||
+        stored_experts > 65536 || stored_top_k == 0 || stored_top_k > stored_experts ||
+        !(stored_balance >= 0.0) || outputs > limit / stored_experts ||
+        static_cast<uint64_t>(outputs) * stored_experts > limit / inputs)
+        throw ModelLoaderException("Invalid *.chisei file format, bad mixture of experts layer.");
+
+    std::unique_ptr<MixtureOfExpertsLayer> layer(new MixtureOfExpertsLayer(
+        _input_shape, outputs, stored_experts, stored_top_k, stored_balance
+    ));
+
+    ModelStream::read_array(stream, layer->gate_weights);
+    ModelStream::read_array(stream, layer->gate_biases);
+    ModelStream::read_array(stream, layer->expert_weights);
+    ModelStream::read_array(stream, layer->expert_biases);
+
+    return layer;
+}
+
+LayerType MixtureOfExpertsLayer::type() const noexcept {
+    return LayerType::MixtureOfExperts;
+}
+
+void MixtureOfExpertsLayer::prepare(size_t max_batch) {
+    const size_t routes = max_batch * this->top_k;
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+
+    this->probabilities.reserve(max_batch * this->experts);
+    this->gate_gradients.reserve(max_batch * this->experts);
+    this->route_positions.reserve(routes);
+    this->slot_experts.reserve(routes);
+    this->slot_gates.reserve(routes);
+    this->gate_output_gradients.reserve(routes);
+    this->routed_samples.reserve(routes);
+    this->routed_experts.reserve(routes);
+    this->routed_gates.reserve(routes);
+    this->routed_inputs.reserve(routes * n_in);
+    this->routed_outputs.reserve(routes * n_out);
+    this->routed_gradients.reserve(routes * n_out);
+    this->routed_input_gradients.reserve(routes * n_in);
+}
+
+void MixtureOfExpertsLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+    const size_t routes = batch * this->top_k;
+
+    this->probabilities.resize(batch * this->experts);
+    DenseKernels::forward(
+        KernelAutotuner::lookup(n_in, this->experts, batch, KernelPrecision::Double),
+        this->gate_weights.data(),
+        this->gate_biases.data(),
+        input,
+        this->probabilities.data(),
+        n_in,
+        this->experts,
+        batch
+    );
+
+    // Softmax per sample, then the top-k experts with their probabilities
+    // renormalized; route slots are first recorded in sample order.
+    this->route_positions.resize(routes);
+    this->slot_experts.resize(routes);
+    this->slot_gates.resize(routes);
+
+    std::fill(this->expert_offsets.begin(), this->expert_offsets.end(), 0);
+    for(size_t sample = 0; sample < batch; ++sample) {
+        double* p = this->probabilities.data() + sample * this->experts;
+        const double peak = *std::max_element(p, p + this->experts);
+        double sum = 0.0;
+
+        for(size_t e = 0; e < this->experts; ++e) {
+            p[e] = std::exp(p[e] - peak);
+            sum += p[e];
+        }
+
+        for(size_t e = 0; e < this->experts; ++e) {
+            p[e] /= sum;
+            this->statistics.gate_mass[e] += p[e];
+        }
+
+        size_t* slots = this->slot_experts.data() + sample * this->top_k;
+        double selected = 0.0;
+
+        for(size_t slot = 0; slot < this->top_k; ++slot) {
+            size_t best = 0;
+            double best_probability = -1.0;
+
+            for(size_t e = 0; e < this->experts; ++e)
+                if(p[e] > best_probability &&
+                    std::find(slots, slots + slot, e) == slots + slot) {
+                    best = e;
+                    best_probability = p[e];
+                }
+
+            slots[slot] = best;
+            selected += best_probability;
+            ++this->expert_offsets[best + 1];
+            ++this->statistics.assignments[best];
+        }
+
+        for(size_t slot = 0; slot < this->top_k; ++slot)
+            this->slot_gates[sample * this->top_k + slot] = p[slots[slot]] / selected;
+    }
+    this->statistics.samples += batch;
+
+    for(size_t e = 0; e < this->experts; ++e)
+        this->expert_offsets[e + 1] += this->expert_offsets[e];
+
+    // Group the routes by expert with a counting sort.
+    std::copy(
+        this->expert_offsets.begin(),
+        this->expert_offsets.end() - 1,
+        this->expert_cursors.begin()
+    );
+
+    this->routed_samples.resize(routes);
+    this->routed_experts.resize(routes);
+    this->routed_gates.resize(routes);
+    this->routed_inputs.resize(routes * n_in);
+
+    for(size_t route = 0; route < routes; ++route) {
+        const size_t position = this->expert_cursors[this->slot_experts[route]]++;
+        const size_t sample = route / this->top_k;
+
+        this->route_positions[route] = position;
+        this->routed_samples[position] = sample;
+        this->routed_experts[position] = this->slot_experts[route];
+        this->routed_gates[position] = this->slot_gates[route];
+
+        std::copy(
+            input + sample * n_in,
+            input + (sample + 1) * n_in,
+            this->routed_inputs.begin() + static_cast<std::ptrdiff_t>(position * n_in)
+        );
+    }
+
+    // One batched kernel per expert over just its samples.
+    this->routed_outputs.resize(routes * n_out);
+    for(size_t e = 0; e < this->experts; ++e) {
+        const size_t first = this->expert_offsets[e];
+        const size_t count = this->expert_offsets[e + 1] - first;
+        if(count == 0)
+            continue;
+
+        DenseKernels::forward(
+            KernelAutotuner::lookup(n_in, n_out, count, KernelPrecision::Double),
+            this->expert_weights.data() + e * n_in * n_out,
+            this->expert_biases.data() + e * n_out,
+            this->routed_inputs.data() + first * n_in,
+            this->routed_outputs.data() + first * n_out,
+            n_in,
+            n_out,
+            count
+        );
+    }
+
+    std::fill(output, output + batch * n_out, 0.0);
+    for(size_t position = 0; position < routes; ++position) {
+        const double gate = this->routed_gates[position];
+        const double* expert_output = this->routed_outputs.data() + position * n_out;
+        double* y = output + this->routed_samples[position] * n_out;
+
+        for(size_t j = 0; j < n_out; ++j)
+            y[j] += gate * expert_output[j];
+    }
+}
+
+void MixtureOfExpertsLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    (void) output;
+    const size_t n_in = this->input_shape.size(), n_out = this->output_shape.size();
+    const size_t routes = batch * this->top_k;
+
+    // Expert path: each route sees the sample's gradient scaled by its gate,
+    // and the gate sees the dot product of that gradient with the route output.
+    this->routed_gradients.resize(routes * n_out);
+    this->gate_output_gradients.resize(routes);
+
+    for(size_t position = 0; position < routes; ++position) {
+        const double gate = this->routed_gates[position];
+        const double* dy = output_gradient + this->routed_samples[position] * n_out;
+        const double* expert_output = this->routed_outputs.data() + position * n_out;
+        double* gradient = this->routed_gradients.data() + position * n_out;
+        double dot = 0.0;
+
+        for(size_t j = 0; j < n_out; ++j) {
+            gradient[j] = gate * dy[j];
+            dot += dy[j] * expert_output[j];
+        }
+
+        this->gate_output_gradients[position] = dot;
+    }
+
+    if(input_gradient != nullptr)
+        this->routed_input_gradients.resize(routes * n_in);
+
+    for(size_t e = 0; e < this->experts; ++e) {
+        const size_t first = this->expert_offsets[e];
+        const size_t count = this->expert_offsets[e + 1] - first;
+        if(count == 0)
+            continue;
+
+        const double* gradient = this->routed_gradients.data() + first * n_out;
+        double* bias_gradient = this->expert_bias_gradients.data() + e * n_out;
+
+        DenseKernels::gemm(
+            true, false,
+            n_in, n_out, count,
+            1.0,
+            this->routed_inputs.data() + first * n_in, n_in,
+            gradient, n_out,
+            1.0,
+            this->expert_weight_gradients.data() + e * n_in * n_out, n_out
+        );
+
+        for(size_t route = 0; route < count; ++route)
+            for(size_t j = 0; j < n_out; ++j)
+                bias_gradient[j] += gradient[route * n_out + j];
+
+        if(input_gradient != nullptr)
+            DenseKernels::gemm(
+                false, true,
+                count, n_in, n_out,
+                1.0,
+                gradient, n_out,
+                this->expert_weights.data() + e * n_in * n_out, n_out,
+                0.0,
+                this->routed_input_gradients.data() + first * n_in, n_in
+            );
+
+        this->expert_touched[e] = 1;
+    }
+
+    // Gate path: the renormalized top-k weights are a softmax over the chosen
+    // logits, and the balancing loss reaches every logit through the full softmax.
+    this->gate_gradients.assign(batch * this->experts, 0.0);
+
+    std::vector<double>& balance = this->balance_gradients;
+    std::fill(balance.begin(), balance.end(), 0.0);
+
+    if(std::isgreater(this->balance_weight, 0.0))
+        for(size_t e = 0; e < this->experts; ++e) {
+            const double fraction = static_cast<double>(
+                this->expert_offsets[e + 1] - this->expert_offsets[e]
+            ) / static_cast<double>(routes);
+
+            balance[e] = this->balance_weight * static_cast<double>(this->experts) *
+                fraction / static_cast<double>(batch);
+        }
+
+    for(size_t sample = 0; sample < batch; ++sample) {
+        double* dz = this->gate_gradients.data() + sample * this->experts;
+        const double* p = this->probabilities.data() + sample * this->experts;
+        const size_t* positions = this->route_positions.data() + sample * this->top_k;
+
+        double weighted = 0.0;
+        for(size_t slot = 0; slot < this->top_k; ++slot)
+            weighted += this->routed_gates[positions[slot]] *
+                this->gate_output_gradients[positions[slot]];
+
+        for(size_t slot = 0; slot < this->top_k; ++slot) {
+            const size_t position = positions[slot];
+            dz[this->routed_experts[position]] += this->routed_gates[position] *
+                (this->gate_output_gradients[position] - weighted);
+        }
+
+        double expected = 0.0;
+        for(size_t e = 0; e < this->experts; ++e)
+            expected += p[e] * balance[e];
+
+        for(size_t e = 0; e < this->experts; ++e)
+            dz[e] += p[e] * (balance[e] - expected);
+    }
+
+    DenseKernels::gemm(
+        true, false,
+        n_in, this->experts, batch,
+        1.0,
+        input, n_in,
+        this->gate_gradients.data(), this->experts,
+        1.0,
+        this->gate_weight_gradients.data(), this->experts
+    );
+
+    for(size_t sample = 0; sample < batch; ++sample)
+        for(size_t e = 0; e < this->experts; ++e)
+            this->gate_bias_gradients[e] += this->gate_gradients[sample * this->experts + e];
+
+    if(input_gradient == nullptr)
+        return;
+
+    DenseKernels::gemm(
+        false, true,
+        batch, n_in, this->experts,
+        1.0,
+        this->gate_gradients.data(), this->experts,
+        this->gate_weights.data(), this->experts,
+        0.0,
+        input_gradient, n_in
+    );
+
+    for(size_t position = 0; position < routes; ++position) {
+        const double* gradient = this->routed_input_gradients.data() + position * n_in;
+        double* dx = input_gradient + this->routed_samples[position] * n_in;
+
+        for(size_t i = 0; i < n_in; ++i)
+            dx[i] += gradient[i];
+    }
+}
+
+void MixtureOfExpertsLayer::update(double learning_rate) {
+    const size_t expert_size = this->input_shape.size() * this->output_shape.size();
+    const size_t n_out = this->output_shape.size();
+
+    for(size_t i = 0; i < this->gate_weights.size(); ++i) {
+        this->gate_weights[i] -= learning_rate * this->gate_weight_gradients[i];
+        this->gate_weight_gradients[i] = 0.0;
+    }
+
+    for(size_t e = 0; e < this->experts; ++e) {
+        this->gate_biases[e] -= learning_rate * this->gate_bias_gradients[e];
+        this->gate_bias_gradients[e] = 0.0;
+
+        // Experts no sample was routed to have no gradient to apply.
+        if(!this->expert_touched[e])
+            continue;
+
+        double* weights = this->expert_weights.data() + e * expert_size;
+        double* gradients = this->expert_weight_gradients.data() + e * expert_size;
+        for(size_t i = 0; i < expert_size; ++i) {
+            weights[i] -= learning_rate * gradients[i];
+            gradients[i] = 0.0;
+        }
+
+        double* bias = this->expert_biases.data() + e * n_out;
+        double* bias_gradient = this->expert_bias_gradients.data() + e * n_out;
+        for(size_t j = 0; j < n_out; ++j) {
+            bias[j] -= learning_rate * bias_gradient[j];
+            bias_gradient[j] = 0.0;
+        }
+
+        this->expert_touched[e] = 0;
+    }
+}
+
+size_t MixtureOfExpertsLayer::parameter_count() const noexcept {
+    return this->gate_weights.size() + this->gate_biases.size() +
+        this->expert_weights.size() + this->expert_biases.size();
+}
+
+std::vector<double> MixtureOfExpertsLayer::weight_values() const {
+    std::vector<double> values(this->gate_weights);
+    values.insert(values.end(), this->expert_weights.begin(), this->expert_weights.end());
+
+    return values;
+}
+
+void MixtureOfExpertsLayer::save(std::ostream& stream) const {
+    ModelStream::write_size(stream, this->output_shape.size());
+    ModelStream::write_size(stream, this->experts);
+    ModelStream::write_size(stream, this->top_k);
+    ModelStream::write(stream, this->balance_weight);
+    ModelStream::write_array(stream, this->gate_weights);
+    ModelStream::write_array(stream, this->gate_biases);
+    ModelStream::write_array(stream, this->expert_weights);
+    ModelStream::write_array(stream, this->expert_biases);
+}
+
+const ExpertStatistics& MixtureOfExpertsLayer::get_statistics() const noexcept {
+    return this->statistics;
+}
+
+void MixtureOfExpertsLayer::reset_statistics() {
+    this->statistics.assignments.assign(this->experts, 0);
+    this->statistics.gate_mass.assign(this->experts, 0.0);
+    this->statistics.samples = 0;
+}
+
+}
@@ -0,0 +1,305 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/model_loader_exception.hpp>
+#include <chisei/model_stream.hpp>
+#include <chisei/multi_task_network.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+constexpr uint32_t multi_task_format_version = 1;
+
+}
+
+MultiTaskNetwork::MultiTaskNetwork(const TensorShape& _input_shape) :
+    trunk(_input_shape),
+    heads(),
+    batch_input(),
+    head_gradient()
+{ }
+
+SequentialNetwork& MultiTaskNetwork::get_trunk() noexcept {
+    return this->trunk;
+}
+
+SequentialNetwork& MultiTaskNetwork::add_task() {
+    this->heads.push_back(std::make_unique<SequentialNetwork>(this->trunk.get_output_shape()));
+    return *this->heads.back();
+}
+
+SequentialNetwork& MultiTaskNetwork::get_task(size_t task) {
+    return *this->heads.at(task);
+}
+
+size_t MultiTaskNetwork::task_count() const noexcept {
+    return this->heads.size();
+}
+
+size_t MultiTaskNetwork::parameter_count() const noexcept {
+    size_t count = this->trunk.parameter_count();
+    for(const auto& head : this->heads)
+        count += head->parameter_count();
+
+    return count;
+}
+
+void MultiTaskNetwork::prepare(size_t batch, CompileMode mode) {
+    if(this->trunk.layer_count() == 0)
+        throw std::invalid_argument("Multi-task trunk has no layers.");
+
+    for(const auto& head : this->heads)
+        if(head->layer_count() == 0 ||
+            !(head->get_input_shape() == this->trunk.get_output_shape()))
+            throw std::invalid_argument("Task head does not match the trunk output.");
+
+    this->trunk.prepare(batch, mode);
+    for(auto& head : this->heads)
+        head->prepare(batch, mode);
+
+    const size_t in_size = this->trunk.get_input_shape().size();
+    const size_t features = this->trunk.get_output_shape().size();
+
+    if(this->batch_input.size() < batch * in_size)
+        this->batch_input.resize(batch * in_size);
+
+    if(mode == CompileMode::Training && this->head_gradient.size() < batch * features)
+        this->head_gradient.resize(batch * features);
+}
+
+std::vector<std::vector<double>> MultiTaskNetwork::predict(const std::vector<double>& input) {
+    this->prepare(1, CompileMode::Inference);
+
+    const double* features = this->trunk.forward(input.data(), 1);
+    std::vector<std::vector<double>> outputs;
+
+    for(auto& head : this->heads) {
+        const double* output = head->forward(features, 1);
+        outputs.emplace_back(output, output + head->get_output_shape().size());
+    }
+
+    return outputs;
+}
+
+std::vector<std::vector<std::vector<double>>> MultiTaskNetwork::predict_batch(
+    const std::vector<std::vector<double>>& inputs,
+    size_t batch_size
+) {
+    std::vector<std::vector<std::vector<double>>> outputs(this->heads.size());
+    if(inputs.empty())
+        return outputs;
+
+    batch_size = std::min(std::max<size_t>(batch_size, 1), inputs.size());
+    this->prepare(batch_size, CompileMode::Inference);
+
+    const size_t in_size = this->trunk.get_input_shape().size();
+    for(size_t start = 0; start < inputs.size(); start += batch_size) {
+        const size_t batch = std::min(batch_size, inputs.size() - start);
+
+        for(size_t sample = 0; sample < batch; ++sample)
+            std::copy(
+                inputs[start + sample].begin(),
+                inputs[start + sample].end(),
+                this->batch_input.begin() + static_cast<std::ptrdiff_t>(sample * in_size)
+            );
+
+        const double* features = this->trunk.forward(this->batch_input.data(), batch);
+        for(size_t task = 0; task < this->heads.size(); ++task) {
+            const size_t out_size = this->heads[task]->get_output_shape().size();
+            const double* output = this->heads[task]->forward(features, batch);
+
+            for(size_t sample = 0; sample < batch; ++sample)
+                outputs[task].emplace_back(
+                    output + sample * out_size,
+                    output + (sample + 1) * out_size
+                );
+        }
+    }
+
+    return outputs;
+}
+
+void MultiTaskNetwork::train(
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<std::vector<double>>>& targets,
+    double learning_rate,
+    int epochs,
+    size_t batch_size
+) {
+    if(targets.size() != this->heads.size())
+        throw std::invalid_argument("Expected one target set per task.");
+
+    for(const auto& task_targets : targets)
+        if(task_targets.size() != inputs.size())
+            throw std::invalid_argument("Expected one target per task and sample.");
+
+    if(inputs.empty())
+        return;
+
+    batch_size = std::max<size_t>(batch_size, 1);
+    this->prepare(batch_size, CompileMode::Training);
+
+    const size_t in_size = this->trunk.get_input_shape().size();
+    const size_t features_size = this->trunk.get_output_shape().size();
+
+    for(int epoch = 0; epoch < epochs; ++epoch)
+        for(size_t start = 0; start < inputs.size(); start += batch_size) {
+            const size_t batch = std::min(batch_size, inputs.size() - start);
+
+            for(size_t sample = 0; sample < batch; ++sample)
+                std::copy(
+                    inputs[start + sample].begin(),
+                    inputs[start + sample].end(),
+                    this->batch_input.begin() + static_cast<std::ptrdiff_t>(sample * in_size)
+                );
+
+            const double* features = this->trunk.forward(this->batch_input.data(), batch);
+            double* trunk_gradient = this->trunk.output_gradient();
+            std::fill(trunk_gradient, trunk_gradient + batch * features_size, 0.0);
+
+            // Every head backpropagates into its own scratch gradient, which is
+            // summed into the trunk output before the single trunk backward pass.
+            const double scale = 1.0 / static_cast<double>(batch);
+            for(size_t task = 0; task < this->heads.size(); ++task) {
+                SequentialNetwork& head = *this->heads[task];
+                const size_t out_size = head.get_output_shape().size();
+
+                const double* output = head.forward(features, batch);
+                double* output_gradient = head.output_gradient();
+
+                for(size_t sample = 0; sample < batch; ++sample)
+                    for(size_t j = 0; j < out_size; ++j)
+                        output_gradient[sample * out_size + j] = scale *
+                            (output[sample * out_size + j] - targets[task][start + sample][j]);
+
+                head.backward(features, this->head_gradient.data(), batch);
+                head.update(learning_rate);
+
+                for(size_t i = 0; i < batch * features_size; ++i)
+                    trunk_gradient[i] += this->head_gradient[i];
+            }
+
+            this->trunk.backward(this->batch_input.data(), nullptr, batch);
+            this->trunk.update(learning_rate);
+        }
+}
+
+double MultiTaskNetwork::compute_accuracy(
+    size_t task,
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets
+) {
+    if(task >= this->heads.size())
+        throw std::out_of_range("Task index out of range.");
+
+    const std::vector<std::vector<double>> predictions = this->predict_batch(inputs)[task];
+    size_t correct_predictions = 0;
+
+    for(size_t i = 0; i < inputs.size(); ++i)
+        if(std::max_element(predictions[i].begin(), predictions[i].end()) - predictions[i].begin() ==
+            std::max_element(targets[i].begin(), targets[i].end()) - targets[i].begin())
+            ++correct_predictions;
+
+    return static_cast<double>(correct_predictions) / (double) inputs.size();
+}
+
+void MultiTaskNetwork::save_model(const std::string& filename, bool fold_batch_norm) const {
+    std::string final_filename = filename;
+    if(final_filename.size() < 7 ||
+        final_filename.substr(final_filename.size() - 7) != ".chisei")
+        final_filename += ".chisei";
+
+    std::ofstream file(final_filename, std::ios::binary);
+    if(!file)
+        throw ModelLoaderException("Failed to open *.chisei file for saving the model.");
+
+    std::ostringstream body(std::ios::out | std::ios::binary);
+    const char magic[] = "MT";
+    body.write(magic, sizeof(magic) - 1);
+
+    ModelStream::write(body, multi_task_format_version);
+    ModelStream::write_size(body, this->heads.size());
+
+    this->trunk.write(body, fold_batch_norm);
+    for(const auto& head : this->heads)
+        head->write(body, fold_batch_norm);
+
+    ModelStream::write_checksummed(file, body.str());
+
+    if(!file)
+        throw ModelLoaderException("Failed to write *.chisei file.");
+}
+
+MultiTaskNetwork MultiTaskNetwork::loadFromModel(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if(!file.is_open())
+        throw ModelLoaderException("Failed to open file for loading model.");
+
+    std::istringstream body(ModelStream::read_checksummed(file), std::ios::in | std::ios::binary);
+    char magic[2] = {0};
+    body.read(magic, sizeof(magic));
+    if(magic[0] != 'M' || magic[1] != 'T')
+        throw ModelLoaderException("Invalid *.chisei file format, missing magic bytes.");
+
+    if(ModelStream::read<uint32_t>(body) != multi_task_format_version)
+        throw ModelLoaderException("Unsupported *.chisei multi-task format version.");
+
+    const size_t task_count = ModelStream::read_size(body);
+    SequentialNetwork trunk = SequentialNetwork::read(body);
+
+    MultiTaskNetwork network(trunk.get_input_shape());
+    network.trunk = std::move(trunk);
+
+    for(size_t task = 0; task < task_count; ++task) {
+        network.heads.push_back(
+            std::make_unique<SequentialNetwork>(SequentialNetwork::read(body))
+        );
+
+        if(!(network.heads.back()->get_input_shape() == network.trunk.get_output_shape()))
+            throw ModelLoaderException("Invalid *.chisei file format, task head does not match the trunk.");
+    }
+
+    if(body.peek() != std::char_traits<char>::eof())
+        throw ModelLoaderException("Invalid *.chisei file format, trailing data.");
+
+    return network;
+}
+
+}
@@ -32,43 +32,232 @@
  * 
  */
 
+#include <chisei/crc32c.hpp>
+#include <chisei/kernel_autotuner.hpp>
+#include <chisei/mapped_file.hpp>
+#include <chisei/model_stream.hpp>
 #include <chisei/neural_network.hpp>
 #include <chisei/model_loader_exception.hpp>
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
 namespace chisei {
 
+namespace {
+
+constexpr char packed_section_tag[4] = {'P', 'K', 'W', 'T'};
+
+// Panels in a packed section have the input transform folded into their
+// first layer whenever the file also holds a transform section.
+constexpr char transform_section_tag[4] = {'I', 'N', 'T', 'F'};
+constexpr char exit_section_tag[4] = {'E', 'X', 'I', 'T'};
+
+// A `ModelStream::checksum_tag` section holds the CRC32C of every byte since
+// the previous one, so the base block and each section that follows it are
+// covered separately.
+constexpr uint64_t section_alignment = 64;
+
+constexpr double pi = 3.14159265358979323846;
+
+class ModelReader final {
+private:
+    const char* data;
+    size_t size;
+    size_t offset;
+    bool verify;
+    uint32_t crc;
+    size_t checked;
+
+public:
+    ModelReader(const char* _data, size_t _size, bool _verify) :
+        data(_data),
+        size(_size),
+        offset(0),
+        verify(_verify),
+        crc(0),
+        checked(0) { }
+
+    ModelReader(const ModelReader&) = delete;
+    ModelReader& operator=(const ModelReader&) = delete;
+
+    void read(void* destination, size_t length) {
+        std::memcpy(destination, this->skip(length), length);
+    }
+
+    template<typename T>
+    T read_value() {
+        T value;
+        this->read(&value, sizeof(value));
+
+        return value;
+    }
+
+    const char* skip(size_t length) {
+        if(length > this->size - this->offset)
+            throw ModelLoaderException("Truncated *.chisei file.");
+
+        const char* position = this->data + this->offset;
+        this->offset += length;
+
+        // Checksumming the bytes as they are consumed keeps verification in
+        // the same pass that reads them or faults their pages in.
+        if(this->verify)
+            this->crc = CRC32C::update(this->crc, position, length);
+
+        return position;
+    }
+
+    size_t position() const {
+        return this->offset;
+    }
+
+    size_t remaining() const {
+        return this->size - this->offset;
+    }
+
+    uint32_t checksum() const {
+        return this->crc;
+    }
+
+    size_t unchecked() const {
+        return this->offset - this->checked;
+    }
+
+    void restart_checksum() {
+        this->crc = 0;
+        this->checked = this->offset;
+    }
+};
+
+class ModelWriter final {
+private:
+    std::ofstream& stream;
+    uint32_t crc;
+
+public:
+    explicit ModelWriter(std::ofstream& _stream) :
+        stream(_stream),
+        crc(0) { }
+
+    ModelWriter(const ModelWriter&) = delete;
+    ModelWriter& operator=(const ModelWriter&) = delete;
+
+    void write(const void* source, size_t length) {
+        this->crc = CRC32C::update(this->crc, source, length);
+        this->stream.write(static_cast<const char*>(source), static_cast<std::streamsize>(length));
+    }
+
+    template<typename T>
+    void write_value(const T& value) {
+        this->write(&value, sizeof(value));
+    }
+
+    void write_checksum() {
+        ModelStream::write_checksum(this->stream, this->crc);
+        this->crc = 0;
+    }
+
+    uint64_t position() {
+        return static_cast<uint64_t>(this->stream.tellp());
+    }
+};
+
+// Margin between the two largest outputs of a head.
+double exit_confidence(const std::pmr::vector<double>& output) {
+    double first = -std::numeric_limits<double>::max();
+    double second = -std::numeric_limits<double>::max();
+
+    for(double value : output)
+        if(value > first) {
+            second = first;
+            first = value;
+        }
+        else if(value > second)
+            second = value;
+
+    return output.size() < 2 ? first : first - second;
+}
+
+size_t argmax(const double* values, size_t size) {
+    return static_cast<size_t>(std::max_element(values, values + size) - values);
+}
+
+double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double mean_squared_error(const double* output, const double* target, size_t size) {
+    double total = 0.0;
+    for(size_t j = 0; j < size; ++j)
+        total += (output[j] - target[j]) * (output[j] - target[j]);
+
+    return total / static_cast<double>(size);
+}
+
+}
+
+NeuralNetwork::NeuralNetwork(
+    const std::vector<size_t>& _layers,
+    std::function<double(double)> _activation,
+    std::function<double(double)> _activation_derivative,
+    std::pmr::memory_resource* _resource
+) : NeuralNetwork(_layers, _activation, _activation_derivative, true, _resource)
+{ }
+
 NeuralNetwork::NeuralNetwork(
     const std::vector<size_t>& _layers,
     std::function<double(double)> _activation,
-    std::function<double(double)> _activation_derivative
-) : layer_sizes(_layers),
-    weights(),
-    biases(),
+    std::function<double(double)> _activation_derivative,
+    bool randomize,
+    std::pmr::memory_resource* _resource
+) : resource(_resource != nullptr ? _resource : std::pmr::get_default_resource()),
+    layer_sizes(_layers),
+    weights(resource),
+    biases(resource),
     activation(_activation),
     activation_derivative(_activation_derivative),
     rd(),
-    gen(rd())
+    gen(rd()),
+    packed(),
+    approximation(),
+    input_scale(resource),
+    input_offset(resource),
+    sparse_weights(resource),
+    sparse_options(),
+    exits(resource),
+    exit_counters(),
+    metrics()
 {
+    if(!randomize) {
+        for(size_t i = 1; i < layer_sizes.size(); ++i) {
+            weights.emplace_back(layer_sizes[i-1] * layer_sizes[i]);
+            biases.emplace_back(layer_sizes[i]);
+        }
+
+        return;
+    }
+
     CPUFeatureOptimizer::init_cpu_features(this->gen);
 
     for(size_t i = 1; i < layer_sizes.size(); ++i) {
-        std::vector<std::vector<double>> layer_weights;
-
-        for(size_t j = 0; j < layer_sizes[i-1]; ++j) {
-            std::vector<double> neuron_weights(layer_sizes[i]);
-            std::generate(
-                neuron_weights.begin(),
-                neuron_weights.end(), 
-                [this]() {
-                    return weight_dist(gen);
-                }
-            );
-
-            layer_weights.emplace_back(neuron_weights);
-        }
-        weights.emplace_back(layer_weights);
+        std::pmr::vector<double>& layer_weights =
+            weights.emplace_back(layer_sizes[i-1] * layer_sizes[i]);
+        std::generate(
+            layer_weights.begin(),
+            layer_weights.end(), 
+            [this]() {
+                return weight_dist(gen);
+            }
+        );
 
-        std::vector<double> layer_biases(layer_sizes[i]);
+        std::pmr::vector<double>& layer_biases = biases.emplace_back(layer_sizes[i]);
         std::generate(
             layer_biases.begin(),
             layer_biases.end(),
@@ -76,19 +265,34 @@ NeuralNetwork::NeuralNetwork(
                 return weight_dist(gen);
             }
         );
-        biases.emplace_back(layer_biases);
     }
 }
 
 NeuralNetwork::NeuralNetwork(const NeuralNetwork& other) :
+    resource(other.resource),
     layer_sizes(std::move(other.layer_sizes)),
-    weights(std::move(other.weights)),
-    biases(std::move(other.biases)),
+    weights(other.weights, other.resource),
+    biases(other.biases, other.resource),
     activation(std::move(other.activation)),
     activation_derivative(std::move(other.activation_derivative)),
     rd(),
-    gen(std::move(other.gen))
-{ }
+    gen(std::move(other.gen)),
+    packed(other.packed),
+    approximation(other.approximation),
+    input_scale(other.input_scale, other.resource),
+    input_offset(other.input_offset, other.resource),
+    sparse_weights(other.sparse_weights, other.resource),
+    sparse_options(other.sparse_options),
+    exits(other.exits, other.resource),
+    exit_counters(other.exit_counters.size()),
+    metrics(other.metrics)
+{
+    for(size_t index = 0; index < this->exit_counters.size(); ++index)
+        this->exit_counters[index].store(
+            other.exit_counters[index].load(std::memory_order_relaxed),
+            std::memory_order_relaxed
+        );
+}
 
 NeuralNetwork::~NeuralNetwork() {
     #pragma omp barrier
@@ -101,247 +305,2252 @@ NeuralNetwork& NeuralNetwork::operator=(NeuralNetwork&& other) noexcept {
         this->biases = std::move(other.biases);
         this->activation = std::move(other.activation);
         this->activation_derivative = std::move(other.activation_derivative);
+        this->packed = std::move(other.packed);
+        this->approximation = std::move(other.approximation);
+        this->input_scale = std::move(other.input_scale);
+        this->input_offset = std::move(other.input_offset);
+        this->sparse_weights = std::move(other.sparse_weights);
+        this->sparse_options = other.sparse_options;
+        this->exits = std::move(other.exits);
+        this->exit_counters = std::move(other.exit_counters);
+        this->metrics = std::move(other.metrics);
     }
 
     return *this;
 }
 
+std::pmr::memory_resource* NeuralNetwork::get_memory_resource() const noexcept {
+    return this->resource;
+}
+
+void NeuralNetwork::set_metrics(std::shared_ptr<Metrics> _metrics) {
+    this->metrics = std::move(_metrics);
+
+    if(this->metrics)
+        this->metrics->set_parameter_bytes(this->parameter_bytes());
+}
+
+std::shared_ptr<Metrics> NeuralNetwork::get_metrics() const noexcept {
+    return this->metrics;
+}
+
+const std::vector<size_t>& NeuralNetwork::get_layer_sizes() const noexcept {
+    return this->layer_sizes;
+}
+
+std::vector<double> NeuralNetwork::get_weights(size_t layer) const {
+    if(this->sparse_weights.empty()) {
+        const std::pmr::vector<double>& dense = this->weights.at(layer);
+        return std::vector<double>(dense.begin(), dense.end());
+    }
+
+    const SparseMatrix& sparse = this->sparse_weights.at(layer);
+    std::vector<double> dense(this->layer_sizes[layer] * this->layer_sizes[layer + 1]);
+    sparse.to_dense(dense.data());
+
+    return dense;
+}
+
+const std::pmr::vector<double>& NeuralNetwork::get_biases(size_t layer) const {
+    return this->biases.at(layer);
+}
+
 std::vector<double> NeuralNetwork::predict(const std::vector<double>& input) {
-    std::vector<double> layer_output = input;
+    if(!this->metrics)
+        return this->predict_sample(input);
 
-    for(size_t layer = 0; layer < weights.size(); ++layer) {
-        std::vector<double> next_layer_output(layer_sizes[layer + 1]);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<double> output = this->predict_sample(input);
+
+    this->metrics->record_prediction(1, seconds_since(start));
+    return output;
+}
 
-        #pragma omp parallel for
-        for(size_t j = 0; j < layer_sizes[layer + 1]; ++j) {
-            double neuron_output = biases[layer][j];
+std::vector<double> NeuralNetwork::predict_sample(const std::vector<double>& input) {
+    if(this->packed)
+        return this->predict_packed(input);
 
-            for(size_t i = 0; i < layer_sizes[layer]; ++i)
-                neuron_output += layer_output[i] * weights[layer][i][j];
-            next_layer_output[j] = this->activation(neuron_output);
-        }
+    if(!this->sparse_weights.empty()) {
+        this->record_exit(0);
+        return this->predict_sparse(input);
+    }
+
+    if(!this->exits.empty()) {
+        size_t exit = 0;
+        std::vector<double> output = this->run_exits(input, exit, nullptr);
 
-        layer_output = next_layer_output;
+        this->record_exit(exit);
+        return output;
     }
 
-    return layer_output;
+    this->record_exit(0);
+    return forward(
+        this->layer_sizes,
+        this->weights,
+        this->biases,
+        this->activation,
+        input.data(),
+        this->approximation.get()
+    );
 }
 
-void NeuralNetwork::train(
-    const std::vector<std::vector<double>>& inputs, 
-    const std::vector<std::vector<double>>& targets, 
-    double learning_rate,
-    int epochs
-) {
-    for(int epoch = 0; epoch < epochs; ++epoch) {
-        for(size_t sample = 0; sample < inputs.size(); ++sample) {
-            std::vector<std::vector<double>> layer_outputs;
-            std::vector<double> current_input = inputs[sample];
+std::vector<double> NeuralNetwork::predict(const Dataset& inputs) {
+    std::vector<double> outputs(inputs.size() * this->layer_sizes.back());
 
-            layer_outputs.emplace_back(current_input);
-            for(size_t layer = 0; layer < weights.size(); ++layer) {
-                std::vector<double> next_layer_output(layer_sizes[layer + 1]);
+    this->predict(inputs, outputs.data());
+    return outputs;
+}
 
-                for(size_t j = 0; j < layer_sizes[layer + 1]; ++j) {
-                    double neuron_output = biases[layer][j];
+void NeuralNetwork::predict(const Dataset& inputs, double* outputs) {
+    this->check_dataset(inputs, false);
 
-                    for(size_t i = 0; i < layer_sizes[layer]; ++i)
-                        neuron_output += current_input[i] * weights[layer][i][j];
-                    next_layer_output[j] = this->activation(neuron_output);
-                }
+    if(!this->metrics) {
+        this->predict_rows(inputs, outputs);
+        return;
+    }
 
-                layer_outputs.emplace_back(next_layer_output);
-                current_input = next_layer_output;
-            }
+    const auto start = std::chrono::steady_clock::now();
+    this->predict_rows(inputs, outputs);
+    this->metrics->record_prediction(inputs.size(), seconds_since(start));
+}
 
-            std::vector<std::vector<double>> gradients(weights.size());
-            std::vector<double> output_gradient(layer_sizes.back());
+void NeuralNetwork::predict_rows(const Dataset& inputs, double* outputs) {
+    const size_t n_inputs = this->layer_sizes.front(), n_outputs = this->layer_sizes.back();
+    if(this->packed || !this->sparse_weights.empty() || !this->exits.empty()) {
+        std::vector<double> input(n_inputs);
 
-            for(size_t j = 0; j < layer_sizes.back(); ++j) {
-                double output = layer_outputs.back()[j];
-                output_gradient[j] = (output - targets[sample][j]) *
-                    this->activation_derivative(output);
-            }
-            gradients.back() = output_gradient;
+        for(size_t sample = 0; sample < inputs.size(); ++sample) {
+            const double* row = inputs.input(sample, input.data());
+            if(row != input.data())
+                std::copy(row, row + n_inputs, input.begin());
 
-            for(int layer = (int) weights.size() - 2; layer >= 0; --layer) {
-                std::vector<double> layer_gradient(
-                    layer_sizes[static_cast<size_t>(layer + 1)]
-                );
+            std::vector<double> output = this->predict_sample(input);
+            std::copy(output.begin(), output.end(), outputs + sample * n_outputs);
+        }
 
-                for(size_t j = 0; j < layer_sizes[static_cast<size_t>(layer + 1)]; ++j) {
-                    double gradient_sum = 0.0;
+        return;
+    }
 
-                    for(size_t k = 0; k < layer_sizes[static_cast<size_t>(layer + 2)]; ++k)
-                        gradient_sum += gradients[static_cast<size_t>(layer + 1)][k] *
-                            weights[static_cast<size_t>(layer + 1)][j][k];
+    // Rows go through the layers in blocks, so each weight matrix is streamed
+    // once per block instead of once per sample.
+    constexpr size_t block_rows = 64;
+    const size_t layers = this->weights.size();
+    std::pmr::vector<double> block(std::min(block_rows, inputs.size()) * n_inputs, this->resource);
+    std::pmr::vector<double> current(this->resource), next(this->resource);
 
-                    double layer_output = layer_outputs[static_cast<size_t>(layer + 1)][j];
-                    layer_gradient[j] = gradient_sum *
-                        this->activation_derivative(layer_output);
-                }
-                
-                gradients[static_cast<size_t>(layer)] = layer_gradient;
-            }
+    for(size_t start = 0; start < inputs.size(); start += block_rows) {
+        const size_t batch = std::min(block_rows, inputs.size() - start);
+        const double* layer_input = inputs.input_block(start, batch, block.data());
 
-            for(size_t layer = 0; layer < weights.size(); ++layer) {
-                for(size_t i = 0; i < layer_sizes[layer]; ++i)
-                    for(size_t j = 0; j < layer_sizes[layer + 1]; ++j)
-                        weights[layer][i][j] -= learning_rate * 
-                            gradients[layer][j] * layer_outputs[layer][i];
+        for(size_t layer = 0; layer < layers; ++layer) {
+            const size_t n_in = this->layer_sizes[layer], n_out = this->layer_sizes[layer + 1];
 
-                for(size_t j = 0; j < layer_sizes[layer + 1]; ++j)
-                    biases[layer][j] -= learning_rate * gradients[layer][j];
-            }
+            next.resize(batch * n_out);
+            double* layer_output = layer + 1 == layers ?
+                outputs + start * n_outputs : next.data();
+
+            DenseKernels::forward(
+                KernelAutotuner::lookup(n_in, n_out, batch, KernelPrecision::Double),
+                this->weights[layer].data(),
+                this->biases[layer].data(),
+                layer_input,
+                layer_output,
+                n_in,
+                n_out,
+                batch
+            );
+
+            if(this->approximation)
+                this->approximation->apply(layer_output, layer_output, batch * n_out);
+            else for(size_t k = 0; k < batch * n_out; ++k)
+                layer_output[k] = this->activation(layer_output[k]);
+
+            current.swap(next);
+            layer_input = current.data();
         }
+
+        for(size_t sample = 0; sample < batch; ++sample)
+            this->record_exit(0);
     }
 }
 
-double NeuralNetwork::compute_mse_loss(const std::vector<double>& prediction, 
-    const std::vector<double>& target) {
-    double total_loss = 0.0;
+std::vector<double> NeuralNetwork::run_exits(
+    const std::vector<double>& input,
+    size_t& exit,
+    std::pmr::vector<std::pmr::vector<double>>* head_outputs
+) const {
+    std::pmr::vector<double> layer_output(input.begin(), input.end(), this->resource);
+    std::pmr::vector<double> next_layer_output(this->resource);
+    std::pmr::vector<double> head_output(this->resource);
 
-    #pragma omp parallel for
-    for(size_t i = 0; i < prediction.size(); ++i) {
-        double diff = prediction[i] - target[i];
-        total_loss += diff * diff;
+    if(head_outputs != nullptr)
+        head_outputs->resize(this->exits.size());
+
+    exit = 0;
+    for(size_t layer = 0; layer < this->weights.size(); ++layer) {
+        const size_t n_in = this->layer_sizes[layer], n_out = this->layer_sizes[layer + 1];
+        next_layer_output.resize(n_out);
+
+        DenseKernels::forward(
+            KernelAutotuner::lookup(n_in, n_out, 1, KernelPrecision::Double),
+            this->weights[layer].data(),
+            this->biases[layer].data(),
+            layer_output.data(),
+            next_layer_output.data(),
+            n_in,
+            n_out
+        );
+
+        if(this->approximation)
+            this->approximation->apply(next_layer_output.data(), next_layer_output.data(), n_out);
+        else for(double& value : next_layer_output)
+            value = this->activation(value);
+        layer_output.swap(next_layer_output);
+
+        if(exit == this->exits.size() || this->exits[exit].layer != layer + 1)
+            continue;
+
+        const ExitHead& head = this->exits[exit];
+        if(head_outputs != nullptr)
+            this->evaluate_exit(head, layer_output.data(), (*head_outputs)[exit]);
+        else if(head.threshold < std::numeric_limits<double>::max() &&
+            this->evaluate_exit(head, layer_output.data(), head_output) >= head.threshold)
+            return std::vector<double>(head_output.begin(), head_output.end());
+
+        ++exit;
     }
 
-    return total_loss / (double) prediction.size();
+    return std::vector<double>(layer_output.begin(), layer_output.end());
 }
 
-std::vector<double> NeuralNetwork::compute_output_gradient(
-    const std::vector<double>& prediction, 
-    const std::vector<double>& target
-) {
-    std::vector<double> gradient(prediction.size());
+double NeuralNetwork::evaluate_exit(
+    const ExitHead& head,
+    const double* hidden,
+    std::pmr::vector<double>& output
+) const {
+    const size_t n_in = this->layer_sizes[head.layer], n_out = this->layer_sizes.back();
+    output.resize(n_out);
 
-    for(size_t i = 0; i < prediction.size(); ++i)
-        gradient[i] = 2 * (prediction[i] - target[i]);
+    DenseKernels::forward(
+        KernelAutotuner::lookup(n_in, n_out, 1, KernelPrecision::Double),
+        head.weights.data(),
+        head.biases.data(),
+        hidden,
+        output.data(),
+        n_in,
+        n_out
+    );
 
-    return gradient;
+    if(this->approximation)
+        this->approximation->apply(output.data(), output.data(), n_out);
+    else for(double& value : output)
+        value = this->activation(value);
+
+    return exit_confidence(output);
 }
 
-double NeuralNetwork::compute_accuracy(const std::vector<std::vector<double>>& inputs, 
-    const std::vector<std::vector<double>>& targets) {
-    int correct_predictions = 0;
+void NeuralNetwork::record_exit(size_t exit) {
+    if(this->exits.empty() || this->exit_counters.size() != this->exits.size() + 3)
+        return;
 
-    for(size_t i = 0; i < inputs.size(); ++i) {
-        std::vector<double> prediction = predict(inputs[i]);
+    this->exit_counters[0].fetch_add(1, std::memory_order_relaxed);
+    this->exit_counters[1].fetch_add(
+        exit < this->exits.size() ? this->exits[exit].layer + 1 : this->weights.size(),
+        std::memory_order_relaxed
+    );
+    this->exit_counters[2 + exit].fetch_add(1, std::memory_order_relaxed);
+}
 
-        if(is_correct_prediction(prediction, targets[i]))
-            ++correct_predictions;
+std::vector<double> NeuralNetwork::forward(
+    const std::vector<size_t>& layer_sizes,
+    const std::pmr::vector<std::pmr::vector<double>>& weights,
+    const std::pmr::vector<std::pmr::vector<double>>& biases,
+    const std::function<double(double)>& activation,
+    const double* input,
+    const ApproximateActivation* approximation
+) {
+    // Scratch comes from the resource the weights live in.
+    std::pmr::memory_resource* resource = weights.get_allocator().resource();
+    std::pmr::vector<double> layer_output(input, input + layer_sizes.front(), resource);
+    std::pmr::vector<double> next_layer_output(resource);
+
+    for(size_t layer = 0; layer < weights.size(); ++layer) {
+        const size_t n_in = layer_sizes[layer], n_out = layer_sizes[layer + 1];
+        next_layer_output.resize(n_out);
+
+        DenseKernels::forward(
+            KernelAutotuner::lookup(n_in, n_out, 1, KernelPrecision::Double),
+            weights[layer].data(),
+            biases[layer].data(),
+            layer_output.data(),
+            next_layer_output.data(),
+            n_in,
+            n_out
+        );
+
+        if(approximation != nullptr)
+            approximation->apply(next_layer_output.data(), next_layer_output.data(), n_out);
+        else for(double& value : next_layer_output)
+            value = activation(value);
+        layer_output.swap(next_layer_output);
     }
 
-    return static_cast<double>(correct_predictions) / (double) inputs.size();
+    return std::vector<double>(layer_output.begin(), layer_output.end());
 }
 
-bool NeuralNetwork::is_correct_prediction(
-    const std::vector<double>& prediction, 
-    const std::vector<double>& target
+void NeuralNetwork::train(
+    const std::vector<std::vector<double>>& inputs, 
+    const std::vector<std::vector<double>>& targets, 
+    double learning_rate,
+    int epochs
 ) {
-    size_t pred_max_idx = static_cast<size_t>(
-        std::max_element(
-            prediction.begin(),
-            prediction.end()
-        ) - prediction.begin()
-    );
-    size_t target_max_idx = static_cast<size_t>(
-        std::max_element(
-            target.begin(),
-            target.end()
-        ) - target.begin()
-    );
-
-    return pred_max_idx == target_max_idx;
+    this->train(Dataset(inputs, targets), learning_rate, epochs);
 }
 
-void NeuralNetwork::save_model(const std::string& filename) {
-    std::string final_filename = filename;
-    if(final_filename.substr(final_filename.size() - 7) != ".chisei")
-        final_filename += ".chisei";
+void NeuralNetwork::train(const Dataset& dataset, double learning_rate, int epochs) {
+    this->check_dataset(dataset, true);
+    this->unfreeze();
 
-    std::ofstream file(final_filename, std::ios::binary);
-    if(!file)
-        throw ModelLoaderException("Failed to open *.chisei file for saving the model.");
+    std::pmr::vector<double> input_scratch(dataset.input_size(), this->resource);
+    std::pmr::vector<double> target_scratch(dataset.target_size(), this->resource);
 
-    const char magic[] = "CS";
-    file.write(magic, sizeof(magic) - 1);
+    const size_t total_steps = static_cast<size_t>(std::max(epochs, 0)) * dataset.size();
+    for(int epoch = 0; epoch < epochs; ++epoch) {
+        const auto start = std::chrono::steady_clock::now();
+        double total_loss = 0.0;
 
-    size_t layer_count = layer_sizes.size();
-    file.write(reinterpret_cast<char*>(&layer_count), sizeof(layer_count));
+        for(size_t sample = 0; sample < dataset.size(); ++sample) {
+            total_loss += this->train_sample(
+                dataset.input(sample, input_scratch.data()),
+                dataset.target(sample, target_scratch.data()),
+                learning_rate
+            );
+            this->sparse_step(
+                dataset,
+                static_cast<size_t>(epoch) * dataset.size() + sample,
+                total_steps
+            );
+        }
 
-    for(size_t i = 0; i < layer_count; ++i) {
-        size_t size = layer_sizes[i];
-        file.write(reinterpret_cast<char*>(&size), sizeof(size));
+        this->record_epoch(dataset.size(), start, total_loss);
     }
+}
 
-    for(size_t layer = 0; layer < weights.size(); ++layer)
-        for(size_t i = 0; i < layer_sizes[layer]; ++i)
-            file.write(
-                reinterpret_cast<char*>(weights[layer][i].data()),
-                static_cast<std::streamsize>(weights[layer][i].size() * sizeof(double))
+int NeuralNetwork::train(
+    const std::vector<std::vector<double>>& inputs, 
+    const std::vector<std::vector<double>>& targets, 
+    const std::vector<std::vector<double>>& validation_inputs, 
+    const std::vector<std::vector<double>>& validation_targets, 
+    const ValidationOptions& options,
+    double learning_rate,
+    int epochs
+) {
+    return this->train(
+        Dataset(inputs, targets),
+        Dataset(validation_inputs, validation_targets),
+        options,
+        learning_rate,
+        epochs
+    );
+}
+
+int NeuralNetwork::train(
+    const Dataset& dataset,
+    const Dataset& validation,
+    const ValidationOptions& options,
+    double learning_rate,
+    int epochs
+) {
+    this->check_dataset(dataset, true);
+    this->check_dataset(validation, true);
+
+    const int interval = std::max(options.interval, 1);
+    this->unfreeze();
+
+    std::pmr::vector<std::pmr::vector<double>> snapshot_weights(this->resource);
+    std::pmr::vector<std::pmr::vector<double>> snapshot_biases(this->resource);
+    std::pmr::vector<std::pmr::vector<double>> best_weights(this->resource);
+    std::pmr::vector<std::pmr::vector<double>> best_biases(this->resource);
+
+    std::future<TrainingProgress> pending;
+    double best_loss = std::numeric_limits<double>::infinity();
+    int stale_validations = 0;
+    bool has_best = false, stop = false;
+
+    auto consume = [&](TrainingProgress progress) {
+        progress.improved = progress.validation_loss < best_loss;
+
+        if(progress.improved) {
+            best_loss = progress.validation_loss;
+            stale_validations = 0;
+
+            if(options.restore_best) {
+                best_weights = snapshot_weights;
+                best_biases = snapshot_biases;
+                has_best = true;
+            }
+        }
+        else if(options.patience > 0 && ++stale_validations >= options.patience)
+            stop = true;
+
+        if(options.on_progress)
+            options.on_progress(progress);
+    };
+
+    std::pmr::vector<double> input_scratch(dataset.input_size(), this->resource);
+    std::pmr::vector<double> target_scratch(dataset.target_size(), this->resource);
+
+    const size_t total_steps = static_cast<size_t>(std::max(epochs, 0)) * dataset.size();
+    int epoch = 0;
+
+    while(epoch < epochs && !stop) {
+        const auto start = std::chrono::steady_clock::now();
+        double total_loss = 0.0;
+
+        for(size_t sample = 0; sample < dataset.size(); ++sample) {
+            total_loss += this->train_sample(
+                dataset.input(sample, input_scratch.data()),
+                dataset.target(sample, target_scratch.data()),
+                learning_rate
             );
+            this->sparse_step(
+                dataset,
+                static_cast<size_t>(epoch) * dataset.size() + sample,
+                total_steps
+            );
+        }
 
-    for(size_t layer = 0; layer < biases.size(); ++layer)
-        file.write(
-            reinterpret_cast<char*>(biases[layer].data()),
-            static_cast<std::streamsize>(biases[layer].size() * sizeof(double))
-        );
+        this->record_epoch(dataset.size(), start, total_loss);
+        ++epoch;
 
-    file.close();
-}
+        if(pending.valid() &&
+            pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            consume(pending.get());
 
-NeuralNetwork NeuralNetwork::loadFromModel(const std::string& filename) {
-    std::ifstream file(filename, std::ios::binary);
-    if(!file.is_open())
-        throw ModelLoaderException("Failed to open file for loading model.");
+        if(stop || epoch % interval != 0 || pending.valid())
+            continue;
 
-    char magic[2] = {0};
-    file.read(magic, sizeof(magic));
-    if(magic[0] != 'C' || magic[1] != 'S')
-        throw ModelLoaderException("Invalid *.chisei file format, missing magic bytes.");
+        if(this->sparse_weights.empty())
+            snapshot_weights = this->weights;
+        else snapshot_weights = this->densify_weights();
+        snapshot_biases = this->biases;
 
-    size_t num_layers;
-    file.read(reinterpret_cast<char*>(&num_layers), sizeof(num_layers));
+        pending = std::async(
+            std::launch::async,
+            &NeuralNetwork::evaluate_snapshot,
+            std::cref(this->layer_sizes),
+            std::cref(snapshot_weights),
+            std::cref(snapshot_biases),
+            std::cref(this->activation),
+            std::cref(validation),
+            epoch
+        );
+    }
 
-    std::vector<size_t> layer_sizes(num_layers);
-    file.read(
-        reinterpret_cast<char*>(layer_sizes.data()),
-        static_cast<std::streamsize>(num_layers * sizeof(size_t))
-    );
+    if(pending.valid())
+        consume(pending.get());
 
-    NeuralNetwork network(
-        layer_sizes,
-        ActivationFunctions::sigmoid_activation,
-        ActivationFunctions::sigmoid_derivative
-    );
+    if(has_best) {
+        if(!this->sparse_weights.empty())
+            for(size_t layer = 0; layer < this->sparse_weights.size(); ++layer)
+                this->sparse_weights[layer] = SparseMatrix::from_dense(
+                    best_weights[layer].data(),
+                    this->layer_sizes[layer],
+                    this->layer_sizes[layer + 1],
+                    this->sparse_weights[layer].nonzeros(),
+                    this->resource
+                );
+        else this->weights = std::move(best_weights);
 
-    network.weights.resize(num_layers - 1);
-    network.biases.resize(num_layers - 1);
+        this->biases = std::move(best_biases);
+    }
+
+    return epoch;
+}
+
+TrainingProgress NeuralNetwork::evaluate_snapshot(
+    const std::vector<size_t>& layer_sizes,
+    const std::pmr::vector<std::pmr::vector<double>>& weights,
+    const std::pmr::vector<std::pmr::vector<double>>& biases,
+    const std::function<double(double)>& activation,
+    const Dataset& validation,
+    int epoch
+) {
+    double total_loss = 0.0;
+    size_t correct_predictions = 0;
 
-    for(size_t layer = 0; layer < num_layers - 1; ++layer) {
-        network.weights[layer].resize(layer_sizes[layer]);
+    #pragma omp parallel reduction(+:total_loss, correct_predictions)
+    {
+        std::pmr::memory_resource* resource = weights.get_allocator().resource();
+        std::pmr::vector<double> input_scratch(validation.input_size(), resource);
+        std::pmr::vector<double> target_scratch(validation.target_size(), resource);
 
-        for(size_t i = 0; i < layer_sizes[layer]; ++i) {
-            network.weights[layer][i].resize(layer_sizes[layer + 1]);
-            file.read(
-                reinterpret_cast<char*>(network.weights[layer][i].data()),
-                static_cast<std::streamsize>(layer_sizes[layer + 1] * sizeof(double))
+        #pragma omp for
+        for(size_t sample = 0; sample < validation.size(); ++sample) {
+            std::vector<double> prediction = forward(
+                layer_sizes,
+                weights,
+                biases,
+                activation,
+                validation.input(sample, input_scratch.data())
             );
+            const double* target = validation.target(sample, target_scratch.data());
+
+            double sample_loss = 0.0;
+            for(size_t i = 0; i < prediction.size(); ++i) {
+                double diff = prediction[i] - target[i];
+                sample_loss += diff * diff;
+            }
+            total_loss += sample_loss / (double) prediction.size();
+
+            if(argmax(prediction.data(), prediction.size()) == argmax(target, prediction.size()))
+                ++correct_predictions;
         }
     }
 
-    for(size_t layer = 0; layer < num_layers - 1; ++layer) {
-        network.biases[layer].resize(layer_sizes[layer + 1]);
-        file.read(
-            reinterpret_cast<char*>(network.biases[layer].data()),
-            static_cast<std::streamsize>(layer_sizes[layer + 1] * sizeof(double))
-        );
+    TrainingProgress progress;
+    progress.epoch = epoch;
+
+    if(!validation.empty()) {
+        progress.validation_loss = total_loss / (double) validation.size();
+        progress.validation_accuracy = static_cast<double>(correct_predictions) /
+            (double) validation.size();
     }
 
-    file.close();
-    return network;
+    return progress;
+}
+
+double NeuralNetwork::train_sample(
+    const double* input,
+    const double* target,
+    double learning_rate
+) {
+    if(!this->sparse_weights.empty())
+        return this->train_sample_sparse(input, target, learning_rate);
+
+    std::pmr::vector<std::pmr::vector<double>> layer_outputs(this->resource);
+    std::pmr::vector<double> current_input(input, input + layer_sizes.front(), this->resource);
+
+    layer_outputs.emplace_back(current_input);
+    for(size_t layer = 0; layer < weights.size(); ++layer) {
+        const size_t n_in = layer_sizes[layer], n_out = layer_sizes[layer + 1];
+        std::pmr::vector<double> next_layer_output(n_out, this->resource);
+
+        DenseKernels::forward(
+            KernelAutotuner::lookup(n_in, n_out, 1, KernelPrecision::Double),
+            weights[layer].data(),
+            biases[layer].data(),
+            current_input.data(),
+            next_layer_output.data(),
+            n_in,
+            n_out
+        );
+
+        for(double& value : next_layer_output)
+            value = this->activation(value);
+
+        layer_outputs.emplace_back(next_layer_output);
+        current_input = next_layer_output;
+    }
+
+    // Exit heads learn the same targets, and their output gradients flow into
+    // the hidden layer they are attached to.
+    const size_t n_outputs = layer_sizes.back();
+    std::pmr::vector<std::pmr::vector<double>> exit_gradients(this->exits.size(), this->resource);
+
+    for(size_t index = 0; index < this->exits.size(); ++index) {
+        const ExitHead& head = this->exits[index];
+        std::pmr::vector<double>& exit_gradient = exit_gradients[index];
+        exit_gradient.resize(n_outputs);
+
+        DenseKernels::forward(
+            KernelAutotuner::lookup(layer_sizes[head.layer], n_outputs, 1, KernelPrecision::Double),
+            head.weights.data(),
+            head.biases.data(),
+            layer_outputs[head.layer].data(),
+            exit_gradient.data(),
+            layer_sizes[head.layer],
+            n_outputs
+        );
+
+        for(size_t j = 0; j < n_outputs; ++j) {
+            const double output = this->activation(exit_gradient[j]);
+            exit_gradient[j] = (output - target[j]) * this->activation_derivative(output);
+        }
+    }
+
+    std::pmr::vector<std::pmr::vector<double>> gradients(weights.size(), this->resource);
+    std::pmr::vector<double> output_gradient(layer_sizes.back(), this->resource);
+
+    for(size_t j = 0; j < layer_sizes.back(); ++j) {
+        double output = layer_outputs.back()[j];
+        output_gradient[j] = (output - target[j]) *
+            this->activation_derivative(output);
+    }
+    gradients.back() = output_gradient;
+
+    // Activations like ReLU have a zero derivative wherever they output zero,
+    // so those neurons get a zero gradient without touching their weight row.
+    const bool zero_is_flat = std::fpclassify(this->activation_derivative(0.0)) == FP_ZERO;
+
+    for(int layer = (int) weights.size() - 2; layer >= 0; --layer) {
+        std::pmr::vector<double> layer_gradient(
+            layer_sizes[static_cast<size_t>(layer + 1)],
+            this->resource
+        );
+
+        const ExitHead* head = nullptr;
+        const double* head_gradient = nullptr;
+
+        for(size_t index = 0; index < this->exits.size(); ++index)
+            if(this->exits[index].layer == static_cast<size_t>(layer + 1)) {
+                head = &this->exits[index];
+                head_gradient = exit_gradients[index].data();
+            }
+
+        const size_t n_next = layer_sizes[static_cast<size_t>(layer + 2)];
+        for(size_t j = 0; j < layer_sizes[static_cast<size_t>(layer + 1)]; ++j) {
+            if(zero_is_flat && std::fpclassify(
+                layer_outputs[static_cast<size_t>(layer + 1)][j]) == FP_ZERO)
+                continue;
+
+            const double* row = &weights[static_cast<size_t>(layer + 1)][j * n_next];
+            double gradient_sum = 0.0;
+
+            for(size_t k = 0; k < n_next; ++k)
+                gradient_sum += gradients[static_cast<size_t>(layer + 1)][k] * row[k];
+
+            if(head != nullptr) {
+                const double* head_row = &head->weights[j * n_outputs];
+
+                for(size_t k = 0; k < n_outputs; ++k)
+                    gradient_sum += head_gradient[k] * head_row[k];
+            }
+
+            double layer_output = layer_outputs[static_cast<size_t>(layer + 1)][j];
+            layer_gradient[j] = gradient_sum *
+                this->activation_derivative(layer_output);
+        }
+        
+        gradients[static_cast<size_t>(layer)] = layer_gradient;
+    }
+
+    // Rows of zero inputs receive no update. The index buffer is kept per
+    // thread and only grows, so steady-state training does not allocate.
+    static thread_local std::vector<uint32_t> nonzero_inputs;
+    for(size_t layer = 0; layer < weights.size(); ++layer) {
+        const size_t n_out = layer_sizes[layer + 1];
+
+        nonzero_inputs.resize(layer_sizes[layer]);
+        const size_t nonzero = DenseKernels::compress_nonzero(
+            layer_outputs[layer].data(),
+            layer_sizes[layer],
+            nonzero_inputs.data()
+        );
+
+        for(size_t k = 0; k < nonzero; ++k) {
+            const size_t i = nonzero_inputs[k];
+            const double scale = learning_rate * layer_outputs[layer][i];
+            double* row = &weights[layer][i * n_out];
+
+            for(size_t j = 0; j < n_out; ++j)
+                row[j] -= scale * gradients[layer][j];
+        }
+
+        for(size_t j = 0; j < layer_sizes[layer + 1]; ++j)
+            biases[layer][j] -= learning_rate * gradients[layer][j];
+    }
+
+    for(size_t index = 0; index < this->exits.size(); ++index) {
+        ExitHead& head = this->exits[index];
+        const std::pmr::vector<double>& hidden = layer_outputs[head.layer];
+
+        nonzero_inputs.resize(hidden.size());
+        const size_t nonzero = DenseKernels::compress_nonzero(
+            hidden.data(),
+            hidden.size(),
+            nonzero_inputs.data()
+        );
+
+        for(size_t k = 0; k < nonzero; ++k) {
+            const size_t i = nonzero_inputs[k];
+            const double scale = learning_rate * hidden[i];
+            double* row = &head.weights[i * n_outputs];
+
+            for(size_t j = 0; j < n_outputs; ++j)
+                row[j] -= scale * exit_gradients[index][j];
+        }
+
+        for(size_t j = 0; j < n_outputs; ++j)
+            head.biases[j] -= learning_rate * exit_gradients[index][j];
+    }
+
+    return mean_squared_error(layer_outputs.back().data(), target, n_outputs);
+}
+
+void NeuralNetwork::flatten_parameters(std::pmr::vector<double>& parameters) const {
+    parameters.clear();
+
+    for(const std::pmr::vector<double>& layer_weights : this->weights)
+        parameters.insert(parameters.end(), layer_weights.begin(), layer_weights.end());
+
+    for(const std::pmr::vector<double>& layer_biases : this->biases)
+        parameters.insert(parameters.end(), layer_biases.begin(), layer_biases.end());
+}
+
+void NeuralNetwork::unflatten_parameters(const std::pmr::vector<double>& parameters) {
+    auto position = parameters.begin();
+
+    for(std::pmr::vector<double>& layer_weights : this->weights) {
+        std::copy(
+            position,
+            position + static_cast<std::ptrdiff_t>(layer_weights.size()),
+            layer_weights.begin()
+        );
+        position += static_cast<std::ptrdiff_t>(layer_weights.size());
+    }
+
+    for(std::pmr::vector<double>& layer_biases : this->biases) {
+        std::copy(
+            position,
+            position + static_cast<std::ptrdiff_t>(layer_biases.size()),
+            layer_biases.begin()
+        );
+        position += static_cast<std::ptrdiff_t>(layer_biases.size());
+    }
+}
+
+double NeuralNetwork::full_batch_loss(
+    const Dataset& dataset,
+    size_t batch_size,
+    std::pmr::vector<std::pmr::vector<double>>& activations,
+    std::pmr::vector<std::pmr::vector<double>>& deltas,
+    double* gradient
+) const {
+    const size_t layers = this->weights.size();
+    const double scale = 1.0 / static_cast<double>(dataset.size());
+    double loss = 0.0;
+
+    std::pmr::vector<double> target_scratch(dataset.target_size(), this->resource);
+
+    std::pmr::vector<double*> weight_gradients(layers, this->resource);
+    std::pmr::vector<double*> bias_gradients(layers, this->resource);
+    if(gradient != nullptr) {
+        double* position = gradient;
+
+        for(size_t layer = 0; layer < layers; ++layer) {
+            weight_gradients[layer] = position;
+            position += this->weights[layer].size();
+        }
+
+        for(size_t layer = 0; layer < layers; ++layer) {
+            bias_gradients[layer] = position;
+            position += this->biases[layer].size();
+        }
+
+        std::fill(gradient, position, 0.0);
+    }
+
+    for(size_t start = 0; start < dataset.size(); start += batch_size) {
+        const size_t batch = std::min(batch_size, dataset.size() - start);
+
+        // Contiguous double inputs are read in place rather than staged.
+        const double* batch_input = dataset.input_block(start, batch, activations[0].data());
+
+        for(size_t layer = 0; layer < layers; ++layer) {
+            const size_t n_in = this->layer_sizes[layer], n_out = this->layer_sizes[layer + 1];
+
+            DenseKernels::forward(
+                KernelAutotuner::lookup(n_in, n_out, batch, KernelPrecision::Double),
+                this->weights[layer].data(),
+                this->biases[layer].data(),
+                layer == 0 ? batch_input : activations[layer].data(),
+                activations[layer + 1].data(),
+                n_in,
+                n_out,
+                batch
+            );
+
+            for(size_t k = 0; k < batch * n_out; ++k)
+                activations[layer + 1][k] = this->activation(activations[layer + 1][k]);
+        }
+
+        const size_t n_outputs = this->layer_sizes.back();
+        for(size_t sample = 0; sample < batch; ++sample) {
+            const double* target = dataset.target(start + sample, target_scratch.data());
+
+            for(size_t j = 0; j < n_outputs; ++j) {
+                const double output = activations[layers][sample * n_outputs + j];
+                const double error = output - target[j];
+
+                loss += 0.5 * scale * error * error;
+                deltas[layers - 1][sample * n_outputs + j] =
+                    scale * error * this->activation_derivative(output);
+            }
+        }
+
+        if(gradient == nullptr)
+            continue;
+
+        for(size_t layer = layers; layer-- > 0;) {
+            const size_t n_in = this->layer_sizes[layer], n_out = this->layer_sizes[layer + 1];
+
+            DenseKernels::gemm(
+                true, false,
+                n_in, n_out, batch,
+                1.0,
+                layer == 0 ? batch_input : activations[layer].data(), n_in,
+                deltas[layer].data(), n_out,
+                1.0,
+                weight_gradients[layer], n_out
+            );
+
+            for(size_t sample = 0; sample < batch; ++sample)
+                for(size_t j = 0; j < n_out; ++j)
+                    bias_gradients[layer][j] += deltas[layer][sample * n_out + j];
+
+            if(layer == 0)
+                continue;
+
+            DenseKernels::gemm(
+                false, true,
+                batch, n_in, n_out,
+                1.0,
+                deltas[layer].data(), n_out,
+                this->weights[layer].data(), n_out,
+                0.0,
+                deltas[layer - 1].data(), n_in
+            );
+
+            for(size_t k = 0; k < batch * n_in; ++k)
+                deltas[layer - 1][k] *= this->activation_derivative(activations[layer][k]);
+        }
+    }
+
+    return loss;
+}
+
+LbfgsResult NeuralNetwork::train_lbfgs(
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets,
+    const LbfgsOptions& options
+) {
+    return this->train_lbfgs(Dataset(inputs, targets), options);
+}
+
+LbfgsResult NeuralNetwork::train_lbfgs(const Dataset& dataset, const LbfgsOptions& options) {
+    this->check_dataset(dataset, true);
+
+    if(!this->sparse_weights.empty())
+        throw std::invalid_argument("L-BFGS does not support sparse training.");
+
+    // The flattened objective covers the trunk only, so heads would go stale.
+    if(!this->exits.empty())
+        throw std::invalid_argument("L-BFGS does not support exit heads.");
+
+    LbfgsResult result;
+    if(dataset.empty())
+        return result;
+
+    this->unfreeze();
+
+    const size_t layers = this->weights.size();
+    const size_t batch_size = std::min(std::max<size_t>(options.batch_size, 1), dataset.size());
+    const size_t history = std::max<size_t>(options.history, 1);
+
+    std::pmr::vector<std::pmr::vector<double>> activations(layers + 1, this->resource);
+    std::pmr::vector<std::pmr::vector<double>> deltas(layers, this->resource);
+    for(size_t layer = 0; layer <= layers; ++layer)
+        activations[layer].resize(batch_size * this->layer_sizes[layer]);
+    for(size_t layer = 0; layer < layers; ++layer)
+        deltas[layer].resize(batch_size * this->layer_sizes[layer + 1]);
+
+    std::pmr::vector<double> x(this->resource), trial_x(this->resource);
+    std::pmr::vector<double> gradient(this->resource), trial_gradient(this->resource);
+    this->flatten_parameters(x);
+
+    const size_t count = x.size();
+    gradient.resize(count);
+    trial_gradient.resize(count);
+
+    // Steps and gradient changes of the last `history` iterations, each ring
+    // buffer one contiguous block with slot `(newest - k) % history` holding
+    // the pair from k iterations ago.
+    std::pmr::vector<double> steps(history * count, this->resource);
+    std::pmr::vector<double> changes(history * count, this->resource);
+    std::pmr::vector<double> rho(history, this->resource), alpha(history, this->resource);
+    std::pmr::vector<double> direction(count, this->resource);
+    size_t stored = 0, newest = 0;
+
+    auto dot = [count](const double* a, const double* b) {
+        double sum = 0.0;
+        for(size_t i = 0; i < count; ++i)
+            sum += a[i] * b[i];
+
+        return sum;
+    };
+
+    double loss = this->full_batch_loss(
+        dataset, batch_size, activations, deltas, gradient.data()
+    );
+
+    for(result.iterations = 0; result.iterations < options.max_iterations; ++result.iterations) {
+        const auto start = std::chrono::steady_clock::now();
+        double largest = 0.0;
+        for(double value : gradient)
+            largest = std::max(largest, std::fabs(value));
+
+        if(!std::isgreater(largest, options.gradient_tolerance)) {
+            result.converged = true;
+            break;
+        }
+
+        // Two-loop recursion for the inverse Hessian times the gradient.
+        direction = gradient;
+        for(size_t k = 0; k < stored; ++k) {
+            const size_t slot = (newest + history - k) % history;
+
+            alpha[slot] = rho[slot] * dot(&steps[slot * count], direction.data());
+            for(size_t i = 0; i < count; ++i)
+                direction[i] -= alpha[slot] * changes[slot * count + i];
+        }
+
+        if(stored > 0) {
+            const double* change = &changes[newest * count];
+            const double gamma = dot(&steps[newest * count], change) / dot(change, change);
+
+            for(double& value : direction)
+                value *= gamma;
+        }
+
+        for(size_t k = stored; k-- > 0;) {
+            const size_t slot = (newest + history - k) % history;
+            const double beta = rho[slot] * dot(&changes[slot * count], direction.data());
+
+            for(size_t i = 0; i < count; ++i)
+                direction[i] += (alpha[slot] - beta) * steps[slot * count + i];
+        }
+
+        for(double& value : direction)
+            value = -value;
+
+        double slope = dot(gradient.data(), direction.data());
+        if(!std::isless(slope, 0.0)) {
+            stored = 0;
+            for(size_t i = 0; i < count; ++i)
+                direction[i] = -gradient[i];
+            slope = -dot(gradient.data(), gradient.data());
+        }
+
+        // Without curvature information the first step is scaled to unit length.
+        double step = stored == 0 ? 1.0 / std::sqrt(-slope) : 1.0;
+        bool accepted = false;
+        double trial_loss = loss;
+
+        trial_x.resize(count);
+        for(int attempt = 0; attempt <= options.max_line_search; ++attempt, step *= 0.5) {
+            for(size_t i = 0; i < count; ++i)
+                trial_x[i] = x[i] + step * direction[i];
+            this->unflatten_parameters(trial_x);
+
+            trial_loss = this->full_batch_loss(
+                dataset, batch_size, activations, deltas, nullptr
+            );
+            if(!std::isgreater(trial_loss, loss + 1e-4 * step * slope)) {
+                accepted = true;
+                break;
+            }
+        }
+
+        if(!accepted) {
+            this->unflatten_parameters(x);
+            break;
+        }
+
+        this->full_batch_loss(
+            dataset, batch_size, activations, deltas, trial_gradient.data()
+        );
+
+        const size_t slot = stored == 0 ? 0 : (newest + 1) % history;
+        double* s = &steps[slot * count];
+        double* y = &changes[slot * count];
+
+        for(size_t i = 0; i < count; ++i) {
+            s[i] = trial_x[i] - x[i];
+            y[i] = trial_gradient[i] - gradient[i];
+        }
+
+        // Pairs without positive curvature would break the Hessian approximation;
+        // a rejected pair has still overwritten the oldest slot of a full ring.
+        const double curvature = dot(s, y);
+        if(std::isgreater(curvature, 1e-10 * dot(y, y))) {
+            rho[slot] = 1.0 / curvature;
+            newest = slot;
+            stored = std::min(stored + 1, history);
+        }
+        else if(stored == history)
+            --stored;
+
+        x.swap(trial_x);
+        gradient.swap(trial_gradient);
+        loss = trial_loss;
+
+        // The L-BFGS loss is half the error summed over outputs; the metrics
+        // report the same mean squared error as stochastic training.
+        this->record_epoch(
+            dataset.size(),
+            start,
+            2.0 * loss * static_cast<double>(dataset.size()) /
+                static_cast<double>(this->layer_sizes.back())
+        );
+
+        if(options.on_iteration)
+            options.on_iteration(result.iterations, loss);
+    }
+
+    result.loss = loss;
+    return result;
+}
+
+double NeuralNetwork::compute_mse_loss(const std::vector<double>& prediction, 
+    const std::vector<double>& target) {
+    double total_loss = 0.0;
+
+    #pragma omp parallel for
+    for(size_t i = 0; i < prediction.size(); ++i) {
+        double diff = prediction[i] - target[i];
+        total_loss += diff * diff;
+    }
+
+    return total_loss / (double) prediction.size();
+}
+
+std::vector<double> NeuralNetwork::compute_output_gradient(
+    const std::vector<double>& prediction, 
+    const std::vector<double>& target
+) {
+    std::vector<double> gradient(prediction.size());
+
+    for(size_t i = 0; i < prediction.size(); ++i)
+        gradient[i] = 2 * (prediction[i] - target[i]);
+
+    return gradient;
+}
+
+double NeuralNetwork::compute_accuracy(const std::vector<std::vector<double>>& inputs, 
+    const std::vector<std::vector<double>>& targets) {
+    return this->compute_accuracy(Dataset(inputs, targets));
+}
+
+double NeuralNetwork::compute_accuracy(const Dataset& dataset) {
+    this->check_dataset(dataset, true);
+
+    const size_t n_outputs = this->layer_sizes.back();
+    std::vector<double> predictions = this->predict(dataset);
+    std::vector<double> target_scratch(n_outputs);
+    size_t correct_predictions = 0;
+
+    for(size_t i = 0; i < dataset.size(); ++i)
+        if(argmax(&predictions[i * n_outputs], n_outputs) ==
+            argmax(dataset.target(i, target_scratch.data()), n_outputs))
+            ++correct_predictions;
+
+    return static_cast<double>(correct_predictions) / (double) dataset.size();
+}
+
+void NeuralNetwork::check_dataset(const Dataset& dataset, bool with_targets) const {
+    if(dataset.empty())
+        return;
+
+    if(dataset.input_size() != this->layer_sizes.front())
+        throw std::invalid_argument("Dataset input size does not match the input layer.");
+
+    if(with_targets && dataset.target_size() != this->layer_sizes.back())
+        throw std::invalid_argument("Dataset target size does not match the output layer.");
+}
+
+bool NeuralNetwork::is_correct_prediction(
+    const std::vector<double>& prediction, 
+    const std::vector<double>& target
+) {
+    size_t pred_max_idx = static_cast<size_t>(
+        std::max_element(
+            prediction.begin(),
+            prediction.end()
+        ) - prediction.begin()
+    );
+    size_t target_max_idx = static_cast<size_t>(
+        std::max_element(
+            target.begin(),
+            target.end()
+        ) - target.begin()
+    );
+
+    return pred_max_idx == target_max_idx;
+}
+
+void NeuralNetwork::save_model(const std::string& filename) {
+    this->save_model(filename, ModelSaveOptions());
+}
+
+void NeuralNetwork::save_model(const std::string& filename, const ModelSaveOptions& options) {
+    std::string final_filename = filename;
+    if(final_filename.size() < 7 ||
+        final_filename.substr(final_filename.size() - 7) != ".chisei")
+        final_filename += ".chisei";
+
+    // Sparse networks are saved as their equivalent dense weights.
+    std::pmr::vector<std::pmr::vector<double>> sparse_dense(this->resource);
+    if(!this->sparse_weights.empty())
+        sparse_dense = this->densify_weights();
+
+    const std::pmr::vector<std::pmr::vector<double>>& canonical_weights =
+        this->sparse_weights.empty() ? this->weights : sparse_dense;
+
+    std::shared_ptr<const PackedModel> packed_model;
+    if(options.embed_packed) {
+        const std::string isa = options.packed_isa.empty() ?
+            PackedLayout::host_isa() : options.packed_isa;
+
+        packed_model = this->packed && this->packed->isa == isa &&
+            this->packed->precision == options.packed_precision ?
+            this->packed :
+            PackedLayout::pack_model(
+                layer_sizes,
+                canonical_weights,
+                biases,
+                isa,
+                input_scale,
+                input_offset,
+                options.packed_precision,
+                this->resource
+            );
+    }
+
+    std::ofstream file(final_filename, std::ios::binary);
+    if(!file)
+        throw ModelLoaderException("Failed to open *.chisei file for saving the model.");
+
+    ModelWriter writer(file);
+
+    const char magic[] = "CS";
+    writer.write(magic, sizeof(magic) - 1);
+
+    const size_t layer_count = layer_sizes.size();
+    writer.write_value(layer_count);
+
+    for(size_t i = 0; i < layer_count; ++i)
+        writer.write_value(layer_sizes[i]);
+
+    for(size_t layer = 0; layer < canonical_weights.size(); ++layer)
+        writer.write(
+            canonical_weights[layer].data(),
+            canonical_weights[layer].size() * sizeof(double)
+        );
+
+    for(size_t layer = 0; layer < biases.size(); ++layer)
+        writer.write(biases[layer].data(), biases[layer].size() * sizeof(double));
+    writer.write_checksum();
+
+    if(!this->input_scale.empty()) {
+        const uint64_t count = this->input_scale.size();
+        const uint64_t payload_size = sizeof(count) + 2 * count * sizeof(double);
+
+        writer.write(transform_section_tag, sizeof(transform_section_tag));
+        writer.write_value(payload_size);
+        writer.write_value(count);
+        writer.write(this->input_scale.data(), count * sizeof(double));
+        writer.write(this->input_offset.data(), count * sizeof(double));
+        writer.write_checksum();
+    }
+
+    if(!this->exits.empty()) {
+        const uint64_t count = this->exits.size();
+        uint64_t payload_size = sizeof(count);
+
+        for(const ExitHead& head : this->exits)
+            payload_size += sizeof(uint64_t) + sizeof(double) +
+                (head.weights.size() + head.biases.size()) * sizeof(double);
+
+        writer.write(exit_section_tag, sizeof(exit_section_tag));
+        writer.write_value(payload_size);
+        writer.write_value(count);
+
+        for(const ExitHead& head : this->exits) {
+            const uint64_t layer = head.layer;
+
+            writer.write_value(layer);
+            writer.write_value(head.threshold);
+            writer.write(head.weights.data(), head.weights.size() * sizeof(double));
+            writer.write(head.biases.data(), head.biases.size() * sizeof(double));
+        }
+        writer.write_checksum();
+    }
+
+    if(packed_model) {
+        const uint32_t isa_length = static_cast<uint32_t>(packed_model->isa.size());
+        const uint32_t precision = static_cast<uint32_t>(packed_model->precision);
+        const uint64_t panel_width = packed_model->panel_width;
+
+        PackedModel layout;
+        layout.panel_width = packed_model->panel_width;
+        layout.precision = packed_model->precision;
+        const uint64_t data_size = PackedLayout::layout(layout, layer_sizes);
+
+        const uint64_t payload_start = writer.position() +
+            sizeof(packed_section_tag) + sizeof(uint64_t);
+        const uint64_t header_size = sizeof(isa_length) + isa_length +
+            sizeof(precision) + sizeof(panel_width) + sizeof(uint64_t);
+        const uint64_t padding = (section_alignment -
+            (payload_start + header_size) % section_alignment) % section_alignment;
+        const uint64_t payload_size = header_size + padding + data_size;
+
+        writer.write(packed_section_tag, sizeof(packed_section_tag));
+        writer.write_value(payload_size);
+        writer.write_value(isa_length);
+        writer.write(packed_model->isa.data(), isa_length);
+        writer.write_value(precision);
+        writer.write_value(panel_width);
+        writer.write_value(padding);
+
+        const char zeros[section_alignment] = {0};
+        writer.write(zeros, padding);
+
+        // Layers are laid out back to back, so the panels go out in one piece.
+        writer.write(packed_model->base(), static_cast<size_t>(data_size));
+        writer.write_checksum();
+    }
+
+    if(!file)
+        throw ModelLoaderException("Failed to write *.chisei file.");
+    file.close();
+}
+
+NeuralNetwork NeuralNetwork::loadFromModel(const std::string& filename) {
+    return loadFromModel(filename, ModelLoadOptions());
+}
+
+NeuralNetwork NeuralNetwork::loadFromModel(
+    const std::string& filename,
+    const ModelLoadOptions& options
+) {
+    auto mapping = std::make_shared<const MappedFile>(filename, options.use_mmap);
+    ModelReader file(mapping->data(), mapping->size(), options.verify_checksums);
+
+    char magic[2] = {0};
+    file.read(magic, sizeof(magic));
+    if(magic[0] != 'C' || magic[1] != 'S')
+        throw ModelLoaderException("Invalid *.chisei file format, missing magic bytes.");
+
+    size_t num_layers = file.read_value<size_t>();
+    if(num_layers < 2 || num_layers > file.remaining() / sizeof(size_t))
+        throw ModelLoaderException("Invalid *.chisei file format, bad layer count.");
+
+    std::vector<size_t> layer_sizes(num_layers);
+    file.read(layer_sizes.data(), num_layers * sizeof(size_t));
+
+    for(size_t layer = 0; layer < num_layers - 1; ++layer)
+        if(layer_sizes[layer] != 0 &&
+            layer_sizes[layer + 1] > file.remaining() / sizeof(double) / layer_sizes[layer])
+            throw ModelLoaderException("Truncated *.chisei file.");
+
+    NeuralNetwork network(
+        layer_sizes,
+        ActivationFunctions::sigmoid_activation,
+        ActivationFunctions::sigmoid_derivative,
+        false,
+        options.memory_resource
+    );
+
+    for(size_t layer = 0; layer < num_layers - 1; ++layer)
+        file.read(
+            network.weights[layer].data(),
+            network.weights[layer].size() * sizeof(double)
+        );
+
+    for(size_t layer = 0; layer < num_layers - 1; ++layer)
+        file.read(
+            network.biases[layer].data(),
+            network.biases[layer].size() * sizeof(double)
+        );
+
+    bool has_packed_section = false;
+    bool has_checksums = false;
+    PackedPrecision packed_precision = PackedPrecision::Float;
+
+    while(file.remaining() >= sizeof(packed_section_tag) + sizeof(uint64_t)) {
+        const uint32_t region_checksum = file.checksum();
+
+        char tag[sizeof(packed_section_tag)];
+        file.read(tag, sizeof(tag));
+
+        const uint64_t payload_size = file.read_value<uint64_t>();
+        if(payload_size > file.remaining())
+            throw ModelLoaderException("Truncated *.chisei file.");
+
+        const size_t payload_end = file.position() + static_cast<size_t>(payload_size);
+        if(std::memcmp(tag, ModelStream::checksum_tag, sizeof(tag)) == 0) {
+            if(payload_size != sizeof(uint32_t))
+                throw ModelLoaderException("Invalid *.chisei file format, bad checksum.");
+
+            if(file.read_value<uint32_t>() != region_checksum && options.verify_checksums)
+                throw ModelLoaderException("Corrupted *.chisei file, checksum mismatch.");
+
+            file.restart_checksum();
+            has_checksums = true;
+
+            continue;
+        }
+
+        if(std::memcmp(tag, transform_section_tag, sizeof(tag)) == 0) {
+            const size_t count = layer_sizes[0];
+            if(payload_size != sizeof(uint64_t) + 2 * count * sizeof(double) ||
+                file.read_value<uint64_t>() != count)
+                throw ModelLoaderException("Invalid *.chisei file format, bad input transform.");
+
+            network.input_scale.resize(count);
+            network.input_offset.resize(count);
+            file.read(network.input_scale.data(), count * sizeof(double));
+            file.read(network.input_offset.data(), count * sizeof(double));
+
+            continue;
+        }
+
+        if(std::memcmp(tag, exit_section_tag, sizeof(tag)) == 0) {
+            const uint64_t count = file.read_value<uint64_t>();
+            if(count > num_layers - 2)
+                throw ModelLoaderException("Invalid *.chisei file format, bad exit heads.");
+
+            const size_t n_out = layer_sizes.back();
+            for(uint64_t index = 0; index < count; ++index) {
+                ExitHead head(network.exits.get_allocator());
+                const uint64_t layer = file.read_value<uint64_t>();
+
+                if(layer == 0 || layer > num_layers - 2 ||
+                    (!network.exits.empty() && layer <= network.exits.back().layer) ||
+                    (layer_sizes[layer] + 1) * n_out >
+                        (payload_end - file.position()) / sizeof(double))
+                    throw ModelLoaderException("Invalid *.chisei file format, bad exit heads.");
+
+                head.layer = static_cast<size_t>(layer);
+                head.threshold = file.read_value<double>();
+                head.weights.resize(layer_sizes[head.layer] * n_out);
+                head.biases.resize(n_out);
+
+                file.read(head.weights.data(), head.weights.size() * sizeof(double));
+                file.read(head.biases.data(), head.biases.size() * sizeof(double));
+                network.exits.push_back(std::move(head));
+            }
+
+            if(file.position() != payload_end)
+                throw ModelLoaderException("Invalid *.chisei file format, bad exit heads.");
+
+            network.reset_exit_statistics();
+            continue;
+        }
+
+        if(std::memcmp(tag, packed_section_tag, sizeof(tag)) != 0) {
+            file.skip(static_cast<size_t>(payload_size));
+            continue;
+        }
+
+        has_packed_section = true;
+
+        const uint32_t isa_length = file.read_value<uint32_t>();
+        if(isa_length > payload_end - file.position())
+            throw ModelLoaderException("Invalid *.chisei file format, bad packed section.");
+
+        std::string isa(file.skip(isa_length), isa_length);
+
+        const uint32_t precision = file.read_value<uint32_t>();
+        const uint64_t panel_width = file.read_value<uint64_t>();
+        file.skip(static_cast<size_t>(file.read_value<uint64_t>()));
+
+        // Panels from another ISA are repacked, at the precision they were saved in.
+        const bool known_precision = precision == static_cast<uint32_t>(PackedPrecision::Float) ||
+            precision == static_cast<uint32_t>(PackedPrecision::Half);
+        if(known_precision)
+            packed_precision = static_cast<PackedPrecision>(precision);
+
+        if(!options.use_packed || !known_precision || isa != PackedLayout::host_isa() ||
+            panel_width != PackedLayout::panel_width(isa)) {
+            file.skip(payload_end - file.position());
+            continue;
+        }
+
+        auto model = std::allocate_shared<PackedModel>(PackedModel::allocator_type(network.resource));
+        model->isa = isa;
+        model->panel_width = static_cast<size_t>(panel_width);
+        model->precision = packed_precision;
+
+        const size_t total = PackedLayout::layout(*model, layer_sizes);
+        if(total != payload_end - file.position())
+            throw ModelLoaderException("Invalid *.chisei file format, bad packed section.");
+
+        const size_t data_offset = file.position();
+        const char* data = file.skip(total);
+
+        if(mapping->is_mapped() && data_offset % alignof(float) == 0) {
+            model->mapping = mapping;
+            model->mapping_offset = data_offset;
+        }
+        else {
+            model->storage.resize(total / sizeof(float));
+            std::memcpy(model->storage.data(), data, total);
+        }
+
+        network.packed = model;
+    }
+
+    // Once a file carries checksums, every byte of it must be covered by one.
+    if(has_checksums && options.verify_checksums &&
+        (file.unchecked() != 0 || file.remaining() != 0))
+        throw ModelLoaderException("Corrupted *.chisei file, unchecked trailing data.");
+
+    if(has_packed_section && options.use_packed && !network.packed)
+        network.freeze(packed_precision);
+
+    return network;
+}
+
+void NeuralNetwork::freeze(PackedPrecision precision) {
+    std::pmr::vector<std::pmr::vector<double>> sparse_dense(this->resource);
+    if(!this->sparse_weights.empty())
+        sparse_dense = this->densify_weights();
+
+    this->packed = PackedLayout::pack_model(
+        this->layer_sizes,
+        this->sparse_weights.empty() ? this->weights : sparse_dense,
+        this->biases,
+        PackedLayout::host_isa(),
+        this->input_scale,
+        this->input_offset,
+        precision,
+        this->resource
+    );
+}
+
+void NeuralNetwork::unfreeze() {
+    this->packed.reset();
+}
+
+bool NeuralNetwork::is_frozen() const {
+    return static_cast<bool>(this->packed);
+}
+
+std::vector<double> NeuralNetwork::predict_packed(const std::vector<double>& input) {
+    std::pmr::vector<float> layer_output(input.begin(), input.end(), this->resource);
+
+    // The first layer's panels expect raw inputs when a transform is folded in.
+    if(!this->input_scale.empty())
+        for(size_t i = 0; i < layer_output.size(); ++i)
+            layer_output[i] = std::fpclassify(this->input_scale[i]) == FP_ZERO ? 0.0f :
+                static_cast<float>((input[i] - this->input_offset[i]) / this->input_scale[i]);
+
+    return this->run_packed(layer_output, nullptr);
+}
+
+std::vector<double> NeuralNetwork::run_packed(
+    std::pmr::vector<float>& layer_output,
+    const uint8_t* raw_input
+) {
+    const bool half = this->packed->precision == PackedPrecision::Half;
+    std::pmr::vector<float> next_layer_output(this->resource);
+    std::pmr::vector<double> hidden(this->resource), head_output(this->resource);
+    size_t exit = 0;
+
+    for(size_t index = 0; index < this->packed->layers.size(); ++index) {
+        const PackedLayer& layer = this->packed->layers[index];
+        const KernelConfig& config =
+            KernelAutotuner::lookup(layer.n_in, layer.n_out, 1, KernelPrecision::Float);
+        next_layer_output.resize(layer.n_out);
+
+        const float* packed_biases = this->packed->biases(layer);
+        if(index == 0 && raw_input != nullptr && half)
+            PackedLayout::forward(
+                config,
+                this->packed->half_panels(layer),
+                packed_biases,
+                raw_input,
+                next_layer_output.data(),
+                layer.n_in,
+                layer.n_out,
+                this->packed->panel_width
+            );
+        else if(index == 0 && raw_input != nullptr)
+            PackedLayout::forward(
+                config,
+                this->packed->float_panels(layer),
+                packed_biases,
+                raw_input,
+                next_layer_output.data(),
+                layer.n_in,
+                layer.n_out,
+                this->packed->panel_width
+            );
+        else if(half)
+            PackedLayout::forward(
+                config,
+                this->packed->half_panels(layer),
+                packed_biases,
+                layer_output.data(),
+                next_layer_output.data(),
+                layer.n_in,
+                layer.n_out,
+                this->packed->panel_width
+            );
+        else PackedLayout::forward(
+            config,
+            this->packed->float_panels(layer),
+            packed_biases,
+            layer_output.data(),
+            next_layer_output.data(),
+            layer.n_in,
+            layer.n_out,
+            this->packed->panel_width
+        );
+
+        if(this->approximation)
+            this->approximation->apply(
+                next_layer_output.data(),
+                next_layer_output.data(),
+                layer.n_out
+            );
+        else for(float& value : next_layer_output)
+            value = static_cast<float>(this->activation(static_cast<double>(value)));
+        layer_output.swap(next_layer_output);
+
+        if(exit == this->exits.size() || this->exits[exit].layer != index + 1)
+            continue;
+
+        // Heads are not packed; they run in double on the float activations.
+        const ExitHead& head = this->exits[exit];
+        if(head.threshold < std::numeric_limits<double>::max()) {
+            hidden.assign(layer_output.begin(), layer_output.end());
+
+            if(this->evaluate_exit(head, hidden.data(), head_output) >= head.threshold) {
+                this->record_exit(exit);
+                return std::vector<double>(head_output.begin(), head_output.end());
+            }
+        }
+
+        ++exit;
+    }
+
+    this->record_exit(this->exits.size());
+    return std::vector<double>(layer_output.begin(), layer_output.end());
+}
+
+std::vector<double> NeuralNetwork::predict_raw(const std::vector<uint8_t>& input) {
+    if(input.size() != this->layer_sizes[0])
+        throw std::invalid_argument("Raw input size does not match the input layer.");
+
+    if(this->packed) {
+        const auto start = std::chrono::steady_clock::now();
+        std::pmr::vector<float> layer_output(this->resource);
+        std::vector<double> output = this->run_packed(layer_output, input.data());
+
+        if(this->metrics)
+            this->metrics->record_prediction(1, seconds_since(start));
+        return output;
+    }
+
+    std::vector<double> transformed(input.begin(), input.end());
+    if(!this->input_scale.empty())
+        for(size_t i = 0; i < transformed.size(); ++i)
+            transformed[i] = this->input_scale[i] * transformed[i] + this->input_offset[i];
+
+    return this->predict(transformed);
+}
+
+void NeuralNetwork::set_input_transform(
+    const std::vector<double>& scale,
+    const std::vector<double>& offset
+) {
+    if(scale.size() != this->layer_sizes[0] || offset.size() != this->layer_sizes[0])
+        throw std::invalid_argument("Input transform size does not match the input layer.");
+
+    this->input_scale.assign(scale.begin(), scale.end());
+    this->input_offset.assign(offset.begin(), offset.end());
+
+    if(this->packed)
+        this->freeze(this->packed->precision);
+}
+
+void NeuralNetwork::set_input_transform(double scale, double offset) {
+    this->set_input_transform(
+        std::vector<double>(this->layer_sizes[0], scale),
+        std::vector<double>(this->layer_sizes[0], offset)
+    );
+}
+
+void NeuralNetwork::clear_input_transform() {
+    this->input_scale.clear();
+    this->input_offset.clear();
+
+    if(this->packed)
+        this->freeze(this->packed->precision);
+}
+
+bool NeuralNetwork::has_input_transform() const noexcept {
+    return !this->input_scale.empty();
+}
+
+void NeuralNetwork::record_epoch(
+    size_t samples,
+    std::chrono::steady_clock::time_point start,
+    double total_loss
+) {
+    if(!this->metrics)
+        return;
+
+    this->metrics->record_epoch(
+        samples,
+        seconds_since(start),
+        samples == 0 ? 0.0 : total_loss / static_cast<double>(samples)
+    );
+    this->metrics->set_parameter_bytes(this->parameter_bytes());
+}
+
+size_t NeuralNetwork::parameter_bytes() const noexcept {
+    size_t values = this->connection_count();
+
+    for(const std::pmr::vector<double>& layer_biases : this->biases)
+        values += layer_biases.size();
+
+    for(const ExitHead& head : this->exits)
+        values += head.weights.size() + head.biases.size();
+
+    return values * sizeof(double);
+}
+
+const std::pmr::vector<double>& NeuralNetwork::get_input_scale() const noexcept {
+    return this->input_scale;
+}
+
+const std::pmr::vector<double>& NeuralNetwork::get_input_offset() const noexcept {
+    return this->input_offset;
+}
+
+size_t NeuralNetwork::add_exit(size_t layer) {
+    if(layer == 0 || layer + 1 >= this->layer_sizes.size())
+        throw std::invalid_argument("Exit heads can only be attached to hidden layers.");
+
+    if(!this->sparse_weights.empty())
+        throw std::invalid_argument("Exit heads cannot be attached during sparse training.");
+
+    auto position = std::lower_bound(
+        this->exits.begin(),
+        this->exits.end(),
+        layer,
+        [](const ExitHead& head, size_t value) {
+            return head.layer < value;
+        }
+    );
+
+    if(position != this->exits.end() && position->layer == layer)
+        throw std::invalid_argument("Hidden layer already has an exit head.");
+
+    ExitHead head(this->exits.get_allocator());
+    head.layer = layer;
+    head.weights.resize(this->layer_sizes[layer] * this->layer_sizes.back());
+    head.biases.resize(this->layer_sizes.back());
+
+    std::generate(head.weights.begin(), head.weights.end(), [this]() {
+        return weight_dist(gen);
+    });
+    std::generate(head.biases.begin(), head.biases.end(), [this]() {
+        return weight_dist(gen);
+    });
+
+    const size_t index = static_cast<size_t>(position - this->exits.begin());
+    this->exits.insert(position, std::move(head));
+    this->reset_exit_statistics();
+
+    return index;
+}
+
+void NeuralNetwork::clear_exits() {
+    this->exits.clear();
+    this->reset_exit_statistics();
+}
+
+size_t NeuralNetwork::exit_count() const noexcept {
+    return this->exits.size();
+}
+
+const ExitHead& NeuralNetwork::get_exit(size_t index) const {
+    return this->exits.at(index);
+}
+
+void NeuralNetwork::set_exit_threshold(size_t index, double threshold) {
+    this->exits.at(index).threshold = threshold;
+}
+
+double NeuralNetwork::calibrate_exits(
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets,
+    double tolerance
+) {
+    if(inputs.size() != targets.size())
+        throw std::invalid_argument("Calibration inputs and targets differ in size.");
+
+    const size_t count = inputs.size(), heads = this->exits.size();
+    std::vector<double> confidences(count * heads);
+    std::vector<uint8_t> correct(count * (heads + 1));
+
+    #pragma omp parallel for
+    for(size_t sample = 0; sample < count; ++sample) {
+        std::pmr::vector<std::pmr::vector<double>> head_outputs(this->resource);
+        size_t exit = 0;
+
+        std::vector<double> output = this->run_exits(inputs[sample], exit, &head_outputs);
+        for(size_t index = 0; index < heads; ++index) {
+            confidences[sample * heads + index] = exit_confidence(head_outputs[index]);
+            correct[sample * (heads + 1) + index] =
+                argmax(head_outputs[index].data(), head_outputs[index].size()) ==
+                    argmax(targets[sample].data(), targets[sample].size());
+        }
+
+        correct[sample * (heads + 1) + heads] =
+            this->is_correct_prediction(output, targets[sample]);
+    }
+
+    size_t full_correct = 0;
+    for(size_t sample = 0; sample < count; ++sample)
+        full_correct += correct[sample * (heads + 1) + heads];
+
+    const double target_accuracy = count == 0 ? 0.0 :
+        static_cast<double>(full_correct) / static_cast<double>(count) - tolerance;
+
+    std::vector<size_t> remaining(count);
+    for(size_t sample = 0; sample < count; ++sample)
+        remaining[sample] = sample;
+
+    uint64_t layers_executed = 0;
+    for(size_t index = 0; index < heads; ++index) {
+        std::sort(remaining.begin(), remaining.end(), [&](size_t a, size_t b) {
+            return confidences[a * heads + index] > confidences[b * heads + index];
+        });
+
+        // The head takes the longest prefix of most confident samples that is
+        // still accurate enough, cut only where the confidence changes.
+        size_t taken = 0, hits = 0;
+        for(size_t k = 0; k < remaining.size(); ++k) {
+            hits += correct[remaining[k] * (heads + 1) + index];
+
+            const bool cut = k + 1 == remaining.size() || std::isless(
+                confidences[remaining[k + 1] * heads + index],
+                confidences[remaining[k] * heads + index]
+            );
+            if(cut && static_cast<double>(hits) >= target_accuracy * static_cast<double>(k + 1))
+                taken = k + 1;
+        }
+
+        ExitHead& head = this->exits[index];
+        head.threshold = taken == 0 ? std::numeric_limits<double>::max() :
+            confidences[remaining[taken - 1] * heads + index];
+
+        layers_executed += taken * (head.layer + 1);
+        remaining.erase(remaining.begin(), remaining.begin() + static_cast<std::ptrdiff_t>(taken));
+    }
+
+    layers_executed += remaining.size() * this->weights.size();
+    this->reset_exit_statistics();
+
+    return count == 0 ? 0.0 :
+        static_cast<double>(layers_executed) / static_cast<double>(count);
+}
+
+ExitStatistics NeuralNetwork::get_exit_statistics() const {
+    ExitStatistics statistics;
+    if(this->exit_counters.empty())
+        return statistics;
+
+    statistics.predictions = this->exit_counters[0].load(std::memory_order_relaxed);
+    statistics.layers_executed = this->exit_counters[1].load(std::memory_order_relaxed);
+
+    for(size_t index = 2; index < this->exit_counters.size(); ++index)
+        statistics.exits.push_back(this->exit_counters[index].load(std::memory_order_relaxed));
+
+    return statistics;
+}
+
+void NeuralNetwork::reset_exit_statistics() {
+    if(this->exits.empty()) {
+        this->exit_counters.clear();
+        return;
+    }
+
+    this->exit_counters = std::vector<std::atomic<uint64_t>>(this->exits.size() + 3);
+    for(std::atomic<uint64_t>& counter : this->exit_counters)
+        counter.store(0, std::memory_order_relaxed);
+}
+
+void NeuralNetwork::widen_layer(size_t layer, size_t width) {
+    if(layer == 0 || layer + 1 >= this->layer_sizes.size())
+        throw std::invalid_argument("Only hidden layers can be widened.");
+
+    if(width < this->layer_sizes[layer])
+        throw std::invalid_argument("Widened layer cannot have fewer neurons.");
+
+    if(!this->sparse_weights.empty())
+        throw std::invalid_argument("Layers cannot be widened during sparse training.");
+
+    const size_t n_prev = this->layer_sizes[layer - 1];
+    const size_t n = this->layer_sizes[layer], n_next = this->layer_sizes[layer + 1];
+
+    std::vector<size_t> source(width);
+    std::vector<double> share(width), total(n, 0.0);
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    std::uniform_real_distribution<double> proportion(0.5, 1.5);
+
+    for(size_t j = 0; j < width; ++j) {
+        source[j] = j < n ? j : pick(this->gen);
+        share[j] = proportion(this->gen);
+        total[source[j]] += share[j];
+    }
+
+    for(size_t j = 0; j < width; ++j)
+        share[j] /= total[source[j]];
+
+    // A neuron's copies compute the same output, so their outgoing rows only
+    // need to sum to the original row.
+    auto split_rows = [&](const std::pmr::vector<double>& rows, size_t row_size) {
+        std::pmr::vector<double> split(width * row_size, this->resource);
+
+        for(size_t j = 0; j < width; ++j)
+            for(size_t k = 0; k < row_size; ++k)
+                split[j * row_size + k] = share[j] * rows[source[j] * row_size + k];
+
+        return split;
+    };
+
+    std::pmr::vector<double> incoming(n_prev * width, this->resource);
+    std::pmr::vector<double> incoming_biases(width, this->resource);
+    for(size_t i = 0; i < n_prev; ++i)
+        for(size_t j = 0; j < width; ++j)
+            incoming[i * width + j] = this->weights[layer - 1][i * n + source[j]];
+
+    for(size_t j = 0; j < width; ++j)
+        incoming_biases[j] = this->biases[layer - 1][source[j]];
+
+    this->weights[layer - 1] = std::move(incoming);
+    this->biases[layer - 1] = std::move(incoming_biases);
+    this->weights[layer] = split_rows(this->weights[layer], n_next);
+
+    for(ExitHead& head : this->exits)
+        if(head.layer == layer)
+            head.weights = split_rows(head.weights, this->layer_sizes.back());
+
+    this->layer_sizes[layer] = width;
+    this->unfreeze();
+    this->reset_exit_statistics();
+}
+
+void NeuralNetwork::insert_layer(size_t after) {
+    if(after == 0 || after + 1 >= this->layer_sizes.size())
+        throw std::invalid_argument("Layers can only be inserted after hidden layers.");
+
+    if(!this->sparse_weights.empty())
+        throw std::invalid_argument("Layers cannot be inserted during sparse training.");
+
+    // The identity layer re-applies the activation to outputs of the activation.
+    for(double probe : {-4.0, -1.0, -0.25, 0.0, 0.25, 1.0, 4.0}) {
+        const double output = this->activation(probe);
+
+        if(std::isgreater(std::fabs(this->activation(output) - output),
+            1e-12 * std::max(1.0, std::fabs(output))))
+            throw std::invalid_argument(
+                "Inserting an identity layer requires an idempotent activation such as ReLU."
+            );
+    }
+
+    const size_t n = this->layer_sizes[after];
+    std::pmr::vector<double> identity(n * n, 0.0, this->resource);
+
+    for(size_t i = 0; i < n; ++i)
+        identity[i * n + i] = 1.0;
+
+    this->layer_sizes.insert(
+        this->layer_sizes.begin() + static_cast<std::ptrdiff_t>(after + 1),
+        n
+    );
+    this->weights.insert(
+        this->weights.begin() + static_cast<std::ptrdiff_t>(after),
+        std::move(identity)
+    );
+    this->biases.insert(
+        this->biases.begin() + static_cast<std::ptrdiff_t>(after),
+        std::pmr::vector<double>(n, 0.0, this->resource)
+    );
+
+    for(ExitHead& head : this->exits)
+        if(head.layer > after)
+            ++head.layer;
+
+    this->unfreeze();
+    this->reset_exit_statistics();
+}
+
+void NeuralNetwork::enable_sparse_training(const SparseTrainingOptions& options) {
+    if(!std::isgreater(options.density, 0.0) || std::isgreater(options.density, 1.0))
+        throw std::invalid_argument("Sparse training density must be in (0, 1].");
+
+    if(!this->exits.empty())
+        throw std::invalid_argument("Sparse training does not support exit heads.");
+
+    if(!this->sparse_weights.empty())
+        this->disable_sparse_training();
+
+    this->unfreeze();
+    this->sparse_options = options;
+
+    for(size_t layer = 0; layer < this->weights.size(); ++layer) {
+        const size_t count = this->layer_sizes[layer] * this->layer_sizes[layer + 1];
+        const size_t keep = std::max<size_t>(1, static_cast<size_t>(
+            std::llround(options.density * static_cast<double>(count))
+        ));
+
+        this->sparse_weights.push_back(SparseMatrix::from_dense(
+            this->weights[layer].data(),
+            this->layer_sizes[layer],
+            this->layer_sizes[layer + 1],
+            keep,
+            this->resource
+        ));
+
+        std::pmr::vector<double>(this->resource).swap(this->weights[layer]);
+    }
+}
+
+void NeuralNetwork::disable_sparse_training() {
+    if(this->sparse_weights.empty())
+        return;
+
+    this->weights = this->densify_weights();
+    this->sparse_weights.clear();
+}
+
+bool NeuralNetwork::is_sparse() const noexcept {
+    return !this->sparse_weights.empty();
+}
+
+size_t NeuralNetwork::connection_count() const noexcept {
+    size_t count = 0;
+
+    if(this->sparse_weights.empty())
+        for(const std::pmr::vector<double>& layer_weights : this->weights)
+            count += layer_weights.size();
+    else for(const SparseMatrix& matrix : this->sparse_weights)
+        count += matrix.nonzeros();
+
+    return count;
+}
+
+std::pmr::vector<std::pmr::vector<double>> NeuralNetwork::densify_weights() const {
+    std::pmr::vector<std::pmr::vector<double>> dense(this->sparse_weights.size(), this->resource);
+
+    for(size_t layer = 0; layer < this->sparse_weights.size(); ++layer) {
+        dense[layer].resize(this->layer_sizes[layer] * this->layer_sizes[layer + 1]);
+        this->sparse_weights[layer].to_dense(dense[layer].data());
+    }
+
+    return dense;
+}
+
+std::vector<double> NeuralNetwork::predict_sparse(const std::vector<double>& input) const {
+    std::pmr::vector<double> layer_output(input.begin(), input.end(), this->resource);
+    std::pmr::vector<double> next_layer_output(this->resource);
+
+    for(size_t layer = 0; layer < this->sparse_weights.size(); ++layer) {
+        next_layer_output.assign(this->biases[layer].begin(), this->biases[layer].end());
+        this->sparse_weights[layer].multiply_add(layer_output.data(), next_layer_output.data());
+
+        if(this->approximation)
+            this->approximation->apply(
+                next_layer_output.data(),
+                next_layer_output.data(),
+                next_layer_output.size()
+            );
+        else for(double& value : next_layer_output)
+            value = this->activation(value);
+        layer_output.swap(next_layer_output);
+    }
+
+    return std::vector<double>(layer_output.begin(), layer_output.end());
+}
+
+void NeuralNetwork::sparse_backpropagate(
+    const double* input,
+    const double* target,
+    std::pmr::vector<std::pmr::vector<double>>& layer_outputs,
+    std::pmr::vector<std::pmr::vector<double>>& gradients
+) const {
+    const size_t layers = this->sparse_weights.size();
+    layer_outputs.resize(layers + 1);
+    gradients.resize(layers);
+
+    layer_outputs[0].assign(input, input + this->layer_sizes.front());
+    for(size_t layer = 0; layer < layers; ++layer) {
+        layer_outputs[layer + 1].assign(this->biases[layer].begin(), this->biases[layer].end());
+        this->sparse_weights[layer].multiply_add(
+            layer_outputs[layer].data(),
+            layer_outputs[layer + 1].data()
+        );
+
+        for(double& value : layer_outputs[layer + 1])
+            value = this->activation(value);
+    }
+
+    gradients[layers - 1].resize(this->layer_sizes.back());
+    for(size_t j = 0; j < this->layer_sizes.back(); ++j) {
+        const double output = layer_outputs[layers][j];
+        gradients[layers - 1][j] = (output - target[j]) * this->activation_derivative(output);
+    }
+
+    for(size_t layer = layers - 1; layer-- > 0;) {
+        std::pmr::vector<double>& gradient = gradients[layer];
+        gradient.resize(this->layer_sizes[layer + 1]);
+
+        this->sparse_weights[layer + 1].multiply_transposed(
+            gradients[layer + 1].data(),
+            gradient.data()
+        );
+
+        for(size_t j = 0; j < gradient.size(); ++j)
+            gradient[j] *= this->activation_derivative(layer_outputs[layer + 1][j]);
+    }
+}
+
+double NeuralNetwork::train_sample_sparse(
+    const double* input,
+    const double* target,
+    double learning_rate
+) {
+    std::pmr::vector<std::pmr::vector<double>> layer_outputs(this->resource);
+    std::pmr::vector<std::pmr::vector<double>> gradients(this->resource);
+    this->sparse_backpropagate(input, target, layer_outputs, gradients);
+
+    for(size_t layer = 0; layer < this->sparse_weights.size(); ++layer) {
+        this->sparse_weights[layer].rank_one_update(
+            learning_rate,
+            layer_outputs[layer].data(),
+            gradients[layer].data()
+        );
+
+        for(size_t j = 0; j < this->biases[layer].size(); ++j)
+            this->biases[layer][j] -= learning_rate * gradients[layer][j];
+    }
+
+    return mean_squared_error(layer_outputs.back().data(), target, this->layer_sizes.back());
+}
+
+void NeuralNetwork::sparse_step(
+    const Dataset& dataset,
+    size_t step,
+    size_t total_steps
+) {
+    const size_t interval = std::max<size_t>(this->sparse_options.interval, 1);
+    if(this->sparse_weights.empty() || (step + 1) % interval != 0)
+        return;
+
+    const double progress = static_cast<double>(step) / static_cast<double>(total_steps);
+    const double fraction = this->sparse_options.drop_fraction * 0.5 *
+        (1.0 + std::cos(pi * progress));
+
+    this->rewire(dataset, (step + 1) % dataset.size(), fraction);
+}
+
+void NeuralNetwork::rewire(
+    const Dataset& dataset,
+    size_t first,
+    double fraction
+) {
+    const size_t layers = this->sparse_weights.size();
+    const bool by_gradient = this->sparse_options.regrowth == SparseRegrowth::Gradient;
+
+    // Gradient regrowth ranks missing connections by the gradient summed over a
+    // few samples, kept here as per-sample activations and output gradients.
+    const size_t samples = by_gradient ?
+        std::min(std::max<size_t>(this->sparse_options.gradient_samples, 1), dataset.size()) : 0;
+    std::pmr::vector<std::pmr::vector<double>> stacked_outputs(layers, this->resource);
+    std::pmr::vector<std::pmr::vector<double>> stacked_gradients(layers, this->resource);
+
+    if(by_gradient) {
+        std::pmr::vector<std::pmr::vector<double>> layer_outputs(this->resource);
+        std::pmr::vector<std::pmr::vector<double>> gradients(this->resource);
+        std::pmr::vector<double> input_scratch(dataset.input_size(), this->resource);
+        std::pmr::vector<double> target_scratch(dataset.target_size(), this->resource);
+
+        for(size_t layer = 0; layer < layers; ++layer) {
+            stacked_outputs[layer].resize(samples * this->layer_sizes[layer]);
+            stacked_gradients[layer].resize(samples * this->layer_sizes[layer + 1]);
+        }
+
+        for(size_t k = 0; k < samples; ++k) {
+            const size_t sample = (first + k) % dataset.size();
+            this->sparse_backpropagate(
+                dataset.input(sample, input_scratch.data()),
+                dataset.target(sample, target_scratch.data()),
+                layer_outputs,
+                gradients
+            );
+
+            for(size_t layer = 0; layer < layers; ++layer) {
+                std::copy(
+                    layer_outputs[layer].begin(),
+                    layer_outputs[layer].end(),
+                    stacked_outputs[layer].begin() +
+                        static_cast<std::ptrdiff_t>(k * this->layer_sizes[layer])
+                );
+                std::copy(
+                    gradients[layer].begin(),
+                    gradients[layer].end(),
+                    stacked_gradients[layer].begin() +
+                        static_cast<std::ptrdiff_t>(k * this->layer_sizes[layer + 1])
+                );
+            }
+        }
+    }
+
+    // Working memory is proportional to the connections, never to n_in * n_out.
+    std::pmr::vector<uint32_t> order(this->resource);
+    std::pmr::vector<uint8_t> kept(this->resource);
+    std::pmr::vector<double> block(this->resource);
+    std::pmr::vector<std::pair<double, uint64_t>> heap(this->resource);
+    const auto weaker = [](const std::pair<double, uint64_t>& a, const std::pair<double, uint64_t>& b) {
+        return a.first > b.first;
+    };
+
+    for(size_t layer = 0; layer < layers; ++layer) {
+        SparseMatrix& matrix = this->sparse_weights[layer];
+        const size_t n_in = this->layer_sizes[layer], n_out = this->layer_sizes[layer + 1];
+        const size_t count = n_in * n_out, nonzeros = matrix.nonzeros();
+        const size_t replaced = std::min(
+            static_cast<size_t>(fraction * static_cast<double>(nonzeros)),
+            count - nonzeros
+        );
+
+        if(replaced == 0)
+            continue;
+
+        order.resize(nonzeros);
+        std::iota(order.begin(), order.end(), 0u);
+        std::nth_element(
+            order.begin(),
+            order.begin() + static_cast<std::ptrdiff_t>(replaced),
+            order.end(),
+            [&matrix](uint32_t a, uint32_t b) {
+                return std::fabs(matrix.values[a]) < std::fabs(matrix.values[b]);
+            }
+        );
+
+        // Survivors are flagged in CSR order; dropped positions may regrow.
+        kept.assign(nonzeros, 1);
+        for(size_t k = 0; k < replaced; ++k)
+            kept[order[k]] = 0;
+
+        std::pmr::vector<std::pair<uint64_t, double>> entries(this->resource);
+        entries.reserve(nonzeros);
+
+        for(size_t row = 0; row < n_in; ++row)
+            for(uint32_t k = matrix.row_offsets[row]; k < matrix.row_offsets[row + 1]; ++k)
+                if(kept[k])
+                    entries.emplace_back(row * n_out + matrix.columns[k], matrix.values[k]);
+
+        if(by_gradient) {
+            // The summed gradient is formed one block of rows at a time, and
+            // only the `replaced` largest missing magnitudes are retained.
+            const size_t block_rows = std::min(std::max<size_t>(65536 / n_out, 1), n_in);
+            block.resize(block_rows * n_out);
+            heap.clear();
+            heap.reserve(replaced);
+
+            for(size_t start = 0; start < n_in; start += block_rows) {
+                const size_t rows = std::min(block_rows, n_in - start);
+                DenseKernels::gemm(
+                    true, false,
+                    rows, n_out, samples,
+                    1.0,
+                    stacked_outputs[layer].data() + start, n_in,
+                    stacked_gradients[layer].data(), n_out,
+                    0.0,
+                    block.data(), n_out
+                );
+
+                for(size_t r = 0; r < rows; ++r) {
+                    const size_t row = start + r;
+                    const uint32_t end = matrix.row_offsets[row + 1];
+                    uint32_t k = matrix.row_offsets[row];
+
+                    for(size_t column = 0; column < n_out; ++column) {
+                        // Columns are sorted within a row, so presence is a merge.
+                        while(k < end && matrix.columns[k] < column)
+                            ++k;
+                        if(k < end && matrix.columns[k] == column && kept[k])
+                            continue;
+
+                        const double magnitude = std::fabs(block[r * n_out + column]);
+                        if(heap.size() < replaced) {
+                            heap.emplace_back(magnitude, row * n_out + column);
+                            std::push_heap(heap.begin(), heap.end(), weaker);
+                        }
+                        else if(magnitude > heap.front().first) {
+                            std::pop_heap(heap.begin(), heap.end(), weaker);
+                            heap.back() = std::make_pair(magnitude, uint64_t(row * n_out + column));
+                            std::push_heap(heap.begin(), heap.end(), weaker);
+                        }
+                    }
+                }
+            }
+
+            for(const auto& candidate : heap)
+                entries.emplace_back(candidate.second, 0.0);
+        }
+        else {
+            std::uniform_int_distribution<uint64_t> position(0, count - 1);
+            std::pmr::unordered_set<uint64_t> grown(this->resource);
+            grown.reserve(replaced);
+
+            while(grown.size() < replaced) {
+                const uint64_t index = position(this->gen);
+                const uint32_t column = static_cast<uint32_t>(index % n_out);
+                const uint32_t* begin = matrix.columns.data() + matrix.row_offsets[index / n_out];
+                const uint32_t* end = matrix.columns.data() + matrix.row_offsets[index / n_out + 1];
+                const uint32_t* found = std::lower_bound(begin, end, column);
+
+                if((found != end && *found == column && kept[static_cast<size_t>(found - matrix.columns.data())]) ||
+                    !grown.insert(index).second)
+                    continue;
+
+                entries.emplace_back(index, this->weight_dist(this->gen));
+            }
+        }
+
+        matrix = SparseMatrix::from_entries(n_in, n_out, entries, this->resource);
+    }
+}
+
+void NeuralNetwork::autotune(const std::vector<size_t>& batch_sizes) {
+    for(size_t layer = 0; layer < weights.size(); ++layer)
+        for(size_t batch : batch_sizes)
+            KernelAutotuner::tune(
+                layer_sizes[layer],
+                layer_sizes[layer + 1],
+                batch,
+                KernelPrecision::Double
+            );
+}
+
+void NeuralNetwork::set_activation_approximation(
+    std::shared_ptr<const ApproximateActivation> _approximation
+) {
+    this->approximation = std::move(_approximation);
+}
+
+std::shared_ptr<const ApproximateActivation> NeuralNetwork::get_activation_approximation() const {
+    return this->approximation;
 }
 
 }
@@ -0,0 +1,585 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/packed_layout.hpp>
+#include <chisei/half_precision.hpp>
+#include <chisei/simd_intrinsics.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+namespace {
+
+// The micro-kernels read their inputs as `float` or `uint8_t`; raw bytes are
+// widened one broadcast at a time, so no converted copy of the input is made.
+// Half-precision panels are widened the same way, one panel row per load.
+
+#if defined(__AVX512F__)
+inline __m512 load_row16(const float* row) {
+    return _mm512_loadu_ps(row);
+}
+
+inline __m512 load_row16(const uint16_t* row) {
+    return SimdIntrinsics::widen_half(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(row)));
+}
+
+template<typename WeightT, typename InputT>
+void forward_panel_avx512(
+    const WeightT* panel,
+    const float* biases,
+    const InputT* input,
+    float* output,
+    size_t n_in,
+    size_t valid
+) {
+    __m512 sum0 = _mm512_loadu_ps(biases);
+    __m512 sum1 = _mm512_setzero_ps();
+    __m512 sum2 = _mm512_setzero_ps();
+    __m512 sum3 = _mm512_setzero_ps();
+
+    size_t i = 0;
+    for(; i + 4 <= n_in; i += 4) {
+        const WeightT* row = panel + i * 16;
+
+        sum0 = _mm512_fmadd_ps(_mm512_set1_ps(static_cast<float>(input[i])),
+            load_row16(row), sum0);
+        sum1 = _mm512_fmadd_ps(_mm512_set1_ps(static_cast<float>(input[i + 1])),
+            load_row16(row + 16), sum1);
+        sum2 = _mm512_fmadd_ps(_mm512_set1_ps(static_cast<float>(input[i + 2])),
+            load_row16(row + 32), sum2);
+        sum3 = _mm512_fmadd_ps(_mm512_set1_ps(static_cast<float>(input[i + 3])),
+            load_row16(row + 48), sum3);
+    }
+
+    for(; i < n_in; ++i)
+        sum0 = _mm512_fmadd_ps(
+            _mm512_set1_ps(static_cast<float>(input[i])),
+            load_row16(panel + i * 16),
+            sum0
+        );
+
+    __m512 sum = _mm512_add_ps(_mm512_add_ps(sum0, sum1), _mm512_add_ps(sum2, sum3));
+    if(valid == 16)
+        _mm512_storeu_ps(output, sum);
+    else _mm512_mask_storeu_ps(
+        output,
+        static_cast<__mmask16>((1u << valid) - 1u),
+        sum
+    );
+}
+#endif
+
+#if defined(__AVX__)
+inline __m256 load_row8(const float* row) {
+    return _mm256_loadu_ps(row);
+}
+
+#if defined(__F16C__)
+inline __m256 load_row8(const uint16_t* row) {
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row)));
+}
+#endif
+
+template<typename WeightT, typename InputT>
+void forward_panel_avx(
+    const WeightT* panel,
+    const float* biases,
+    const InputT* input,
+    float* output,
+    size_t n_in,
+    size_t valid
+) {
+    __m256 sum0 = _mm256_loadu_ps(biases);
+    __m256 sum1 = _mm256_setzero_ps();
+    __m256 sum2 = _mm256_setzero_ps();
+    __m256 sum3 = _mm256_setzero_ps();
+
+    #if defined(__FMA__)
+    #   define CHISEI_PANEL_FMA(a, b, c) _mm256_fmadd_ps(a, b, c)
+    #else
+    #   define CHISEI_PANEL_FMA(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+    #endif
+
+    size_t i = 0;
+    for(; i + 4 <= n_in; i += 4) {
+        const WeightT* row = panel + i * 8;
+
+        sum0 = CHISEI_PANEL_FMA(_mm256_set1_ps(static_cast<float>(input[i])),
+            load_row8(row), sum0);
+        sum1 = CHISEI_PANEL_FMA(_mm256_set1_ps(static_cast<float>(input[i + 1])),
+            load_row8(row + 8), sum1);
+        sum2 = CHISEI_PANEL_FMA(_mm256_set1_ps(static_cast<float>(input[i + 2])),
+            load_row8(row + 16), sum2);
+        sum3 = CHISEI_PANEL_FMA(_mm256_set1_ps(static_cast<float>(input[i + 3])),
+            load_row8(row + 24), sum3);
+    }
+
+    for(; i < n_in; ++i)
+        sum0 = CHISEI_PANEL_FMA(
+            _mm256_set1_ps(static_cast<float>(input[i])),
+            load_row8(panel + i * 8),
+            sum0
+        );
+
+    #undef CHISEI_PANEL_FMA
+
+    __m256 sum = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+    if(valid == 8)
+        _mm256_storeu_ps(output, sum);
+    else {
+        float result[8];
+        _mm256_storeu_ps(result, sum);
+
+        for(size_t r = 0; r < valid; ++r)
+            output[r] = result[r];
+    }
+}
+#endif
+
+// Whether the AVX kernel can widen this weight type in registers.
+template<typename WeightT>
+constexpr bool avx_weights() {
+    #if defined(__F16C__)
+    return true;
+    #else
+    return std::is_same<WeightT, float>::value;
+    #endif
+}
+
+inline float widen(float weight) {
+    return weight;
+}
+
+inline float widen(uint16_t weight) {
+    return HalfPrecision::to_float(weight);
+}
+
+template<size_t NR, typename WeightT, typename InputT>
+void forward_panel(
+    const WeightT* panel,
+    const float* biases,
+    const InputT* input,
+    float* output,
+    size_t n_in,
+    size_t valid
+) {
+    #if defined(__AVX512F__)
+    if constexpr(NR == 16) {
+        forward_panel_avx512(panel, biases, input, output, n_in, valid);
+        return;
+    }
+    #endif
+
+    #if defined(__AVX__)
+    if constexpr(NR == 8 && avx_weights<WeightT>()) {
+        forward_panel_avx(panel, biases, input, output, n_in, valid);
+        return;
+    }
+    #endif
+
+    float sum[NR];
+    for(size_t r = 0; r < NR; ++r)
+        sum[r] = biases[r];
+
+    for(size_t i = 0; i < n_in; ++i) {
+        const float x = static_cast<float>(input[i]);
+        const WeightT* row = panel + i * NR;
+
+        for(size_t r = 0; r < NR; ++r)
+            sum[r] += x * widen(row[r]);
+    }
+
+    for(size_t r = 0; r < valid; ++r)
+        output[r] = sum[r];
+}
+
+template<size_t NR, typename WeightT, typename InputT>
+void forward_panels(
+    const KernelConfig& config,
+    const WeightT* panels,
+    const float* biases,
+    const InputT* input,
+    float* output,
+    size_t n_in,
+    size_t n_out
+) {
+    const size_t panel_count = (n_out + NR - 1) / NR;
+    const bool parallel = config.threads > 1 &&
+        n_in * n_out >= config.parallel_threshold;
+    const int threads = std::max(config.threads, 1);
+    (void) parallel;
+    (void) threads;
+
+    #pragma omp parallel for schedule(static) if(parallel) num_threads(threads)
+    for(size_t p = 0; p < panel_count; ++p)
+        forward_panel<NR>(
+            panels + p * n_in * NR,
+            biases + p * NR,
+            input,
+            output + p * NR,
+            n_in,
+            std::min(NR, n_out - p * NR)
+        );
+}
+
+template<typename WeightT, typename InputT>
+void forward_dispatch(
+    const KernelConfig& config,
+    const WeightT* panels,
+    const float* biases,
+    const InputT* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width
+) {
+    switch(panel_width) {
+        case 16:
+            forward_panels<16>(config, panels, biases, input, output, n_in, n_out);
+            break;
+
+        case 8:
+            forward_panels<8>(config, panels, biases, input, output, n_in, n_out);
+            break;
+
+        case 4:
+        default:
+            forward_panels<4>(config, panels, biases, input, output, n_in, n_out);
+            break;
+    }
+}
+
+inline void store_weight(double weight, float* destination) {
+    *destination = static_cast<float>(weight);
+}
+
+inline void store_weight(double weight, uint16_t* destination) {
+    *destination = HalfPrecision::from_float(static_cast<float>(weight));
+}
+
+template<typename WeightT>
+void pack_panels(
+    const double* weights,
+    const double* biases,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width,
+    WeightT* panels,
+    float* packed_biases,
+    const double* input_scale,
+    const double* input_offset
+) {
+    const size_t padded = PackedLayout::biases_size(n_out, panel_width);
+
+    for(size_t j = 0; j < padded; ++j) {
+        double bias = j < n_out ? biases[j] : 0.0;
+
+        if(j < n_out && input_offset != nullptr)
+            for(size_t i = 0; i < n_in; ++i)
+                bias += input_offset[i] * weights[i * n_out + j];
+        packed_biases[j] = static_cast<float>(bias);
+    }
+
+    for(size_t p = 0; p < padded / panel_width; ++p) {
+        WeightT* panel = panels + p * n_in * panel_width;
+
+        for(size_t i = 0; i < n_in; ++i)
+            for(size_t r = 0; r < panel_width; ++r) {
+                const size_t j = p * panel_width + r;
+
+                store_weight(j < n_out ? (
+                    input_scale != nullptr ?
+                        input_scale[i] * weights[i * n_out + j] :
+                        weights[i * n_out + j]
+                ) : 0.0, panel + i * panel_width + r);
+            }
+    }
+}
+
+}
+
+const unsigned char* PackedModel::base() const noexcept {
+    if(this->mapping)
+        return reinterpret_cast<const unsigned char*>(
+            this->mapping->data() + this->mapping_offset
+        );
+
+    return reinterpret_cast<const unsigned char*>(this->storage.data());
+}
+
+const float* PackedModel::float_panels(const PackedLayer& layer) const noexcept {
+    return reinterpret_cast<const float*>(this->base() + layer.panels_offset);
+}
+
+const uint16_t* PackedModel::half_panels(const PackedLayer& layer) const noexcept {
+    return reinterpret_cast<const uint16_t*>(this->base() + layer.panels_offset);
+}
+
+const float* PackedModel::biases(const PackedLayer& layer) const noexcept {
+    return reinterpret_cast<const float*>(this->base() + layer.biases_offset);
+}
+
+std::string PackedLayout::host_isa() {
+    #if defined(__AVX512F__)
+    return "avx512";
+    #elif defined(__AVX2__) && defined(__FMA__)
+    return "avx2";
+    #elif defined(__AVX__)
+    return "avx";
+    #elif defined(__SSE2__)
+    return "sse2";
+    #elif defined(__ARM_NEON)
+    return "neon";
+    #else
+    return "generic";
+    #endif
+}
+
+size_t PackedLayout::panel_width(const std::string& isa) {
+    if(isa == "avx512")
+        return 16;
+    else if(isa == "avx2" || isa == "avx")
+        return 8;
+    else if(isa == "sse2" || isa == "neon" || isa == "generic")
+        return 4;
+
+    throw std::invalid_argument("Unknown packed kernel ISA: " + isa);
+}
+
+size_t PackedLayout::panels_size(size_t n_in, size_t n_out, size_t panel_width) {
+    return biases_size(n_out, panel_width) * n_in;
+}
+
+size_t PackedLayout::biases_size(size_t n_out, size_t panel_width) {
+    return (n_out + panel_width - 1) / panel_width * panel_width;
+}
+
+size_t PackedLayout::element_size(PackedPrecision precision) {
+    switch(precision) {
+        case PackedPrecision::Half:
+            return sizeof(uint16_t);
+
+        case PackedPrecision::Float:
+        default:
+            return sizeof(float);
+    }
+}
+
+size_t PackedLayout::layout(PackedModel& model, const std::vector<size_t>& layer_sizes) {
+    // Panel and bias sizes are multiples of four values, so every offset stays
+    // float-aligned whatever the precision.
+    model.layers.clear();
+
+    size_t total = 0;
+    for(size_t layer = 0; layer + 1 < layer_sizes.size(); ++layer) {
+        PackedLayer packed;
+        packed.n_in = layer_sizes[layer];
+        packed.n_out = layer_sizes[layer + 1];
+        packed.panels_offset = total;
+        total += panels_size(packed.n_in, packed.n_out, model.panel_width) *
+            element_size(model.precision);
+
+        packed.biases_offset = total;
+        total += biases_size(packed.n_out, model.panel_width) * sizeof(float);
+
+        model.layers.push_back(packed);
+    }
+
+    return total;
+}
+
+void PackedLayout::pack(
+    const double* weights,
+    const double* biases,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width,
+    float* panels,
+    float* packed_biases,
+    const double* input_scale,
+    const double* input_offset
+) {
+    pack_panels(
+        weights,
+        biases,
+        n_in,
+        n_out,
+        panel_width,
+        panels,
+        packed_biases,
+        input_scale,
+        input_offset
+    );
+}
+
+void PackedLayout::pack(
+    const double* weights,
+    const double* biases,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width,
+    uint16_t* panels,
+    float* packed_biases,
+    const double* input_scale,
+    const double* input_offset
+) {
+    pack_panels(
+        weights,
+        biases,
+        n_in,
+        n_out,
+        panel_width,
+        panels,
+        packed_biases,
+        input_scale,
+        input_offset
+    );
+}
+
+std::shared_ptr<const PackedModel> PackedLayout::pack_model(
+    const std::vector<size_t>& layer_sizes,
+    const std::pmr::vector<std::pmr::vector<double>>& weights,
+    const std::pmr::vector<std::pmr::vector<double>>& biases,
+    const std::string& isa,
+    const std::pmr::vector<double>& input_scale,
+    const std::pmr::vector<double>& input_offset,
+    PackedPrecision precision,
+    std::pmr::memory_resource* resource
+) {
+    // The allocator is handed to the model's constructor as well, so the
+    // panels share the resource of the control block.
+    auto model = std::allocate_shared<PackedModel>(PackedModel::allocator_type(resource));
+    model->isa = isa;
+    model->panel_width = panel_width(isa);
+    model->precision = precision;
+    model->storage.resize(layout(*model, layer_sizes) / sizeof(float));
+
+    for(size_t layer = 0; layer < model->layers.size(); ++layer) {
+        const PackedLayer& packed = model->layers[layer];
+        unsigned char* data = reinterpret_cast<unsigned char*>(model->storage.data());
+
+        const double* scale = layer == 0 && !input_scale.empty() ?
+            input_scale.data() : nullptr;
+        const double* offset = layer == 0 && !input_offset.empty() ?
+            input_offset.data() : nullptr;
+        float* packed_biases = reinterpret_cast<float*>(data + packed.biases_offset);
+
+        if(precision == PackedPrecision::Half)
+            pack(
+                weights[layer].data(),
+                biases[layer].data(),
+                packed.n_in,
+                packed.n_out,
+                model->panel_width,
+                reinterpret_cast<uint16_t*>(data + packed.panels_offset),
+                packed_biases,
+                scale,
+                offset
+            );
+        else pack(
+            weights[layer].data(),
+            biases[layer].data(),
+            packed.n_in,
+            packed.n_out,
+            model->panel_width,
+            reinterpret_cast<float*>(data + packed.panels_offset),
+            packed_biases,
+            scale,
+            offset
+        );
+    }
+
+    return model;
+}
+
+void PackedLayout::forward(
+    const KernelConfig& config,
+    const float* panels,
+    const float* biases,
+    const float* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width
+) {
+    forward_dispatch(config, panels, biases, input, output, n_in, n_out, panel_width);
+}
+
+void PackedLayout::forward(
+    const KernelConfig& config,
+    const float* panels,
+    const float* biases,
+    const uint8_t* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width
+) {
+    forward_dispatch(config, panels, biases, input, output, n_in, n_out, panel_width);
+}
+
+void PackedLayout::forward(
+    const KernelConfig& config,
+    const uint16_t* panels,
+    const float* biases,
+    const float* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width
+) {
+    forward_dispatch(config, panels, biases, input, output, n_in, n_out, panel_width);
+}
+
+void PackedLayout::forward(
+    const KernelConfig& config,
+    const uint16_t* panels,
+    const float* biases,
+    const uint8_t* input,
+    float* output,
+    size_t n_in,
+    size_t n_out,
+    size_t panel_width
+) {
+    forward_dispatch(config, panels, biases, input, output, n_in, n_out, panel_width);
+}
+
+}
@@ -0,0 +1,188 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/model_stream.hpp>
+#include <chisei/pool2d_layer.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+TensorShape pooling_output(const TensorShape& input, size_t pool_size, size_t stride) {
+    if(pool_size == 0 || stride == 0 ||
+        input.height < pool_size || input.width < pool_size)
+        throw std::invalid_argument("Pooling window does not fit the input.");
+
+    return TensorShape{
+        input.channels,
+        (input.height - pool_size) / stride + 1,
+        (input.width - pool_size) / stride + 1
+    };
+}
+
+}
+
+Pool2DLayer::Pool2DLayer(
+    const TensorShape& _input_shape,
+    PoolingMode _mode,
+    size_t _pool_size,
+    size_t _stride
+) : Layer(
+        _input_shape,
+        pooling_output(_input_shape, _pool_size, _stride == 0 ? _pool_size : _stride)
+    ),
+    mode(_mode),
+    pool_size(_pool_size),
+    stride(_stride == 0 ? _pool_size : _stride)
+{ }
+
+std::unique_ptr<Pool2DLayer> Pool2DLayer::load(
+    std::istream& stream,
+    const TensorShape& _input_shape
+) {
+    const uint32_t pooling = ModelStream::read<uint32_t>(stream);
+    const size_t window = ModelStream::read_size(stream);
+    const size_t step = ModelStream::read_size(stream);
+
+    if(pooling < static_cast<uint32_t>(PoolingMode::Max) ||
+        pooling > static_cast<uint32_t>(PoolingMode::Average) || step == 0)
+        throw ModelLoaderException("Invalid *.chisei file format, bad pooling layer.");
+
+    try {
+        return std::unique_ptr<Pool2DLayer>(new Pool2DLayer(
+            _input_shape,
+            static_cast<PoolingMode>(pooling),
+            window,
+            step
+        ));
+    }
+    catch(const std::invalid_argument&) {
+        throw ModelLoaderException("Invalid *.chisei file format, bad pooling layer.");
+    }
+}
+
+LayerType Pool2DLayer::type() const noexcept {
+    return LayerType::Pool2D;
+}
+
+void Pool2DLayer::forward(const double* input, double* output, size_t batch) {
+    const size_t in_h = this->input_shape.height, in_w = this->input_shape.width;
+    const size_t out_h = this->output_shape.height, out_w = this->output_shape.width;
+    const size_t planes = batch * this->input_shape.channels;
+    const double scale = 1.0 / static_cast<double>(this->pool_size * this->pool_size);
+
+    #pragma omp parallel for schedule(static) if(planes * in_h * in_w >= 65536)
+    for(size_t plane = 0; plane < planes; ++plane) {
+        const double* x = input + plane * in_h * in_w;
+        double* y = output + plane * out_h * out_w;
+
+        for(size_t oy = 0; oy < out_h; ++oy)
+            for(size_t ox = 0; ox < out_w; ++ox) {
+                const double* window = x + oy * this->stride * in_w + ox * this->stride;
+                double value = this->mode == PoolingMode::Max ? window[0] : 0.0;
+
+                for(size_t ky = 0; ky < this->pool_size; ++ky)
+                    for(size_t kx = 0; kx < this->pool_size; ++kx) {
+                        const double sample = window[ky * in_w + kx];
+
+                        if(this->mode == PoolingMode::Max)
+                            value = std::max(value, sample);
+                        else value += sample;
+                    }
+
+                y[oy * out_w + ox] = this->mode == PoolingMode::Max ? value : value * scale;
+            }
+    }
+}
+
+void Pool2DLayer::backward(
+    const double* input,
+    const double* output,
+    const double* output_gradient,
+    double* input_gradient,
+    size_t batch
+) {
+    (void) output;
+    if(input_gradient == nullptr)
+        return;
+
+    const size_t in_h = this->input_shape.height, in_w = this->input_shape.width;
+    const size_t out_h = this->output_shape.height, out_w = this->output_shape.width;
+    const size_t planes = batch * this->input_shape.channels;
+    const double scale = 1.0 / static_cast<double>(this->pool_size * this->pool_size);
+
+    std::fill(input_gradient, input_gradient + planes * in_h * in_w, 0.0);
+
+    #pragma omp parallel for schedule(static) if(planes * in_h * in_w >= 65536)
+    for(size_t plane = 0; plane < planes; ++plane) {
+        const double* x = input + plane * in_h * in_w;
+        const double* dy = output_gradient + plane * out_h * out_w;
+        double* dx = input_gradient + plane * in_h * in_w;
+
+        for(size_t oy = 0; oy < out_h; ++oy)
+            for(size_t ox = 0; ox < out_w; ++ox) {
+                const size_t origin = oy * this->stride * in_w + ox * this->stride;
+                const double gradient = dy[oy * out_w + ox];
+
+                if(this->mode == PoolingMode::Average) {
+                    for(size_t ky = 0; ky < this->pool_size; ++ky)
+                        for(size_t kx = 0; kx < this->pool_size; ++kx)
+                            dx[origin + ky * in_w + kx] += gradient * scale;
+                    continue;
+                }
+
+                size_t best = origin;
+                for(size_t ky = 0; ky < this->pool_size; ++ky)
+                    for(size_t kx = 0; kx < this->pool_size; ++kx) {
+                        const size_t index = origin + ky * in_w + kx;
+
+                        if(x[index] > x[best])
+                            best = index;
+                    }
+
+                dx[best] += gradient;
+            }
+    }
+}
+
+void Pool2DLayer::save(std::ostream& stream) const {
+    ModelStream::write(stream, static_cast<uint32_t>(this->mode));
+    ModelStream::write_size(stream, this->pool_size);
+    ModelStream::write_size(stream, this->stride);
+}
+
+}
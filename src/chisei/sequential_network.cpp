@@ -0,0 +1,649 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/model_loader_exception.hpp>
+#include <chisei/model_stream.hpp>
+#include <chisei/sequential_network.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace chisei {
+
+namespace {
+
+constexpr uint32_t sequential_format_version = 1;
+
+// Buffers are rounded up to whole 64-byte cache lines.
+constexpr size_t arena_granularity = 64 / sizeof(double);
+
+struct BufferLifetime {
+    size_t size = 0;
+    size_t first_use = 0;
+    size_t last_use = 0;
+    size_t offset = 0;
+};
+
+// Greedy first-fit placement by start time: a buffer reuses the lowest gap
+// left by buffers whose last use came strictly before its first use.
+size_t place_buffers(std::vector<BufferLifetime>& buffers) {
+    std::vector<size_t> order(buffers.size());
+    for(size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    std::sort(order.begin(), order.end(), [&buffers](size_t a, size_t b) {
+        if(buffers[a].first_use != buffers[b].first_use)
+            return buffers[a].first_use < buffers[b].first_use;
+        return buffers[a].size > buffers[b].size;
+    });
+
+    std::vector<size_t> live;
+    size_t total = 0;
+
+    for(size_t index : order) {
+        BufferLifetime& buffer = buffers[index];
+
+        live.erase(std::remove_if(live.begin(), live.end(), [&](size_t other) {
+            return buffers[other].last_use < buffer.first_use;
+        }), live.end());
+
+        std::sort(live.begin(), live.end(), [&buffers](size_t a, size_t b) {
+            return buffers[a].offset < buffers[b].offset;
+        });
+
+        size_t offset = 0;
+        for(size_t other : live) {
+            if(offset + buffer.size <= buffers[other].offset)
+                break;
+            offset = std::max(offset, buffers[other].offset + buffers[other].size);
+        }
+
+        buffer.offset = offset;
+        total = std::max(total, offset + buffer.size);
+        live.push_back(index);
+    }
+
+    return total;
+}
+
+}
+
+SequentialNetwork::SequentialNetwork(const TensorShape& _input_shape) :
+    input_shape(_input_shape),
+    layers(),
+    plan(),
+    arena(),
+    input_offset(0),
+    compiled_batch(0),
+    compiled_mode(CompileMode::Inference),
+    activation_approximation(ApproximationKind::Exact),
+    approximation_resolution(0)
+{ }
+
+Layer& SequentialNetwork::add(std::unique_ptr<Layer> layer) {
+    if(layer->get_input_shape() != this->get_output_shape())
+        throw std::invalid_argument("Layer input shape does not match the network output.");
+
+    this->layers.push_back(std::move(layer));
+    this->compiled_batch = 0;
+
+    return *this->layers.back();
+}
+
+const TensorShape& SequentialNetwork::get_input_shape() const noexcept {
+    return this->input_shape;
+}
+
+const TensorShape& SequentialNetwork::get_output_shape() const noexcept {
+    return this->layers.empty() ?
+        this->input_shape :
+        this->layers.back()->get_output_shape();
+}
+
+size_t SequentialNetwork::layer_count() const noexcept {
+    return this->layers.size();
+}
+
+Layer& SequentialNetwork::get_layer(size_t index) {
+    return *this->layers.at(index);
+}
+
+size_t SequentialNetwork::parameter_count() const noexcept {
+    size_t count = 0;
+
+    for(const auto& layer : this->layers)
+        count += layer->parameter_count();
+    return count;
+}
+
+void SequentialNetwork::compile(size_t max_batch, CompileMode mode) {
+    max_batch = std::max<size_t>(max_batch, 1);
+
+    this->plan.clear();
+    std::vector<std::shared_ptr<const ApproximateActivation>> approximations(
+        this->layers.size()
+    );
+
+    for(size_t index = 0; index < this->layers.size(); ++index) {
+        Layer& layer = *this->layers[index];
+        layer.clear_fused_activation();
+
+        if(layer.type() != LayerType::Activation)
+            continue;
+
+        auto& activation = static_cast<ActivationLayer&>(layer);
+        if(mode == CompileMode::Inference)
+            approximations[index] = ActivationLayer::approximate(
+                activation.get_activation(),
+                this->activation_approximation,
+                this->approximation_resolution
+            );
+
+        activation.set_approximation(approximations[index]);
+    }
+
+    for(size_t index = 0; index < this->layers.size(); ++index) {
+        ExecutionStep step;
+        step.layer = step.last_layer = index;
+
+        Layer& layer = *this->layers[index];
+        if(index + 1 < this->layers.size() && layer.supports_fused_activation() &&
+            this->layers[index + 1]->type() == LayerType::Activation) {
+            const auto& activation = static_cast<const ActivationLayer&>(*this->layers[index + 1]);
+
+            layer.set_fused_activation(activation.get_activation(), approximations[index + 1]);
+            step.last_layer = ++index;
+        }
+
+        this->plan.push_back(step);
+    }
+
+    // Steps run forward at times 0..S-1, the loss at S and the backward pass of
+    // step s at 2S - s. Buffer k + 1 is the output of step k; buffer 0 is the
+    // training input. Gradient buffers follow the activations.
+    const size_t steps = this->plan.size();
+    const bool training = mode == CompileMode::Training;
+
+    std::vector<BufferLifetime> buffers;
+    auto planned = [&](size_t values, size_t first, size_t last) {
+        BufferLifetime buffer;
+        buffer.size = (max_batch * values + arena_granularity - 1) /
+            arena_granularity * arena_granularity;
+        buffer.first_use = first;
+        buffer.last_use = last;
+
+        buffers.push_back(buffer);
+        return buffers.size() - 1;
+    };
+
+    const size_t input_buffer = training ?
+        planned(this->input_shape.size(), 0, 2 * steps) : 0;
+    std::vector<size_t> outputs(steps), output_gradients(steps);
+
+    for(size_t s = 0; s < steps; ++s) {
+        const size_t values = this->layers[this->plan[s].last_layer]->get_output_shape().size();
+        outputs[s] = planned(values, s, training ? 2 * steps - s : s + 1);
+    }
+
+    if(training)
+        for(size_t s = 0; s < steps; ++s) {
+            const size_t values = this->layers[this->plan[s].last_layer]->get_output_shape().size();
+            output_gradients[s] = planned(values, 2 * steps - s - 1, 2 * steps - s);
+        }
+
+    this->arena.assign(place_buffers(buffers), 0.0);
+    this->input_offset = training ? buffers[input_buffer].offset : 0;
+
+    for(size_t s = 0; s < steps; ++s) {
+        ExecutionStep& step = this->plan[s];
+
+        step.input_offset = s == 0 ? this->input_offset : this->plan[s - 1].output_offset;
+        step.output_offset = buffers[outputs[s]].offset;
+        step.output_gradient_offset = training ? buffers[output_gradients[s]].offset : 0;
+    }
+
+    for(auto& layer : this->layers) {
+        layer->prepare(max_batch);
+        layer->set_training(training);
+    }
+
+    this->compiled_batch = max_batch;
+    this->compiled_mode = mode;
+}
+
+bool SequentialNetwork::is_compiled() const noexcept {
+    return this->compiled_batch != 0;
+}
+
+size_t SequentialNetwork::arena_size() const noexcept {
+    return this->arena.size();
+}
+
+const std::vector<ExecutionStep>& SequentialNetwork::get_plan() const noexcept {
+    return this->plan;
+}
+
+void SequentialNetwork::set_activation_approximation(ApproximationKind kind, size_t resolution) {
+    this->activation_approximation = kind;
+    this->approximation_resolution = resolution;
+    this->compiled_batch = 0;
+}
+
+ApproximationKind SequentialNetwork::get_activation_approximation() const noexcept {
+    return this->activation_approximation;
+}
+
+void SequentialNetwork::set_training(bool training) {
+    for(auto& layer : this->layers)
+        layer->set_training(training);
+}
+
+const double* SequentialNetwork::forward(const double* input, size_t batch) {
+    double* base = this->arena.data();
+
+    for(size_t s = 0; s < this->plan.size(); ++s) {
+        const ExecutionStep& step = this->plan[s];
+
+        this->layers[step.layer]->forward(
+            s == 0 ? input : base + step.input_offset,
+            base + step.output_offset,
+            batch
+        );
+    }
+
+    return base + this->plan.back().output_offset;
+}
+
+void SequentialNetwork::backward(const double* input, double* input_gradient, size_t batch) {
+    double* base = this->arena.data();
+
+    for(size_t s = this->plan.size(); s-- > 0;) {
+        const ExecutionStep& step = this->plan[s];
+
+        this->layers[step.layer]->backward(
+            s == 0 ? input : base + step.input_offset,
+            base + step.output_offset,
+            base + step.output_gradient_offset,
+            s == 0 ? input_gradient : base + this->plan[s - 1].output_gradient_offset,
+            batch
+        );
+    }
+}
+
+void SequentialNetwork::update(double learning_rate) {
+    for(auto& layer : this->layers)
+        layer->update(learning_rate);
+}
+
+double* SequentialNetwork::output_gradient() {
+    return this->arena.data() + this->plan.back().output_gradient_offset;
+}
+
+void SequentialNetwork::prepare(size_t batch, CompileMode mode) {
+    // A training plan also serves inference unless inference is approximated.
+    const bool recompile = !this->is_compiled() || this->compiled_batch < batch ||
+        (mode == CompileMode::Training ?
+            this->compiled_mode != CompileMode::Training :
+            this->compiled_mode == CompileMode::Training &&
+                this->activation_approximation != ApproximationKind::Exact);
+
+    if(recompile)
+        this->compile(batch, mode);
+    else if(this->compiled_mode == CompileMode::Training)
+        this->set_training(mode == CompileMode::Training);
+}
+
+std::vector<double> SequentialNetwork::predict(const std::vector<double>& input) {
+    if(this->layers.empty())
+        return input;
+
+    this->prepare(1, CompileMode::Inference);
+
+    const double* output = this->forward(input.data(), 1);
+    return std::vector<double>(output, output + this->get_output_shape().size());
+}
+
+void SequentialNetwork::train(
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets,
+    double learning_rate,
+    int epochs,
+    size_t batch_size
+) {
+    if(this->layers.empty() || inputs.empty())
+        return;
+
+    const size_t in_size = this->input_shape.size();
+    const size_t out_size = this->get_output_shape().size();
+    batch_size = std::max<size_t>(batch_size, 1);
+
+    this->prepare(batch_size, CompileMode::Training);
+    double* batch_input = this->arena.data() + this->input_offset;
+
+    // An LSH output layer only trains the classes it retrieves, plus the
+    // non-zero target entries it is told about.
+    Layer* last = this->layers[this->plan.back().layer].get();
+    LshDenseLayer* lsh_output = last->type() == LayerType::LshDense ?
+        static_cast<LshDenseLayer*>(last) : nullptr;
+    std::vector<uint32_t> target_neurons;
+    std::vector<size_t> target_offsets;
+
+    for(int epoch = 0; epoch < epochs; ++epoch)
+        for(size_t start = 0; start < inputs.size(); start += batch_size) {
+            const size_t batch = std::min(batch_size, inputs.size() - start);
+
+            for(size_t sample = 0; sample < batch; ++sample)
+                std::copy(
+                    inputs[start + sample].begin(),
+                    inputs[start + sample].end(),
+                    batch_input + sample * in_size
+                );
+
+            const double* output = this->forward(batch_input, batch);
+            double* output_gradient = this->output_gradient();
+
+            const double scale = 1.0 / static_cast<double>(batch);
+            for(size_t sample = 0; sample < batch; ++sample)
+                for(size_t j = 0; j < out_size; ++j)
+                    output_gradient[sample * out_size + j] = scale *
+                        (output[sample * out_size + j] - targets[start + sample][j]);
+
+            if(lsh_output != nullptr) {
+                target_neurons.clear();
+                target_offsets.assign(1, 0);
+
+                for(size_t sample = 0; sample < batch; ++sample) {
+                    for(size_t j = 0; j < out_size; ++j)
+                        if(std::fpclassify(targets[start + sample][j]) != FP_ZERO)
+                            target_neurons.push_back(static_cast<uint32_t>(j));
+
+                    target_offsets.push_back(target_neurons.size());
+                }
+
+                lsh_output->set_targets(target_neurons.data(), target_offsets.data(), batch);
+            }
+
+            this->backward(batch_input, nullptr, batch);
+            this->update(learning_rate);
+        }
+}
+
+double SequentialNetwork::compute_accuracy(
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets
+) {
+    size_t correct_predictions = 0;
+
+    for(size_t i = 0; i < inputs.size(); ++i) {
+        std::vector<double> prediction = this->predict(inputs[i]);
+
+        if(std::max_element(prediction.begin(), prediction.end()) - prediction.begin() ==
+            std::max_element(targets[i].begin(), targets[i].end()) - targets[i].begin())
+            ++correct_predictions;
+    }
+
+    return static_cast<double>(correct_predictions) / (double) inputs.size();
+}
+
+size_t SequentialNetwork::fold_batch_norm() {
+    size_t folded = 0;
+
+    for(size_t index = 1; index < this->layers.size();) {
+        Layer& previous = *this->layers[index - 1];
+        const LayerType previous_type = previous.type();
+
+        if(this->layers[index]->type() != LayerType::BatchNorm ||
+            (previous_type != LayerType::Dense && previous_type != LayerType::Conv2D)) {
+            ++index;
+            continue;
+        }
+
+        const auto& norm = static_cast<const BatchNormLayer&>(*this->layers[index]);
+        const std::vector<double> scale = norm.folded_scale();
+        const std::vector<double> shift = norm.folded_shift();
+
+        if(previous_type == LayerType::Dense) {
+            auto& dense = static_cast<DenseLayer&>(previous);
+            std::vector<double>& weights = dense.get_weights();
+            const size_t n_out = scale.size();
+
+            for(size_t i = 0; i < weights.size(); ++i)
+                weights[i] *= scale[i % n_out];
+
+            std::vector<double>& biases = dense.get_biases();
+            for(size_t j = 0; j < n_out; ++j)
+                biases[j] = scale[j] * biases[j] + shift[j];
+        }
+        else {
+            auto& conv = static_cast<Conv2DLayer&>(previous);
+            std::vector<double>& weights = conv.get_weights();
+            const size_t depth = weights.size() / scale.size();
+
+            for(size_t f = 0; f < scale.size(); ++f)
+                for(size_t k = 0; k < depth; ++k)
+                    weights[f * depth + k] *= scale[f];
+
+            std::vector<double>& biases = conv.get_biases();
+            for(size_t f = 0; f < scale.size(); ++f)
+                biases[f] = scale[f] * biases[f] + shift[f];
+        }
+
+        this->layers.erase(this->layers.begin() + static_cast<std::ptrdiff_t>(index));
+        ++folded;
+    }
+
+    if(folded != 0) {
+        this->plan.clear();
+        this->compiled_batch = 0;
+    }
+
+    return folded;
+}
+
+size_t SequentialNetwork::prune_blocks(double sparsity, size_t block_rows, size_t block_cols) {
+    size_t pruned = 0;
+
+    for(auto& layer : this->layers) {
+        if(layer->type() != LayerType::Dense)
+            continue;
+
+        auto& dense = static_cast<DenseLayer&>(*layer);
+        layer = BlockSparseDenseLayer::prune(
+            dense.get_input_shape(),
+            dense.get_weights(),
+            dense.get_biases(),
+            sparsity,
+            block_rows,
+            block_cols
+        );
+        ++pruned;
+    }
+
+    if(pruned != 0) {
+        this->plan.clear();
+        this->compiled_batch = 0;
+    }
+
+    return pruned;
+}
+
+void SequentialNetwork::write(std::ostream& stream, bool fold_batch_norm) const {
+    bool foldable = false;
+    for(size_t index = 1; fold_batch_norm && index < this->layers.size(); ++index)
+        if(this->layers[index]->type() == LayerType::BatchNorm &&
+            (this->layers[index - 1]->type() == LayerType::Dense ||
+            this->layers[index - 1]->type() == LayerType::Conv2D))
+            foldable = true;
+
+    if(foldable) {
+        // Fold a round-tripped copy so the trainable network keeps its layers.
+        std::stringstream buffer(std::ios::in | std::ios::out | std::ios::binary);
+        this->write(buffer);
+
+        SequentialNetwork copy = SequentialNetwork::read(buffer);
+        copy.fold_batch_norm();
+        copy.write(stream);
+
+        return;
+    }
+
+    const char magic[] = "CL";
+    stream.write(magic, sizeof(magic) - 1);
+
+    ModelStream::write(stream, sequential_format_version);
+    ModelStream::write_size(stream, this->input_shape.channels);
+    ModelStream::write_size(stream, this->input_shape.height);
+    ModelStream::write_size(stream, this->input_shape.width);
+    ModelStream::write_size(stream, this->layers.size());
+
+    for(const auto& layer : this->layers) {
+        ModelStream::write(stream, static_cast<uint32_t>(layer->type()));
+        layer->save(stream);
+    }
+}
+
+void SequentialNetwork::save_model(const std::string& filename, bool fold_batch_norm) const {
+    std::string final_filename = filename;
+    if(final_filename.size() < 7 ||
+        final_filename.substr(final_filename.size() - 7) != ".chisei")
+        final_filename += ".chisei";
+
+    std::ofstream file(final_filename, std::ios::binary);
+    if(!file)
+        throw ModelLoaderException("Failed to open *.chisei file for saving the model.");
+
+    std::ostringstream body(std::ios::out | std::ios::binary);
+    this->write(body, fold_batch_norm);
+    ModelStream::write_checksummed(file, body.str());
+
+    if(!file)
+        throw ModelLoaderException("Failed to write *.chisei file.");
+}
+
+SequentialNetwork SequentialNetwork::loadFromModel(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    if(!file.is_open())
+        throw ModelLoaderException("Failed to open file for loading model.");
+
+    std::istringstream body(ModelStream::read_checksummed(file), std::ios::in | std::ios::binary);
+    SequentialNetwork network = SequentialNetwork::read(body);
+
+    if(body.peek() != std::char_traits<char>::eof())
+        throw ModelLoaderException("Invalid *.chisei file format, trailing data.");
+
+    return network;
+}
+
+SequentialNetwork SequentialNetwork::read(std::istream& stream) {
+    char magic[2] = {0};
+    stream.read(magic, sizeof(magic));
+    if(magic[0] != 'C' || magic[1] != 'L')
+        throw ModelLoaderException("Invalid *.chisei file format, missing magic bytes.");
+
+    if(ModelStream::read<uint32_t>(stream) != sequential_format_version)
+        throw ModelLoaderException("Unsupported *.chisei layered format version.");
+
+    TensorShape shape;
+    shape.channels = ModelStream::read_size(stream);
+    shape.height = ModelStream::read_size(stream);
+    shape.width = ModelStream::read_size(stream);
+
+    // Each dimension, and the sample size they multiply to, fits in 32 bits.
+    const size_t limit = std::numeric_limits<uint32_t>::max();
+    if(shape.channels == 0 || shape.height == 0 || shape.width == 0 ||
+        shape.channels > limit || shape.height > limit / shape.channels ||
+        shape.width > limit / (shape.channels * shape.height))
+        throw ModelLoaderException("Invalid *.chisei file format, bad input shape.");
+
+    SequentialNetwork network(shape);
+    const size_t count = ModelStream::read_size(stream);
+
+    for(size_t index = 0; index < count; ++index) {
+        const TensorShape& input = network.get_output_shape();
+
+        switch(static_cast<LayerType>(ModelStream::read<uint32_t>(stream))) {
+            case LayerType::Dense:
+                network.add(DenseLayer::load(stream, input));
+                break;
+
+            case LayerType::Activation:
+                network.add(ActivationLayer::load(stream, input));
+                break;
+
+            case LayerType::Conv2D:
+                network.add(Conv2DLayer::load(stream, input));
+                break;
+
+            case LayerType::Pool2D:
+                network.add(Pool2DLayer::load(stream, input));
+                break;
+
+            case LayerType::Embedding:
+                network.add(EmbeddingLayer::load(stream, input));
+                break;
+
+            case LayerType::BatchNorm:
+                network.add(BatchNormLayer::load(stream, input));
+                break;
+
+            case LayerType::LshDense:
+                network.add(LshDenseLayer::load(stream, input));
+                break;
+
+            case LayerType::MixtureOfExperts:
+                network.add(MixtureOfExpertsLayer::load(stream, input));
+                break;
+
+            case LayerType::HashedDense:
+                network.add(HashedDenseLayer::load(stream, input));
+                break;
+
+            case LayerType::BlockSparseDense:
+                network.add(BlockSparseDenseLayer::load(stream, input));
+                break;
+
+            default:
+                throw ModelLoaderException("Invalid *.chisei file format, unknown layer type.");
+        }
+    }
+
+    return network;
+}
+
+}
@@ -0,0 +1,243 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+#include <chisei/simd_intrinsics.hpp>
+#include <chisei/sparse_matrix.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#   include <immintrin.h>
+#endif
+
+namespace chisei {
+
+SparseMatrix SparseMatrix::from_entries(
+    size_t rows,
+    size_t cols,
+    std::pmr::vector<std::pair<uint64_t, double>>& entries,
+    std::pmr::memory_resource* resource
+) {
+    std::sort(entries.begin(), entries.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    SparseMatrix matrix{SparseMatrix::allocator_type(resource)};
+    matrix.rows = rows;
+    matrix.cols = cols;
+    matrix.row_offsets.assign(rows + 1, 0);
+    matrix.columns.resize(entries.size());
+    matrix.values.resize(entries.size());
+
+    for(size_t k = 0; k < entries.size(); ++k) {
+        const size_t row = static_cast<size_t>(entries[k].first / cols);
+
+        ++matrix.row_offsets[row + 1];
+        matrix.columns[k] = static_cast<uint32_t>(entries[k].first % cols);
+        matrix.values[k] = entries[k].second;
+    }
+
+    for(size_t row = 0; row < rows; ++row)
+        matrix.row_offsets[row + 1] += matrix.row_offsets[row];
+
+    return matrix;
+}
+
+SparseMatrix SparseMatrix::from_dense(
+    const double* dense,
+    size_t rows,
+    size_t cols,
+    size_t keep,
+    std::pmr::memory_resource* resource
+) {
+    const size_t count = rows * cols;
+    std::pmr::vector<uint64_t> order(count, resource);
+
+    for(size_t index = 0; index < count; ++index)
+        order[index] = index;
+
+    keep = std::min(keep, count);
+    std::nth_element(
+        order.begin(),
+        order.begin() + static_cast<std::ptrdiff_t>(keep),
+        order.end(),
+        [dense](uint64_t a, uint64_t b) {
+            return std::fabs(dense[a]) > std::fabs(dense[b]);
+        }
+    );
+
+    std::pmr::vector<std::pair<uint64_t, double>> entries(keep, resource);
+    for(size_t k = 0; k < keep; ++k)
+        entries[k] = {order[k], dense[order[k]]};
+
+    return from_entries(rows, cols, entries, resource);
+}
+
+void SparseMatrix::to_dense(double* dense) const {
+    std::fill(dense, dense + this->rows * this->cols, 0.0);
+
+    for(size_t row = 0; row < this->rows; ++row)
+        for(uint32_t k = this->row_offsets[row]; k < this->row_offsets[row + 1]; ++k)
+            dense[row * this->cols + this->columns[k]] = this->values[k];
+}
+
+void SparseMatrix::multiply_add(const double* input, double* output) const {
+    for(size_t row = 0; row < this->rows; ++row) {
+        const double value = input[row];
+        if(std::fpclassify(value) == FP_ZERO)
+            continue;
+
+        size_t k = this->row_offsets[row];
+        const size_t end = this->row_offsets[row + 1];
+
+#if defined(__AVX512F__)
+        // Columns are unique within a row, so the scatter never collides.
+        const __m512d scale = _mm512_set1_pd(value);
+        for(; k + 8 <= end; k += 8) {
+            const __m256i index = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(this->columns.data() + k)
+            );
+            const __m512d sum = _mm512_fmadd_pd(
+                scale,
+                _mm512_loadu_pd(this->values.data() + k),
+                SimdIntrinsics::gather(output, index)
+            );
+
+            _mm512_i32scatter_pd(output, index, sum, 8);
+        }
+#endif
+
+        for(; k < end; ++k)
+            output[this->columns[k]] += value * this->values[k];
+    }
+}
+
+void SparseMatrix::multiply_transposed(const double* gradient, double* output) const {
+    for(size_t row = 0; row < this->rows; ++row) {
+        size_t k = this->row_offsets[row];
+        const size_t end = this->row_offsets[row + 1];
+        double sum = 0.0;
+
+#if defined(__AVX512F__)
+        __m512d partial = _mm512_setzero_pd();
+        for(; k + 8 <= end; k += 8) {
+            const __m256i index = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(this->columns.data() + k)
+            );
+
+            partial = _mm512_fmadd_pd(
+                _mm512_loadu_pd(this->values.data() + k),
+                SimdIntrinsics::gather(gradient, index),
+                partial
+            );
+        }
+        // Reduced through memory; GCC 12's reduction intrinsic also trips
+        // the warning `SimdIntrinsics` works around.
+        alignas(64) double lanes[8];
+        _mm512_store_pd(lanes, partial);
+
+        for(double lane : lanes)
+            sum += lane;
+#elif defined(__AVX2__)
+        __m256d partial = _mm256_setzero_pd();
+
+        for(; k + 4 <= end; k += 4) {
+            const __m128i index = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(this->columns.data() + k)
+            );
+
+            partial = _mm256_add_pd(partial, _mm256_mul_pd(
+                _mm256_loadu_pd(this->values.data() + k),
+                SimdIntrinsics::gather(gradient, index)
+            ));
+        }
+
+        const __m128d half = _mm_add_pd(
+            _mm256_castpd256_pd128(partial),
+            _mm256_extractf128_pd(partial, 1)
+        );
+        sum = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+#endif
+
+        for(; k < end; ++k)
+            sum += this->values[k] * gradient[this->columns[k]];
+
+        output[row] = sum;
+    }
+}
+
+void SparseMatrix::rank_one_update(double scale, const double* input, const double* gradient) {
+    for(size_t row = 0; row < this->rows; ++row) {
+        if(std::fpclassify(input[row]) == FP_ZERO)
+            continue;
+
+        const double step = scale * input[row];
+        size_t k = this->row_offsets[row];
+        const size_t end = this->row_offsets[row + 1];
+
+#if defined(__AVX512F__)
+        const __m512d factor = _mm512_set1_pd(step);
+        for(; k + 8 <= end; k += 8) {
+            const __m256i index = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i*>(this->columns.data() + k)
+            );
+
+            _mm512_storeu_pd(this->values.data() + k, _mm512_fnmadd_pd(
+                factor,
+                SimdIntrinsics::gather(gradient, index),
+                _mm512_loadu_pd(this->values.data() + k)
+            ));
+        }
+#elif defined(__AVX2__)
+        const __m256d factor = _mm256_set1_pd(step);
+
+        for(; k + 4 <= end; k += 4) {
+            const __m128i index = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(this->columns.data() + k)
+            );
+
+            _mm256_storeu_pd(this->values.data() + k, _mm256_sub_pd(
+                _mm256_loadu_pd(this->values.data() + k),
+                _mm256_mul_pd(factor, SimdIntrinsics::gather(gradient, index))
+            ));
+        }
+#endif
+
+        for(; k < end; ++k)
+            this->values[k] -= step * gradient[this->columns[k]];
+    }
+}
+
+}
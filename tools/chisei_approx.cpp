@@ -0,0 +1,199 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+// Measures how much approximate activations change the accuracy of a model.
+//
+// Usage: chisei_approx <model.chisei> <images.idx> <labels.idx> [samples] [resolution]
+//
+// Accepts both `NeuralNetwork` (CS) and `SequentialNetwork` (CL) models and
+// an MNIST-style IDX dataset. Every approximation kind is compared against
+// the exact activations on the same samples.
+
+#include <chisei/activation_layer.hpp>
+#include <chisei/idx_loader.hpp>
+#include <chisei/neural_network.hpp>
+#include <chisei/sequential_network.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Evaluation {
+    std::vector<std::vector<double>> outputs{};
+    double accuracy = 0.0;
+    double microseconds = 0.0;
+};
+
+size_t argmax(const std::vector<double>& values) {
+    return static_cast<size_t>(
+        std::max_element(values.begin(), values.end()) - values.begin()
+    );
+}
+
+Evaluation evaluate(
+    const std::function<std::vector<double>(const std::vector<double>&)>& predict,
+    const std::vector<std::vector<double>>& inputs,
+    const std::vector<std::vector<double>>& targets
+) {
+    Evaluation evaluation;
+    evaluation.outputs.reserve(inputs.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    for(const auto& input : inputs)
+        evaluation.outputs.push_back(predict(input));
+    const auto end = std::chrono::steady_clock::now();
+
+    size_t correct = 0;
+    for(size_t i = 0; i < inputs.size(); ++i)
+        if(argmax(evaluation.outputs[i]) == argmax(targets[i]))
+            ++correct;
+
+    evaluation.accuracy = 100.0 * static_cast<double>(correct) /
+        static_cast<double>(inputs.size());
+    evaluation.microseconds = std::chrono::duration<double, std::micro>(end - start).count() /
+        static_cast<double>(inputs.size());
+
+    return evaluation;
+}
+
+void report(const std::string& name, const Evaluation& exact, const Evaluation& approximate) {
+    double max_deviation = 0.0, total_deviation = 0.0;
+    size_t values = 0;
+
+    for(size_t i = 0; i < exact.outputs.size(); ++i)
+        for(size_t j = 0; j < exact.outputs[i].size(); ++j) {
+            const double deviation = std::fabs(exact.outputs[i][j] - approximate.outputs[i][j]);
+
+            max_deviation = std::max(max_deviation, deviation);
+            total_deviation += deviation;
+            ++values;
+        }
+
+    std::cout << std::left << std::setw(10) << name << std::right << std::fixed
+        << std::setprecision(2) << std::setw(10) << approximate.accuracy << "%"
+        << std::showpos << std::setw(10) << approximate.accuracy - exact.accuracy << std::noshowpos
+        << std::scientific << std::setprecision(2)
+        << std::setw(12) << total_deviation / static_cast<double>(std::max<size_t>(values, 1))
+        << std::setw(12) << max_deviation
+        << std::fixed << std::setw(10) << approximate.microseconds << std::endl;
+}
+
+bool is_sequential(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[2] = {0, 0};
+
+    file.read(magic, sizeof(magic));
+    return magic[0] == 'C' && magic[1] == 'L';
+}
+
+}
+
+int main(int argc, char** argv) {
+    if(argc < 4) {
+        std::cerr << "Usage: " << argv[0]
+            << " <model.chisei> <images.idx> <labels.idx> [samples] [resolution]" << std::endl;
+        return 1;
+    }
+
+    const std::string model = argv[1];
+    const size_t samples = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 0;
+    const size_t resolution = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 0;
+
+    try {
+        std::vector<std::vector<double>> inputs, targets;
+        chisei::IDXLoader::loadMNIST(argv[2], argv[3], inputs, targets, samples);
+
+        const std::vector<std::pair<std::string, chisei::ApproximationKind>> kinds = {
+            {"hard", chisei::ApproximationKind::Hard},
+            {"pwl", chisei::ApproximationKind::PiecewiseLinear},
+            {"lut", chisei::ApproximationKind::LookupTable}
+        };
+
+        std::cout << "Samples: " << inputs.size() << std::endl
+            << std::left << std::setw(10) << "mode" << std::right
+            << std::setw(11) << "accuracy" << std::setw(10) << "delta"
+            << std::setw(12) << "mean |dy|" << std::setw(12) << "max |dy|"
+            << std::setw(10) << "us/pred" << std::endl;
+
+        if(is_sequential(model)) {
+            chisei::SequentialNetwork network = chisei::SequentialNetwork::loadFromModel(model);
+            auto predict = [&network](const std::vector<double>& input) {
+                return network.predict(input);
+            };
+
+            const Evaluation exact = evaluate(predict, inputs, targets);
+            report("exact", exact, exact);
+
+            for(const auto& kind : kinds) {
+                network.set_activation_approximation(kind.second, resolution);
+                report(kind.first, exact, evaluate(predict, inputs, targets));
+            }
+
+            return 0;
+        }
+
+        chisei::NeuralNetwork network = chisei::NeuralNetwork::loadFromModel(model);
+        auto predict = [&network](const std::vector<double>& input) {
+            return network.predict(input);
+        };
+
+        const Evaluation exact = evaluate(predict, inputs, targets);
+        report("exact", exact, exact);
+
+        for(const auto& kind : kinds) {
+            network.set_activation_approximation(chisei::ActivationLayer::approximate(
+                chisei::ActivationType::Sigmoid,
+                kind.second,
+                resolution
+            ));
+            report(kind.first, exact, evaluate(predict, inputs, targets));
+        }
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,589 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+// Reports where a model spends its parameters, FLOPs and memory traffic.
+//
+// Usage: chisei_inspect <model.chisei> [--bandwidth <GB/s>] [--peak <GFLOP/s>]
+//
+// Prints the layer shapes, parameter counts and weight memory per precision,
+// FLOPs per sample for predict and train, and weight magnitude statistics of
+// every layer that stores weights, which show pruning and quantization headroom.
+// Every layer is then placed on a roofline built from a quick probe of the
+// host's memory bandwidth and of the library's own dense kernel throughput;
+// --bandwidth and --peak replace the probed values.
+//
+// `SequentialNetwork` (CL) layers other than dense and convolution layers get
+// estimated FLOPs, marked with `~`.
+
+#include <chisei/dense_kernels.hpp>
+#include <chisei/kernel_autotuner.hpp>
+#include <chisei/neural_network.hpp>
+#include <chisei/sequential_network.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr size_t batched_rows = 64;
+
+struct LayerInfo {
+    std::string name{};
+    std::string shape{};
+    size_t parameters = 0;
+    double weights_read = 0.0;
+    double activations = 0.0;
+    double predict_flops = 0.0;
+    double train_flops = 0.0;
+    bool estimated = false;
+    std::vector<double> weights{};
+};
+
+struct Roofline {
+    double bandwidth = 0.0;
+    double peak = 0.0;
+};
+
+std::string format_shape(const chisei::TensorShape& shape) {
+    std::ostringstream stream;
+    if(shape.height == 1 && shape.width == 1)
+        stream << shape.channels;
+    else if(shape.channels == 1 && shape.height == 1)
+        stream << shape.width;
+    else stream << shape.channels << "x" << shape.height << "x" << shape.width;
+
+    return stream.str();
+}
+
+std::string format_count(double value) {
+    const char* const suffixes[] = {"", "K", "M", "G", "T"};
+    size_t suffix = 0;
+
+    while(value >= 1000.0 && suffix + 1 < sizeof(suffixes) / sizeof(suffixes[0])) {
+        value /= 1000.0;
+        ++suffix;
+    }
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(suffix == 0 ? 0 : 2) << value << suffixes[suffix];
+
+    return stream.str();
+}
+
+std::string format_bytes(double bytes) {
+    const char* const suffixes[] = {"B", "KiB", "MiB", "GiB"};
+    size_t suffix = 0;
+
+    while(bytes >= 1024.0 && suffix + 1 < sizeof(suffixes) / sizeof(suffixes[0])) {
+        bytes /= 1024.0;
+        ++suffix;
+    }
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(suffix == 0 ? 0 : 1) << bytes << " " << suffixes[suffix];
+
+    return stream.str();
+}
+
+bool is_sequential(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[2] = {0, 0};
+
+    file.read(magic, sizeof(magic));
+    return magic[0] == 'C' && magic[1] == 'L';
+}
+
+std::vector<LayerInfo> describe(const chisei::NeuralNetwork& network) {
+    const std::vector<size_t>& sizes = network.get_layer_sizes();
+    std::vector<LayerInfo> layers;
+
+    for(size_t layer = 0; layer + 1 < sizes.size(); ++layer) {
+        const double n_in = static_cast<double>(sizes[layer]);
+        const double n_out = static_cast<double>(sizes[layer + 1]);
+        const double macs = n_in * n_out;
+
+        LayerInfo info;
+        info.name = "dense" + std::to_string(layer);
+        info.shape = std::to_string(sizes[layer]) + " -> " + std::to_string(sizes[layer + 1]);
+        info.parameters = sizes[layer] * sizes[layer + 1] + sizes[layer + 1];
+        info.weights_read = static_cast<double>(info.parameters);
+        info.activations = n_in + n_out;
+
+        // Bias and activation per output, then in training the output delta,
+        // the input delta (not needed below the first layer) and the update.
+        info.predict_flops = 2.0 * macs + 2.0 * n_out;
+        info.train_flops = info.predict_flops + 2.0 * n_out +
+            (layer == 0 ? 0.0 : 2.0 * macs) + 2.0 * (macs + n_out);
+
+        info.weights = network.get_weights(layer);
+
+        layers.push_back(std::move(info));
+    }
+
+    return layers;
+}
+
+std::vector<LayerInfo> describe(chisei::SequentialNetwork& network) {
+    std::vector<LayerInfo> layers;
+
+    for(size_t index = 0; index < network.layer_count(); ++index) {
+        const chisei::Layer& layer = network.get_layer(index);
+        const double n_in = static_cast<double>(layer.get_input_shape().size());
+        const double n_out = static_cast<double>(layer.get_output_shape().size());
+
+        LayerInfo info;
+        info.shape = format_shape(layer.get_input_shape()) + " -> " +
+            format_shape(layer.get_output_shape());
+        info.parameters = layer.parameter_count();
+        info.weights_read = static_cast<double>(info.parameters);
+        info.activations = n_in + n_out;
+
+        const double parameters = static_cast<double>(info.parameters);
+        switch(layer.type()) {
+            case chisei::LayerType::Dense:
+            case chisei::LayerType::HashedDense:
+                info.name = layer.type() == chisei::LayerType::Dense ? "dense" : "hashed";
+                info.predict_flops = 2.0 * n_in * n_out + n_out;
+                info.train_flops = 3.0 * info.predict_flops + 2.0 * parameters;
+                break;
+
+            case chisei::LayerType::BlockSparseDense:
+                // Every stored weight, padding included, is multiplied.
+                info.name = "blocksparse";
+                info.predict_flops = 2.0 * (parameters - n_out) + n_out;
+                info.train_flops = 3.0 * info.predict_flops + 2.0 * parameters;
+                break;
+
+            case chisei::LayerType::Conv2D: {
+                const chisei::TensorShape& output = layer.get_output_shape();
+                const double kernel_weights = parameters - static_cast<double>(output.channels);
+                const double macs = kernel_weights * static_cast<double>(output.height * output.width);
+
+                info.name = "conv2d";
+                info.predict_flops = 2.0 * macs + n_out;
+                info.train_flops = 3.0 * info.predict_flops + 2.0 * parameters;
+                break;
+            }
+
+            case chisei::LayerType::Embedding:
+                info.name = "embedding";
+                info.weights_read = n_out;
+                info.predict_flops = n_out;
+                info.train_flops = 2.0 * n_out;
+                break;
+
+            case chisei::LayerType::Activation:
+                info.name = "activation";
+                info.predict_flops = n_out;
+                info.train_flops = 2.0 * n_out;
+                break;
+
+            case chisei::LayerType::Pool2D:
+                info.name = "pool2d";
+                info.predict_flops = n_in;
+                info.train_flops = 2.0 * n_in;
+                break;
+
+            case chisei::LayerType::BatchNorm:
+                info.name = "batchnorm";
+                info.predict_flops = 2.0 * n_out;
+                info.train_flops = 6.0 * n_out;
+                info.estimated = true;
+                break;
+
+            case chisei::LayerType::LshDense:
+            case chisei::LayerType::MixtureOfExperts:
+                // Both compute only a data-dependent part of their weights;
+                // running all of them bounds the cost from above.
+                info.name = layer.type() == chisei::LayerType::LshDense ? "lsh" : "moe";
+                info.predict_flops = 2.0 * parameters;
+                info.train_flops = 6.0 * parameters;
+                info.estimated = true;
+                break;
+
+            default:
+                info.name = "layer";
+                info.estimated = true;
+                break;
+        }
+
+        info.name += std::to_string(index);
+        info.weights = layer.weight_values();
+        layers.push_back(std::move(info));
+    }
+
+    return layers;
+}
+
+Roofline probe() {
+    Roofline roofline;
+
+    // Streams a buffer well beyond the last-level cache.
+    std::vector<double> buffer(size_t(1) << 24, 1.0);
+    double best = std::numeric_limits<double>::max();
+    volatile double sink = 0.0;
+
+    for(int run = 0; run < 5; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        double sum = 0.0;
+
+        #pragma omp parallel for reduction(+:sum) schedule(static)
+        for(size_t i = 0; i < buffer.size(); ++i)
+            sum += buffer[i];
+
+        best = std::min(best, std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count());
+        sink = sum;
+    }
+
+    (void) sink;
+    roofline.bandwidth = static_cast<double>(buffer.size() * sizeof(double)) / best;
+
+    // A large batched GEMM through the library's own kernel is the compute roof.
+    const size_t n = 1024, batch = 256;
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+
+    std::vector<double> weights(n * n), input(batch * n), output(batch * n);
+    for(double& value : weights)
+        value = distribution(generator);
+    for(double& value : input)
+        value = distribution(generator);
+
+    const chisei::KernelConfig config = chisei::KernelAutotuner::lookup(
+        n, n, batch, chisei::KernelPrecision::Double
+    );
+
+    best = std::numeric_limits<double>::max();
+    for(int run = 0; run < 3; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        chisei::DenseKernels::forward(
+            config,
+            weights.data(),
+            nullptr,
+            input.data(),
+            output.data(),
+            n,
+            n,
+            batch
+        );
+
+        best = std::min(best, std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count());
+    }
+
+    roofline.peak = 2.0 * static_cast<double>(n * n * batch) / best;
+    return roofline;
+}
+
+void print_layers(const std::vector<LayerInfo>& layers) {
+    std::cout << std::left << std::setw(14) << "layer" << std::setw(22) << "shape"
+        << std::right << std::setw(12) << "params" << std::setw(12) << "fp64"
+        << std::setw(12) << "fp32" << std::setw(12) << "fp16" << std::setw(12) << "int8"
+        << std::setw(12) << "predict" << std::setw(12) << "train" << std::endl;
+
+    size_t parameters = 0;
+    double predict_flops = 0.0, train_flops = 0.0;
+    bool estimated = false;
+
+    for(const LayerInfo& layer : layers) {
+        const double count = static_cast<double>(layer.parameters);
+        const std::string mark = layer.estimated ? "~" : "";
+
+        std::cout << std::left << std::setw(14) << layer.name << std::setw(22) << layer.shape
+            << std::right << std::setw(12) << format_count(count)
+            << std::setw(12) << format_bytes(8.0 * count) << std::setw(12) << format_bytes(4.0 * count)
+            << std::setw(12) << format_bytes(2.0 * count) << std::setw(12) << format_bytes(count)
+            << std::setw(12) << mark + format_count(layer.predict_flops)
+            << std::setw(12) << mark + format_count(layer.train_flops) << std::endl;
+
+        parameters += layer.parameters;
+        predict_flops += layer.predict_flops;
+        train_flops += layer.train_flops;
+        estimated = estimated || layer.estimated;
+    }
+
+    const double count = static_cast<double>(parameters);
+    const std::string mark = estimated ? "~" : "";
+
+    std::cout << std::left << std::setw(14) << "total" << std::setw(22) << ""
+        << std::right << std::setw(12) << format_count(count)
+        << std::setw(12) << format_bytes(8.0 * count) << std::setw(12) << format_bytes(4.0 * count)
+        << std::setw(12) << format_bytes(2.0 * count) << std::setw(12) << format_bytes(count)
+        << std::setw(12) << mark + format_count(predict_flops)
+        << std::setw(12) << mark + format_count(train_flops) << std::endl << std::endl;
+}
+
+void print_weight_statistics(const std::vector<LayerInfo>& layers) {
+    const std::array<double, 6> edges = {{1e-4, 1e-3, 1e-2, 1e-1, 1.0, 10.0}};
+
+    std::cout << "Weight magnitudes (% of weights per |w| range):" << std::endl
+        << std::left << std::setw(14) << "layer" << std::right
+        << std::setw(8) << "0" << std::setw(8) << "<1e-4" << std::setw(8) << "<1e-3"
+        << std::setw(8) << "<1e-2" << std::setw(8) << "<0.1" << std::setw(8) << "<1"
+        << std::setw(8) << "<10" << std::setw(8) << ">=10" << std::endl;
+
+    for(const LayerInfo& layer : layers) {
+        if(layer.weights.empty())
+            continue;
+
+        std::array<size_t, edges.size() + 2> histogram{};
+        for(double weight : layer.weights) {
+            const double magnitude = std::fabs(weight);
+            if(std::fpclassify(magnitude) == FP_ZERO) {
+                ++histogram[0];
+                continue;
+            }
+
+            ++histogram[1 + static_cast<size_t>(
+                std::upper_bound(edges.begin(), edges.end(), magnitude) - edges.begin()
+            )];
+        }
+
+        std::cout << std::left << std::setw(14) << layer.name << std::right
+            << std::fixed << std::setprecision(1);
+        for(size_t bucket : histogram)
+            std::cout << std::setw(8) << 100.0 * static_cast<double>(bucket) /
+                static_cast<double>(std::max<size_t>(layer.weights.size(), 1));
+        std::cout << std::endl;
+    }
+
+    std::cout << std::endl << "Pruning and quantization headroom:" << std::endl
+        << std::left << std::setw(14) << "layer" << std::right
+        << std::setw(12) << "max |w|" << std::setw(12) << "<1% max" << std::setw(12) << "<5% max"
+        << std::setw(12) << "int8 SQNR" << std::setw(12) << "fp16 loss" << std::endl;
+
+    for(const LayerInfo& layer : layers) {
+        if(layer.weights.empty())
+            continue;
+
+        double max_magnitude = 0.0;
+        for(double weight : layer.weights)
+            max_magnitude = std::max(max_magnitude, std::fabs(weight));
+
+        // Symmetric per-layer int8 quantization; fp16 loses weights that are
+        // subnormal or overflow in half precision.
+        const double scale = max_magnitude / 127.0;
+        double signal = 0.0, noise = 0.0;
+        size_t below_one = 0, below_five = 0, half_loss = 0;
+
+        for(double weight : layer.weights) {
+            const double magnitude = std::fabs(weight);
+            below_one += magnitude < 0.01 * max_magnitude ? 1 : 0;
+            below_five += magnitude < 0.05 * max_magnitude ? 1 : 0;
+            half_loss += (magnitude > 0.0 && magnitude < 6.103515625e-05) ||
+                magnitude > 65504.0 ? 1 : 0;
+
+            const double quantized = scale > 0.0 ? std::round(weight / scale) * scale : 0.0;
+            signal += weight * weight;
+            noise += (weight - quantized) * (weight - quantized);
+        }
+
+        const double count = static_cast<double>(std::max<size_t>(layer.weights.size(), 1));
+        std::ostringstream sqnr;
+        if(noise > 0.0)
+            sqnr << std::fixed << std::setprecision(1) << 10.0 * std::log10(signal / noise) << " dB";
+        else sqnr << "exact";
+
+        std::cout << std::left << std::setw(14) << layer.name << std::right
+            << std::scientific << std::setprecision(2) << std::setw(12) << max_magnitude
+            << std::fixed << std::setprecision(1)
+            << std::setw(11) << 100.0 * static_cast<double>(below_one) / count << "%"
+            << std::setw(11) << 100.0 * static_cast<double>(below_five) / count << "%"
+            << std::setw(12) << sqnr.str()
+            << std::setw(11) << 100.0 * static_cast<double>(half_loss) / count << "%" << std::endl;
+    }
+
+    std::cout << std::endl;
+}
+
+void print_roofline(const std::vector<LayerInfo>& layers, const Roofline& roofline, bool packable) {
+    const double ridge = roofline.peak / roofline.bandwidth;
+
+    std::cout << std::fixed << std::setprecision(1)
+        << "Roofline: " << roofline.bandwidth / 1e9 << " GB/s, "
+        << roofline.peak / 1e9 << " GFLOP/s, ridge at "
+        << std::setprecision(2) << ridge << " FLOP/byte" << std::endl
+        << std::left << std::setw(14) << "layer" << std::right
+        << std::setw(12) << "AI fp64@1" << std::setw(12) << "AI fp32@1"
+        << std::setw(12) << "AI fp64@" + std::to_string(batched_rows)
+        << std::setw(10) << "bound@1" << std::setw(10) << "bound@" + std::to_string(batched_rows)
+        << std::setw(12) << "us@1" << std::setw(12) << "us@" + std::to_string(batched_rows)
+        << std::endl;
+
+    double total_single = 0.0, total_batched = 0.0;
+    size_t memory_bound_single = 0, memory_bound_batched = 0;
+
+    for(const LayerInfo& layer : layers) {
+        // Weights are read once per call and shared by every row of a batch;
+        // inputs and outputs are moved once per row.
+        auto intensity = [&layer](double element_size, double rows) {
+            const double bytes = element_size * (layer.weights_read / rows + layer.activations);
+            return layer.predict_flops / std::max(bytes, 1.0);
+        };
+
+        auto seconds = [&layer, &roofline](double arithmetic_intensity) {
+            return layer.predict_flops /
+                std::min(roofline.peak, arithmetic_intensity * roofline.bandwidth);
+        };
+
+        const double single = intensity(8.0, 1.0);
+        const double batched = intensity(8.0, static_cast<double>(batched_rows));
+
+        memory_bound_single += single < ridge ? 1 : 0;
+        memory_bound_batched += batched < ridge ? 1 : 0;
+        total_single += seconds(single);
+        total_batched += seconds(batched);
+
+        std::cout << std::left << std::setw(14) << layer.name << std::right
+            << std::setprecision(2) << std::setw(12) << single
+            << std::setw(12) << intensity(4.0, 1.0) << std::setw(12) << batched
+            << std::setw(10) << (single < ridge ? "memory" : "compute")
+            << std::setw(10) << (batched < ridge ? "memory" : "compute")
+            << std::setprecision(3) << std::setw(12) << 1e6 * seconds(single)
+            << std::setw(12) << 1e6 * seconds(batched) << std::endl;
+    }
+
+    std::cout << std::left << std::setw(14) << "total" << std::right << std::setw(56) << ""
+        << std::setprecision(3) << std::setw(12) << 1e6 * total_single
+        << std::setw(12) << 1e6 * total_batched << std::endl << std::endl;
+
+    std::cout << "Hints:" << std::endl;
+    if(memory_bound_single > memory_bound_batched)
+        std::cout << "  - Batching moves " << memory_bound_single - memory_bound_batched
+            << " layer(s) off the memory roof; score with predict(Dataset) or chisei_score."
+            << std::endl;
+
+    if(memory_bound_single != 0 && packable)
+        std::cout << "  - Single-sample predict is bandwidth bound; freeze() packs the weights"
+            " as fp32 and halves their traffic, freeze(PackedPrecision::Half) as fp16"
+            " quarters it." << std::endl;
+
+    if(memory_bound_batched == 0 && memory_bound_single == 0)
+        std::cout << "  - Every layer is compute bound; fewer FLOPs (pruning, narrower layers)"
+            " pay off more than smaller weights." << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    if(argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+            << " <model.chisei> [--bandwidth GB/s] [--peak GFLOP/s]" << std::endl;
+        return 1;
+    }
+
+    const std::string model = argv[1];
+    double bandwidth = 0.0, peak = 0.0;
+
+    for(int i = 2; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        if(flag == "--bandwidth")
+            bandwidth = std::strtod(argv[i + 1], nullptr) * 1e9;
+        else if(flag == "--peak")
+            peak = std::strtod(argv[i + 1], nullptr) * 1e9;
+        else {
+            std::cerr << "Unknown option " << flag << std::endl;
+            return 1;
+        }
+    }
+
+    try {
+        std::vector<LayerInfo> layers;
+        std::string kind;
+        bool packable = false;
+
+        if(is_sequential(model)) {
+            chisei::SequentialNetwork network = chisei::SequentialNetwork::loadFromModel(model);
+
+            kind = "SequentialNetwork";
+            layers = describe(network);
+        }
+        else {
+            chisei::NeuralNetwork network = chisei::NeuralNetwork::loadFromModel(model);
+
+            kind = "NeuralNetwork";
+            layers = describe(network);
+            packable = true;
+
+            if(network.exit_count() != 0)
+                kind += ", " + std::to_string(network.exit_count()) + " exit head(s)";
+            if(network.has_input_transform())
+                kind += ", input transform";
+            if(network.is_frozen())
+                kind += ", packed panels";
+        }
+
+        std::cout << "Model: " << model << " (" << kind << ", "
+            << format_bytes(static_cast<double>(std::filesystem::file_size(model)))
+            << " on disk)" << std::endl << std::endl;
+
+        print_layers(layers);
+        if(std::any_of(layers.begin(), layers.end(), [](const LayerInfo& layer) {
+            return !layer.weights.empty();
+        }))
+            print_weight_statistics(layers);
+
+        Roofline roofline;
+        if(bandwidth <= 0.0 || peak <= 0.0)
+            roofline = probe();
+        if(bandwidth > 0.0)
+            roofline.bandwidth = bandwidth;
+        if(peak > 0.0)
+            roofline.peak = peak;
+
+        print_roofline(layers, roofline, packable);
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,648 @@
+/*
+ * 
+ * Copyright 2025 Nathanne Isip
+ * 
+ * Redistribution and use in source and binary forms,
+ * with or without modification, are permitted provided
+ * that the following conditions are met:
+ * 
+ * 1. Redistributions of source code must retain the
+ *    above copyright notice, this list of conditions
+ *    and the following disclaimer.
+ * 
+ * 2. Redistributions in binary form must reproduce
+ *    the above copyright notice, this list of conditions
+ *    and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ * 
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+ * CONTRIBUTORS “AS IS” AND ANY EXPRESS OR IMPLIED WARRANTIES,
+ * INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ * NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+ * DAMAGE.
+ * 
+ */
+
+// Scores an IDX or CSV file with a model through a pipelined batch loop.
+//
+// Usage: chisei_score <model.chisei> <inputs.idx|inputs.csv> <output> [options]
+//
+//   --batch <rows>      Rows per batch (default 256).
+//   --top-k <k>         Writes the k best outputs per row instead of all of them.
+//   --text              Writes one comma-separated text line per row.
+//   --scale <value>     Raw input scale; defaults to the model's input transform.
+//   --offset <value>    Raw input offset; defaults to the model's input transform.
+//
+// Binary output holds `float` outputs row by row, or `k` pairs of a `uint32_t`
+// output index and its `float` value with --top-k. Text output with --top-k
+// writes `index:value` pairs. Inputs ending in `.csv` are parsed as CSV (an
+// optional header line is skipped); anything else is read as IDX.
+//
+// Reading, conversion, inference and writing each run on their own thread
+// and hand batches to the next stage through bounded queues, so disk I/O and
+// parsing overlap with the batched `NeuralNetwork::predict` call.
+
+#include <chisei/dataset.hpp>
+#include <chisei/matrix_view.hpp>
+#include <chisei/neural_network.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t pipeline_depth = 4;
+
+struct Options {
+    std::string model{};
+    std::string input{};
+    std::string output{};
+    size_t batch = 256;
+    size_t top_k = 0;
+    bool text = false;
+    bool has_scale = false;
+    bool has_offset = false;
+    double scale = 1.0;
+    double offset = 0.0;
+};
+
+struct Batch {
+    size_t first = 0;
+    size_t rows = 0;
+    std::vector<char> raw{};
+    std::vector<double> inputs{};
+    std::vector<double> outputs{};
+    std::string text{};
+};
+
+class BatchQueue final {
+private:
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<std::unique_ptr<Batch>> batches;
+    bool closed;
+
+public:
+    BatchQueue() :
+        mutex(),
+        ready(),
+        batches(),
+        closed(false) { }
+
+    void push(std::unique_ptr<Batch> batch) {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            if(this->closed)
+                return;
+
+            this->batches.push_back(std::move(batch));
+        }
+
+        this->ready.notify_one();
+    }
+
+    // Returns nullptr once the queue is closed and drained.
+    std::unique_ptr<Batch> pop() {
+        std::unique_lock<std::mutex> lock(this->mutex);
+        this->ready.wait(lock, [this] { return !this->batches.empty() || this->closed; });
+
+        if(this->batches.empty())
+            return nullptr;
+
+        std::unique_ptr<Batch> batch = std::move(this->batches.front());
+        this->batches.pop_front();
+
+        return batch;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->closed = true;
+        }
+
+        this->ready.notify_all();
+    }
+};
+
+// Reads batches of raw rows: fixed-size records for IDX, text lines for CSV.
+class InputReader {
+public:
+    virtual ~InputReader() = default;
+
+    virtual bool read(Batch& batch, size_t rows) = 0;
+    virtual void convert(Batch& batch, size_t columns) const = 0;
+    virtual size_t columns() const = 0;
+};
+
+class IdxReader final : public InputReader {
+private:
+    std::ifstream file;
+    uint8_t type;
+    size_t element_size;
+    size_t row_elements;
+    size_t remaining;
+
+    static uint32_t read_uint32(std::ifstream& stream) {
+        unsigned char bytes[4] = {0, 0, 0, 0};
+        stream.read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+
+        return static_cast<uint32_t>(bytes[0]) << 24 | static_cast<uint32_t>(bytes[1]) << 16 |
+            static_cast<uint32_t>(bytes[2]) << 8 | static_cast<uint32_t>(bytes[3]);
+    }
+
+    template<typename T, typename Bits>
+    static double decode(const char* element) {
+        Bits bits = 0;
+        for(size_t i = 0; i < sizeof(Bits); ++i)
+            bits = static_cast<Bits>(bits << 8 | static_cast<unsigned char>(element[i]));
+
+        T value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+        return static_cast<double>(value);
+    }
+
+public:
+    explicit IdxReader(const std::string& filename) :
+        file(filename, std::ios::binary),
+        type(0),
+        element_size(0),
+        row_elements(1),
+        remaining(0) {
+        if(!this->file)
+            throw std::runtime_error("Failed to open " + filename);
+
+        char header[4] = {0, 0, 0, 0};
+        this->file.read(header, sizeof(header));
+        this->type = static_cast<uint8_t>(header[2]);
+
+        const size_t dimensions = static_cast<unsigned char>(header[3]);
+        switch(this->type) {
+            case 0x08: case 0x09: this->element_size = 1; break;
+            case 0x0B: this->element_size = 2; break;
+            case 0x0C: case 0x0D: this->element_size = 4; break;
+            case 0x0E: this->element_size = 8; break;
+            default: this->element_size = 0; break;
+        }
+
+        if(!this->file || header[0] != 0 || header[1] != 0 ||
+            this->element_size == 0 || dimensions == 0)
+            throw std::runtime_error("Invalid IDX file: " + filename);
+
+        this->remaining = read_uint32(this->file);
+        for(size_t dimension = 1; dimension < dimensions; ++dimension)
+            this->row_elements *= read_uint32(this->file);
+
+        if(!this->file)
+            throw std::runtime_error("Truncated IDX header: " + filename);
+    }
+
+    bool read(Batch& batch, size_t rows) override {
+        batch.rows = std::min(rows, this->remaining);
+        if(batch.rows == 0)
+            return false;
+
+        const size_t row_bytes = this->row_elements * this->element_size;
+        batch.raw.resize(batch.rows * row_bytes);
+        this->file.read(batch.raw.data(), static_cast<std::streamsize>(batch.raw.size()));
+
+        if(!this->file)
+            throw std::runtime_error("Truncated IDX file.");
+
+        this->remaining -= batch.rows;
+        return true;
+    }
+
+    void convert(Batch& batch, size_t) const override {
+        const size_t count = batch.rows * this->row_elements;
+        const char* raw = batch.raw.data();
+
+        batch.inputs.resize(count);
+        for(size_t i = 0; i < count; ++i, raw += this->element_size)
+            switch(this->type) {
+                case 0x08: batch.inputs[i] = static_cast<unsigned char>(*raw); break;
+                case 0x09: batch.inputs[i] = static_cast<signed char>(*raw); break;
+                case 0x0B: batch.inputs[i] = decode<int16_t, uint16_t>(raw); break;
+                case 0x0C: batch.inputs[i] = decode<int32_t, uint32_t>(raw); break;
+                case 0x0D: batch.inputs[i] = decode<float, uint32_t>(raw); break;
+                default: batch.inputs[i] = decode<double, uint64_t>(raw); break;
+            }
+    }
+
+    size_t columns() const override {
+        return this->row_elements;
+    }
+};
+
+class CsvReader final : public InputReader {
+private:
+    std::ifstream file;
+    std::string line;
+    size_t column_count;
+    bool pending;
+
+    static bool is_numeric(const std::string& text) {
+        const size_t start = text.find_first_not_of(" \t");
+        return start != std::string::npos &&
+            std::strchr("0123456789+-.", text[start]) != nullptr;
+    }
+
+    bool next_line() {
+        while(std::getline(this->file, this->line)) {
+            if(!this->line.empty() && this->line.back() == '\r')
+                this->line.pop_back();
+
+            if(this->line.find_first_not_of(" \t") != std::string::npos)
+                return true;
+        }
+
+        return false;
+    }
+
+public:
+    explicit CsvReader(const std::string& filename) :
+        file(filename),
+        line(),
+        column_count(0),
+        pending(false) {
+        if(!this->file)
+            throw std::runtime_error("Failed to open " + filename);
+
+        this->pending = this->next_line();
+        if(this->pending && !is_numeric(this->line))
+            this->pending = this->next_line();
+
+        if(this->pending)
+            this->column_count = static_cast<size_t>(
+                std::count(this->line.begin(), this->line.end(), ',')
+            ) + 1;
+    }
+
+    bool read(Batch& batch, size_t rows) override {
+        batch.raw.clear();
+        batch.rows = 0;
+
+        while(batch.rows < rows && this->pending) {
+            batch.raw.insert(batch.raw.end(), this->line.begin(), this->line.end());
+            batch.raw.push_back('\n');
+            ++batch.rows;
+
+            this->pending = this->next_line();
+        }
+
+        return batch.rows != 0;
+    }
+
+    void convert(Batch& batch, size_t columns) const override {
+        batch.raw.push_back('\0');
+        batch.inputs.resize(batch.rows * columns);
+
+        const char* cursor = batch.raw.data();
+        for(size_t row = 0; row < batch.rows; ++row) {
+            for(size_t column = 0; column < columns; ++column) {
+                char* end = nullptr;
+                batch.inputs[row * columns + column] = std::strtod(cursor, &end);
+
+                while(end != cursor && (*end == ' ' || *end == '\t'))
+                    ++end;
+
+                const char expected = column + 1 == columns ? '\n' : ',';
+                if(end == cursor || *end != expected)
+                    throw std::runtime_error(
+                        "CSV row " + std::to_string(batch.first + row + 1) +
+                        " does not hold " + std::to_string(columns) + " numeric values."
+                    );
+
+                cursor = end + 1;
+            }
+        }
+    }
+
+    size_t columns() const override {
+        return this->column_count;
+    }
+};
+
+bool ends_with(const std::string& text, const std::string& suffix) {
+    return text.size() >= suffix.size() &&
+        text.compare(text.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+Options parse_options(int argc, char** argv) {
+    if(argc < 4)
+        throw std::invalid_argument(
+            std::string("Usage: ") + argv[0] + " <model.chisei> <inputs.idx|inputs.csv> <output>"
+            " [--batch rows] [--top-k k] [--text] [--scale value] [--offset value]"
+        );
+
+    Options options;
+    options.model = argv[1];
+    options.input = argv[2];
+    options.output = argv[3];
+
+    for(int i = 4; i < argc; ++i) {
+        const std::string flag = argv[i];
+        if(flag == "--text") {
+            options.text = true;
+            continue;
+        }
+
+        if(i + 1 >= argc)
+            throw std::invalid_argument("Missing value for " + flag);
+
+        const char* value = argv[++i];
+        if(flag == "--batch")
+            options.batch = std::strtoull(value, nullptr, 10);
+        else if(flag == "--top-k")
+            options.top_k = std::strtoull(value, nullptr, 10);
+        else if(flag == "--scale") {
+            options.scale = std::strtod(value, nullptr);
+            options.has_scale = true;
+        }
+        else if(flag == "--offset") {
+            options.offset = std::strtod(value, nullptr);
+            options.has_offset = true;
+        }
+        else throw std::invalid_argument("Unknown option " + flag);
+    }
+
+    if(options.batch == 0)
+        throw std::invalid_argument("--batch must be positive.");
+
+    return options;
+}
+
+void format_row(
+    const Options& options,
+    const double* outputs,
+    size_t n_outputs,
+    std::vector<uint32_t>& order,
+    Batch& batch
+) {
+    const size_t k = std::min(options.top_k, n_outputs);
+    if(k != 0) {
+        order.resize(n_outputs);
+        std::iota(order.begin(), order.end(), 0u);
+        std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k),
+            order.end(), [outputs](uint32_t a, uint32_t b) { return outputs[a] > outputs[b]; });
+    }
+
+    if(!options.text) {
+        for(size_t i = 0; i < (k != 0 ? k : n_outputs); ++i) {
+            const uint32_t index = k != 0 ? order[i] : static_cast<uint32_t>(i);
+            const float value = static_cast<float>(outputs[index]);
+
+            if(k != 0)
+                batch.text.append(reinterpret_cast<const char*>(&index), sizeof(index));
+            batch.text.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        return;
+    }
+
+    char field[48];
+    for(size_t i = 0; i < (k != 0 ? k : n_outputs); ++i) {
+        const int length = k != 0 ?
+            std::snprintf(field, sizeof(field), "%s%u:%.6g", i == 0 ? "" : ",",
+                static_cast<unsigned>(order[i]), outputs[order[i]]) :
+            std::snprintf(field, sizeof(field), "%s%.6g", i == 0 ? "" : ",", outputs[i]);
+
+        batch.text.append(field, static_cast<size_t>(length));
+    }
+
+    batch.text.push_back('\n');
+}
+
+class Stage final {
+private:
+    std::chrono::steady_clock::duration busy;
+    std::chrono::steady_clock::time_point started;
+
+public:
+    Stage() :
+        busy(),
+        started() { }
+
+    void begin() {
+        this->started = std::chrono::steady_clock::now();
+    }
+
+    void end() {
+        this->busy += std::chrono::steady_clock::now() - this->started;
+    }
+
+    double seconds() const {
+        return std::chrono::duration<double>(this->busy).count();
+    }
+};
+
+}
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parse_options(argc, argv);
+        chisei::NeuralNetwork network = chisei::NeuralNetwork::loadFromModel(options.model);
+
+        const size_t n_inputs = network.get_layer_sizes().front();
+        const size_t n_outputs = network.get_layer_sizes().back();
+
+        std::unique_ptr<InputReader> reader;
+        if(ends_with(options.input, ".csv"))
+            reader = std::make_unique<CsvReader>(options.input);
+        else reader = std::make_unique<IdxReader>(options.input);
+
+        if(reader->columns() != 0 && reader->columns() != n_inputs)
+            throw std::runtime_error(
+                "Input rows hold " + std::to_string(reader->columns()) +
+                " values, but the model expects " + std::to_string(n_inputs) + "."
+            );
+
+        // Raw values go through the model's recorded transform, like `predict_raw`.
+        std::vector<double> scale(n_inputs, options.scale), offset(n_inputs, options.offset);
+        if(network.has_input_transform()) {
+            if(!options.has_scale)
+                scale.assign(network.get_input_scale().begin(), network.get_input_scale().end());
+
+            if(!options.has_offset)
+                offset.assign(
+                    network.get_input_offset().begin(),
+                    network.get_input_offset().end()
+                );
+        }
+
+        std::ofstream output(options.output, options.text ? std::ios::out : std::ios::binary);
+        if(!output)
+            throw std::runtime_error("Failed to open " + options.output);
+
+        BatchQueue free_batches, read_batches, converted_batches, scored_batches;
+        for(size_t i = 0; i < pipeline_depth; ++i)
+            free_batches.push(std::make_unique<Batch>());
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        auto fail = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if(!error)
+                    error = std::current_exception();
+            }
+
+            for(BatchQueue* queue : {&free_batches, &read_batches,
+                &converted_batches, &scored_batches})
+                queue->close();
+        };
+
+        Stage read_stage, convert_stage, predict_stage, write_stage;
+        size_t samples = 0;
+
+        const auto start = std::chrono::steady_clock::now();
+        std::thread read_thread([&]() {
+            try {
+                for(size_t first = 0;;) {
+                    std::unique_ptr<Batch> batch = free_batches.pop();
+                    if(!batch)
+                        break;
+
+                    read_stage.begin();
+                    batch->first = first;
+                    const bool more = reader->read(*batch, options.batch);
+                    read_stage.end();
+
+                    if(!more)
+                        break;
+
+                    first += batch->rows;
+                    read_batches.push(std::move(batch));
+                }
+            }
+            catch(...) {
+                fail();
+            }
+
+            read_batches.close();
+        });
+
+        std::thread convert_thread([&]() {
+            try {
+                while(std::unique_ptr<Batch> batch = read_batches.pop()) {
+                    convert_stage.begin();
+                    reader->convert(*batch, n_inputs);
+
+                    for(size_t row = 0; row < batch->rows; ++row)
+                        for(size_t i = 0; i < n_inputs; ++i) {
+                            double& value = batch->inputs[row * n_inputs + i];
+                            value = scale[i] * value + offset[i];
+                        }
+                    convert_stage.end();
+
+                    converted_batches.push(std::move(batch));
+                }
+            }
+            catch(...) {
+                fail();
+            }
+
+            converted_batches.close();
+        });
+
+        std::thread write_thread([&]() {
+            try {
+                std::vector<uint32_t> order;
+                while(std::unique_ptr<Batch> batch = scored_batches.pop()) {
+                    write_stage.begin();
+                    batch->text.clear();
+
+                    for(size_t row = 0; row < batch->rows; ++row)
+                        format_row(options, batch->outputs.data() + row * n_outputs,
+                            n_outputs, order, *batch);
+
+                    output.write(batch->text.data(), static_cast<std::streamsize>(batch->text.size()));
+                    if(!output)
+                        throw std::runtime_error("Failed to write " + options.output);
+
+                    samples += batch->rows;
+                    write_stage.end();
+
+                    free_batches.push(std::move(batch));
+                }
+            }
+            catch(...) {
+                fail();
+            }
+        });
+
+        try {
+            while(std::unique_ptr<Batch> batch = converted_batches.pop()) {
+                predict_stage.begin();
+                batch->outputs.resize(batch->rows * n_outputs);
+                network.predict(
+                    chisei::MatrixView<double>(batch->inputs.data(), batch->rows, n_inputs),
+                    batch->outputs.data()
+                );
+                predict_stage.end();
+
+                scored_batches.push(std::move(batch));
+            }
+        }
+        catch(...) {
+            fail();
+        }
+
+        scored_batches.close();
+        read_thread.join();
+        convert_thread.join();
+        write_thread.join();
+
+        if(error)
+            std::rethrow_exception(error);
+
+        output.flush();
+        const double seconds = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+
+        std::cout << "Samples: " << samples << std::endl
+            << std::fixed << std::setprecision(3)
+            << "Elapsed: " << seconds << " s" << std::endl
+            << std::setprecision(0)
+            << "Throughput: " << static_cast<double>(samples) / std::max(seconds, 1e-9)
+            << " samples/s" << std::endl
+            << std::setprecision(3)
+            << "Busy: read " << read_stage.seconds() << " s, convert "
+            << convert_stage.seconds() << " s, predict " << predict_stage.seconds()
+            << " s, write " << write_stage.seconds() << " s" << std::endl;
+    }
+    catch(const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}